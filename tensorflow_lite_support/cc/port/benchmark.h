@@ -16,6 +16,6 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_PORT_BENCHMARK_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_PORT_BENCHMARK_H_
 
-#include "gtest/benchmark.h"
+#include "benchmark/benchmark.h"
 
 #endif  // TENSORFLOW_LITE_SUPPORT_CC_PORT_BENCHMARK_H_
@@ -257,9 +257,20 @@ absl::Status TfLiteInterpreterWrapper::InitializeDelegate() {
 absl::Status TfLiteInterpreterWrapper::InvokeWithFallback(
     const std::function<absl::Status(tflite::Interpreter* interpreter)>&
         set_inputs) {
+  return InvokeWithFallback(set_inputs, absl::InfiniteFuture());
+}
+
+absl::Status TfLiteInterpreterWrapper::InvokeWithFallback(
+    const std::function<absl::Status(tflite::Interpreter* interpreter)>&
+        set_inputs,
+    absl::Time deadline) {
   RETURN_IF_ERROR(set_inputs(interpreter_.get()));
-  // Reset cancel flag before calling `Invoke()`.
-  cancel_flag_.Set(false);
+  // Reset cancel flag and set the deadline before calling `Invoke()`.
+  cancel_flag_.Reset(deadline);
+  if (cancel_flag_.DeadlineExceeded()) {
+    return absl::DeadlineExceededError(
+        "Deadline exceeded before Invoke() was called.");
+  }
   TfLiteStatus status = kTfLiteError;
   if (fallback_on_execution_error_) {
     status = InterpreterUtils::InvokeWithCPUFallback(interpreter_.get());
@@ -275,6 +286,9 @@ absl::Status TfLiteInterpreterWrapper::InvokeWithFallback(
   if (status == kTfLiteError && cancel_flag_.Get()) {
     return absl::CancelledError("Invoke() cancelled.");
   }
+  if (status == kTfLiteError && cancel_flag_.DeadlineExceeded()) {
+    return absl::DeadlineExceededError("Invoke() exceeded its deadline.");
+  }
   if (delegate_) {
     // Mark that an error occurred so that later invocations immediately
     // fallback to CPU.
@@ -289,9 +303,32 @@ absl::Status TfLiteInterpreterWrapper::InvokeWithFallback(
 }
 
 absl::Status TfLiteInterpreterWrapper::InvokeWithoutFallback() {
-  // Reset cancel flag before calling `Invoke()`.
-  cancel_flag_.Set(false);
-  TfLiteStatus status = interpreter_->Invoke();
+  return InvokeWithoutFallback(absl::InfiniteFuture());
+}
+
+absl::Status TfLiteInterpreterWrapper::InvokeWithoutFallback(
+    absl::Time deadline) {
+  return InvokeWithCancelFlag([this]() { return interpreter_->Invoke(); },
+                              deadline);
+}
+
+absl::Status TfLiteInterpreterWrapper::InvokeSignatureWithoutFallback(
+    tflite::SignatureRunner* runner, absl::Time deadline) {
+  // The cancellation function is set on all the subgraphs of the interpreter,
+  // including those of its signatures.
+  return InvokeWithCancelFlag([runner]() { return runner->Invoke(); },
+                              deadline);
+}
+
+absl::Status TfLiteInterpreterWrapper::InvokeWithCancelFlag(
+    const std::function<TfLiteStatus()>& invoke, absl::Time deadline) {
+  // Reset cancel flag and set the deadline before calling `Invoke()`.
+  cancel_flag_.Reset(deadline);
+  if (cancel_flag_.DeadlineExceeded()) {
+    return absl::DeadlineExceededError(
+        "Deadline exceeded before Invoke() was called.");
+  }
+  TfLiteStatus status = invoke();
   if (status != kTfLiteOk) {
     // Assume InvokeWithoutFallback() is guarded under caller's synchronization.
     // Assume the inference is cancelled successfully if Invoke() returns
@@ -299,6 +336,9 @@ absl::Status TfLiteInterpreterWrapper::InvokeWithoutFallback() {
     if (status == kTfLiteError && cancel_flag_.Get()) {
       return absl::CancelledError("Invoke() cancelled.");
     }
+    if (status == kTfLiteError && cancel_flag_.DeadlineExceeded()) {
+      return absl::DeadlineExceededError("Invoke() exceeded its deadline.");
+    }
     return absl::InternalError("Invoke() failed.");
   }
   return absl::OkStatus();
@@ -310,7 +350,7 @@ void TfLiteInterpreterWrapper::SetTfLiteCancellation() {
   // Create a cancellation check function and set to the TFLite interpreter.
   auto check_cancel_flag = [](void* data) {
     auto* cancel_flag = reinterpret_cast<CancelFlag*>(data);
-    return cancel_flag->Get();
+    return cancel_flag->ShouldAbort();
   };
   interpreter_->SetCancellationFunction(reinterpret_cast<void*>(&cancel_flag_),
                                         check_cancel_flag);
@@ -15,11 +15,16 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_PORT_DEFAULT_TFLITE_WRAPPER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_PORT_DEFAULT_TFLITE_WRAPPER_H_
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/acceleration/configuration/configuration.pb.h"
 #include "tensorflow/lite/acceleration/configuration/delegate_registry.h"
@@ -27,6 +32,7 @@ limitations under the License.
 #include "tensorflow/lite/experimental/acceleration/mini_benchmark/mini_benchmark.h"
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/interpreter_builder.h"
+#include "tensorflow/lite/signature_runner.h"
 
 namespace tflite {
 namespace support {
@@ -133,10 +139,30 @@ class TfLiteInterpreterWrapper {
       const std::function<absl::Status(tflite::Interpreter* interpreter)>&
           set_inputs);
 
+  // Same as above, but aborts the invocation between two ops once `deadline`
+  // is exceeded, in which case a `DeadlineExceededError` is returned. The
+  // interpreter is not invoked at all if the deadline is already exceeded once
+  // inputs are set. Like `Cancel()`, this only applies to the CPU part of the
+  // inference.
+  absl::Status InvokeWithFallback(
+      const std::function<absl::Status(tflite::Interpreter* interpreter)>&
+          set_inputs,
+      absl::Time deadline);
+
   // Calls Invoke() on the interpreter. Caller must have set up inputs
   // before-hand.
   absl::Status InvokeWithoutFallback();
 
+  // Same as above, but aborts the invocation once `deadline` is exceeded, see
+  // `InvokeWithFallback`.
+  absl::Status InvokeWithoutFallback(absl::Time deadline);
+
+  // Same as above, but invokes the subgraph of `runner`, a signature runner of
+  // the underlying interpreter, instead of its primary subgraph. Subject to
+  // `Cancel()` and `deadline` in the same way.
+  absl::Status InvokeSignatureWithoutFallback(tflite::SignatureRunner* runner,
+                                              absl::Time deadline);
+
   // Cancels the current TFLite **CPU** inference.
   //
   // IMPORTANT: If inference is entirely running on a delegate, this has no
@@ -188,6 +214,11 @@ class TfLiteInterpreterWrapper {
   std::unique_ptr<tflite::delegates::DelegatePluginInterface> delegate_plugin_;
 
  private:
+  // Resets the cancel flag with `deadline` and calls `invoke`, mapping its
+  // failures to `CancelledError`, `DeadlineExceededError` or `InternalError`.
+  absl::Status InvokeWithCancelFlag(const std::function<TfLiteStatus()>& invoke,
+                                    absl::Time deadline);
+
   // Performs sanity checks on the provided ComputeSettings.
   static absl::Status SanityCheckComputeSettings(
       const tflite::proto::ComputeSettings& compute_settings);
@@ -242,24 +273,41 @@ class TfLiteInterpreterWrapper {
   // Used to convert the ComputeSettings proto to FlatBuffer format.
   flatbuffers::FlatBufferBuilder flatbuffers_builder_;
 
-  // Cancellation flag definition.
+  // Cancellation flag definition. The interpreter polls it between ops, so it
+  // is lock-free and only reads the clock if a deadline is set.
   struct CancelFlag {
-    // Mutex to guard the `cancel_flag`.
-    mutable absl::Mutex cancel_mutex;
+    static constexpr int64_t kNoDeadline = std::numeric_limits<int64_t>::max();
 
     // A flag indicates if the caller cancels the TFLite interpreter invocation.
-    bool cancel_flag ABSL_GUARDED_BY(cancel_mutex) = false;
+    std::atomic<bool> cancel_flag{false};
+
+    // Deadline of the current invocation, in nanoseconds since the Unix epoch,
+    // or `kNoDeadline`. Only accessed by the invoking thread.
+    int64_t deadline_ns = kNoDeadline;
 
     // Returns `cancel_flag`.
-    bool Get() const ABSL_LOCKS_EXCLUDED(cancel_mutex) {
-      absl::MutexLock cancel_lock(&cancel_mutex);
-      return cancel_flag;
-    }
+    bool Get() const { return cancel_flag.load(std::memory_order_relaxed); }
 
     // Sets `cancel_flag` to `value`.
-    void Set(bool value) ABSL_LOCKS_EXCLUDED(cancel_mutex) {
-      absl::MutexLock cancel_lock(&cancel_mutex);
-      cancel_flag = value;
+    void Set(bool value) {
+      cancel_flag.store(value, std::memory_order_relaxed);
+    }
+
+    // Whether the invocation must be aborted.
+    bool ShouldAbort() const { return Get() || DeadlineExceeded(); }
+
+    // Whether the current invocation exceeded its deadline.
+    bool DeadlineExceeded() const {
+      return deadline_ns != kNoDeadline &&
+             absl::GetCurrentTimeNanos() >= deadline_ns;
+    }
+
+    // Resets the flag and sets the deadline before an invocation.
+    void Reset(absl::Time deadline) {
+      Set(false);
+      deadline_ns = deadline == absl::InfiniteFuture()
+                        ? kNoDeadline
+                        : absl::ToUnixNanos(deadline);
     }
   };
   CancelFlag cancel_flag_;
@@ -115,6 +115,14 @@ class AudioClassifier
       const std::vector<const TfLiteTensor*>& output_tensors,
       const AudioBuffer& audio_buffer) override;
 
+  // Accounts for the label maps.
+  void AddTaskMemoryStats(
+      tflite::task::core::MemoryStats* stats) const override {
+    for (const auto& postprocessor : postprocessors_) {
+      postprocessor->AddMemoryStats(stats);
+    }
+  }
+
   // The options used to build this AudioClassifier.
   std::unique_ptr<AudioClassifierOptions> options_;
 
@@ -0,0 +1,77 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_ALIGNED_BUFFER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_ALIGNED_BUFFER_H_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Heap buffer aligned as required by TF Lite for custom tensor allocations,
+// e.g. to be bound as the storage of an input or output tensor through
+// `TfLiteEngine::SetInputTensorBuffer` (resp. `SetOutputTensorBuffer`).
+class AlignedBuffer {
+ public:
+  // Alignment of TF Lite tensor data, i.e. `tflite::kDefaultTensorAlignment`.
+  static constexpr size_t kAlignment = 64;
+
+  AlignedBuffer() = default;
+  explicit AlignedBuffer(size_t size)
+      : data_(size > 0 ? ::operator new(size, std::align_val_t(kAlignment))
+                       : nullptr),
+        size_(size) {}
+
+  ~AlignedBuffer() { Free(); }
+
+  // AlignedBuffer is movable but not copyable.
+  AlignedBuffer(AlignedBuffer&& other)
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  AlignedBuffer& operator=(AlignedBuffer&& other) {
+    if (this != &other) {
+      Free();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+  void* data() { return data_; }
+  const void* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  void Free() {
+    if (data_ != nullptr) {
+      ::operator delete(data_, std::align_val_t(kAlignment));
+    }
+  }
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_ALIGNED_BUFFER_H_
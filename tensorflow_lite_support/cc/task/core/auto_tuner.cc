@@ -0,0 +1,143 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/auto_tuner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/numbers.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/strip.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::tflite::proto::ComputeSettings;
+using ::tflite::proto::Delegate;
+using ::tflite::support::StatusOr;
+
+// Keys of /proc/cpuinfo identifying the CPU model, by order of preference.
+constexpr const char* kCpuInfoModelKeys[] = {"model name", "Hardware",
+                                             "CPU part"};
+
+int GetNumHardwareThreads() {
+  return std::max<int>(1, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+std::vector<AutoTuneCandidate> GetAutoTuneCandidates(
+    const AutoTuneConfig& config, bool tune_delegate) {
+  std::vector<int> num_threads = config.candidate_num_threads;
+  if (num_threads.empty()) {
+    const int num_hardware_threads = GetNumHardwareThreads();
+    for (int n = 1; n < num_hardware_threads; n *= 2) {
+      num_threads.push_back(n);
+    }
+    num_threads.push_back(num_hardware_threads);
+  }
+  std::vector<AutoTuneCandidate> candidates;
+  for (bool use_xnnpack : {false, true}) {
+    if (use_xnnpack && !(tune_delegate && config.try_xnnpack)) {
+      continue;
+    }
+    for (int n : num_threads) {
+      AutoTuneCandidate candidate{n, use_xnnpack};
+      if (std::find(candidates.begin(), candidates.end(), candidate) ==
+          candidates.end()) {
+        candidates.push_back(candidate);
+      }
+    }
+  }
+  return candidates;
+}
+
+ComputeSettings ApplyAutoTuneCandidate(const ComputeSettings& compute_settings,
+                                       const AutoTuneCandidate& candidate,
+                                       bool tune_delegate) {
+  ComputeSettings settings(compute_settings);
+  auto* tflite_settings = settings.mutable_tflite_settings();
+  tflite_settings->mutable_cpu_settings()->set_num_threads(
+      candidate.num_threads);
+  if (tune_delegate) {
+    tflite_settings->set_delegate(candidate.use_xnnpack ? Delegate::XNNPACK
+                                                        : Delegate::NONE);
+  }
+  if (tflite_settings->delegate() == Delegate::XNNPACK) {
+    tflite_settings->mutable_xnnpack_settings()->set_num_threads(
+        candidate.num_threads);
+  }
+  return settings;
+}
+
+std::string GetCpuSignature() {
+  std::string model = "unknown";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  int best_key = sizeof(kCpuInfoModelKeys) / sizeof(kCpuInfoModelKeys[0]);
+  while (best_key > 0 && std::getline(cpuinfo, line)) {
+    for (int i = 0; i < best_key; ++i) {
+      if (!absl::StartsWith(line, kCpuInfoModelKeys[i])) {
+        continue;
+      }
+      std::vector<absl::string_view> parts =
+          absl::StrSplit(line, absl::MaxSplits(':', 1));
+      if (parts.size() == 2) {
+        model = std::string(absl::StripAsciiWhitespace(parts[1]));
+        best_key = i;
+      }
+      break;
+    }
+  }
+  return absl::StrFormat("%s/%d", model, GetNumHardwareThreads());
+}
+
+StatusOr<absl::optional<AutoTuneCandidate>> AutoTuneCache::Lookup(
+    absl::string_view key) const {
+  ASSIGN_OR_RETURN(absl::optional<std::string> value, file_.Lookup(key));
+  if (!value.has_value()) {
+    return absl::optional<AutoTuneCandidate>();
+  }
+  std::vector<absl::string_view> fields = absl::StrSplit(*value, '\t');
+  AutoTuneCandidate candidate;
+  int use_xnnpack;
+  if (fields.size() != 2 ||
+      !absl::SimpleAtoi(fields[0], &candidate.num_threads) ||
+      !absl::SimpleAtoi(fields[1], &use_xnnpack)) {
+    return absl::optional<AutoTuneCandidate>();
+  }
+  candidate.use_xnnpack = use_xnnpack != 0;
+  return absl::optional<AutoTuneCandidate>(candidate);
+}
+
+absl::Status AutoTuneCache::Store(absl::string_view key,
+                                  const AutoTuneCandidate& candidate) const {
+  return file_.Store(key, absl::StrFormat("%d\t%d", candidate.num_threads,
+                                          candidate.use_xnnpack ? 1 : 0));
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
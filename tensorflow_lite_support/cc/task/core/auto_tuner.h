@@ -0,0 +1,101 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_AUTO_TUNER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_AUTO_TUNER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/configuration_proto_inc.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/sidecar_file.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Parameters of the auto-tuning of the CPU settings, see
+// `TfLiteEngine::AutoTuneComputeSettings`.
+struct AutoTuneConfig {
+  // Numbers of threads to try. If empty, powers of two up to the number of
+  // hardware threads are tried.
+  std::vector<int> candidate_num_threads;
+  // Whether to try running the model with and without the XNNPACK delegate.
+  // Only applies if no delegate is specified in the ComputeSettings.
+  bool try_xnnpack = true;
+  // Number of timed invocations per candidate, after one warm-up invocation.
+  int num_runs = 3;
+  // Optional file in which the winning settings are persisted per model, CPU,
+  // set of candidates and configured delegate, so that they are only
+  // benchmarked once per host type and configuration.
+  std::string cache_file;
+};
+
+// CPU settings evaluated by the auto-tuning.
+struct AutoTuneCandidate {
+  int num_threads = 1;
+  bool use_xnnpack = false;
+
+  bool operator==(const AutoTuneCandidate& other) const {
+    return num_threads == other.num_threads &&
+           use_xnnpack == other.use_xnnpack;
+  }
+};
+
+// Returns the candidates to evaluate for `config`, trying XNNPACK only if
+// `tune_delegate` is true.
+std::vector<AutoTuneCandidate> GetAutoTuneCandidates(
+    const AutoTuneConfig& config, bool tune_delegate);
+
+// Returns a copy of `compute_settings` using the number of threads of
+// `candidate`, and its delegate if `tune_delegate` is true.
+tflite::proto::ComputeSettings ApplyAutoTuneCandidate(
+    const tflite::proto::ComputeSettings& compute_settings,
+    const AutoTuneCandidate& candidate, bool tune_delegate);
+
+// Returns a string identifying the CPU of the host (model name and number of
+// hardware threads), used to key auto-tuning results.
+std::string GetCpuSignature();
+
+// `SidecarFile` persisting the auto-tuning results, one record per key (e.g.
+// model digest and CPU signature).
+class AutoTuneCache {
+ public:
+  explicit AutoTuneCache(std::string file_path)
+      : file_(std::move(file_path), "auto-tuning cache") {}
+
+  // Returns the candidate recorded for `key`, if any. A missing file is
+  // considered empty, and so is a malformed record.
+  tflite::support::StatusOr<absl::optional<AutoTuneCandidate>> Lookup(
+      absl::string_view key) const;
+
+  // Records `candidate` for `key`, creating the file if needed.
+  absl::Status Store(absl::string_view key,
+                     const AutoTuneCandidate& candidate) const;
+
+ private:
+  const SidecarFile file_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_AUTO_TUNER_H_
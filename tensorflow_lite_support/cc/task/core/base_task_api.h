@@ -16,15 +16,36 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_BASE_TASK_API_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_BASE_TASK_API_H_
 
+#include <cstddef>
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/port/tflite_wrapper.h"
+#include "tensorflow_lite_support/cc/task/core/aligned_buffer.h"
+#include "tensorflow_lite_support/cc/task/core/dynamic_batcher.h"
+#include "tensorflow_lite_support/cc/task/core/inference_stats.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 
 namespace tflite {
@@ -42,6 +63,98 @@ class BaseUntypedTaskApi {
     return engine_->metadata_extractor();
   }
 
+  // Sets the executor running the asynchronous inference methods of this task.
+  // The same executor can be shared by several tasks. Must be called before
+  // any asynchronous inference is requested.
+  //
+  // If not set, an executor with as many threads as the number of interpreters
+  // held by the underlying TfLiteEngine is created upon the first asynchronous
+  // inference request.
+  void SetExecutor(std::shared_ptr<TaskExecutor> executor) {
+    absl::MutexLock lock(&executor_mutex_);
+    executor_ = std::move(executor);
+  }
+
+  // Makes concurrent calls to `Infer` (resp. `InferWithFallback`) be coalesced
+  // into batched invocations of up to `max_batch_size` elements, a call waiting
+  // at most `batch_timeout` for others to join its batch (see
+  // `DynamicBatcher`). Must be called before any inference is performed.
+  //
+  // Typically called by `TaskAPIFactory` from `BaseOptions.dynamic_batching`.
+  // Returns an error if the task or the model does not support batching.
+  virtual absl::Status EnableDynamicBatching(int max_batch_size,
+                                             absl::Duration batch_timeout) {
+    return tflite::support::CreateStatusWithPayload(
+        absl::StatusCode::kUnimplemented,
+        "Dynamic batching is not supported by this task.");
+  }
+
+  // Attaches `stats` to this task, so that inference calls record their
+  // per-stage latencies into it. The same stats can be shared by several
+  // tasks. Pass null to stop recording. Must be called before any inference
+  // is performed.
+  //
+  // With dynamic batching or `InferBatch`, each batched invocation is recorded
+  // as a single call.
+  void SetInferenceStats(std::shared_ptr<InferenceStats> stats) {
+    inference_stats_ = std::move(stats);
+  }
+
+  // Returns the stats set through `SetInferenceStats`, if any.
+  std::shared_ptr<InferenceStats> GetInferenceStats() const {
+    return inference_stats_;
+  }
+
+  // Returns the execution statistics of each op of the model, collected since
+  // the task was created or `ResetOpProfiling` was last called and sorted by
+  // decreasing total time. Requires `BaseOptions.op_profiling` to be set.
+  tflite::support::StatusOr<std::vector<OpProfile>> GetOpProfiles() const {
+    return engine_->GetOpProfiles();
+  }
+
+  // Returns the most recent op executions in the Chrome trace event JSON
+  // format. Requires `BaseOptions.op_profiling` to be set.
+  tflite::support::StatusOr<std::string> GetOpProfilingChromeTrace() const {
+    return engine_->GetOpProfilingChromeTrace();
+  }
+
+  // Clears the op profiles and traces collected so far.
+  void ResetOpProfiling() { engine_->ResetOpProfiling(); }
+
+  // Returns the approximate memory used by the task: model buffer, interpreter
+  // arenas, and task-specific data such as label maps, tokenizer vocabularies
+  // or search indices. See `MemoryStats` for what is not accounted for.
+  //
+  // Waits for the inferences in progress to complete, and delays new ones
+  // until it returns, see `TfLiteEngine::GetMemoryStats`.
+  MemoryStats GetMemoryStats() const {
+    MemoryStats stats = engine_->GetMemoryStats();
+    AddTaskMemoryStats(&stats);
+    return stats;
+  }
+
+  // Returns the keys of the signatures defined by the model, which tasks
+  // supporting it can run instead of the primary subgraph (see
+  // `BaseTaskApi::InferWithSignature`). Empty if the model has none.
+  std::vector<std::string> GetSignatureKeys() const {
+    return engine_->GetSignatureKeys();
+  }
+
+  // Binds the caller-owned `data` buffer as the storage of the model input
+  // (resp. output) tensor at `index`, so that inputs are written and outputs
+  // read in place instead of being copied to and from the interpreter. See
+  // `TfLiteEngine::SetInputTensorBuffer` for the requirements on `data`, e.g.
+  // use an `AlignedBuffer`. Only supported by tasks holding a single
+  // interpreter, and the buffer must not be accessed while inference runs.
+  absl::Status BindInputTensorBuffer(int index, void* data, size_t size) {
+    RETURN_IF_ERROR(CheckSingleInterpreter());
+    return engine_->SetInputTensorBuffer(index, data, size);
+  }
+  absl::Status BindOutputTensorBuffer(int index, void* data, size_t size) {
+    RETURN_IF_ERROR(CheckSingleInterpreter());
+    return engine_->SetOutputTensorBuffer(index, data, size);
+  }
+
  protected:
   // TODO(b/200258103): It's a short term solution. In the future we will forbid
   // Tasks exposing the underlying TfLiteEngine. Please try not rely on this
@@ -50,10 +163,62 @@ class BaseUntypedTaskApi {
   // Returns a raw pointer to the underlying TfLiteEngine.
   TfLiteEngine* GetTfLiteEngine() { return engine_.get(); }
 
+  // Returns the executor set through `SetExecutor`, or creates the default one.
+  tflite::support::StatusOr<std::shared_ptr<TaskExecutor>> GetExecutor() {
+    absl::MutexLock lock(&executor_mutex_);
+    if (executor_ == nullptr) {
+      ASSIGN_OR_RETURN(executor_,
+                       TaskExecutor::Create(engine_->interpreter_pool_size()));
+    }
+    return executor_;
+  }
+
+  // Returns the stats set through `SetInferenceStats`, or null.
+  InferenceStats* inference_stats() const { return inference_stats_.get(); }
+
+  // Adds the memory owned by the task outside of the TfLiteEngine to `stats`,
+  // for `GetMemoryStats`. Tasks holding large data structures (label maps,
+  // tokenizers, etc.) should override this.
+  virtual void AddTaskMemoryStats(MemoryStats* stats) const {}
+
  private:
+  absl::Status CheckSingleInterpreter() const {
+    if (engine_->interpreter_pool_size() != 1) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kFailedPrecondition,
+          "Binding tensor buffers requires a single interpreter.");
+    }
+    return absl::OkStatus();
+  }
+
   std::unique_ptr<TfLiteEngine> engine_;
+
+  std::shared_ptr<InferenceStats> inference_stats_;
+
+  absl::Mutex executor_mutex_;
+  std::shared_ptr<TaskExecutor> executor_ ABSL_GUARDED_BY(executor_mutex_);
 };
 
+// Base class for all tasks performing inference through `Infer` (resp.
+// `InferWithFallback`), which call `Preprocess`, invoke the interpreter and
+// call `Postprocess`.
+//
+// Tasks are thread-compatible by default. If the underlying TfLiteEngine holds
+// a pool of interpreters (see `BaseOptions.num_interpreters`), each call checks
+// out its own interpreter, so that up to that many calls can run concurrently
+// on the same task instance. This requires `Preprocess` and `Postprocess` to
+// only mutate state through the tensors they are given (or that the engine
+// returns), which is the case for the processor-based tasks of this library.
+//
+// `InferAsync` (resp. `InferWithFallbackAsync`) runs the same inference on the
+// task executor (see `SetExecutor`) instead of blocking the calling thread.
+// With several interpreters, the `Preprocess` of one request then overlaps
+// with the invocation of another.
+//
+// If dynamic batching is enabled (see `EnableDynamicBatching`), concurrent
+// calls to `Infer` (resp. `InferWithFallback`) are run through `InferBatch`
+// (resp. `InferBatchWithFallback`) instead, which requires `Preprocess` and
+// `Postprocess` to support batched inference.
 template <class OutputType, class... InputTypes>
 class BaseTaskApi : public BaseUntypedTaskApi {
  public:
@@ -81,7 +246,8 @@ class BaseTaskApi : public BaseUntypedTaskApi {
     return interpreter->tensor(interpreter->outputs()[index])->dims;
   }
 
-  // Cancels the current running TFLite invocation on CPU.
+  // Cancels the current running TFLite invocation on CPU. If the task was
+  // created with several interpreters, all on-going invocations are cancelled.
   //
   // Usually called on a different thread than the one inference is running on.
   // Calling Cancel() will cause the underlying TFLite interpreter to return an
@@ -94,6 +260,35 @@ class BaseTaskApi : public BaseUntypedTaskApi {
   // the CPU invocation will not be executed.
   void Cancel() { GetTfLiteEngine()->Cancel(); }
 
+  absl::Status EnableDynamicBatching(int max_batch_size,
+                                     absl::Duration batch_timeout) override {
+    if (max_batch_size < 2) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrFormat("`max_batch_size` must be greater than 1, got %d.",
+                          max_batch_size),
+          tflite::support::TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    // Fails early if the model inputs cannot be batched.
+    TfLiteEngine* engine = GetTfLiteEngine();
+    {
+      auto lease = engine->AcquireInterpreter();
+      RETURN_IF_ERROR(engine->ResizeInputBatch(max_batch_size));
+      RETURN_IF_ERROR(engine->ResizeInputBatch(1));
+    }
+    batcher_ = absl::make_unique<Batcher>(
+        max_batch_size, batch_timeout,
+        [this](absl::Span<const std::tuple<InputTypes...>> batch) {
+          return InferBatchInternal(batch, /*with_fallback=*/false);
+        });
+    fallback_batcher_ = absl::make_unique<Batcher>(
+        max_batch_size, batch_timeout,
+        [this](absl::Span<const std::tuple<InputTypes...>> batch) {
+          return InferBatchInternal(batch, /*with_fallback=*/true);
+        });
+    return absl::OkStatus();
+  }
+
  protected:
   // Subclasses need to populate input_tensors from api_inputs.
   virtual absl::Status Preprocess(
@@ -119,12 +314,34 @@ class BaseTaskApi : public BaseUntypedTaskApi {
   // Performs inference using tflite::support::TfLiteInterpreterWrapper
   // InvokeWithoutFallback().
   tflite::support::StatusOr<OutputType> Infer(InputTypes... args) {
+    return InferWithDeadline(absl::InfiniteFuture(), args...);
+  }
+
+  // Same as `Infer`, but fails with a `DEADLINE_EXCEEDED` status once
+  // `deadline` is exceeded, so that late requests can be shed instead of
+  // finishing useless work: the deadline is checked once an interpreter is
+  // available, before invoking it, and between the ops of the invocation (on
+  // CPU only, see `TfLiteInterpreterWrapper`). With dynamic batching, it is
+  // only checked before the call joins a batch.
+  tflite::support::StatusOr<OutputType> InferWithDeadline(absl::Time deadline,
+                                                          InputTypes... args) {
+    if (batcher_ != nullptr) {
+      RETURN_IF_ERROR(CheckDeadline(deadline));
+      return batcher_->Run(args...);
+    }
+    InferenceTimer timer(inference_stats());
+    auto lease = GetTfLiteEngine()->AcquireInterpreter();
+    timer.StartStages();
+    RETURN_IF_ERROR(CheckDeadline(deadline));
     tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
         GetTfLiteEngine()->interpreter_wrapper();
     // Note: AllocateTensors() is already performed by the interpreter wrapper
     // at InitInterpreter time (see TfLiteEngine).
+    RETURN_IF_ERROR(RestoreUnbatchedInputs());
     RETURN_IF_ERROR(Preprocess(GetInputTensors(), args...));
-    absl::Status status = interpreter_wrapper->InvokeWithoutFallback();
+    timer.EndStage(InferenceStage::kPreprocess);
+    absl::Status status = interpreter_wrapper->InvokeWithoutFallback(deadline);
+    timer.EndStage(InferenceStage::kInvoke);
     if (!status.ok()) {
       return status.GetPayload(tflite::support::kTfLiteSupportPayload)
                      .has_value()
@@ -132,18 +349,40 @@ class BaseTaskApi : public BaseUntypedTaskApi {
                  : tflite::support::CreateStatusWithPayload(status.code(),
                                                             status.message());
     }
-    return Postprocess(GetOutputTensors(), args...);
+    tflite::support::StatusOr<OutputType> result =
+        Postprocess(GetOutputTensors(), args...);
+    timer.EndStage(InferenceStage::kPostprocess);
+    if (result.ok()) {
+      timer.MarkSucceeded();
+    }
+    return result;
   }
 
   // Performs inference using tflite::support::TfLiteInterpreterWrapper
   // InvokeWithFallback() to benefit from automatic fallback from delegation to
   // CPU where applicable.
   tflite::support::StatusOr<OutputType> InferWithFallback(InputTypes... args) {
+    return InferWithFallbackWithDeadline(absl::InfiniteFuture(), args...);
+  }
+
+  // Same as `InferWithDeadline`, but using InvokeWithFallback().
+  tflite::support::StatusOr<OutputType> InferWithFallbackWithDeadline(
+      absl::Time deadline, InputTypes... args) {
+    if (fallback_batcher_ != nullptr) {
+      RETURN_IF_ERROR(CheckDeadline(deadline));
+      return fallback_batcher_->Run(args...);
+    }
+    InferenceTimer timer(inference_stats());
+    auto lease = GetTfLiteEngine()->AcquireInterpreter();
+    timer.StartStages();
+    RETURN_IF_ERROR(CheckDeadline(deadline));
     tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
         GetTfLiteEngine()->interpreter_wrapper();
     // Note: AllocateTensors() is already performed by the interpreter wrapper
     // at InitInterpreter time (see TfLiteEngine).
+    RETURN_IF_ERROR(RestoreUnbatchedInputs());
     RETURN_IF_ERROR(Preprocess(GetInputTensors(), args...));
+    timer.EndStage(InferenceStage::kPreprocess);
     auto set_inputs_nop =
         [](tflite::task::core::TfLiteEngine::Interpreter* interpreter)
         -> absl::Status {
@@ -151,7 +390,8 @@ class BaseTaskApi : public BaseUntypedTaskApi {
       return absl::OkStatus();
     };
     absl::Status status =
-        interpreter_wrapper->InvokeWithFallback(set_inputs_nop);
+        interpreter_wrapper->InvokeWithFallback(set_inputs_nop, deadline);
+    timer.EndStage(InferenceStage::kInvoke);
     if (!status.ok()) {
       return status.GetPayload(tflite::support::kTfLiteSupportPayload)
                      .has_value()
@@ -159,8 +399,311 @@ class BaseTaskApi : public BaseUntypedTaskApi {
                  : tflite::support::CreateStatusWithPayload(status.code(),
                                                             status.message());
     }
-    return Postprocess(GetOutputTensors(), args...);
+    tflite::support::StatusOr<OutputType> result =
+        Postprocess(GetOutputTensors(), args...);
+    timer.EndStage(InferenceStage::kPostprocess);
+    if (result.ok()) {
+      timer.MarkSucceeded();
+    }
+    return result;
   }
+
+  // Same as `Infer`, but runs the signature of the model with the provided key
+  // (see `GetSignatureKeys`) instead of its primary subgraph, e.g. one of
+  // several encoders sharing the same weights. `Preprocess` and `Postprocess`
+  // are called on the inputs and outputs of the signature, sorted by name, so
+  // they must have the same layout as those of the primary subgraph the task
+  // was initialized with. The tensors of the signature are allocated on first
+  // use. Dynamic batching is not applied.
+  tflite::support::StatusOr<OutputType> InferWithSignature(
+      absl::string_view signature_key, InputTypes... args) {
+    return InferWithSignatureWithDeadline(signature_key,
+                                          absl::InfiniteFuture(), args...);
+  }
+
+  // Same as `InferWithSignature`, but fails with a `DEADLINE_EXCEEDED` status
+  // once `deadline` is exceeded, see `InferWithDeadline`. Like the primary
+  // subgraph, the signature is subject to `Cancel()`.
+  tflite::support::StatusOr<OutputType> InferWithSignatureWithDeadline(
+      absl::string_view signature_key, absl::Time deadline,
+      InputTypes... args) {
+    InferenceTimer timer(inference_stats());
+    TfLiteEngine* engine = GetTfLiteEngine();
+    auto lease = engine->AcquireInterpreter();
+    timer.StartStages();
+    RETURN_IF_ERROR(CheckDeadline(deadline));
+    RETURN_IF_ERROR(RestoreUnbatchedInputs());
+    ASSIGN_OR_RETURN(TfLiteEngine::SignatureRunner * runner,
+                     engine->SelectSignature(signature_key));
+    tflite::support::StatusOr<OutputType> result =
+        RunSelectedSignature(runner, deadline, &timer, args...);
+    engine->ClearSignature();
+    if (result.ok()) {
+      timer.MarkSucceeded();
+    }
+    return result;
+  }
+
+  // Schedules `Infer(args...)` on the task executor and returns a future
+  // holding its result.
+  //
+  // The arguments are stored as declared by `InputTypes`: value parameters are
+  // copied, but reference parameters (e.g. `const FrameBuffer&`) are not, so
+  // the objects they refer to must outlive the returned future. Likewise, the
+  // task must not be destroyed before all asynchronous requests complete.
+  // Requests are subject to `Cancel()` once they are running; requests still
+  // waiting for a worker thread are not affected. If the request cannot be
+  // scheduled, the future is immediately ready with the corresponding error.
+  std::future<tflite::support::StatusOr<OutputType>> InferAsync(
+      InputTypes... args) {
+    auto promise =
+        std::make_shared<std::promise<tflite::support::StatusOr<OutputType>>>();
+    std::future<tflite::support::StatusOr<OutputType>> future =
+        promise->get_future();
+    ScheduleInference(
+        [promise](tflite::support::StatusOr<OutputType> result) {
+          promise->set_value(std::move(result));
+        },
+        /*with_fallback=*/false, args...);
+    return future;
+  }
+
+  // Same as above, but `callback` is called with the result, from the worker
+  // thread that ran the inference (or from the calling thread, if the request
+  // could not be scheduled).
+  void InferAsync(
+      std::function<void(tflite::support::StatusOr<OutputType>)> callback,
+      InputTypes... args) {
+    ScheduleInference(std::move(callback), /*with_fallback=*/false, args...);
+  }
+
+  // Same as `InferAsync`, but schedules `InferWithFallback(args...)`.
+  std::future<tflite::support::StatusOr<OutputType>> InferWithFallbackAsync(
+      InputTypes... args) {
+    auto promise =
+        std::make_shared<std::promise<tflite::support::StatusOr<OutputType>>>();
+    std::future<tflite::support::StatusOr<OutputType>> future =
+        promise->get_future();
+    ScheduleInference(
+        [promise](tflite::support::StatusOr<OutputType> result) {
+          promise->set_value(std::move(result));
+        },
+        /*with_fallback=*/true, args...);
+    return future;
+  }
+
+  // Same as above, but `callback` is called with the result.
+  void InferWithFallbackAsync(
+      std::function<void(tflite::support::StatusOr<OutputType>)> callback,
+      InputTypes... args) {
+    ScheduleInference(std::move(callback), /*with_fallback=*/true, args...);
+  }
+
+  // Performs batched inference in a single TFLite invocation, using
+  // tflite::support::TfLiteInterpreterWrapper InvokeWithoutFallback().
+  //
+  // Each element of `batch` holds the arguments of what would otherwise be a
+  // single call to `Infer`. The batch dimension of the model inputs is resized
+  // to `batch.size()`, `Preprocess` is run on each element in turn with the
+  // input tensors restricted to the corresponding batch slot, the interpreter
+  // is invoked once, and `Postprocess` is run on each slot of the output
+  // tensors. Results are returned in the same order as `batch`.
+  //
+  // This requires all model inputs and outputs to have a leading batch
+  // dimension (see `TfLiteEngine::ResizeInputBatch`). Any error fails the
+  // entire batch.
+  tflite::support::StatusOr<std::vector<OutputType>> InferBatch(
+      absl::Span<const std::tuple<InputTypes...>> batch) {
+    return InferBatchInternal(batch, /*with_fallback=*/false);
+  }
+
+  // Same as above, but taking one span per `Infer` argument. All spans must
+  // have the same size.
+  tflite::support::StatusOr<std::vector<OutputType>> InferBatch(
+      absl::Span<const std::decay_t<InputTypes>>... inputs) {
+    ASSIGN_OR_RETURN(auto batch, ZipBatch(inputs...));
+    return InferBatchInternal(batch, /*with_fallback=*/false);
+  }
+
+  // Same as `InferBatch`, but using tflite::support::TfLiteInterpreterWrapper
+  // InvokeWithFallback() to benefit from automatic fallback from delegation to
+  // CPU where applicable.
+  tflite::support::StatusOr<std::vector<OutputType>> InferBatchWithFallback(
+      absl::Span<const std::tuple<InputTypes...>> batch) {
+    return InferBatchInternal(batch, /*with_fallback=*/true);
+  }
+
+  // Same as above, but taking one span per `Infer` argument. All spans must
+  // have the same size.
+  tflite::support::StatusOr<std::vector<OutputType>> InferBatchWithFallback(
+      absl::Span<const std::decay_t<InputTypes>>... inputs) {
+    ASSIGN_OR_RETURN(auto batch, ZipBatch(inputs...));
+    return InferBatchInternal(batch, /*with_fallback=*/true);
+  }
+
+ private:
+  using Batcher = DynamicBatcher<OutputType, InputTypes...>;
+
+  void ScheduleInference(
+      std::function<void(tflite::support::StatusOr<OutputType>)> callback,
+      bool with_fallback, InputTypes... args) {
+    tflite::support::StatusOr<std::shared_ptr<TaskExecutor>> executor =
+        GetExecutor();
+    if (!executor.ok()) {
+      callback(executor.status());
+      return;
+    }
+    std::tuple<InputTypes...> inputs(args...);
+    absl::Status status =
+        (*executor)->Schedule([this, callback, with_fallback, inputs]() {
+          callback(std::apply(
+              [this, with_fallback](auto&&... scheduled_args) {
+                return with_fallback
+                           ? this->InferWithFallback(scheduled_args...)
+                           : this->Infer(scheduled_args...);
+              },
+              inputs));
+        });
+    if (!status.ok()) {
+      callback(status);
+    }
+  }
+
+  // Returns a `DEADLINE_EXCEEDED` status if `deadline` is exceeded.
+  static absl::Status CheckDeadline(absl::Time deadline) {
+    if (deadline != absl::InfiniteFuture() && absl::Now() >= deadline) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kDeadlineExceeded,
+          "Deadline exceeded before inference.");
+    }
+    return absl::OkStatus();
+  }
+
+  // Runs `Preprocess`, the signature `runner` selected on the current
+  // interpreter and `Postprocess`, for `InferWithSignatureWithDeadline`.
+  tflite::support::StatusOr<OutputType> RunSelectedSignature(
+      TfLiteEngine::SignatureRunner* runner, absl::Time deadline,
+      InferenceTimer* timer, InputTypes... args) {
+    RETURN_IF_ERROR(Preprocess(GetInputTensors(), args...));
+    timer->EndStage(InferenceStage::kPreprocess);
+    tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
+        GetTfLiteEngine()->interpreter_wrapper();
+    absl::Status status =
+        interpreter_wrapper->InvokeSignatureWithoutFallback(runner, deadline);
+    timer->EndStage(InferenceStage::kInvoke);
+    if (!status.ok()) {
+      return status.GetPayload(tflite::support::kTfLiteSupportPayload)
+                     .has_value()
+                 ? status
+                 : tflite::support::CreateStatusWithPayload(status.code(),
+                                                            status.message());
+    }
+    tflite::support::StatusOr<OutputType> result =
+        Postprocess(GetOutputTensors(), args...);
+    timer->EndStage(InferenceStage::kPostprocess);
+    return result;
+  }
+
+  // Brings the model inputs back to a batch size of 1 if a previous call to
+  // `InferBatch` resized them.
+  absl::Status RestoreUnbatchedInputs() {
+    TfLiteEngine* engine = GetTfLiteEngine();
+    if (engine->input_batch_size() == 1) {
+      return absl::OkStatus();
+    }
+    return engine->ResizeInputBatch(1);
+  }
+
+  // Converts per-argument spans into a list of per-element argument tuples.
+  static tflite::support::StatusOr<std::vector<std::tuple<InputTypes...>>>
+  ZipBatch(absl::Span<const std::decay_t<InputTypes>>... inputs) {
+    const size_t sizes[] = {inputs.size()...};
+    for (size_t size : sizes) {
+      if (size != sizes[0]) {
+        return tflite::support::CreateStatusWithPayload(
+            absl::StatusCode::kInvalidArgument,
+            absl::StrFormat("All batched inputs must have the same size, got "
+                            "%d and %d.",
+                            sizes[0], size),
+            tflite::support::TfLiteSupportStatus::kInvalidArgumentError);
+      }
+    }
+    std::vector<std::tuple<InputTypes...>> batch;
+    batch.reserve(sizes[0]);
+    for (size_t i = 0; i < sizes[0]; ++i) {
+      batch.emplace_back(inputs[i]...);
+    }
+    return batch;
+  }
+
+  tflite::support::StatusOr<std::vector<OutputType>> InferBatchInternal(
+      absl::Span<const std::tuple<InputTypes...>> batch, bool with_fallback) {
+    std::vector<OutputType> results;
+    if (batch.empty()) {
+      return results;
+    }
+    InferenceTimer timer(inference_stats());
+    TfLiteEngine* engine = GetTfLiteEngine();
+    auto lease = engine->AcquireInterpreter();
+    timer.StartStages();
+    RETURN_IF_ERROR(engine->ResizeInputBatch(batch.size()));
+    for (int slot = 0; slot < batch.size(); ++slot) {
+      RETURN_IF_ERROR(engine->SelectBatchSlot(slot));
+      absl::Status status = std::apply(
+          [this](const auto&... args) {
+            return this->Preprocess(this->GetInputTensors(), args...);
+          },
+          batch[slot]);
+      engine->ClearBatchSlot();
+      RETURN_IF_ERROR(status);
+    }
+    timer.EndStage(InferenceStage::kPreprocess);
+
+    tflite::task::core::TfLiteEngine::InterpreterWrapper* interpreter_wrapper =
+        engine->interpreter_wrapper();
+    absl::Status status;
+    if (with_fallback) {
+      status = interpreter_wrapper->InvokeWithFallback(
+          [](tflite::task::core::TfLiteEngine::Interpreter* interpreter)
+              -> absl::Status {
+            // NOP since inputs are populated at Preprocess() time.
+            return absl::OkStatus();
+          });
+    } else {
+      status = interpreter_wrapper->InvokeWithoutFallback();
+    }
+    timer.EndStage(InferenceStage::kInvoke);
+    if (!status.ok()) {
+      return status.GetPayload(tflite::support::kTfLiteSupportPayload)
+                     .has_value()
+                 ? status
+                 : tflite::support::CreateStatusWithPayload(status.code(),
+                                                            status.message());
+    }
+
+    results.reserve(batch.size());
+    for (int slot = 0; slot < batch.size(); ++slot) {
+      RETURN_IF_ERROR(engine->SelectBatchSlot(slot));
+      tflite::support::StatusOr<OutputType> result = std::apply(
+          [this](const auto&... args) {
+            return this->Postprocess(this->GetOutputTensors(), args...);
+          },
+          batch[slot]);
+      engine->ClearBatchSlot();
+      if (!result.ok()) {
+        return result.status();
+      }
+      results.push_back(std::move(result).value());
+    }
+    timer.EndStage(InferenceStage::kPostprocess);
+    timer.MarkSucceeded();
+    return results;
+  }
+
+  // Batchers used by `Infer` (resp. `InferWithFallback`) when dynamic batching
+  // is enabled, null otherwise.
+  std::unique_ptr<Batcher> batcher_;
+  std::unique_ptr<Batcher> fallback_batcher_;
 };
 
 }  // namespace core
@@ -14,9 +14,12 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow_lite_support/cc/task/core/classification_head.h"
 
+#include <cstdint>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
 #include "tensorflow_lite_support/metadata/metadata_schema_generated.h"
 
 namespace tflite {
@@ -109,6 +112,24 @@ StatusOr<ClassificationHead> BuildClassificationHead(
   return head;
 }
 
+int64_t EstimateMemoryUsage(const ClassificationHead& head) {
+  int64_t bytes = sizeof(ClassificationHead) +
+                  EstimateHeapMemoryUsage(head.name) +
+                  head.label_map_items.capacity() * sizeof(LabelMapItem);
+  for (const LabelMapItem& item : head.label_map_items) {
+    bytes += EstimateHeapMemoryUsage(item.name) +
+             EstimateHeapMemoryUsage(item.display_name) +
+             EstimateHeapMemoryUsage(item.child_name);
+  }
+  if (head.calibration_params.has_value()) {
+    bytes += head.calibration_params->sigmoid.capacity() * sizeof(Sigmoid);
+    for (const Sigmoid& sigmoid : head.calibration_params->sigmoid) {
+      bytes += EstimateHeapMemoryUsage(sigmoid.label);
+    }
+  }
+  return bytes;
+}
+
 }  // namespace core
 }  // namespace task
 }  // namespace tflite
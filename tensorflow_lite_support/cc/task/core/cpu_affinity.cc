@@ -0,0 +1,152 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/cpu_affinity.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+// Affinity last set on the current thread by `SetCurrentThreadCpuAffinity`,
+// empty if unknown.
+thread_local std::vector<int> current_thread_cpus;
+
+absl::Status CreateUnsupportedStatus() {
+  return CreateStatusWithPayload(
+      StatusCode::kUnimplemented,
+      "CPU affinity is only supported on Linux.",
+      TfLiteSupportStatus::kInvalidArgumentError);
+}
+
+}  // namespace
+
+absl::Status ValidateCpuAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return CreateStatusWithPayload(StatusCode::kInvalidArgument,
+                                   "Expected a non-empty set of CPUs.",
+                                   TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  const int num_cpus = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE || (num_cpus > 0 && cpu >= num_cpus)) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("CPU %d out of range [0, %d).", cpu,
+                          num_cpus > 0 ? num_cpus : CPU_SETSIZE),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+  }
+  // Check that the CPUs are not all excluded from the process, e.g. by
+  // cgroups, by actually applying the affinity.
+  ASSIGN_OR_RETURN(std::vector<int> previous_cpus,
+                   GetCurrentThreadCpuAffinity());
+  RETURN_IF_ERROR(SetCurrentThreadCpuAffinity(cpus));
+  return SetCurrentThreadCpuAffinity(previous_cpus);
+#else
+  return CreateUnsupportedStatus();
+#endif
+}
+
+StatusOr<std::vector<int>> GetCurrentThreadCpuAffinity() {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+      0) {
+    return CreateStatusWithPayload(StatusCode::kInternal,
+                                   "Unable to get the CPU affinity.");
+  }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+#else
+  return CreateUnsupportedStatus();
+#endif
+}
+
+absl::Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) !=
+      0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "Unable to set the CPU affinity: none of the CPUs is available.",
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  current_thread_cpus = cpus;
+  return absl::OkStatus();
+#else
+  return CreateUnsupportedStatus();
+#endif
+}
+
+void PinCurrentThreadToCpus(const std::vector<int>& cpus) {
+  if (cpus.empty() || cpus == current_thread_cpus) {
+    return;
+  }
+  SetCurrentThreadCpuAffinity(cpus).IgnoreError();
+}
+
+ScopedCpuAffinity::ScopedCpuAffinity(const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+  StatusOr<std::vector<int>> previous_cpus = GetCurrentThreadCpuAffinity();
+  if (previous_cpus.ok() && SetCurrentThreadCpuAffinity(cpus).ok()) {
+    previous_cpus_ = *std::move(previous_cpus);
+  }
+}
+
+ScopedCpuAffinity::~ScopedCpuAffinity() {
+  if (!previous_cpus_.empty()) {
+    SetCurrentThreadCpuAffinity(previous_cpus_).IgnoreError();
+  }
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,68 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_CPU_AFFINITY_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_CPU_AFFINITY_H_
+
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Returns an error if `cpus` is not a valid, non-empty set of CPUs the
+// current thread can be restricted to, or if CPU affinity is not supported on
+// this platform (i.e. other than Linux).
+absl::Status ValidateCpuAffinity(const std::vector<int>& cpus);
+
+// Returns the CPUs the current thread is allowed to run on.
+tflite::support::StatusOr<std::vector<int>> GetCurrentThreadCpuAffinity();
+
+// Restricts the current thread to the provided CPUs. Threads spawned by the
+// current thread afterwards inherit this affinity.
+absl::Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+
+// Restricts the current thread to the provided CPUs and keeps it that way.
+// Unlike `SetCurrentThreadCpuAffinity`, this makes no system call if the last
+// affinity set on the current thread through this file is already `cpus`, so
+// that it can be called before each inference. This is a no-op if `cpus` is
+// empty. Failures are ignored, as for `ScopedCpuAffinity`.
+void PinCurrentThreadToCpus(const std::vector<int>& cpus);
+
+// Restricts the current thread to the provided CPUs for the lifetime of the
+// object, then restores its previous affinity. This is a no-op if `cpus` is
+// empty. Failures are ignored, so `cpus` is expected to have been checked with
+// `ValidateCpuAffinity` beforehand.
+class ScopedCpuAffinity {
+ public:
+  explicit ScopedCpuAffinity(const std::vector<int>& cpus);
+  ~ScopedCpuAffinity();
+  // ScopedCpuAffinity is neither copyable nor movable.
+  ScopedCpuAffinity(const ScopedCpuAffinity&) = delete;
+  ScopedCpuAffinity& operator=(const ScopedCpuAffinity&) = delete;
+
+ private:
+  // Affinity to restore at destruction, empty if none was set.
+  std::vector<int> previous_cpus_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_CPU_AFFINITY_H_
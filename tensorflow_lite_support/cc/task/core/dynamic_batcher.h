@@ -0,0 +1,190 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_DYNAMIC_BATCHER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_DYNAMIC_BATCHER_H_
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Coalesces concurrent single-item calls into batches, which are run through a
+// user-provided batch function (typically `BaseTaskApi::InferBatch`).
+//
+// There is no background thread: the first caller that finds no batch being
+// formed becomes the collector. It waits until either `max_batch_size` calls
+// are pending or `batch_timeout` has elapsed, takes up to `max_batch_size`
+// pending calls (including its own), runs the batch function on them and hands
+// out the results. While a batch runs, the next one is being formed by another
+// caller, so that several batches can be in flight at the same time if the
+// batch function allows it (e.g. with a pool of interpreters).
+//
+// If the batch function fails, all calls of the batch fail with the same
+// status. This class is thread-safe. Its destructor runs the pending calls
+// without waiting for `batch_timeout`, and blocks until all calls in progress
+// have returned; no call may start once it has been entered.
+template <class OutputType, class... InputTypes>
+class DynamicBatcher {
+ public:
+  using BatchFunction =
+      std::function<tflite::support::StatusOr<std::vector<OutputType>>(
+          absl::Span<const std::tuple<InputTypes...>>)>;
+
+  DynamicBatcher(int max_batch_size, absl::Duration batch_timeout,
+                 BatchFunction batch_function)
+      : max_batch_size_(max_batch_size),
+        batch_timeout_(batch_timeout),
+        batch_function_(std::move(batch_function)) {}
+
+  // DynamicBatcher is neither copyable nor movable.
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  ~DynamicBatcher() {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+    batch_full_.Signal();
+    while (num_running_calls_ > 0) {
+      request_done_.Wait(&mutex_);
+    }
+  }
+
+  // Adds the call to the next batch and blocks until its result is available.
+  // Arguments passed by reference are only accessed before this method
+  // returns.
+  tflite::support::StatusOr<OutputType> Run(InputTypes... inputs) {
+    Request request{std::tuple<InputTypes...>(inputs...)};
+    absl::MutexLock lock(&mutex_);
+    ++num_running_calls_;
+    pending_requests_.push_back(&request);
+    if (static_cast<int>(pending_requests_.size()) >= max_batch_size_) {
+      batch_full_.Signal();
+    }
+    while (!request.done) {
+      if (!collecting_ && !request.batched) {
+        CollectAndRunBatch(&request);
+      } else {
+        request_done_.Wait(&mutex_);
+      }
+    }
+    if (--num_running_calls_ == 0 && shutting_down_) {
+      request_done_.SignalAll();
+    }
+    return std::move(request.result);
+  }
+
+  int max_batch_size() const { return max_batch_size_; }
+
+ private:
+  struct Request {
+    std::tuple<InputTypes...> inputs;
+    tflite::support::StatusOr<OutputType> result =
+        absl::UnknownError("Request not processed");
+    // Whether the request was taken into a batch.
+    bool batched = false;
+    bool done = false;
+  };
+
+  void CollectAndRunBatch(Request* collector)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    collecting_ = true;
+    const absl::Time deadline = absl::Now() + batch_timeout_;
+    while (!shutting_down_ &&
+           static_cast<int>(pending_requests_.size()) < max_batch_size_ &&
+           !batch_full_.WaitWithDeadline(&mutex_, deadline)) {
+    }
+
+    // The collector is always part of the batch, followed by the oldest
+    // pending requests.
+    std::vector<Request*> batch = {collector};
+    pending_requests_.erase(std::find(pending_requests_.begin(),
+                                      pending_requests_.end(), collector));
+    while (static_cast<int>(batch.size()) < max_batch_size_ &&
+           !pending_requests_.empty()) {
+      batch.push_back(pending_requests_.front());
+      pending_requests_.pop_front();
+    }
+    for (Request* request : batch) {
+      request->batched = true;
+    }
+    collecting_ = false;
+    // Lets one of the remaining requests start collecting the next batch.
+    request_done_.SignalAll();
+
+    mutex_.Unlock();
+    std::vector<std::tuple<InputTypes...>> inputs;
+    inputs.reserve(batch.size());
+    for (const Request* request : batch) {
+      inputs.push_back(request->inputs);
+    }
+    tflite::support::StatusOr<std::vector<OutputType>> results =
+        batch_function_(inputs);
+    if (results.ok() && results->size() != batch.size()) {
+      results = tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInternal,
+          absl::StrFormat("Expected %d batched results, got %d.", batch.size(),
+                          results->size()));
+    }
+    mutex_.Lock();
+
+    for (int i = 0; i < batch.size(); ++i) {
+      if (results.ok()) {
+        batch[i]->result = std::move((*results)[i]);
+      } else {
+        batch[i]->result = results.status();
+      }
+      batch[i]->done = true;
+    }
+    request_done_.SignalAll();
+  }
+
+  const int max_batch_size_;
+  const absl::Duration batch_timeout_;
+  const BatchFunction batch_function_;
+
+  absl::Mutex mutex_;
+  // Signaled when `max_batch_size_` requests are pending, or on destruction.
+  absl::CondVar batch_full_;
+  // Signaled when requests are done or when a new batch can be collected.
+  absl::CondVar request_done_;
+  std::deque<Request*> pending_requests_ ABSL_GUARDED_BY(mutex_);
+  bool collecting_ ABSL_GUARDED_BY(mutex_) = false;
+  // Number of `Run` calls which have not returned yet.
+  int num_running_calls_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_DYNAMIC_BATCHER_H_
@@ -26,6 +26,7 @@ namespace task {
 namespace core {
 
 int ErrorReporter::Report(const char* format, va_list args) {
+  absl::MutexLock lock(&mutex_);
   std::strcpy(second_last_message_, last_message_);  // NOLINT
   last_message_[0] = '\0';
   int num_characters = vsnprintf(last_message_, kBufferSize, format, args);
@@ -35,9 +36,15 @@ int ErrorReporter::Report(const char* format, va_list args) {
   return num_characters;
 }
 
-std::string ErrorReporter::message() { return last_message_; }
+std::string ErrorReporter::message() {
+  absl::MutexLock lock(&mutex_);
+  return last_message_;
+}
 
-std::string ErrorReporter::previous_message() { return second_last_message_; }
+std::string ErrorReporter::previous_message() {
+  absl::MutexLock lock(&mutex_);
+  return second_last_message_;
+}
 
 }  // namespace core
 }  // namespace task
@@ -19,6 +19,8 @@ limitations under the License.
 #include <cstdarg>
 #include <string>
 
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
 #include "tensorflow/lite/stateful_error_reporter.h"
 
 namespace tflite {
@@ -26,6 +28,8 @@ namespace task {
 namespace core {
 
 // An ErrorReporter that logs to stderr and captures the last two messages.
+// This class is thread-safe, so that it can be shared by several interpreters
+// built from the same model.
 class ErrorReporter : public tflite::StatefulErrorReporter {
  public:
   ErrorReporter() {
@@ -45,8 +49,9 @@ class ErrorReporter : public tflite::StatefulErrorReporter {
 
  private:
   static constexpr int kBufferSize = 1024;
-  char last_message_[kBufferSize];
-  char second_last_message_[kBufferSize];
+  absl::Mutex mutex_;
+  char last_message_[kBufferSize] ABSL_GUARDED_BY(mutex_);
+  char second_last_message_[kBufferSize] ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace core
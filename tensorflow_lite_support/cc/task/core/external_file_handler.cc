@@ -100,22 +100,78 @@ int64_t GetPageSizeAlignedOffset(int64_t offset) {
   return aligned_offset;
 }
 
+#ifndef _WIN32
+// Gives `advice`, named `advice_name`, about the `size` bytes mapped at
+// `buffer`. Advice is best-effort, hence failures are only reported to
+// `error_reporter`, if not null.
+void Advise(void* buffer, size_t size, int advice, const char* advice_name,
+            tflite::ErrorReporter* error_reporter) {
+  if (madvise(buffer, size, advice) != 0 && error_reporter != nullptr) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Unable to apply %s advice to mapped file, errno=%d",
+                         advice_name, errno);
+  }
+}
+
+// Applies the advice of `options` to the `size` bytes mapped at `buffer`.
+// Advice failures are reported to `error_reporter`, if not null, but are not
+// fatal, unlike locking failures.
+absl::Status ApplyMmapOptions(const MmapOptions& options, void* buffer,
+                              size_t size,
+                              tflite::ErrorReporter* error_reporter) {
+#ifdef ABSL_HAVE_MMAP
+  switch (options.access_pattern()) {
+    case MmapOptions::SEQUENTIAL:
+      Advise(buffer, size, MADV_SEQUENTIAL, "MADV_SEQUENTIAL", error_reporter);
+      break;
+    case MmapOptions::RANDOM:
+      Advise(buffer, size, MADV_RANDOM, "MADV_RANDOM", error_reporter);
+      break;
+    default:
+      break;
+  }
+#ifdef MADV_HUGEPAGE
+  if (options.huge_pages()) {
+    Advise(buffer, size, MADV_HUGEPAGE, "MADV_HUGEPAGE", error_reporter);
+  }
+#endif
+  if (options.prefetch()) {
+    Advise(buffer, size, MADV_WILLNEED, "MADV_WILLNEED", error_reporter);
+  }
+  if (options.lock() && mlock(buffer, size) != 0) {
+    // EPERM if not allowed to lock memory at all, e.g. with a zero
+    // RLIMIT_MEMLOCK, ENOMEM or EAGAIN if above the limit.
+    const int error = errno;
+    return CreateStatusWithPayload(
+        error == EPERM ? StatusCode::kPermissionDenied
+                       : StatusCode::kResourceExhausted,
+        absl::StrFormat("Unable to lock mapped file in memory, errno=%d",
+                        error),
+        TfLiteSupportStatus::kFileMmapError);
+  }
+#endif
+  return absl::OkStatus();
+}
+#endif
+
 }  // namespace
 
 /* static */
 StatusOr<std::unique_ptr<ExternalFileHandler>>
-ExternalFileHandler::CreateFromExternalFile(const ExternalFile* external_file) {
+ExternalFileHandler::CreateFromExternalFile(
+    const ExternalFile* external_file, tflite::ErrorReporter* error_reporter) {
   // Use absl::WrapUnique() to call private constructor:
   // https://abseil.io/tips/126.
   std::unique_ptr<ExternalFileHandler> handler =
       absl::WrapUnique(new ExternalFileHandler(external_file));
 
-  RETURN_IF_ERROR(handler->MapExternalFile());
+  RETURN_IF_ERROR(handler->MapExternalFile(error_reporter));
 
   return handler;
 }
 
-absl::Status ExternalFileHandler::MapExternalFile() {
+absl::Status ExternalFileHandler::MapExternalFile(
+    tflite::ErrorReporter* error_reporter) {
   if (!external_file_.file_content().empty()) {
     return absl::OkStatus();
   }
@@ -335,14 +391,24 @@ absl::Status ExternalFileHandler::MapExternalFile() {
   buffer_aligned_offset_ = GetPageSizeAlignedOffset(buffer_offset_);
   buffer_aligned_size_ = buffer_size_ + buffer_offset_ - buffer_aligned_offset_;
   // Map into memory.
-  buffer_ = mmap(/*addr=*/nullptr, buffer_aligned_size_, PROT_READ, MAP_SHARED,
-                 fd, buffer_aligned_offset_);
+  int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  if (external_file_.mmap_options().populate()) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+  buffer_ = mmap(/*addr=*/nullptr, buffer_aligned_size_, PROT_READ, flags, fd,
+                 buffer_aligned_offset_);
   if (buffer_ == MAP_FAILED) {
     return CreateStatusWithPayload(
         StatusCode::kUnknown,
         absl::StrFormat("Unable to map file to memory buffer, errno=%d", errno),
         TfLiteSupportStatus::kFileMmapError);
   }
+  if (external_file_.has_mmap_options()) {
+    RETURN_IF_ERROR(ApplyMmapOptions(external_file_.mmap_options(), buffer_,
+                                     buffer_aligned_size_, error_reporter));
+  }
 #endif
   return absl::OkStatus();
 }
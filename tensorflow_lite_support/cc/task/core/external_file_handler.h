@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
 
@@ -47,8 +48,13 @@ class ExternalFileHandler {
   //
   // Warning: Does not take ownership of `external_file`, which must refer to a
   // valid proto that outlives this object.
+  //
+  // Failures to apply the best-effort `mmap_options` advice are not fatal, and
+  // are only reported to `error_reporter` if not null. It is not retained after
+  // this call.
   static tflite::support::StatusOr<std::unique_ptr<ExternalFileHandler>>
-  CreateFromExternalFile(const ExternalFile* external_file);
+  CreateFromExternalFile(const ExternalFile* external_file,
+                         tflite::ErrorReporter* error_reporter = nullptr);
 
   ~ExternalFileHandler();
 
@@ -63,8 +69,9 @@ class ExternalFileHandler {
 
   // Opens (if provided by path) and maps (if provided by path or file
   // descriptor) the external file in memory. Does nothing otherwise, as file
-  // contents are already loaded in memory.
-  absl::Status MapExternalFile();
+  // contents are already loaded in memory. Mapping advice failures are
+  // reported to `error_reporter`, if not null.
+  absl::Status MapExternalFile(tflite::ErrorReporter* error_reporter);
 
   // Reference to the input ExternalFile.
   const ExternalFile& external_file_;
@@ -0,0 +1,193 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/inference_stats.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "absl/numeric/bits.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+constexpr const char* kStageNames[kNumInferenceStages] = {
+    "preprocess", "invoke", "postprocess", "total"};
+
+// Lowers `target` to `value` if `value` is smaller.
+void AtomicMin(std::atomic<int64_t>& target, int64_t value) {
+  int64_t current = target.load(std::memory_order_relaxed);
+  while (value < current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+// Raises `target` to `value` if `value` is larger.
+void AtomicMax(std::atomic<int64_t>& target, int64_t value) {
+  int64_t current = target.load(std::memory_order_relaxed);
+  while (value > current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+int InferenceStats::BucketIndex(int64_t micros) {
+  if (micros < kNumSubBuckets) {
+    return std::max<int64_t>(micros, 0);
+  }
+  // Position of the most significant bit, which is >= 3.
+  int exponent = 63 - absl::countl_zero(static_cast<uint64_t>(micros));
+  int sub_bucket = (micros >> (exponent - 3)) & (kNumSubBuckets - 1);
+  return std::min((exponent - 2) * kNumSubBuckets + sub_bucket,
+                  kNumBuckets - 1);
+}
+
+int64_t InferenceStats::BucketLowerBound(int index) {
+  if (index < kNumSubBuckets) {
+    return index;
+  }
+  int exponent = index / kNumSubBuckets + 2;
+  int64_t sub_bucket = index % kNumSubBuckets;
+  return (kNumSubBuckets + sub_bucket) << (exponent - 3);
+}
+
+void InferenceStats::RecordStage(int stage, absl::Duration duration) {
+  const int64_t micros = absl::ToInt64Microseconds(duration);
+  StageHistogram& histogram = histograms_[stage];
+  histogram.total_micros.fetch_add(micros, std::memory_order_relaxed);
+  AtomicMin(histogram.min_micros, micros);
+  AtomicMax(histogram.max_micros, micros);
+  histogram.buckets[BucketIndex(micros)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+}
+
+void InferenceStats::Record(const InferenceTimings& timings) {
+  num_calls_.fetch_add(1, std::memory_order_relaxed);
+  if (!timings.ok) {
+    num_failed_calls_.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (int stage = 0; stage < kNumInferenceStages; ++stage) {
+    // Stages not reached (e.g. because of an error) are not recorded.
+    if (timings.stages[stage] > absl::ZeroDuration() ||
+        stage == static_cast<int>(InferenceStage::kTotal)) {
+      RecordStage(stage, timings.stages[stage]);
+    }
+  }
+  if (export_callback_) {
+    export_callback_(timings);
+  }
+}
+
+StageLatencyStats InferenceStats::StageSnapshot(int stage) const {
+  const StageHistogram& histogram = histograms_[stage];
+  StageLatencyStats stats;
+  std::array<int64_t, kNumBuckets> buckets;
+  int64_t count = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    buckets[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+  if (count == 0) {
+    return stats;
+  }
+  const int64_t min_micros =
+      histogram.min_micros.load(std::memory_order_relaxed);
+  const int64_t max_micros =
+      histogram.max_micros.load(std::memory_order_relaxed);
+  const int64_t total_micros =
+      histogram.total_micros.load(std::memory_order_relaxed);
+  stats.count = count;
+  stats.total = absl::Microseconds(total_micros);
+  stats.mean = absl::Microseconds(total_micros / count);
+  stats.min = absl::Microseconds(min_micros);
+  stats.max = absl::Microseconds(max_micros);
+
+  // Returns the midpoint of the bucket containing the given percentile,
+  // clamped to the observed range.
+  auto percentile = [&](double p) {
+    const int64_t rank =
+        std::max<int64_t>(1, static_cast<int64_t>(p * count + 0.5));
+    int64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        const int64_t lower = BucketLowerBound(i);
+        const int64_t upper =
+            i + 1 < kNumBuckets ? BucketLowerBound(i + 1) : lower;
+        const int64_t mid = lower + (upper - lower) / 2;
+        return absl::Microseconds(
+            std::min(std::max(mid, min_micros), max_micros));
+      }
+    }
+    return stats.max;
+  };
+  stats.p50 = percentile(0.50);
+  stats.p90 = percentile(0.90);
+  stats.p99 = percentile(0.99);
+  return stats;
+}
+
+InferenceStatsSnapshot InferenceStats::Snapshot() const {
+  InferenceStatsSnapshot snapshot;
+  snapshot.num_calls = num_calls_.load(std::memory_order_relaxed);
+  snapshot.num_failed_calls =
+      num_failed_calls_.load(std::memory_order_relaxed);
+  for (int stage = 0; stage < kNumInferenceStages; ++stage) {
+    snapshot.stages[stage] = StageSnapshot(stage);
+  }
+  return snapshot;
+}
+
+void InferenceStats::Reset() {
+  num_calls_.store(0, std::memory_order_relaxed);
+  num_failed_calls_.store(0, std::memory_order_relaxed);
+  for (StageHistogram& histogram : histograms_) {
+    histogram.total_micros.store(0, std::memory_order_relaxed);
+    histogram.min_micros.store(std::numeric_limits<int64_t>::max(),
+                               std::memory_order_relaxed);
+    histogram.max_micros.store(0, std::memory_order_relaxed);
+    for (std::atomic<int64_t>& bucket : histogram.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::string InferenceStatsSnapshot::ToString() const {
+  std::string result =
+      absl::StrFormat("calls: %d (failed: %d)\n", num_calls, num_failed_calls);
+  for (int stage = 0; stage < kNumInferenceStages; ++stage) {
+    const StageLatencyStats& stats = stages[stage];
+    absl::StrAppend(
+        &result,
+        absl::StrFormat(
+            "%-12s count: %d mean: %s p50: %s p90: %s p99: %s max: %s\n",
+            kStageNames[stage], stats.count, absl::FormatDuration(stats.mean),
+            absl::FormatDuration(stats.p50), absl::FormatDuration(stats.p90),
+            absl::FormatDuration(stats.p99), absl::FormatDuration(stats.max)));
+  }
+  return result;
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
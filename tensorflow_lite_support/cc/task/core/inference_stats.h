@@ -0,0 +1,205 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_INFERENCE_STATS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_INFERENCE_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Stages of an inference call, as performed by `BaseTaskApi`.
+enum class InferenceStage {
+  // `Preprocess`, i.e. populating the input tensors.
+  kPreprocess = 0,
+  // Interpreter invocation.
+  kInvoke = 1,
+  // `Postprocess`, i.e. building the results from the output tensors.
+  kPostprocess = 2,
+  // End-to-end call, including waiting for an available interpreter.
+  kTotal = 3,
+};
+
+// Number of values in `InferenceStage`.
+constexpr int kNumInferenceStages = 4;
+
+// Latency statistics of a single stage.
+struct StageLatencyStats {
+  // Number of times the stage was completed.
+  int64_t count = 0;
+  absl::Duration total = absl::ZeroDuration();
+  absl::Duration mean = absl::ZeroDuration();
+  absl::Duration min = absl::ZeroDuration();
+  absl::Duration max = absl::ZeroDuration();
+  // Percentiles, estimated from histograms with a 12.5% resolution (see
+  // `InferenceStats`).
+  absl::Duration p50 = absl::ZeroDuration();
+  absl::Duration p90 = absl::ZeroDuration();
+  absl::Duration p99 = absl::ZeroDuration();
+};
+
+// Point-in-time copy of the statistics collected by `InferenceStats`.
+struct InferenceStatsSnapshot {
+  // Number of inference calls, including failed ones.
+  int64_t num_calls = 0;
+  // Number of inference calls that returned an error.
+  int64_t num_failed_calls = 0;
+  std::array<StageLatencyStats, kNumInferenceStages> stages;
+
+  const StageLatencyStats& stage(InferenceStage stage) const {
+    return stages[static_cast<int>(stage)];
+  }
+
+  // Returns a human-readable multi-line summary.
+  std::string ToString() const;
+};
+
+// Durations of the stages of a single inference call, as reported to the
+// export callback. Stages that were not reached are left to zero.
+struct InferenceTimings {
+  std::array<absl::Duration, kNumInferenceStages> stages = {};
+  bool ok = false;
+
+  absl::Duration stage(InferenceStage stage) const {
+    return stages[static_cast<int>(stage)];
+  }
+};
+
+// Collects per-stage counters and latency histograms of inference calls. Can be
+// attached to any task through `BaseUntypedTaskApi::SetInferenceStats`, and
+// shared among several tasks.
+//
+// Recording is lock-free and only costs a few atomic increments per stage.
+// This class is thread-safe, although a snapshot taken while calls are being
+// recorded (or reset) may be slightly inconsistent across stages.
+class InferenceStats {
+ public:
+  using ExportCallback = std::function<void(const InferenceTimings&)>;
+
+  InferenceStats() { Reset(); }
+
+  // InferenceStats is neither copyable nor movable.
+  InferenceStats(const InferenceStats&) = delete;
+  InferenceStats& operator=(const InferenceStats&) = delete;
+
+  // Sets a callback invoked with the timings of every recorded call, e.g. to
+  // export them to a monitoring system. The callback is run synchronously on
+  // the inference thread and must be thread-safe. Must be set before any call
+  // is recorded.
+  void SetExportCallback(ExportCallback callback) {
+    export_callback_ = std::move(callback);
+  }
+
+  // Records the timings of an inference call.
+  void Record(const InferenceTimings& timings);
+
+  // Returns the statistics collected since creation or the last `Reset`.
+  InferenceStatsSnapshot Snapshot() const;
+
+  // Clears all the collected statistics.
+  void Reset();
+
+ private:
+  // Latencies are bucketed in microseconds: exactly below 8us, then with 8
+  // linear sub-buckets per power of two (i.e. a width of 1/8 = 12.5% of the
+  // bucket lower bound). Latencies of 2^42us or more all fall in the last
+  // bucket.
+  static constexpr int kNumSubBuckets = 8;
+  static constexpr int kNumBuckets = 40 * kNumSubBuckets;
+
+  static int BucketIndex(int64_t micros);
+  static int64_t BucketLowerBound(int index);
+
+  struct StageHistogram {
+    std::atomic<int64_t> total_micros;
+    std::atomic<int64_t> min_micros;
+    std::atomic<int64_t> max_micros;
+    std::array<std::atomic<int64_t>, kNumBuckets> buckets;
+  };
+
+  void RecordStage(int stage, absl::Duration duration);
+  StageLatencyStats StageSnapshot(int stage) const;
+
+  std::atomic<int64_t> num_calls_;
+  std::atomic<int64_t> num_failed_calls_;
+  std::array<StageHistogram, kNumInferenceStages> histograms_;
+  ExportCallback export_callback_;
+};
+
+// Measures the stages of one inference call and records them into the provided
+// stats when going out of scope. Does nothing if the stats are null.
+class InferenceTimer {
+ public:
+  explicit InferenceTimer(InferenceStats* stats)
+      : stats_(stats), start_(stats != nullptr ? absl::Now() : absl::Time()),
+        stage_start_(start_) {}
+
+  InferenceTimer(const InferenceTimer&) = delete;
+  InferenceTimer& operator=(const InferenceTimer&) = delete;
+
+  ~InferenceTimer() {
+    if (stats_ == nullptr) {
+      return;
+    }
+    timings_.stages[static_cast<int>(InferenceStage::kTotal)] =
+        absl::Now() - start_;
+    stats_->Record(timings_);
+  }
+
+  // Ends `stage`, which is considered to have started at the end of the
+  // previous stage (or when waiting for an interpreter ended, see
+  // `StartStages`).
+  void EndStage(InferenceStage stage) {
+    if (stats_ == nullptr) {
+      return;
+    }
+    const absl::Time now = absl::Now();
+    timings_.stages[static_cast<int>(stage)] += now - stage_start_;
+    stage_start_ = now;
+  }
+
+  // Marks the beginning of the first stage, e.g. after an interpreter has been
+  // acquired.
+  void StartStages() {
+    if (stats_ != nullptr) {
+      stage_start_ = absl::Now();
+    }
+  }
+
+  // Marks the call as successful. Calls are otherwise recorded as failed.
+  void MarkSucceeded() { timings_.ok = true; }
+
+ private:
+  InferenceStats* const stats_;
+  const absl::Time start_;
+  absl::Time stage_start_;
+  InferenceTimings timings_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_INFERENCE_STATS_H_
@@ -0,0 +1,69 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+int64_t MemoryStats::total_bytes() const {
+  int64_t total = model_bytes + tensor_arena_bytes + persistent_arena_bytes +
+                  dynamic_tensor_bytes;
+  for (const auto& component : task_bytes) {
+    total += component.second;
+  }
+  return total;
+}
+
+std::string MemoryStats::ToString() const {
+  std::string result;
+  auto append_line = [&result](const std::string& name, int64_t bytes) {
+    absl::StrAppend(&result, absl::StrFormat("%-24s %12d\n", name, bytes));
+  };
+  append_line("model", model_bytes);
+  append_line("shared_model", shared_model_bytes);
+  append_line("tensor_arena", tensor_arena_bytes);
+  append_line("persistent_arena", persistent_arena_bytes);
+  append_line("dynamic_tensors", dynamic_tensor_bytes);
+  for (const auto& component : task_bytes) {
+    append_line(component.first, component.second);
+  }
+  append_line("total (excl. shared)", total_bytes());
+  return result;
+}
+
+int64_t EstimateHeapMemoryUsage(const std::string& value) {
+  return value.capacity();
+}
+
+int64_t EstimateHeapMemoryUsage(const std::vector<std::string>& values) {
+  int64_t bytes = values.capacity() * sizeof(std::string);
+  for (const std::string& value : values) {
+    bytes += EstimateHeapMemoryUsage(value);
+  }
+  return bytes;
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
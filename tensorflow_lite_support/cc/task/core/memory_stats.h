@@ -0,0 +1,69 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MEMORY_STATS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MEMORY_STATS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Approximate memory usage of a task, in bytes.
+//
+// Memory owned by delegates (e.g. XNNPACK packed weights or GPU buffers) is
+// not visible to TFLite and is not accounted for, nor are the tensor buffers
+// provided by the caller.
+struct MemoryStats {
+  // Size of the model buffer, including its metadata and associated files,
+  // if owned by the task.
+  int64_t model_bytes = 0;
+  // Size of the model buffer if the model is loaded through the model cache,
+  // in which case it is shared by all the tasks created from the same model
+  // file (and `model_bytes` is 0). It is not part of `total_bytes()`, so that
+  // summing the stats of several tasks does not count it more than once.
+  int64_t shared_model_bytes = 0;
+  // Tensor arenas of all the interpreters, holding the intermediate tensors.
+  int64_t tensor_arena_bytes = 0;
+  // Persistent arenas of all the interpreters, holding e.g. op kernel state
+  // and variables.
+  int64_t persistent_arena_bytes = 0;
+  // Dynamic tensors of all the interpreters, allocated outside of the arenas.
+  int64_t dynamic_tensor_bytes = 0;
+  // Memory owned by the task outside of the interpreters, such as label maps,
+  // tokenizer vocabularies or search indices, by component name.
+  std::map<std::string, int64_t> task_bytes;
+
+  // Returns the sum of all the above, except `shared_model_bytes`.
+  int64_t total_bytes() const;
+
+  // Returns a human-readable summary, one line per component.
+  std::string ToString() const;
+};
+
+// Returns the approximate heap memory owned by `value`, excluding
+// `sizeof(value)` which is accounted for by its owner.
+int64_t EstimateHeapMemoryUsage(const std::string& value);
+int64_t EstimateHeapMemoryUsage(const std::vector<std::string>& values);
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MEMORY_STATS_H_
@@ -0,0 +1,156 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/model_cache.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/escaping.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+
+}  // namespace
+
+/* static */
+ModelCache* ModelCache::GetInstance() {
+  // Intentionally leaked to avoid destruction order issues at exit.
+  static ModelCache* const instance = new ModelCache();
+  return instance;
+}
+
+/* static */
+StatusOr<std::string> ModelCache::GetFileIdentityKey(
+    const ExternalFile& external_file) {
+#ifdef _WIN32
+  return CreateStatusWithPayload(
+      StatusCode::kUnimplemented,
+      "File identity keys are not supported on Windows.");
+#else
+  if (!external_file.file_content().empty()) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "In-memory file contents have no file identity.");
+  }
+  struct stat file_stat;
+  int64_t offset = 0;
+  int64_t length = 0;
+  if (!external_file.file_name().empty()) {
+    if (stat(external_file.file_name().c_str(), &file_stat) != 0) {
+      return CreateStatusWithPayload(
+          StatusCode::kNotFound,
+          absl::StrFormat("Unable to stat file at %s",
+                          external_file.file_name()));
+    }
+  } else if (external_file.has_file_descriptor_meta() &&
+             external_file.file_descriptor_meta().has_fd()) {
+    if (fstat(external_file.file_descriptor_meta().fd(), &file_stat) != 0) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Unable to stat file descriptor %d",
+                          external_file.file_descriptor_meta().fd()));
+    }
+    offset = external_file.file_descriptor_meta().offset();
+    length = external_file.file_descriptor_meta().length();
+  } else {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        "ExternalFile must specify at least one of 'file_content', "
+        "'file_name' or 'file_descriptor_meta'.");
+  }
+#ifdef __APPLE__
+  const int64_t mtime_nsec = file_stat.st_mtimespec.tv_nsec;
+#else
+  const int64_t mtime_nsec = file_stat.st_mtim.tv_nsec;
+#endif  // __APPLE__
+  // The mmap options are part of the key since they apply to the mapping held
+  // by the cached model.
+  return absl::StrFormat(
+      "file:%d:%d:%d:%d.%09d:%d:%d:%s", static_cast<uint64_t>(file_stat.st_dev),
+      static_cast<uint64_t>(file_stat.st_ino),
+      static_cast<int64_t>(file_stat.st_size),
+      static_cast<int64_t>(file_stat.st_mtime), mtime_nsec, offset, length,
+      absl::BytesToHexString(external_file.mmap_options().SerializeAsString()));
+#endif  // _WIN32
+}
+
+/* static */
+std::string ModelCache::GetContentKey(absl::string_view content) {
+  return absl::StrCat("content:", VerifiedModelsCache::ComputeDigest(content));
+}
+
+StatusOr<std::shared_ptr<CachedModel>> ModelCache::GetOrCreate(
+    const std::string& key,
+    absl::FunctionRef<StatusOr<std::shared_ptr<CachedModel>>()> create) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = models_.find(key);
+    if (it != models_.end()) {
+      if (std::shared_ptr<CachedModel> model = it->second.lock()) {
+        return model;
+      }
+    }
+  }
+  // The model is built without holding the lock, so that unrelated models can
+  // be loaded concurrently. If another thread cached the same model meanwhile,
+  // its copy wins and this one is discarded.
+  ASSIGN_OR_RETURN(std::shared_ptr<CachedModel> model, create());
+  absl::MutexLock lock(&mutex_);
+  RemoveExpiredEntries();
+  std::weak_ptr<CachedModel>& entry = models_[key];
+  if (std::shared_ptr<CachedModel> cached_model = entry.lock()) {
+    return cached_model;
+  }
+  entry = model;
+  return model;
+}
+
+int ModelCache::size() {
+  absl::MutexLock lock(&mutex_);
+  RemoveExpiredEntries();
+  return models_.size();
+}
+
+void ModelCache::RemoveExpiredEntries() {
+  for (auto it = models_.begin(); it != models_.end();) {
+    if (it->second.expired()) {
+      models_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,100 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MODEL_CACHE_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MODEL_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/functional/function_ref.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/external_file_handler.h"
+#include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
+#include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Verified TF Lite model content and associated resources, shared by all the
+// TfLiteEngine instances built from the same model file. Each engine wraps the
+// content in its own FlatBufferModel, so that errors are reported to the
+// engine's own error reporter.
+struct CachedModel {
+  // Copy of the ExternalFile the model was loaded from, which must outlive the
+  // file handler.
+  std::unique_ptr<ExternalFile> external_file;
+  // Holds the model content, which passed FlatBuffer verification.
+  std::unique_ptr<ExternalFileHandler> file_handler;
+  std::unique_ptr<tflite::metadata::ModelMetadataExtractor> metadata_extractor;
+};
+
+// Process-wide cache of the models loaded by TfLiteEngine, so that task
+// instances built from the same model file share a single mapping of the file,
+// FlatBuffer verification and metadata extractor instead of loading their own.
+//
+// The cache only holds weak references: a model is released as soon as the
+// last engine using it is destroyed. This class is thread-safe.
+class ModelCache {
+ public:
+  // Returns the process-wide instance.
+  static ModelCache* GetInstance();
+
+  // Returns a key identifying the file referenced by `external_file` (device,
+  // inode, size and modification time down to the nanosecond, plus offset and
+  // length for file descriptors) and its mmap options, without reading it.
+  // Returns an error if the file cannot be identified this way, e.g. for
+  // in-memory contents or on Windows, in which case `GetContentKey` should be
+  // used instead.
+  static tflite::support::StatusOr<std::string> GetFileIdentityKey(
+      const ExternalFile& external_file);
+
+  // Returns a key computed from the SHA-256 digest of the model `content` (see
+  // `VerifiedModelsCache::ComputeDigest`), which is stable across processes.
+  static std::string GetContentKey(absl::string_view content);
+
+  // Returns the live model cached under `key` if any. Otherwise, builds it
+  // through `create` and caches it. If `create` fails, the error is returned
+  // and nothing is cached.
+  tflite::support::StatusOr<std::shared_ptr<CachedModel>> GetOrCreate(
+      const std::string& key,
+      absl::FunctionRef<
+          tflite::support::StatusOr<std::shared_ptr<CachedModel>>()>
+          create);
+
+  // Returns the number of models currently alive in the cache.
+  int size();
+
+ private:
+  ModelCache() = default;
+
+  // Removes the entries whose model has been released.
+  void RemoveExpiredEntries() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<CachedModel>> models_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_MODEL_CACHE_H_
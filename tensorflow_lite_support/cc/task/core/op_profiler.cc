@@ -0,0 +1,172 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+// Escapes `value` for use in a JSON string literal.
+std::string JsonEscape(absl::string_view value) {
+  std::string result;
+  result.reserve(value.size());
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+      result.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      absl::StrAppendFormat(&result, "\\u%04x", c);
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+std::string FormatOpProfiles(absl::Span<const OpProfile> profiles) {
+  std::string result = absl::StrFormat("%-32s %8s %8s %10s %14s %14s\n",
+                                       "op type", "subgraph", "node", "count",
+                                       "total (us)", "average (us)");
+  for (const OpProfile& profile : profiles) {
+    absl::StrAppendFormat(
+        &result, "%-32s %8d %8d %10d %14.3f %14.3f\n",
+        profile.delegated ? absl::StrCat(profile.op_type, " (delegated)")
+                          : profile.op_type,
+        profile.subgraph_index, profile.node_index, profile.invocation_count,
+        absl::ToDoubleMicroseconds(profile.total_time),
+        absl::ToDoubleMicroseconds(profile.average_time()));
+  }
+  return result;
+}
+
+std::string FormatChromeTrace(
+    absl::Span<const std::vector<OpTraceEvent>> events) {
+  std::string result = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (int thread = 0; thread < static_cast<int>(events.size()); ++thread) {
+    for (const OpTraceEvent& event : events[thread]) {
+      absl::StrAppendFormat(
+          &result,
+          "%s\n{\"name\":\"%s\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,"
+          "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+          "\"args\":{\"subgraph_index\":%d,\"node_index\":%d}}",
+          first ? "" : ",", JsonEscape(event.op_type), thread,
+          event.start_ns / 1e3, event.duration_ns / 1e3, event.subgraph_index,
+          event.node_index);
+      first = false;
+    }
+  }
+  absl::StrAppend(&result, "\n]}\n");
+  return result;
+}
+
+OpProfiler::OpProfiler(int max_trace_events)
+    : max_trace_events_(std::max(max_trace_events, 0)) {}
+
+uint32_t OpProfiler::BeginEvent(const char* tag, EventType event_type,
+                                int64_t event_metadata1,
+                                int64_t event_metadata2) {
+  if (event_type != EventType::OPERATOR_INVOKE_EVENT &&
+      event_type != EventType::DELEGATE_OPERATOR_INVOKE_EVENT) {
+    return 0;
+  }
+  // For op events, metadata are the node and subgraph indices.
+  OpenEvent event{tag == nullptr ? "" : tag,
+                  event_type == EventType::DELEGATE_OPERATOR_INVOKE_EVENT,
+                  /*subgraph_index=*/event_metadata2,
+                  /*node_index=*/event_metadata1, absl::GetCurrentTimeNanos()};
+  absl::MutexLock lock(&mutex_);
+  open_events_.push_back(event);
+  return open_events_.size();
+}
+
+void OpProfiler::EndEvent(uint32_t event_handle) {
+  if (event_handle == 0) {
+    return;
+  }
+  const int64_t end_ns = absl::GetCurrentTimeNanos();
+  absl::MutexLock lock(&mutex_);
+  if (event_handle > open_events_.size()) {
+    return;
+  }
+  const OpenEvent event = open_events_[event_handle - 1];
+  open_events_.resize(event_handle - 1);
+
+  OpProfile& profile = profiles_[std::make_tuple(
+      event.subgraph_index, event.node_index, event.delegated)];
+  if (profile.invocation_count == 0) {
+    profile.op_type = event.tag;
+    profile.subgraph_index = event.subgraph_index;
+    profile.node_index = event.node_index;
+    profile.delegated = event.delegated;
+  }
+  ++profile.invocation_count;
+  profile.total_time += absl::Nanoseconds(end_ns - event.start_ns);
+
+  if (max_trace_events_ == 0) {
+    return;
+  }
+  OpTraceEvent trace_event{event.tag, event.subgraph_index, event.node_index,
+                           event.start_ns, end_ns - event.start_ns};
+  if (static_cast<int>(trace_events_.size()) < max_trace_events_) {
+    trace_events_.push_back(std::move(trace_event));
+  } else {
+    trace_events_[next_trace_event_] = std::move(trace_event);
+    next_trace_event_ = (next_trace_event_ + 1) % max_trace_events_;
+  }
+}
+
+std::vector<OpProfile> OpProfiler::GetOpProfiles() const {
+  std::vector<OpProfile> result;
+  absl::MutexLock lock(&mutex_);
+  result.reserve(profiles_.size());
+  for (const auto& entry : profiles_) {
+    result.push_back(entry.second);
+  }
+  return result;
+}
+
+std::vector<OpTraceEvent> OpProfiler::GetTraceEvents() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<OpTraceEvent> result(trace_events_.begin() + next_trace_event_,
+                                   trace_events_.end());
+  result.insert(result.end(), trace_events_.begin(),
+                trace_events_.begin() + next_trace_event_);
+  return result;
+}
+
+void OpProfiler::Reset() {
+  absl::MutexLock lock(&mutex_);
+  profiles_.clear();
+  trace_events_.clear();
+  next_trace_event_ = 0;
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,129 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "tensorflow/lite/core/api/profiler.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Aggregated execution statistics of one node of the model.
+struct OpProfile {
+  // Op type, e.g. "CONV_2D", or the name of the delegate kernel for nodes
+  // replaced by a delegate.
+  std::string op_type;
+  int64_t subgraph_index = 0;
+  int64_t node_index = 0;
+  // Whether the node is executed by a delegate. Delegate ops are only
+  // reported by delegates supporting profiling.
+  bool delegated = false;
+  int64_t invocation_count = 0;
+  absl::Duration total_time = absl::ZeroDuration();
+
+  absl::Duration average_time() const {
+    return invocation_count > 0 ? total_time / invocation_count
+                                : absl::ZeroDuration();
+  }
+};
+
+// Returns a human-readable table of `profiles`, one line per node.
+std::string FormatOpProfiles(absl::Span<const OpProfile> profiles);
+
+// Single op execution, as recorded for trace dumps.
+struct OpTraceEvent {
+  // Op type, as in `OpProfile::op_type`.
+  std::string op_type;
+  int64_t subgraph_index = 0;
+  int64_t node_index = 0;
+  // Wall-clock start time and duration, in nanoseconds.
+  int64_t start_ns = 0;
+  int64_t duration_ns = 0;
+};
+
+// Returns the provided events in the Chrome trace event JSON format, which can
+// be loaded in chrome://tracing or https://ui.perfetto.dev. Each `events`
+// element is shown as a separate thread, e.g. one per interpreter.
+std::string FormatChromeTrace(
+    absl::Span<const std::vector<OpTraceEvent>> events);
+
+// TF Lite profiler aggregating per-node execution times, and keeping a bounded
+// buffer of the most recent op executions for trace dumps. Only op invocation
+// events are recorded; other runtime events are ignored.
+//
+// Meant to be attached to a single interpreter through
+// `Interpreter::SetProfiler`. This class is thread-safe, so that profiles can
+// be retrieved while the interpreter is running.
+class OpProfiler : public tflite::Profiler {
+ public:
+  // Keeps up to `max_trace_events` events for trace dumps, or none if 0.
+  explicit OpProfiler(int max_trace_events);
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+  void EndEvent(uint32_t event_handle) override;
+
+  // Returns the aggregated profiles of all the nodes executed so far.
+  std::vector<OpProfile> GetOpProfiles() const;
+
+  // Returns the most recent op executions, oldest first.
+  std::vector<OpTraceEvent> GetTraceEvents() const;
+
+  // Clears the aggregated profiles and trace events.
+  void Reset();
+
+ private:
+  // Op execution in progress.
+  struct OpenEvent {
+    const char* tag;
+    bool delegated;
+    int64_t subgraph_index;
+    int64_t node_index;
+    int64_t start_ns;
+  };
+
+  const int max_trace_events_;
+
+  mutable absl::Mutex mutex_;
+  // Events begun and not yet ended. They are nested, e.g. the ops run by a
+  // delegate kernel within the delegate node, and thus ended in reverse order.
+  std::vector<OpenEvent> open_events_ ABSL_GUARDED_BY(mutex_);
+  // Profiles keyed by (subgraph index, node index, delegated).
+  absl::flat_hash_map<std::tuple<int64_t, int64_t, bool>, OpProfile> profiles_
+      ABSL_GUARDED_BY(mutex_);
+  // Ring buffer of trace events, `next_trace_event_` being the oldest one
+  // once the buffer is full.
+  std::vector<OpTraceEvent> trace_events_ ABSL_GUARDED_BY(mutex_);
+  int next_trace_event_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_OP_PROFILER_H_
@@ -0,0 +1,90 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/shared_thread_pool.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace core {
+
+/* static */
+std::shared_ptr<SharedThreadPool> SharedThreadPool::GetOrCreate(
+    const std::string& name) {
+  // Intentionally leaked to avoid destruction order issues at exit.
+  static absl::Mutex* const registry_mutex = new absl::Mutex();
+  static auto* const registry =
+      new absl::flat_hash_map<std::string, std::weak_ptr<SharedThreadPool>>();
+
+  absl::MutexLock lock(registry_mutex);
+  std::shared_ptr<SharedThreadPool> pool = (*registry)[name].lock();
+  if (pool == nullptr) {
+    // Drop the entries of released pools before registering a new one.
+    for (auto it = registry->begin(); it != registry->end();) {
+      if (it->second.expired()) {
+        registry->erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    pool = std::shared_ptr<SharedThreadPool>(new SharedThreadPool());
+    (*registry)[name] = pool;
+  }
+  return pool;
+}
+
+int SharedThreadPool::num_cpu_backend_contexts() const {
+  absl::MutexLock lock(&mutex_);
+  return contexts_.size();
+}
+
+tflite::ExternalCpuBackendContext* SharedThreadPool::Acquire() {
+  absl::MutexLock lock(&mutex_);
+  if (idle_contexts_.empty()) {
+    contexts_.push_back(std::make_unique<tflite::ExternalCpuBackendContext>());
+    return contexts_.back().get();
+  }
+  tflite::ExternalCpuBackendContext* context = idle_contexts_.back();
+  idle_contexts_.pop_back();
+  return context;
+}
+
+void SharedThreadPool::Release(tflite::ExternalCpuBackendContext* context) {
+  absl::MutexLock lock(&mutex_);
+  idle_contexts_.push_back(context);
+}
+
+SharedThreadPoolSlot::SharedThreadPoolSlot(SharedThreadPool* pool)
+    : pool_(pool) {
+  if (pool_ != nullptr) {
+    cpu_backend_context_ = pool_->Acquire();
+  }
+}
+
+SharedThreadPoolSlot::~SharedThreadPoolSlot() {
+  if (pool_ != nullptr) {
+    pool_->Release(cpu_backend_context_);
+  }
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,100 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SHARED_THREAD_POOL_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SHARED_THREAD_POOL_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow/lite/external_cpu_backend_context.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Thread pools used by the built-in CPU kernels of several TFLite
+// interpreters, possibly belonging to different engines, instead of each
+// interpreter spawning its own. Pools are registered by name in a process-wide
+// registry and released as soon as the last engine using them is destroyed.
+//
+// A pool holds a set of CPU backend contexts, each with its own worker
+// threads. A backend context is not thread-safe, so it is checked out through a
+// `SharedThreadPoolSlot` by each interpreter for the duration of a set-up or an
+// invocation. Checking out never blocks: a new backend context is created if
+// all of them are in use, so a pool holds as many backend contexts as the peak
+// number of concurrent inferences of the interpreters using it, which remains
+// below the number of threads they would spawn on their own. This class is
+// thread-safe.
+class SharedThreadPool {
+ public:
+  // Returns the live pool registered under `name`, or creates and registers a
+  // new one.
+  static std::shared_ptr<SharedThreadPool> GetOrCreate(const std::string& name);
+
+  // SharedThreadPool is neither copyable nor movable.
+  SharedThreadPool(const SharedThreadPool&) = delete;
+  SharedThreadPool& operator=(const SharedThreadPool&) = delete;
+
+  // Returns the number of backend contexts created so far.
+  int num_cpu_backend_contexts() const;
+
+ private:
+  friend class SharedThreadPoolSlot;
+
+  SharedThreadPool() = default;
+
+  tflite::ExternalCpuBackendContext* Acquire();
+  void Release(tflite::ExternalCpuBackendContext* context);
+
+  mutable absl::Mutex mutex_;
+  // Backend contexts are never released before the pool, so that interpreters
+  // keep pointing to valid ones between checkouts.
+  std::vector<std::unique_ptr<tflite::ExternalCpuBackendContext>> contexts_
+      ABSL_GUARDED_BY(mutex_);
+  // Backend contexts available for checkout, the most recently released last.
+  std::vector<tflite::ExternalCpuBackendContext*> idle_contexts_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Checks out one of the backend contexts of `pool` for its lifetime. This is a
+// no-op if `pool` is null.
+class SharedThreadPoolSlot {
+ public:
+  explicit SharedThreadPoolSlot(SharedThreadPool* pool);
+  ~SharedThreadPoolSlot();
+  // SharedThreadPoolSlot is neither copyable nor movable.
+  SharedThreadPoolSlot(const SharedThreadPoolSlot&) = delete;
+  SharedThreadPoolSlot& operator=(const SharedThreadPoolSlot&) = delete;
+
+  // Context to be set as the `kTfLiteCpuBackendContext` external context of
+  // the interpreter using the slot, or null if `pool` was null.
+  tflite::ExternalCpuBackendContext* cpu_backend_context() const {
+    return cpu_backend_context_;
+  }
+
+ private:
+  SharedThreadPool* pool_;
+  tflite::ExternalCpuBackendContext* cpu_backend_context_ = nullptr;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SHARED_THREAD_POOL_H_
@@ -0,0 +1,97 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/sidecar_file.h"
+
+#include <fstream>
+#include <string>
+
+#include "absl/strings/match.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+}  // namespace
+
+StatusOr<absl::optional<std::string>> SidecarFile::Lookup(
+    absl::string_view key) const {
+  absl::optional<std::string> result;
+  std::ifstream file(file_path_);
+  if (!file.is_open()) {
+    return result;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t separator = line.find('\t');
+    if (separator != std::string::npos &&
+        absl::string_view(line).substr(0, separator) == key) {
+      result = line.substr(separator + 1);
+    }
+  }
+  if (file.bad()) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Error while reading %s file %s", description_,
+                        file_path_),
+        TfLiteSupportStatus::kFileReadError);
+  }
+  return result;
+}
+
+absl::Status SidecarFile::Store(absl::string_view key,
+                                absl::string_view value) const {
+  if (absl::StrContains(key, '\t') || absl::StrContains(key, '\n') ||
+      absl::StrContains(value, '\n')) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid record for %s file %s: keys must not contain "
+                        "tabs nor newlines, and values must not contain "
+                        "newlines.",
+                        description_, file_path_));
+  }
+  std::ofstream file(file_path_, std::ios::app);
+  if (!file.is_open()) {
+    return CreateStatusWithPayload(
+        StatusCode::kPermissionDenied,
+        absl::StrFormat("Unable to open %s file %s", description_, file_path_),
+        TfLiteSupportStatus::kFilePermissionDeniedError);
+  }
+  // A single write of the whole line, so that concurrent writers appending to
+  // the same file do not interleave.
+  file << absl::StrCat(key, "\t", value, "\n");
+  file.flush();
+  if (!file.good()) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrFormat("Error while writing %s file %s", description_,
+                        file_path_));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,62 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SIDECAR_FILE_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SIDECAR_FILE_H_
+
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Plain text file of key/value records persisted next to the models, e.g. to
+// cache per-model results across process restarts.
+//
+// Each record is a `<key>\t<value>` line. The file is only ever appended to,
+// and the last record for a key wins, so that several processes can share the
+// same file without locking: each record is written in a single call, so that
+// concurrent writers do not interleave. Lines without a tab are ignored.
+class SidecarFile {
+ public:
+  // `description` names the file in error messages, e.g. "auto-tuning cache".
+  SidecarFile(std::string file_path, std::string description)
+      : file_path_(std::move(file_path)), description_(std::move(description)) {}
+
+  // Returns the value of the last record for `key`, if any. A missing file is
+  // considered empty.
+  tflite::support::StatusOr<absl::optional<std::string>> Lookup(
+      absl::string_view key) const;
+
+  // Appends a record for `key`, creating the file if needed. `key` must not
+  // contain tabs nor newlines, and `value` must not contain newlines.
+  absl::Status Store(absl::string_view key, absl::string_view value) const;
+
+ private:
+  const std::string file_path_;
+  const std::string description_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_SIDECAR_FILE_H_
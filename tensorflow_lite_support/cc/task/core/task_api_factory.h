@@ -17,9 +17,11 @@ limitations under the License.
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_API_FACTORY_H_
 
 #include <memory>
+#include <vector>
 
 #include "absl/base/macros.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/kernels/op_macros.h"
 #include "tensorflow/lite/kernels/register.h"
@@ -27,6 +29,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/configuration_proto_inc.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/auto_tuner.h"
 #include "tensorflow_lite_support/cc/task/core/base_task_api.h"
 #include "tensorflow_lite_support/cc/task/core/proto/base_options_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
@@ -165,9 +168,69 @@ class TaskAPIFactory {
       RETURN_IF_ERROR(SetMiniBenchmarkFileNameFromBaseOptions(compute_settings,
                                                               base_options));
     }
+    if (base_options->num_interpreters() < 1) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "`num_interpreters` must be greater than 0.",
+          tflite::support::TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    if (base_options->use_model_cache()) {
+      engine->EnableModelCache();
+    }
+    if (base_options->has_verified_models_cache_file()) {
+      engine->SetVerifiedModelsCacheFile(
+          base_options->verified_models_cache_file());
+    }
+    if (base_options->has_op_profiling()) {
+      engine->EnableOpProfiling(
+          base_options->op_profiling().max_trace_events());
+    }
+    if (base_options->has_threading()) {
+      const ThreadingOptions& threading_options = base_options->threading();
+      if (!threading_options.cpu_affinity().empty()) {
+        RETURN_IF_ERROR(engine->SetCpuAffinity(
+            std::vector<int>(threading_options.cpu_affinity().begin(),
+                             threading_options.cpu_affinity().end())));
+      }
+      if (threading_options.has_shared_thread_pool()) {
+        engine->UseSharedThreadPool(threading_options.shared_thread_pool());
+      }
+    }
+    RETURN_IF_ERROR(engine->SetShapeBuckets(
+        std::vector<int>(base_options->shape_buckets().begin(),
+                         base_options->shape_buckets().end())));
     RETURN_IF_ERROR(engine->BuildModelFromExternalFileProto(
         &base_options->model_file(), compute_settings));
-    return CreateFromTfLiteEngine<T>(std::move(engine), compute_settings);
+    if (base_options->has_auto_tune()) {
+      const AutoTuneOptions& auto_tune_options = base_options->auto_tune();
+      AutoTuneConfig config;
+      config.candidate_num_threads.assign(
+          auto_tune_options.candidate_num_threads().begin(),
+          auto_tune_options.candidate_num_threads().end());
+      config.try_xnnpack = auto_tune_options.try_xnnpack();
+      config.num_runs = auto_tune_options.num_runs();
+      config.cache_file = auto_tune_options.cache_file();
+      ASSIGN_OR_RETURN(compute_settings, engine->AutoTuneComputeSettings(
+                                             compute_settings, config));
+    }
+    RETURN_IF_ERROR(engine->InitInterpreter(compute_settings));
+    RETURN_IF_ERROR(
+        engine->InitInterpreterPool(base_options->num_interpreters()));
+    if (base_options->has_warmup()) {
+      if (base_options->warmup().prefault_model()) {
+        RETURN_IF_ERROR(engine->PrefaultModel());
+      }
+      RETURN_IF_ERROR(engine->Warmup(base_options->warmup().num_runs()));
+    }
+    auto task = absl::make_unique<T>(std::move(engine));
+    if (base_options->has_dynamic_batching()) {
+      const DynamicBatchingOptions& batching_options =
+          base_options->dynamic_batching();
+      RETURN_IF_ERROR(task->EnableDynamicBatching(
+          batching_options.max_batch_size(),
+          absl::Microseconds(batching_options.batch_timeout_us())));
+    }
+    return task;
   }
 
  private:
@@ -0,0 +1,104 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+
+#include <utility>
+
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+}  // namespace
+
+/* static */
+StatusOr<std::unique_ptr<TaskExecutor>> TaskExecutor::Create(
+    int num_threads, int max_pending_closures) {
+  if (num_threads < 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected a positive number of threads, got %d.",
+                        num_threads),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  // Not using make_unique since the constructor is private.
+  std::unique_ptr<TaskExecutor> executor(
+      new TaskExecutor(max_pending_closures));
+  executor->workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    executor->workers_.emplace_back(&TaskExecutor::WorkerLoop, executor.get());
+  }
+  return executor;
+}
+
+TaskExecutor::~TaskExecutor() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutting_down_ = true;
+  }
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+absl::Status TaskExecutor::Schedule(std::function<void()> closure) {
+  absl::MutexLock lock(&mutex_);
+  if (max_pending_closures_ > 0 &&
+      pending_closures_.size() >= static_cast<size_t>(max_pending_closures_)) {
+    return CreateStatusWithPayload(
+        StatusCode::kResourceExhausted,
+        absl::StrFormat("Too many pending requests: the limit of %d has been "
+                        "reached.",
+                        max_pending_closures_));
+  }
+  pending_closures_.push_back(std::move(closure));
+  return absl::OkStatus();
+}
+
+bool TaskExecutor::HasClosureOrIsShuttingDown() const {
+  return !pending_closures_.empty() || shutting_down_;
+}
+
+void TaskExecutor::WorkerLoop() {
+  while (true) {
+    std::function<void()> closure;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(
+          absl::Condition(this, &TaskExecutor::HasClosureOrIsShuttingDown));
+      // Pending closures are drained before shutting down.
+      if (pending_closures_.empty()) {
+        return;
+      }
+      closure = std::move(pending_closures_.front());
+      pending_closures_.pop_front();
+    }
+    closure();
+  }
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
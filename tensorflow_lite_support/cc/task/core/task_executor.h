@@ -0,0 +1,81 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_EXECUTOR_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_EXECUTOR_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// A fixed-size pool of worker threads running closures in FIFO order, used to
+// back the asynchronous inference methods of `BaseTaskApi`.
+//
+// The number of pending (i.e. scheduled but not yet started) closures can be
+// bounded, in which case `Schedule` fails instead of queueing more work. This
+// class is thread-safe. Its destructor waits for all scheduled closures to
+// complete.
+class TaskExecutor {
+ public:
+  // Creates an executor with `num_threads` worker threads. If
+  // `max_pending_closures` is positive, at most that many closures can be
+  // waiting for a worker at any given time; otherwise, the queue is unbounded.
+  static tflite::support::StatusOr<std::unique_ptr<TaskExecutor>> Create(
+      int num_threads, int max_pending_closures = 0);
+
+  // TaskExecutor is neither copyable nor movable.
+  TaskExecutor(const TaskExecutor&) = delete;
+  TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+  ~TaskExecutor();
+
+  // Schedules `closure` to run on one of the worker threads. Returns a
+  // `RESOURCE_EXHAUSTED` error if the queue of pending closures is full, in
+  // which case `closure` is not run.
+  absl::Status Schedule(std::function<void()> closure);
+
+  int num_threads() const { return workers_.size(); }
+
+ private:
+  explicit TaskExecutor(int max_pending_closures)
+      : max_pending_closures_(max_pending_closures) {}
+
+  void WorkerLoop();
+
+  bool HasClosureOrIsShuttingDown() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const int max_pending_closures_;
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> pending_closures_ ABSL_GUARDED_BY(mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_TASK_EXECUTOR_H_
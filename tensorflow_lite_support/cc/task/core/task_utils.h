@@ -79,7 +79,11 @@ inline absl::Status PopulateTensor(const T* data, int num_elements,
         absl::StrFormat("tensor->bytes (%d) != bytes (%d)", tensor->bytes,
                         bytes));
   }
-  memcpy(v, data, bytes);
+  // The data may already be in place, e.g. if it was written directly into a
+  // caller-owned buffer bound to the tensor.
+  if (v != data) {
+    memcpy(v, data, bytes);
+  }
   return absl::OkStatus();
 }
 
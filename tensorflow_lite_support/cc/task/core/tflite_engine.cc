@@ -20,15 +20,26 @@ limitations under the License.
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/match.h"  // from @com_google_absl
 #include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
 #include "tensorflow/lite/c/c_api.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
@@ -63,77 +74,754 @@ static std::ios_base::Init s_iostream_initializer;
 
 using ::absl::StatusCode;
 using ::tflite::proto::ComputeSettings;
+using ::tflite::proto::Delegate;
 using ::tflite::support::CreateStatusWithPayload;
 using ::tflite::support::InterpreterCreationResources;
+using ::tflite::support::StatusOr;
 using ::tflite::support::TfLiteSupportStatus;
 
+namespace {
+// Innermost interpreter lease held by the current thread, if any. Enclosing
+// leases are reachable through `InterpreterLease::previous_`.
+thread_local const TfLiteEngine::InterpreterLease* current_lease = nullptr;
+
+// Returns the status corresponding to a failure to build a FlatBufferModel,
+// based on the messages captured by `error_reporter`.
+absl::Status CreateModelBuildErrorStatus(ErrorReporter* error_reporter) {
+  static constexpr char kInvalidFlatbufferMessage[] =
+      "The model is not a valid Flatbuffer";
+  // To be replaced with a proper switch-case when TF Lite model builder
+  // returns a `TfLiteStatus` code capturing this type of error.
+  if (absl::StrContains(error_reporter->message(),
+                        kInvalidFlatbufferMessage)) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument, error_reporter->message(),
+        TfLiteSupportStatus::kInvalidFlatBufferError);
+  } else if (absl::StrContains(error_reporter->message(),
+                               "Error loading model from buffer")) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument, kInvalidFlatbufferMessage,
+        TfLiteSupportStatus::kInvalidFlatBufferError);
+  } else {
+    // TODO(b/154917059): augment status with another `TfLiteStatus` code when
+    // ready. And use a new `TfLiteStatus::kCoreTfLiteError` for the TFLS
+    // code, instead of the unspecified `kError`.
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrCat(
+            "Could not build model from the provided pre-loaded flatbuffer: ",
+            error_reporter->message()));
+  }
+}
+
+// Original dimensions of input tensors, keyed by input index.
+using InputDims = std::vector<std::pair<int, std::vector<int>>>;
+
+// Fills the input tensors of `interpreter` with zeros, for synthetic
+// invocations. Inputs with dynamic dimensions whose shape is not known yet
+// (i.e. that have no data) are first resized to 1 along those dimensions, and
+// their original dimensions are appended to `resized_inputs` so that they can
+// be restored by `RestoreInputTensors`. `purpose` names the caller in error
+// messages.
+absl::Status ZeroInputTensors(tflite::Interpreter* interpreter,
+                              absl::string_view purpose,
+                              InputDims* resized_inputs) {
+  for (int index = 0; index < TfLiteEngine::InputCount(interpreter); ++index) {
+    const TfLiteTensor* input = TfLiteEngine::GetInput(interpreter, index);
+    if (input->type == kTfLiteString) {
+      return CreateStatusWithPayload(
+          StatusCode::kFailedPrecondition,
+          absl::StrCat(purpose,
+                       " is not supported for models with string inputs."));
+    }
+    if (input->data.raw != nullptr) {
+      continue;
+    }
+    std::vector<int> original_dims(input->dims->data,
+                                   input->dims->data + input->dims->size);
+    std::vector<int> dims = original_dims;
+    for (int i = 0; i < dims.size(); ++i) {
+      const bool dynamic = input->dims_signature != nullptr &&
+                           i < input->dims_signature->size &&
+                           input->dims_signature->data[i] == -1;
+      if (dynamic || dims[i] == 0) {
+        dims[i] = 1;
+      }
+    }
+    if (interpreter->ResizeInputTensor(interpreter->inputs()[index], dims) !=
+        kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrCat(purpose, " could not resize dynamic input tensor ",
+                       index, "."));
+    }
+    resized_inputs->emplace_back(index, std::move(original_dims));
+  }
+  if (!resized_inputs->empty() &&
+      interpreter->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat(purpose,
+                     " could not allocate tensors for dynamic inputs."));
+  }
+  for (int index = 0; index < TfLiteEngine::InputCount(interpreter); ++index) {
+    TfLiteTensor* input = TfLiteEngine::GetInput(interpreter, index);
+    if (input->data.raw == nullptr) {
+      return CreateStatusWithPayload(
+          StatusCode::kFailedPrecondition,
+          absl::StrCat(purpose, " could not allocate input tensor ", index,
+                       "."));
+    }
+    memset(input->data.raw, 0, input->bytes);
+  }
+  return absl::OkStatus();
+}
+
+// Restores the dimensions of the inputs resized by `ZeroInputTensors`.
+absl::Status RestoreInputTensors(tflite::Interpreter* interpreter,
+                                 const InputDims& resized_inputs) {
+  if (resized_inputs.empty()) {
+    return absl::OkStatus();
+  }
+  for (const auto& [index, dims] : resized_inputs) {
+    if (interpreter->ResizeInputTensor(interpreter->inputs()[index], dims) !=
+        kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrCat("Could not restore dynamic input tensor ", index, "."));
+    }
+  }
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        "Could not reallocate tensors after restoring dynamic inputs.");
+  }
+  return absl::OkStatus();
+}
+
+// Returns the shape of `tensor` as defined by the model, i.e. with -1 for
+// dynamic dimensions, regardless of the shape it was resized to.
+std::vector<int> GetModelShape(const TfLiteTensor& tensor) {
+  const TfLiteIntArray* dims =
+      tensor.dims_signature != nullptr && tensor.dims_signature->size > 0
+          ? tensor.dims_signature
+          : tensor.dims;
+  return std::vector<int>(dims->data, dims->data + dims->size);
+}
+
+// Returns whether `a` and `b` have the same type and model shape, dynamic
+// dimensions matching any size.
+bool HaveSameTypeAndShape(const TfLiteTensor& a, const TfLiteTensor& b) {
+  if (a.type != b.type) {
+    return false;
+  }
+  const std::vector<int> a_shape = GetModelShape(a);
+  const std::vector<int> b_shape = GetModelShape(b);
+  if (a_shape.size() != b_shape.size()) {
+    return false;
+  }
+  for (int i = 0; i < a_shape.size(); ++i) {
+    if (a_shape[i] != b_shape[i] && a_shape[i] != -1 && b_shape[i] != -1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks that the inputs and outputs of `runner`, sorted by name, match those
+// of the primary subgraph of `interpreter` in count, type and shape, since the
+// pre-processing and post-processing of tasks are written for the latter.
+absl::Status CheckSignatureMatchesPrimarySubgraph(
+    tflite::Interpreter* interpreter, TfLiteEngine::SignatureRunner* runner,
+    absl::string_view signature_key) {
+  auto mismatch = [&](absl::string_view detail) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat(
+            "Signature \"%s\" does not match the primary subgraph: %s.",
+            signature_key, detail),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  };
+  const int input_count = runner->input_size();
+  const int output_count = runner->output_size();
+  if (input_count != TfLiteEngine::InputCount(interpreter) ||
+      output_count != TfLiteEngine::OutputCount(interpreter)) {
+    return mismatch(absl::StrFormat(
+        "expected %d inputs and %d outputs, got %d and %d",
+        TfLiteEngine::InputCount(interpreter),
+        TfLiteEngine::OutputCount(interpreter), input_count, output_count));
+  }
+  for (int index = 0; index < input_count; ++index) {
+    if (!HaveSameTypeAndShape(
+            *runner->input_tensor(runner->input_names()[index]),
+            *TfLiteEngine::GetInput(interpreter, index))) {
+      return mismatch(
+          absl::StrCat("input ", index, " has a different type or shape"));
+    }
+  }
+  for (int index = 0; index < output_count; ++index) {
+    if (!HaveSameTypeAndShape(
+            *runner->output_tensor(runner->output_names()[index]),
+            *TfLiteEngine::GetOutput(interpreter, index))) {
+      return mismatch(
+          absl::StrCat("output ", index, " has a different type or shape"));
+    }
+  }
+  return absl::OkStatus();
+}
+}  // namespace
+
 bool TfLiteEngine::Verifier::Verify(const char* data, int length,
                                     tflite::ErrorReporter* reporter) {
   return tflite::Verify(data, length, reporter);
 }
 
 TfLiteEngine::TfLiteEngine(std::unique_ptr<tflite::OpResolver> resolver)
-    : model_(), resolver_(std::move(resolver)), verifier_() {}
+    : model_(), resolver_(std::move(resolver)), verifier_() {
+  contexts_.push_back(std::make_unique<InterpreterContext>());
+  absl::MutexLock lock(&pool_mutex_);
+  idle_contexts_.push_back(contexts_[0].get());
+}
+
+TfLiteEngine::InterpreterLease::InterpreterLease(TfLiteEngine* engine)
+    : engine_(engine),
+      context_(nullptr),
+      owns_context_(false),
+      previous_(current_lease) {
+  PinCurrentThreadToCpus(engine->cpu_affinity_);
+  for (const InterpreterLease* lease = previous_; lease != nullptr;
+       lease = lease->previous_) {
+    if (lease->engine_ == engine) {
+      context_ = lease->context_;
+      break;
+    }
+  }
+  if (context_ == nullptr) {
+    absl::MutexLock lock(&engine->pool_mutex_);
+    engine->pool_mutex_.Await(absl::Condition(
+        +[](std::vector<InterpreterContext*>* idle_contexts) {
+          return !idle_contexts->empty();
+        },
+        &engine->idle_contexts_));
+    context_ = engine->idle_contexts_.back();
+    engine->idle_contexts_.pop_back();
+    owns_context_ = true;
+  }
+  if (owns_context_ && engine->shared_thread_pool_ != nullptr) {
+    thread_pool_slot_.emplace(engine->shared_thread_pool_.get());
+    UseCpuBackendContext(thread_pool_slot_->cpu_backend_context(), context_);
+  }
+  current_lease = this;
+}
+
+TfLiteEngine::InterpreterLease::~InterpreterLease() {
+  current_lease = previous_;
+  // Released first, so as to be available to the next lease on the
+  // interpreter.
+  thread_pool_slot_.reset();
+  if (owns_context_) {
+    absl::MutexLock lock(&engine_->pool_mutex_);
+    engine_->idle_contexts_.push_back(context_);
+  }
+}
+
+TfLiteEngine::InterpreterLease TfLiteEngine::AcquireInterpreter() {
+  return InterpreterLease(this);
+}
+
+absl::Status TfLiteEngine::SetCpuAffinity(std::vector<int> cpus) {
+  RETURN_IF_ERROR(ValidateCpuAffinity(cpus));
+  cpu_affinity_ = std::move(cpus);
+  return absl::OkStatus();
+}
+
+/* static */
+void TfLiteEngine::UseCpuBackendContext(
+    tflite::ExternalCpuBackendContext* cpu_backend_context,
+    InterpreterContext* context) {
+  Interpreter* interpreter = context->wrapper.get();
+  if (cpu_backend_context == nullptr || interpreter == nullptr) {
+    return;
+  }
+  context->cpu_backend_context = cpu_backend_context;
+  interpreter->SetExternalContext(kTfLiteCpuBackendContext,
+                                  cpu_backend_context);
+  // The backend context may have last been used by an interpreter with a
+  // different number of threads.
+  cpu_backend_context->Refresh(interpreter->primary_subgraph().context());
+}
+
+TfLiteEngine::InterpreterContext* TfLiteEngine::current_context() const {
+  for (const InterpreterLease* lease = current_lease; lease != nullptr;
+       lease = lease->previous_) {
+    if (lease->engine_ == this) {
+      return lease->context_;
+    }
+  }
+  return contexts_[0].get();
+}
+
+void TfLiteEngine::Cancel() {
+  for (const auto& context : contexts_) {
+    context->wrapper.Cancel();
+  }
+}
+
+TfLiteTensor* TfLiteEngine::GetInputTensor(int index) {
+  InterpreterContext* context = current_context();
+  if (context->signature_runner != nullptr) {
+    SignatureRunner* runner = context->signature_runner;
+    return runner->input_tensor(runner->input_names()[index]);
+  }
+  if (context->batch_slot >= 0) {
+    return &context->input_slot_views[index].tensor;
+  }
+  return GetInput(context->wrapper.get(), index);
+}
+
+TfLiteTensor* TfLiteEngine::GetOutputTensor(int index) {
+  InterpreterContext* context = current_context();
+  if (context->signature_runner != nullptr) {
+    SignatureRunner* runner = context->signature_runner;
+    // The runner only hands out const outputs, but they live in the mutable
+    // signature subgraph just like the outputs of the primary subgraph.
+    return const_cast<TfLiteTensor*>(
+        runner->output_tensor(runner->output_names()[index]));
+  }
+  if (context->batch_slot >= 0) {
+    return &context->output_slot_views[index].tensor;
+  }
+  return GetOutput(context->wrapper.get(), index);
+}
 
 std::vector<TfLiteTensor*> TfLiteEngine::GetInputs() {
-  Interpreter* interpreter = this->interpreter();
   std::vector<TfLiteTensor*> tensors;
-  int input_count = InputCount(interpreter);
+  const SignatureRunner* runner = current_context()->signature_runner;
+  int input_count = runner != nullptr ? runner->input_size()
+                                      : InputCount(interpreter());
   tensors.reserve(input_count);
   for (int index = 0; index < input_count; index++) {
-    tensors.push_back(GetInput(interpreter, index));
+    tensors.push_back(GetInputTensor(index));
   }
   return tensors;
 }
 
 std::vector<const TfLiteTensor*> TfLiteEngine::GetOutputs() {
-  Interpreter* interpreter = this->interpreter();
   std::vector<const TfLiteTensor*> tensors;
-  int output_count = OutputCount(interpreter);
+  const SignatureRunner* runner = current_context()->signature_runner;
+  int output_count = runner != nullptr ? runner->output_size()
+                                       : OutputCount(interpreter());
   tensors.reserve(output_count);
   for (int index = 0; index < output_count; index++) {
-    tensors.push_back(GetOutput(interpreter, index));
+    tensors.push_back(GetOutputTensor(index));
   }
   return tensors;
 }
 
-void TfLiteEngine::VerifyAndBuildModelFromBuffer(
-    const char* buffer_data, size_t buffer_size,
-    TfLiteVerifier* extra_verifier) {
-  model_ = tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
-      buffer_data, buffer_size, extra_verifier, &error_reporter_);
+absl::Status TfLiteEngine::ResizeInputBatch(int batch_size) {
+  if (batch_size < 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected batch size >= 1, got %d.", batch_size),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  InterpreterContext* context = current_context();
+  Interpreter* interpreter = context->wrapper.get();
+  if (interpreter == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "TF Lite interpreter is null. Please make sure to call "
+        "InitInterpreter before resizing the input batch.");
+  }
+  context->batch_slot = -1;
+  if (batch_size == context->input_batch_size &&
+      !context->input_slot_views.empty()) {
+    return absl::OkStatus();
+  }
+  if (batch_size != context->input_batch_size) {
+    for (int index = 0; index < InputCount(interpreter); ++index) {
+      const TfLiteTensor* input = GetInput(interpreter, index);
+      if (input->dims->size < 1 ||
+          input->dims->data[0] != context->input_batch_size) {
+        return CreateStatusWithPayload(
+            StatusCode::kFailedPrecondition,
+            absl::StrFormat("Input tensor %d has no batch dimension of size "
+                            "%d: batched inference is not supported.",
+                            index, context->input_batch_size),
+            TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
+      }
+      std::vector<int> dims(input->dims->data,
+                            input->dims->data + input->dims->size);
+      dims[0] = batch_size;
+      if (interpreter->ResizeInputTensor(interpreter->inputs()[index], dims) !=
+          kTfLiteOk) {
+        return CreateStatusWithPayload(
+            StatusCode::kInternal,
+            absl::StrCat("Could not resize input tensor batch dimension: ",
+                         error_reporter_.message()));
+      }
+    }
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrCat("Could not allocate tensors for batch size ",
+                       batch_size, ": ", error_reporter_.message()));
+    }
+    context->input_batch_size = batch_size;
+  }
+  return BuildBatchSlotViews(context);
+}
+
+absl::Status TfLiteEngine::ResizeInputTensors(
+    const std::vector<std::pair<int, std::vector<int>>>& input_dims) {
+  InterpreterContext* context = current_context();
+  Interpreter* interpreter = context->wrapper.get();
+  if (interpreter == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "TF Lite interpreter is null. Please make sure to call "
+        "InitInterpreter before resizing input tensors.");
+  }
+  if (context->signature_runner != nullptr) {
+    return ResizeSignatureInputTensors(context->signature_runner, input_dims);
+  }
+  bool resized = false;
+  for (const auto& [index, dims] : input_dims) {
+    if (index < 0 || index >= InputCount(interpreter)) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Invalid input tensor index: %d.", index),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    if (TfLiteIntArrayEqualsArray(GetInput(interpreter, index)->dims,
+                                  static_cast<int>(dims.size()),
+                                  dims.data())) {
+      continue;
+    }
+    if (interpreter->ResizeInputTensorStrict(interpreter->inputs()[index],
+                                             dims) != kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrCat("Could not resize input tensor ", index, ": ",
+                       error_reporter_.message()),
+          TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
+    }
+    resized = true;
+  }
+  if (!resized && !context->allocation_pending) {
+    return absl::OkStatus();
+  }
+  context->allocation_pending = true;
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat("Could not allocate tensors: ",
+                     error_reporter_.message()));
+  }
+  context->allocation_pending = false;
+  ++context->num_input_tensor_allocations;
+  return absl::OkStatus();
+}
+
+absl::Status TfLiteEngine::ResizeSignatureInputTensors(
+    SignatureRunner* runner,
+    const std::vector<std::pair<int, std::vector<int>>>& input_dims) {
+  bool resized = false;
+  for (const auto& [index, dims] : input_dims) {
+    if (index < 0 || index >= static_cast<int>(runner->input_size())) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Invalid input tensor index: %d.", index),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+    const char* name = runner->input_names()[index];
+    if (TfLiteIntArrayEqualsArray(runner->input_tensor(name)->dims,
+                                  static_cast<int>(dims.size()),
+                                  dims.data())) {
+      continue;
+    }
+    if (runner->ResizeInputTensor(name, dims) != kTfLiteOk) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrCat("Could not resize input tensor ", index, ": ",
+                       error_reporter_.message()),
+          TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
+    }
+    resized = true;
+  }
+  // A failed allocation leaves the signature subgraph unallocated, so that it
+  // is allocated again when the signature is next selected.
+  if (!resized) {
+    return absl::OkStatus();
+  }
+  if (runner->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat("Could not allocate tensors: ",
+                     error_reporter_.message()));
+  }
+  ++current_context()->num_input_tensor_allocations;
+  return absl::OkStatus();
+}
+
+absl::Status TfLiteEngine::SetInputTensorBuffer(int index, void* data,
+                                                size_t size) {
+  return SetTensorBuffer(/*is_input=*/true, index, data, size);
+}
+
+absl::Status TfLiteEngine::SetOutputTensorBuffer(int index, void* data,
+                                                 size_t size) {
+  return SetTensorBuffer(/*is_input=*/false, index, data, size);
+}
+
+absl::Status TfLiteEngine::SetTensorBuffer(bool is_input, int index,
+                                           void* data, size_t size) {
+  Interpreter* interpreter = current_context()->wrapper.get();
+  if (interpreter == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "TF Lite interpreter is null. Please make sure to call "
+        "InitInterpreter before binding tensor buffers.");
+  }
+  const char* type_name = is_input ? "input" : "output";
+  const std::vector<int>& tensor_indices =
+      is_input ? interpreter->inputs() : interpreter->outputs();
+  if (index < 0 || index >= static_cast<int>(tensor_indices.size())) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid %s tensor index: %d.", type_name, index),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (data == nullptr ||
+      reinterpret_cast<uintptr_t>(data) % AlignedBuffer::kAlignment != 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Buffers bound to tensors must be non-null and "
+                        "aligned on %d bytes.",
+                        AlignedBuffer::kAlignment),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  const TfLiteTensor* tensor = interpreter->tensor(tensor_indices[index]);
+  if (tensor->type == kTfLiteString ||
+      tensor->allocation_type == kTfLiteDynamic) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        absl::StrFormat("Can't bind a buffer to the %s tensor %d: string and "
+                        "dynamic tensors are not supported.",
+                        type_name, index));
+  }
+  if (size < tensor->bytes) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Buffer of %d bytes is too small for the %s tensor "
+                        "%d, which requires %d bytes.",
+                        size, type_name, index, tensor->bytes),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (interpreter->SetCustomAllocationForTensor(
+          tensor_indices[index], TfLiteCustomAllocation{data, size}) !=
+      kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat("Could not bind buffer to ", type_name, " tensor ",
+                     index, ": ", error_reporter_.message()));
+  }
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat("Could not allocate tensors: ",
+                     error_reporter_.message()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status TfLiteEngine::SetShapeBuckets(std::vector<int> buckets) {
+  for (int bucket : buckets) {
+    if (bucket < 1) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Shape buckets must be positive, got %d.", bucket),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+  }
+  std::sort(buckets.begin(), buckets.end());
+  shape_buckets_ = std::move(buckets);
+  return absl::OkStatus();
+}
+
+int TfLiteEngine::RoundUpToShapeBucket(int size) const {
+  auto it = std::lower_bound(shape_buckets_.begin(), shape_buckets_.end(),
+                             size);
+  return it == shape_buckets_.end() ? size : *it;
+}
+
+absl::Status TfLiteEngine::BuildBatchSlotViews(InterpreterContext* context) {
+  const int batch_size = context->input_batch_size;
+  auto build_views = [batch_size](
+                         const std::vector<const TfLiteTensor*>& tensors,
+                         absl::string_view type_name,
+                         std::vector<TensorSlotView>* views) -> absl::Status {
+    views->clear();
+    views->resize(tensors.size());
+    for (int index = 0; index < tensors.size(); ++index) {
+      const TfLiteTensor* tensor = tensors[index];
+      if (tensor->type == kTfLiteString ||
+          tensor->allocation_type == kTfLiteDynamic ||
+          tensor->dims->size < 1 || tensor->dims->data[0] != batch_size) {
+        views->clear();
+        return CreateStatusWithPayload(
+            StatusCode::kFailedPrecondition,
+            absl::StrFormat("The %s tensor %d can't be split along a batch "
+                            "dimension of size %d: batched inference is not "
+                            "supported by this model.",
+                            type_name, index, batch_size),
+            type_name == "input"
+                ? TfLiteSupportStatus::kInvalidInputTensorDimensionsError
+                : TfLiteSupportStatus::kInvalidOutputTensorDimensionsError);
+      }
+      TensorSlotView& view = (*views)[index];
+      view.dims.reset(TfLiteIntArrayCopy(tensor->dims));
+      view.dims->data[0] = 1;
+    }
+    return absl::OkStatus();
+  };
+  const Interpreter* interpreter = context->wrapper.get();
+  std::vector<const TfLiteTensor*> inputs;
+  for (int index = 0; index < InputCount(interpreter); ++index) {
+    inputs.push_back(GetInput(interpreter, index));
+  }
+  std::vector<const TfLiteTensor*> outputs;
+  for (int index = 0; index < OutputCount(interpreter); ++index) {
+    outputs.push_back(GetOutput(interpreter, index));
+  }
+  RETURN_IF_ERROR(build_views(inputs, "input", &context->input_slot_views));
+  return build_views(outputs, "output", &context->output_slot_views);
+}
+
+/* static */
+void TfLiteEngine::UpdateBatchSlotView(const TfLiteTensor& tensor,
+                                       int batch_size, int slot,
+                                       TensorSlotView* view) {
+  const size_t slot_bytes = tensor.bytes / batch_size;
+  view->tensor = tensor;
+  view->tensor.dims = view->dims.get();
+  view->tensor.bytes = slot_bytes;
+  view->tensor.data.raw = tensor.data.raw == nullptr
+                              ? nullptr
+                              : tensor.data.raw + slot * slot_bytes;
+}
+
+absl::Status TfLiteEngine::SelectBatchSlot(int slot) {
+  InterpreterContext* context = current_context();
+  if (slot < 0 || slot >= context->input_batch_size) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Batch slot %d out of range [0, %d).", slot,
+                        context->input_batch_size),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (context->input_slot_views.empty() &&
+      context->output_slot_views.empty()) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "ResizeInputBatch must be called before selecting a batch slot.");
+  }
+  Interpreter* interpreter = context->wrapper.get();
+  for (int index = 0; index < context->input_slot_views.size(); ++index) {
+    UpdateBatchSlotView(*GetInput(interpreter, index),
+                        context->input_batch_size, slot,
+                        &context->input_slot_views[index]);
+  }
+  for (int index = 0; index < context->output_slot_views.size(); ++index) {
+    UpdateBatchSlotView(*GetOutput(interpreter, index),
+                        context->input_batch_size, slot,
+                        &context->output_slot_views[index]);
+  }
+  context->batch_slot = slot;
+  return absl::OkStatus();
+}
+
+std::vector<std::string> TfLiteEngine::GetSignatureKeys() const {
+  std::vector<std::string> keys;
+  const Interpreter* interpreter = contexts_[0]->wrapper.get();
+  if (interpreter == nullptr) {
+    return keys;
+  }
+  for (const std::string* key : interpreter->signature_keys()) {
+    keys.push_back(*key);
+  }
+  return keys;
+}
+
+StatusOr<TfLiteEngine::SignatureRunner*> TfLiteEngine::SelectSignature(
+    absl::string_view signature_key) {
+  InterpreterContext* context = current_context();
+  Interpreter* interpreter = context->wrapper.get();
+  if (interpreter == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "TF Lite interpreter is null. Please make sure to call "
+        "InitInterpreter before selecting a signature.");
+  }
+  std::string key(signature_key);
+  SignatureRunner* runner = interpreter->GetSignatureRunner(key.c_str());
+  if (runner == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kNotFound,
+        absl::StrFormat("Model has no signature with key \"%s\".", key),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  RETURN_IF_ERROR(
+      CheckSignatureMatchesPrimarySubgraph(interpreter, runner, signature_key));
+  // Only allocates the signature subgraph on first use: this is a no-op
+  // afterwards, unless the subgraph has dynamic tensors.
+  if (runner->AllocateTensors() != kTfLiteOk) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Failed to allocate tensors for signature \"%s\".",
+                        key));
+  }
+  context->signature_runner = runner;
+  return runner;
+}
+
+std::unique_ptr<TfLiteEngine::Model>
+TfLiteEngine::VerifyAndBuildModelFromBuffer(const char* buffer_data,
+                                            size_t buffer_size,
+                                            ErrorReporter* error_reporter) {
+  if (verified_models_cache_ == nullptr) {
+    return tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
+        buffer_data, buffer_size, &verifier_, error_reporter);
+  }
+  const std::string digest = VerifiedModelsCache::ComputeDigest(
+      absl::string_view(buffer_data, buffer_size));
+  StatusOr<bool> is_verified = verified_models_cache_->Contains(digest);
+  if (is_verified.ok() && *is_verified) {
+    std::unique_ptr<Model> model = tflite::FlatBufferModel::BuildFromBuffer(
+        buffer_data, buffer_size, error_reporter);
+    if (model != nullptr) {
+      return model;
+    }
+  }
+  std::unique_ptr<Model> model =
+      tflite::FlatBufferModel::VerifyAndBuildFromBuffer(
+          buffer_data, buffer_size, &verifier_, error_reporter);
+  if (model != nullptr && is_verified.ok() && !*is_verified) {
+    // Failing to record the digest only means the next load will verify the
+    // model again.
+    verified_models_cache_->Add(digest).IgnoreError();
+  }
+  return model;
 }
 
 absl::Status TfLiteEngine::InitializeFromModelFileHandler(
     const tflite::proto::ComputeSettings& compute_settings) {
   const char* buffer_data = model_file_handler_->GetFileContent().data();
   size_t buffer_size = model_file_handler_->GetFileContent().size();
-  VerifyAndBuildModelFromBuffer(buffer_data, buffer_size, &verifier_);
+  model_ =
+      VerifyAndBuildModelFromBuffer(buffer_data, buffer_size, &error_reporter_);
   if (model_ == nullptr) {
-    static constexpr char kInvalidFlatbufferMessage[] =
-        "The model is not a valid Flatbuffer";
-    // To be replaced with a proper switch-case when TF Lite model builder
-    // returns a `TfLiteStatus` code capturing this type of error.
-    if (absl::StrContains(error_reporter_.message(),
-                          kInvalidFlatbufferMessage)) {
-      return CreateStatusWithPayload(
-          StatusCode::kInvalidArgument, error_reporter_.message(),
-          TfLiteSupportStatus::kInvalidFlatBufferError);
-    } else if (absl::StrContains(error_reporter_.message(),
-                                 "Error loading model from buffer")) {
-      return CreateStatusWithPayload(
-          StatusCode::kInvalidArgument, kInvalidFlatbufferMessage,
-          TfLiteSupportStatus::kInvalidFlatBufferError);
-    } else {
-      // TODO(b/154917059): augment status with another `TfLiteStatus` code when
-      // ready. And use a new `TfLiteStatus::kCoreTfLiteError` for the TFLS
-      // code, instead of the unspecified `kError`.
-      return CreateStatusWithPayload(
-          StatusCode::kUnknown,
-          absl::StrCat(
-              "Could not build model from the provided pre-loaded flatbuffer: ",
-              error_reporter_.message()));
-    }
+    return CreateModelBuildErrorStatus(&error_reporter_);
   }
 
   ASSIGN_OR_RETURN(
@@ -144,6 +832,76 @@ absl::Status TfLiteEngine::InitializeFromModelFileHandler(
   return absl::OkStatus();
 }
 
+absl::Status TfLiteEngine::InitializeFromExternalFile(
+    const ExternalFile* external_file,
+    const tflite::proto::ComputeSettings& compute_settings) {
+  if (use_model_cache_) {
+    return InitializeFromModelCache(external_file, compute_settings);
+  }
+  ASSIGN_OR_RETURN(model_file_handler_,
+                   ExternalFileHandler::CreateFromExternalFile(
+                       external_file, &error_reporter_));
+  return InitializeFromModelFileHandler(compute_settings);
+}
+
+absl::Status TfLiteEngine::InitializeFromModelCache(
+    const ExternalFile* external_file,
+    const tflite::proto::ComputeSettings& compute_settings) {
+  std::string key;
+  StatusOr<std::string> file_identity_key =
+      ModelCache::GetFileIdentityKey(*external_file);
+  if (file_identity_key.ok()) {
+    key = *std::move(file_identity_key);
+  } else {
+    // The file has to be read to compute its digest.
+    ASSIGN_OR_RETURN(model_file_handler_,
+                     ExternalFileHandler::CreateFromExternalFile(
+                         external_file, &error_reporter_));
+    key = ModelCache::GetContentKey(model_file_handler_->GetFileContent());
+  }
+  ASSIGN_OR_RETURN(std::shared_ptr<CachedModel> cached_model,
+                   ModelCache::GetInstance()->GetOrCreate(key, [&]() {
+                     return CreateCachedModel(*external_file);
+                   }));
+  model_file_handler_.reset();
+  // The model content was verified when the cache entry was created, so this
+  // only wraps it, reporting errors to the error reporter of this engine.
+  absl::string_view content = cached_model->file_handler->GetFileContent();
+  model_ = tflite::FlatBufferModel::BuildFromBuffer(
+      content.data(), content.size(), &error_reporter_);
+  if (model_ == nullptr) {
+    return CreateModelBuildErrorStatus(&error_reporter_);
+  }
+  // The aliasing constructor keeps the whole cache entry alive.
+  model_metadata_extractor_ =
+      std::shared_ptr<const tflite::metadata::ModelMetadataExtractor>(
+          cached_model, cached_model->metadata_extractor.get());
+  cached_model_ = std::move(cached_model);
+  return absl::OkStatus();
+}
+
+StatusOr<std::shared_ptr<CachedModel>> TfLiteEngine::CreateCachedModel(
+    const ExternalFile& external_file) {
+  auto cached_model = std::make_shared<CachedModel>();
+  cached_model->external_file = std::make_unique<ExternalFile>(external_file);
+  ASSIGN_OR_RETURN(cached_model->file_handler,
+                   ExternalFileHandler::CreateFromExternalFile(
+                       cached_model->external_file.get(), &error_reporter_));
+  absl::string_view content = cached_model->file_handler->GetFileContent();
+  // The model built for verification is discarded: it would otherwise report
+  // errors to the error reporter of this engine, which may not outlive the
+  // cache entry.
+  if (VerifyAndBuildModelFromBuffer(content.data(), content.size(),
+                                    &error_reporter_) == nullptr) {
+    return CreateModelBuildErrorStatus(&error_reporter_);
+  }
+  ASSIGN_OR_RETURN(
+      cached_model->metadata_extractor,
+      tflite::metadata::ModelMetadataExtractor::CreateFromModelBuffer(
+          content.data(), content.size()));
+  return cached_model;
+}
+
 absl::Status TfLiteEngine::BuildModelFromFlatBuffer(
     const char* buffer_data, size_t buffer_size,
     const tflite::proto::ComputeSettings& compute_settings) {
@@ -153,10 +911,7 @@ absl::Status TfLiteEngine::BuildModelFromFlatBuffer(
   }
   external_file_ = std::make_unique<ExternalFile>();
   external_file_->set_file_content(std::string(buffer_data, buffer_size));
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file_.get(), compute_settings);
 }
 
 absl::Status TfLiteEngine::BuildModelFromFile(
@@ -170,10 +925,7 @@ absl::Status TfLiteEngine::BuildModelFromFile(
     external_file_ = std::make_unique<ExternalFile>();
   }
   external_file_->set_file_name(file_name);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file_.get(), compute_settings);
 }
 
 #ifdef _WIN32
@@ -189,10 +941,7 @@ absl::Status TfLiteEngine::BuildModelFromFileHandle(
   }
   external_file_->mutable_file_descriptor_meta()->set_handle(
       reinterpret_cast<uint64_t>(file_handle));
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file_.get(), compute_settings);
 }
 #endif
 
@@ -207,10 +956,7 @@ absl::Status TfLiteEngine::BuildModelFromFileDescriptor(
     external_file_ = std::make_unique<ExternalFile>();
   }
   external_file_->mutable_file_descriptor_meta()->set_fd(file_descriptor);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file_.get(), compute_settings);
 }
 
 absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
@@ -220,9 +966,7 @@ absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
     return CreateStatusWithPayload(StatusCode::kInternal,
                                    "Model already built");
   }
-  ASSIGN_OR_RETURN(model_file_handler_,
-                   ExternalFileHandler::CreateFromExternalFile(external_file));
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file, compute_settings);
 }
 
 absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
@@ -232,12 +976,9 @@ absl::Status TfLiteEngine::BuildModelFromExternalFileProto(
                                    "Model already built");
   }
   external_file_ = std::move(external_file);
-  ASSIGN_OR_RETURN(
-      model_file_handler_,
-      ExternalFileHandler::CreateFromExternalFile(external_file_.get()));
   // Dummy proto. InitializeFromModelFileHandler doesn't use this proto.
   tflite::proto::ComputeSettings compute_settings;
-  return InitializeFromModelFileHandler(compute_settings);
+  return InitializeFromExternalFile(external_file_.get(), compute_settings);
 }
 
 absl::Status TfLiteEngine::InitInterpreter(int num_threads) {
@@ -264,15 +1005,385 @@ absl::Status TfLiteEngine::InitInterpreter(
 
 absl::Status TfLiteEngine::InitInterpreter(
     const tflite::proto::ComputeSettings& compute_settings) {
+  return InitInterpreterContext(compute_settings, contexts_[0].get());
+}
+
+StatusOr<ComputeSettings> TfLiteEngine::AutoTuneComputeSettings(
+    const ComputeSettings& compute_settings, const AutoTuneConfig& config) {
+  if (model_ == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        "TF Lite FlatBufferModel is null. Please make sure to call one of the "
+        "BuildModelFrom methods before auto-tuning.");
+  }
+  if (config.num_runs < 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected auto-tuning `num_runs` >= 1, got %d.",
+                        config.num_runs),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  for (int num_threads : config.candidate_num_threads) {
+    if (num_threads < 1) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrFormat("Expected auto-tuning candidate numbers of threads "
+                          ">= 1, got %d.",
+                          num_threads),
+          TfLiteSupportStatus::kInvalidArgumentError);
+    }
+  }
+  const Delegate delegate = compute_settings.tflite_settings().delegate();
+  const bool tune_delegate = delegate == Delegate::NONE;
+  const std::vector<AutoTuneCandidate> candidates =
+      GetAutoTuneCandidates(config, tune_delegate);
+
+  std::string key;
+  absl::optional<AutoTuneCache> cache;
+  if (!config.cache_file.empty()) {
+    // The result of a benchmark only holds for the same set of candidates and
+    // the same configured delegate, so both are part of the key.
+    const tflite::Allocation* allocation = model_->allocation();
+    key = absl::StrCat(
+        VerifiedModelsCache::ComputeDigest(absl::string_view(
+            static_cast<const char*>(allocation->base()), allocation->bytes())),
+        "|", GetCpuSignature(), "|delegate=", static_cast<int>(delegate),
+        "|candidates=",
+        absl::StrJoin(candidates, ",",
+                      [](std::string* out, const AutoTuneCandidate& c) {
+                        absl::StrAppend(out, c.num_threads,
+                                        c.use_xnnpack ? "x" : "");
+                      }));
+    cache.emplace(config.cache_file);
+    ASSIGN_OR_RETURN(absl::optional<AutoTuneCandidate> cached,
+                     cache->Lookup(key));
+    // Entries are also checked against the candidates in case the file was
+    // edited by hand.
+    if (cached.has_value() &&
+        std::find(candidates.begin(), candidates.end(), *cached) !=
+            candidates.end()) {
+      return ApplyAutoTuneCandidate(compute_settings, *cached, tune_delegate);
+    }
+  }
+
+  absl::optional<AutoTuneCandidate> best;
+  absl::Duration best_latency = absl::InfiniteDuration();
+  absl::Status last_error;
+  for (const AutoTuneCandidate& candidate : candidates) {
+    ComputeSettings settings =
+        ApplyAutoTuneCandidate(compute_settings, candidate, tune_delegate);
+    // Candidates must not silently fall back to other settings.
+    auto* fallback_settings =
+        settings.mutable_tflite_settings()->mutable_fallback_settings();
+    fallback_settings->set_allow_automatic_fallback_on_compilation_error(false);
+    fallback_settings->set_allow_automatic_fallback_on_execution_error(false);
+    StatusOr<absl::Duration> latency =
+        BenchmarkComputeSettings(settings, config.num_runs);
+    if (!latency.ok()) {
+      last_error = latency.status();
+      continue;
+    }
+    if (*latency < best_latency) {
+      best = candidate;
+      best_latency = *latency;
+    }
+  }
+  if (!best.has_value()) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrCat("Auto-tuning failed: no candidate settings could run the "
+                     "model. Last error: ",
+                     last_error.message()));
+  }
+  if (cache.has_value()) {
+    // Failing to persist the result only costs a new benchmark next time.
+    cache->Store(key, *best).IgnoreError();
+  }
+  return ApplyAutoTuneCandidate(compute_settings, *best, tune_delegate);
+}
+
+StatusOr<absl::Duration> TfLiteEngine::BenchmarkComputeSettings(
+    const ComputeSettings& compute_settings, int num_runs) {
+  // Benchmark under the same thread placement as actual inferences.
+  SharedThreadPoolSlot thread_pool_slot(shared_thread_pool_.get());
+  ScopedCpuAffinity cpu_affinity(cpu_affinity_);
+  InterpreterContext context;
+  RETURN_IF_ERROR(InitInterpreterContext(compute_settings, &context));
+  UseCpuBackendContext(thread_pool_slot.cpu_backend_context(), &context);
+  // The context is discarded after the benchmark, so resized dynamic inputs
+  // need not be restored.
+  InputDims resized_inputs;
+  RETURN_IF_ERROR(
+      ZeroInputTensors(context.wrapper.get(), "Auto-tuning", &resized_inputs));
+  std::vector<absl::Duration> latencies;
+  // The first invocation is a warm-up run and is not timed.
+  for (int run = 0; run <= num_runs; ++run) {
+    const absl::Time start = absl::Now();
+    RETURN_IF_ERROR(context.wrapper.InvokeWithoutFallback());
+    if (run > 0) {
+      latencies.push_back(absl::Now() - start);
+    }
+  }
+  std::nth_element(latencies.begin(),
+                   latencies.begin() + latencies.size() / 2, latencies.end());
+  return latencies[latencies.size() / 2];
+}
+
+absl::Status TfLiteEngine::InitInterpreterPool(int pool_size) {
+  if (pool_size < 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected interpreter pool size >= 1, got %d.",
+                        pool_size),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (contexts_[0]->wrapper.get() == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "InitInterpreter must be called before InitInterpreterPool.");
+  }
+  if (contexts_.size() != 1) {
+    return CreateStatusWithPayload(StatusCode::kFailedPrecondition,
+                                   "Interpreter pool already initialized.");
+  }
+  // Use the settings actually retained by the primary interpreter, which may
+  // have been updated by the mini-benchmark.
+  const tflite::proto::ComputeSettings compute_settings =
+      contexts_[0]->wrapper.compute_settings();
+  for (int i = 1; i < pool_size; ++i) {
+    auto context = std::make_unique<InterpreterContext>();
+    RETURN_IF_ERROR(InitInterpreterContext(compute_settings, context.get()));
+    contexts_.push_back(std::move(context));
+  }
+  absl::MutexLock lock(&pool_mutex_);
+  for (int i = 1; i < contexts_.size(); ++i) {
+    idle_contexts_.push_back(contexts_[i].get());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status TfLiteEngine::Warmup(int num_runs) {
+  if (num_runs < 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected warm-up `num_runs` >= 0, got %d.", num_runs),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (num_runs == 0) {
+    return absl::OkStatus();
+  }
+  if (contexts_[0]->wrapper.get() == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "InitInterpreter must be called before Warmup.");
+  }
+  auto set_inputs_nop = [](Interpreter*) -> absl::Status {
+    return absl::OkStatus();
+  };
+  // Worker threads spawned on the first invocations inherit the affinity.
+  ScopedCpuAffinity cpu_affinity(cpu_affinity_);
+  for (const auto& context : contexts_) {
+    SharedThreadPoolSlot thread_pool_slot(shared_thread_pool_.get());
+    UseCpuBackendContext(thread_pool_slot.cpu_backend_context(),
+                         context.get());
+    InputDims resized_inputs;
+    RETURN_IF_ERROR(
+        ZeroInputTensors(context->wrapper.get(), "Warm-up", &resized_inputs));
+    for (int run = 0; run < num_runs; ++run) {
+      RETURN_IF_ERROR(context->wrapper.InvokeWithFallback(set_inputs_nop));
+    }
+    RETURN_IF_ERROR(
+        RestoreInputTensors(context->wrapper.get(), resized_inputs));
+  }
+  // Warm-up invocations are not representative of the actual traffic.
+  if (op_profiling_enabled_) {
+    ResetOpProfiling();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status TfLiteEngine::PrefaultModel() const {
+  if (model_ == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        "TF Lite FlatBufferModel is null. Please make sure to call one of the "
+        "BuildModelFrom methods before prefaulting the model.");
+  }
+  const tflite::Allocation* allocation = model_->allocation();
+  // Reading one byte per page is enough to fault it in. 4 KiB is the smallest
+  // page size of the supported platforms.
+  static constexpr size_t kPageSize = 4096;
+  const volatile char* data =
+      static_cast<const volatile char*>(allocation->base());
+  char checksum = 0;
+  for (size_t offset = 0; offset < allocation->bytes(); offset += kPageSize) {
+    checksum ^= data[offset];
+  }
+  (void)checksum;
+  return absl::OkStatus();
+}
+
+tflite::support::StatusOr<std::vector<OpProfile>>
+TfLiteEngine::GetOpProfiles() const {
+  if (!op_profiling_enabled_) {
+    return CreateStatusWithPayload(StatusCode::kFailedPrecondition,
+                                   "Op profiling is not enabled.");
+  }
+  // Merges the profiles of the same node across interpreters.
+  absl::flat_hash_map<std::tuple<int64_t, int64_t, bool>, OpProfile> merged;
+  for (const auto& context : contexts_) {
+    if (context->profiler == nullptr) {
+      continue;
+    }
+    for (OpProfile& profile : context->profiler->GetOpProfiles()) {
+      auto key = std::make_tuple(profile.subgraph_index, profile.node_index,
+                                 profile.delegated);
+      auto it = merged.find(key);
+      if (it == merged.end()) {
+        merged.emplace(key, std::move(profile));
+      } else {
+        it->second.invocation_count += profile.invocation_count;
+        it->second.total_time += profile.total_time;
+      }
+    }
+  }
+  std::vector<OpProfile> profiles;
+  profiles.reserve(merged.size());
+  for (auto& entry : merged) {
+    profiles.push_back(std::move(entry.second));
+  }
+  std::sort(profiles.begin(), profiles.end(),
+            [](const OpProfile& a, const OpProfile& b) {
+              return a.total_time > b.total_time;
+            });
+  return profiles;
+}
+
+tflite::support::StatusOr<std::string>
+TfLiteEngine::GetOpProfilingChromeTrace() const {
+  if (!op_profiling_enabled_) {
+    return CreateStatusWithPayload(StatusCode::kFailedPrecondition,
+                                   "Op profiling is not enabled.");
+  }
+  std::vector<std::vector<OpTraceEvent>> events;
+  for (const auto& context : contexts_) {
+    if (context->profiler != nullptr) {
+      events.push_back(context->profiler->GetTraceEvents());
+    }
+  }
+  return FormatChromeTrace(events);
+}
+
+void TfLiteEngine::ResetOpProfiling() {
+  for (const auto& context : contexts_) {
+    if (context->profiler != nullptr) {
+      context->profiler->Reset();
+    }
+  }
+}
+
+MemoryStats TfLiteEngine::GetMemoryStats() const {
+  MemoryStats stats;
+  if (model_ != nullptr) {
+    (cached_model_ != nullptr ? stats.shared_model_bytes : stats.model_bytes) =
+        model_->allocation()->bytes();
+  }
+  // The tensors are walked while all the interpreters are checked in, so that
+  // no inference resizes or re-allocates them meanwhile. An interpreter leased
+  // by the current thread is not running an inference either.
+  int num_leased_contexts = 0;
+  for (const InterpreterLease* lease = current_lease; lease != nullptr;
+       lease = lease->previous_) {
+    if (lease->engine_ == this && lease->owns_context_) {
+      ++num_leased_contexts;
+    }
+  }
+  absl::MutexLock lock(&pool_mutex_);
+  struct IdleCount {
+    const std::vector<InterpreterContext*>* idle_contexts;
+    size_t expected;
+  } idle_count = {&idle_contexts_, contexts_.size() - num_leased_contexts};
+  pool_mutex_.Await(absl::Condition(
+      +[](IdleCount* count) {
+        return count->idle_contexts->size() == count->expected;
+      },
+      &idle_count));
+  for (const auto& context : contexts_) {
+    const Interpreter* interpreter = context->wrapper.get();
+    if (interpreter == nullptr) {
+      continue;
+    }
+    for (int i = 0; i < interpreter->subgraphs_size(); ++i) {
+      const tflite::Subgraph& subgraph = *interpreter->subgraph(i);
+      // Each arena is a single buffer, spanning the tensors placed in it.
+      const char* arena_begin = nullptr;
+      const char* arena_end = nullptr;
+      const char* persistent_arena_begin = nullptr;
+      const char* persistent_arena_end = nullptr;
+      auto extend = [](const TfLiteTensor& tensor, const char** begin,
+                       const char** end) {
+        const char* data = tensor.data.raw_const;
+        if (*begin == nullptr || data < *begin) {
+          *begin = data;
+        }
+        if (*end == nullptr || data + tensor.bytes > *end) {
+          *end = data + tensor.bytes;
+        }
+      };
+      for (int j = 0; j < subgraph.tensors_size(); ++j) {
+        const TfLiteTensor& tensor = *subgraph.tensor(j);
+        if (tensor.data.raw_const == nullptr) {
+          continue;
+        }
+        switch (tensor.allocation_type) {
+          case kTfLiteArenaRw:
+            extend(tensor, &arena_begin, &arena_end);
+            break;
+          case kTfLiteArenaRwPersistent:
+            extend(tensor, &persistent_arena_begin, &persistent_arena_end);
+            break;
+          case kTfLitePersistentRo:
+            stats.persistent_arena_bytes += tensor.bytes;
+            break;
+          case kTfLiteDynamic:
+            stats.dynamic_tensor_bytes += tensor.bytes;
+            break;
+          default:
+            // Read-only tensors live in the model buffer, custom ones are
+            // owned by the caller.
+            break;
+        }
+      }
+      stats.tensor_arena_bytes += arena_end - arena_begin;
+      stats.persistent_arena_bytes +=
+          persistent_arena_end - persistent_arena_begin;
+    }
+  }
+  return stats;
+}
+
+absl::Status TfLiteEngine::InitInterpreterContext(
+    const tflite::proto::ComputeSettings& compute_settings,
+    InterpreterContext* context) {
   if (model_ == nullptr) {
     return CreateStatusWithPayload(
         StatusCode::kInternal,
         "TF Lite FlatBufferModel is null. Please make sure to call one of the "
         "BuildModelFrom methods before calling InitInterpreter.");
   }
+  if (op_profiling_enabled_ && context->profiler == nullptr) {
+    context->profiler = std::make_unique<OpProfiler>(max_op_trace_events_);
+  }
+  // Threads spawned by delegates at initialization time inherit the affinity.
+  ScopedCpuAffinity cpu_affinity(cpu_affinity_);
+  // Interpreters are set up on a backend context checked out for the duration
+  // of the initialization, then on the one of each lease.
+  SharedThreadPoolSlot thread_pool_slot(shared_thread_pool_.get());
+  context->cpu_backend_context = thread_pool_slot.cpu_backend_context();
   auto initializer =
-      [this](const InterpreterCreationResources& resources,
-             std::unique_ptr<Interpreter, InterpreterDeleter>* interpreter_out)
+      [this, context](
+          const InterpreterCreationResources& resources,
+          std::unique_ptr<Interpreter, InterpreterDeleter>* interpreter_out)
       -> absl::Status {
     tflite::InterpreterBuilder interpreter_builder(*model_, *resolver_);
     resources.ApplyTo(&interpreter_builder);
@@ -286,11 +1397,20 @@ absl::Status TfLiteEngine::InitInterpreter(
       return CreateStatusWithPayload(StatusCode::kInternal,
                                      "TF Lite interpreter is null.");
     }
+    // Also set when the interpreter is re-built on delegate fallback.
+    if (context->profiler != nullptr) {
+      (*interpreter_out)->SetProfiler(context->profiler.get());
+    }
+    if (context->cpu_backend_context != nullptr) {
+      (*interpreter_out)
+          ->SetExternalContext(kTfLiteCpuBackendContext,
+                               context->cpu_backend_context);
+    }
     return absl::OkStatus();
   };
 
   absl::Status status =
-      interpreter_.InitializeWithFallback(initializer, compute_settings);
+      context->wrapper.InitializeWithFallback(initializer, compute_settings);
   if (!status.ok()) {
     if (absl::StrContains(error_reporter_.previous_message(),
                           "Encountered unresolved custom op")) {
@@ -300,7 +1420,8 @@ absl::Status TfLiteEngine::InitInterpreter(
     } else if (absl::StrContains(error_reporter_.previous_message(),
                                  "Didn't find op for builtin opcode")) {
       return CreateStatusWithPayload(
-          StatusCode::kInvalidArgument, error_reporter_.previous_message(),
+          StatusCode::kInvalidArgument,
+          error_reporter_.previous_message(),
           TfLiteSupportStatus::kUnsupportedBuiltinOp);
     } else if (!status.GetPayload(tflite::support::kTfLiteSupportPayload)
                     .has_value()) {
@@ -21,11 +21,15 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
@@ -33,11 +37,20 @@ limitations under the License.
 #include "tensorflow/lite/kernels/register.h"
 #include "tensorflow/lite/model.h"
 #include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/signature_runner.h"
 #include "tensorflow_lite_support/cc/port/configuration_proto_inc.h"
 #include "tensorflow_lite_support/cc/port/tflite_wrapper.h"
+#include "tensorflow_lite_support/cc/task/core/aligned_buffer.h"
+#include "tensorflow_lite_support/cc/task/core/auto_tuner.h"
+#include "tensorflow_lite_support/cc/task/core/cpu_affinity.h"
 #include "tensorflow_lite_support/cc/task/core/error_reporter.h"
 #include "tensorflow_lite_support/cc/task/core/external_file_handler.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
+#include "tensorflow_lite_support/cc/task/core/model_cache.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
 #include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/core/shared_thread_pool.h"
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
 #include "tensorflow_lite_support/metadata/cc/metadata_extractor.h"
 
 #ifdef ABSL_HAVE_MMAP
@@ -54,6 +67,13 @@ namespace core {
 
 // TfLiteEngine encapsulates logic for TFLite model initialization, inference
 // and error reporting.
+//
+// By default, the engine holds a single interpreter and is thread-compatible.
+// `InitInterpreterPool` can be used to create a bounded pool of interpreters
+// sharing the same model and metadata extractor: callers then check out an
+// interpreter for the duration of an inference through `AcquireInterpreter`,
+// which makes it safe to run up to `interpreter_pool_size()` inferences
+// concurrently.
 class TfLiteEngine {
  public:
   // Types.
@@ -62,7 +82,13 @@ class TfLiteEngine {
   using Interpreter = ::tflite::Interpreter;
   using ModelDeleter = std::default_delete<Model>;
   using InterpreterDeleter = std::default_delete<Interpreter>;
+  using SignatureRunner = ::tflite::SignatureRunner;
 
+ private:
+  // Per-interpreter state, defined below.
+  struct InterpreterContext;
+
+ public:
   // Constructors.
   explicit TfLiteEngine(
       std::unique_ptr<tflite::OpResolver> resolver =
@@ -71,6 +97,39 @@ class TfLiteEngine {
   TfLiteEngine(const TfLiteEngine&) = delete;
   TfLiteEngine& operator=(const TfLiteEngine&) = delete;
 
+  // Exclusive handle on one of the interpreters of the engine, returned to the
+  // pool at destruction. While a lease is alive, all the accessors of the
+  // engine called from the thread that acquired it (`interpreter()`,
+  // `interpreter_wrapper()`, `GetInputs()`, ...) refer to the leased
+  // interpreter. Leases must be destroyed on the thread that acquired them.
+  //
+  // If set, the CPU affinity of the engine (see `SetCpuAffinity`) is applied
+  // to the current thread, and one of the backend contexts of the shared
+  // thread pool of the engine (see `UseSharedThreadPool`) is checked out for
+  // the lifetime of the lease.
+  class InterpreterLease {
+   public:
+    ~InterpreterLease();
+    // InterpreterLease is neither copyable nor movable.
+    InterpreterLease(const InterpreterLease&) = delete;
+    InterpreterLease& operator=(const InterpreterLease&) = delete;
+
+   private:
+    friend class TfLiteEngine;
+    explicit InterpreterLease(TfLiteEngine* engine);
+
+    TfLiteEngine* engine_;
+    InterpreterContext* context_;
+    // Whether the context was checked out of the pool by this lease, as
+    // opposed to being already held by an enclosing lease on the same thread.
+    bool owns_context_;
+    // Enclosing lease held by the current thread, if any.
+    const InterpreterLease* previous_;
+    // Only checked out if `owns_context_`: nested leases on the same engine
+    // reuse the backend context of the enclosing one.
+    absl::optional<SharedThreadPoolSlot> thread_pool_slot_;
+  };
+
   // Accessors.
   static int32_t InputCount(const Interpreter* interpreter) {
     return interpreter->inputs().size();
@@ -95,17 +154,185 @@ class TfLiteEngine {
     return interpreter->tensor(interpreter->outputs()[index]);
   }
 
+  // Returns the input (resp. output) tensor at `index`. While a batch slot is
+  // selected (see `SelectBatchSlot`), this is a view restricted to that slot,
+  // i.e. with a batch dimension of 1 and pointing into the batched tensor data.
+  // While a signature is selected (see `SelectSignature`), this is the tensor
+  // of that signature at `index`.
+  TfLiteTensor* GetInputTensor(int index);
+  TfLiteTensor* GetOutputTensor(int index);
+
   std::vector<TfLiteTensor*> GetInputs();
   std::vector<const TfLiteTensor*> GetOutputs();
 
+  // Resizes the batch (i.e. first) dimension of all input tensors to
+  // `batch_size` and re-allocates tensors. This is a no-op if the inputs
+  // already have this batch size.
+  //
+  // Batching is only supported for models whose inputs and outputs all have a
+  // leading batch dimension (equal to 1 in the original model) and are not
+  // dynamic or string tensors.
+  absl::Status ResizeInputBatch(int batch_size);
+
+  // Resizes the inputs at the provided indices to the provided dimensions and
+  // re-allocates tensors, for models with dynamic input shapes. Both steps are
+  // skipped if all these inputs already have the requested dimensions, e.g.
+  // when consecutive calls use the same shape, so that the memory plan of the
+  // interpreter is only rebuilt when the shape actually changes.
+  //
+  // Each interpreter of the pool keeps its own shapes. While a signature is
+  // selected (see `SelectSignature`), the inputs of that signature are resized
+  // instead of those of the primary subgraph. See also `RoundUpToShapeBucket`
+  // to reduce the number of distinct shapes.
+  absl::Status ResizeInputTensors(
+      const std::vector<std::pair<int, std::vector<int>>>& input_dims);
+
+  // Binds the caller-owned `data` buffer of `size` bytes as the storage of the
+  // input (resp. output) tensor at `index` of the current interpreter, using
+  // TF Lite custom allocations, and re-allocates tensors. Pre-processing then
+  // writes directly into `data` (see `PopulateTensor`, which skips copies from
+  // the tensor's own storage), and post-processing reads from it, saving
+  // full-tensor copies for large inputs or outputs.
+  //
+  // `data` must be aligned on `AlignedBuffer::kAlignment` bytes, hold at least
+  // the current byte size of the tensor, and outlive the binding, which lasts
+  // until the tensor is bound to another buffer. String and dynamic tensors
+  // are not supported. Resizing the tensor (e.g. through `ResizeInputBatch`)
+  // fails if the buffer is too small for the new shape.
+  absl::Status SetInputTensorBuffer(int index, void* data, size_t size);
+  absl::Status SetOutputTensorBuffer(int index, void* data, size_t size);
+
+  // Sets the sizes to which dynamic input dimensions are rounded up by tasks
+  // able to pad their inputs (e.g. the sequence length of BERT-based text
+  // tasks), see `RoundUpToShapeBucket`. All sizes must be positive.
+  absl::Status SetShapeBuckets(std::vector<int> buckets);
+
+  // Returns the smallest shape bucket greater than or equal to `size`, or
+  // `size` itself if no bucket is that large (or none is set).
+  int RoundUpToShapeBucket(int size) const;
+
+  // Returns the number of times `ResizeInputTensors` re-allocated the tensors
+  // of the current interpreter.
+  int num_input_tensor_allocations() const {
+    return current_context()->num_input_tensor_allocations;
+  }
+
+  // Returns the current batch size of the inputs, as set through
+  // `ResizeInputBatch`. Defaults to 1.
+  int input_batch_size() const { return current_context()->input_batch_size; }
+
+  // Restricts `GetInputTensor`, `GetOutputTensor`, `GetInputs` and `GetOutputs`
+  // to the provided slot of the current batch, so that single-input
+  // pre-processing and post-processing logic can be run unchanged on each
+  // element of the batch. `slot` must be in `[0, input_batch_size())`.
+  absl::Status SelectBatchSlot(int slot);
+
+  // Lifts the restriction set by `SelectBatchSlot`.
+  void ClearBatchSlot() { current_context()->batch_slot = -1; }
+
+  // Returns the keys of the signatures defined by the model, e.g. several
+  // entry points sharing the same weights. Empty if the model has none.
+  std::vector<std::string> GetSignatureKeys() const;
+
+  // Makes `GetInputTensor`, `GetOutputTensor`, `GetInputs` and `GetOutputs`
+  // address the inputs and outputs of the signature with the provided key
+  // (sorted by name) instead of those of the primary subgraph, and returns the
+  // runner to be used to invoke it. The tensors of each signature are
+  // allocated in their own arena the first time the signature is selected on
+  // a given interpreter, while the model weights are shared by all of them.
+  // The inputs and outputs of the signature must match those of the primary
+  // subgraph in count, type and shape (dynamic dimensions matching any size),
+  // since tasks process them the same way; kInvalidArgument is returned
+  // otherwise.
+  //
+  // Batching (see `ResizeInputBatch`) and bound tensor buffers only apply to
+  // the primary subgraph.
+  tflite::support::StatusOr<SignatureRunner*> SelectSignature(
+      absl::string_view signature_key);
+
+  // Lifts the selection made by `SelectSignature`.
+  void ClearSignature() { current_context()->signature_runner = nullptr; }
+
   const Model* model() const { return model_.get(); }
-  Interpreter* interpreter() { return interpreter_.get(); }
-  const Interpreter* interpreter() const { return interpreter_.get(); }
-  InterpreterWrapper* interpreter_wrapper() { return &interpreter_; }
+  Interpreter* interpreter() { return current_context()->wrapper.get(); }
+  const Interpreter* interpreter() const {
+    return current_context()->wrapper.get();
+  }
+  InterpreterWrapper* interpreter_wrapper() {
+    return &current_context()->wrapper;
+  }
   const tflite::metadata::ModelMetadataExtractor* metadata_extractor() const {
     return model_metadata_extractor_.get();
   }
 
+  // Makes the `BuildModelFrom` methods below share the model with all other
+  // engines of the process built from the same model file and with the model
+  // cache enabled: the file is mapped, verified and its metadata parsed only
+  // once, see `ModelCache`. Must be called before building the model.
+  void EnableModelCache() { use_model_cache_ = true; }
+
+  // Makes the `BuildModelFrom` methods below skip the verification of models
+  // whose digest is recorded in the provided sidecar file, and record the
+  // digest of the models that pass verification. See `VerifiedModelsCache`
+  // for the security implications: only use this with trusted models and a
+  // file that can't be written by untrusted parties. Must be called before
+  // building the model.
+  void SetVerifiedModelsCacheFile(const std::string& file_path) {
+    verified_models_cache_ = std::make_unique<VerifiedModelsCache>(file_path);
+  }
+
+  // Attaches a per-op profiler to each interpreter of the engine, keeping up to
+  // `max_trace_events` op executions per interpreter for trace dumps (see
+  // `GetOpProfilingChromeTrace`). Must be called before `InitInterpreter`.
+  void EnableOpProfiling(int max_trace_events) {
+    op_profiling_enabled_ = true;
+    max_op_trace_events_ = max_trace_events;
+  }
+
+  // Restricts the threads running inference to the provided CPUs: the thread
+  // creating and warming up the interpreters for the duration of these calls,
+  // the threads holding a lease (see `AcquireInterpreter`), and thus the worker
+  // threads they spawn. Threads that held a lease stay restricted to `cpus`
+  // afterwards, so that the affinity is only set once per thread. Only
+  // supported on Linux. Must be called before `InitInterpreter`.
+  absl::Status SetCpuAffinity(std::vector<int> cpus);
+
+  // Makes the interpreters of the engine run their built-in CPU kernels on the
+  // process-wide thread pool registered under `name`, shared with all other
+  // engines using the same name, instead of spawning their own threads.
+  // Leases on these engines still run concurrently, each on a backend context
+  // of the pool, see `SharedThreadPool`. Must be called before
+  // `InitInterpreter`.
+  void UseSharedThreadPool(const std::string& name) {
+    shared_thread_pool_ = SharedThreadPool::GetOrCreate(name);
+  }
+
+  // Returns the thread pool set through `UseSharedThreadPool`, or null.
+  SharedThreadPool* shared_thread_pool() const {
+    return shared_thread_pool_.get();
+  }
+
+  // Returns the execution statistics of each node of the model, aggregated
+  // over all interpreters and sorted by decreasing total time. Fails if op
+  // profiling is not enabled.
+  tflite::support::StatusOr<std::vector<OpProfile>> GetOpProfiles() const;
+
+  // Returns the most recent op executions of all interpreters in the Chrome
+  // trace event JSON format, one thread per interpreter. Fails if op profiling
+  // is not enabled.
+  tflite::support::StatusOr<std::string> GetOpProfilingChromeTrace() const;
+
+  // Clears the op profiles and traces collected so far.
+  void ResetOpProfiling();
+
+  // Returns the memory used by the model and the interpreters of the engine.
+  // Arena sizes are derived from the placement of the tensors they hold, and
+  // may change when input tensors are resized, hence this waits for all the
+  // inferences in progress on other threads to release their interpreters,
+  // and blocks new ones until it returns. The model buffer is reported as
+  // `shared_model_bytes` if it comes from the model cache.
+  MemoryStats GetMemoryStats() const;
+
   // Builds the TF Lite FlatBufferModel (model_) from the raw FlatBuffer data
   // whose ownership remains with the caller, and which must outlive the current
   // object. This performs extra verification on the input data using
@@ -164,10 +391,53 @@ class TfLiteEngine {
   absl::Status InitInterpreter(
       const tflite::proto::ComputeSettings& compute_settings, int num_threads);
 
-  // Cancels the on-going `Invoke()` call if any and if possible. This method
-  // can be called from a different thread than the one where `Invoke()` is
-  // running.
-  void Cancel() { interpreter_.Cancel(); }
+  // Returns a copy of `compute_settings` with the fastest CPU settings for the
+  // model on this host: a short benchmark on zero inputs is run for each
+  // candidate number of threads, with and without the XNNPACK delegate (if no
+  // other delegate is set), as configured by `config`. Candidates that fail
+  // to initialize, e.g. if the XNNPACK delegate plugin is not linked in, are
+  // skipped. Results are persisted per model and CPU in `config.cache_file`,
+  // if set, so that subsequent calls on the same host type skip benchmarking.
+  //
+  // Must be called after building the model; the returned settings are meant
+  // to be passed to `InitInterpreter`.
+  tflite::support::StatusOr<tflite::proto::ComputeSettings>
+  AutoTuneComputeSettings(
+      const tflite::proto::ComputeSettings& compute_settings,
+      const AutoTuneConfig& config);
+
+  // Grows the pool of interpreters to `pool_size` interpreters, all sharing the
+  // model and metadata extractor of the engine and configured with the same
+  // ComputeSettings as the interpreter created by `InitInterpreter`, which
+  // must have been called before. Can only be called once.
+  absl::Status InitInterpreterPool(int pool_size);
+
+  // Runs `num_runs` invocations on zero inputs on each interpreter of the
+  // pool, so that one-time costs (delegate weight packing, first touch of the
+  // tensor arena, etc.) are paid upfront rather than by the first inference
+  // calls. Inputs with dynamic dimensions whose shape is not known yet are
+  // warmed up with a size of 1 along those dimensions, then restored. Models
+  // with string inputs are not supported. Op profiles collected so far are
+  // cleared. Must be called after `InitInterpreter` and, if used,
+  // `InitInterpreterPool`.
+  absl::Status Warmup(int num_runs);
+
+  // Reads the whole model buffer so that, if it is memory mapped, all its
+  // pages are loaded in memory before the first inference call.
+  absl::Status PrefaultModel() const;
+
+  // Returns the number of interpreters in the pool.
+  int interpreter_pool_size() const { return contexts_.size(); }
+
+  // Checks out an interpreter from the pool, blocking until one is available.
+  // If the current thread already holds a lease on this engine, the returned
+  // lease shares its interpreter instead.
+  InterpreterLease AcquireInterpreter();
+
+  // Cancels the on-going `Invoke()` calls if any and if possible, on all
+  // interpreters of the pool. This method can be called from a different
+  // thread than the one where `Invoke()` is running.
+  void Cancel();
 
  protected:
   // Custom error reporter capturing and printing to stderr low-level TF Lite
@@ -186,10 +456,15 @@ class TfLiteEngine {
   // Verifies that the supplied buffer refers to a valid flatbuffer model,
   // and that it uses only operators that are supported by the OpResolver
   // that was passed to the TfLiteEngine constructor, and then builds
-  // the model from the buffer and stores it in 'model_'.
-  void VerifyAndBuildModelFromBuffer(const char* buffer_data,
-                                     size_t buffer_size,
-                                     TfLiteVerifier* extra_verifier = nullptr);
+  // the model from the buffer, reporting errors to `error_reporter`. Returns
+  // null on failure.
+  //
+  // Verification is skipped if the digest of the buffer is recorded in the
+  // verified models cache file (see `SetVerifiedModelsCacheFile`), and the
+  // digest is recorded there after a successful verification otherwise.
+  std::unique_ptr<Model> VerifyAndBuildModelFromBuffer(
+      const char* buffer_data, size_t buffer_size,
+      ErrorReporter* error_reporter);
 
   // Gets the buffer from the file handler; verifies and builds the model
   // from the buffer; if successful, sets 'model_metadata_extractor_' to be
@@ -200,20 +475,148 @@ class TfLiteEngine {
       const tflite::proto::ComputeSettings& compute_settings =
           tflite::proto::ComputeSettings());
 
+  // Builds the model from `external_file`, which must outlive the current
+  // object, either directly or through the model cache if enabled.
+  absl::Status InitializeFromExternalFile(
+      const ExternalFile* external_file,
+      const tflite::proto::ComputeSettings& compute_settings);
+
+  // Shares the model of `external_file` through the model cache, loading it
+  // first if needed.
+  absl::Status InitializeFromModelCache(
+      const ExternalFile* external_file,
+      const tflite::proto::ComputeSettings& compute_settings);
+
+  // Maps and verifies a model to be stored in the model cache.
+  tflite::support::StatusOr<std::shared_ptr<CachedModel>> CreateCachedModel(
+      const ExternalFile& external_file);
+
+  // View over a single batch slot of an input or output tensor. The view owns
+  // its `dims` array; all other fields are shallow copies of the batched
+  // tensor.
+  struct TensorSlotView {
+    TfLiteTensor tensor{};
+    std::unique_ptr<TfLiteIntArray, void (*)(TfLiteIntArray*)> dims{
+        nullptr, TfLiteIntArrayFree};
+  };
+
+  // Returns the median latency of `num_runs` invocations, on zero inputs, of a
+  // temporary interpreter built with `compute_settings`.
+  tflite::support::StatusOr<absl::Duration> BenchmarkComputeSettings(
+      const tflite::proto::ComputeSettings& compute_settings, int num_runs);
+
+  // Implements `SetInputTensorBuffer` and `SetOutputTensorBuffer`.
+  absl::Status SetTensorBuffer(bool is_input, int index, void* data,
+                               size_t size);
+
+  // Implements `ResizeInputTensors` while a signature is selected, resizing
+  // the inputs of `runner` instead of those of the primary subgraph.
+  absl::Status ResizeSignatureInputTensors(
+      SignatureRunner* runner,
+      const std::vector<std::pair<int, std::vector<int>>>& input_dims);
+
+  // Builds the input and output slot views of `context` for its current batch
+  // size, checking that every tensor can be split along its first dimension.
+  absl::Status BuildBatchSlotViews(InterpreterContext* context);
+
+  // Points `view` to the `slot`-th element of the batched `tensor`.
+  static void UpdateBatchSlotView(const TfLiteTensor& tensor, int batch_size,
+                                  int slot, TensorSlotView* view);
+
+  // Builds the interpreter of `context` from the model with the provided
+  // ComputeSettings.
+  absl::Status InitInterpreterContext(
+      const tflite::proto::ComputeSettings& compute_settings,
+      InterpreterContext* context);
+
+  // Makes the interpreter of `context` run its built-in CPU kernels on the
+  // worker threads of `cpu_backend_context`, resized to the number of threads
+  // of the interpreter. No-op if `cpu_backend_context` is null, i.e. if the
+  // engine doesn't use a shared thread pool.
+  static void UseCpuBackendContext(
+      tflite::ExternalCpuBackendContext* cpu_backend_context,
+      InterpreterContext* context);
+
+  // Returns the context leased by the current thread, or the primary context
+  // if none.
+  InterpreterContext* current_context() const;
+
   // ExternalFile and corresponding ExternalFileHandler for models loaded from
   // disk or file descriptor.
   // Make sure ExternalFile proto outlives the model and the interpreter.
   std::unique_ptr<ExternalFile> external_file_;
   std::unique_ptr<ExternalFileHandler> model_file_handler_;
 
+  // Model cache entry holding the content of `model_`, if it was loaded
+  // through `EnableModelCache`. Declared first so that it outlives the model.
+  std::shared_ptr<const CachedModel> cached_model_;
+
   // TF Lite model and interpreter for actual inference.
-  std::unique_ptr<Model, ModelDeleter> model_;
+  std::shared_ptr<Model> model_;
+
+  // Whether to load the model through the model cache.
+  bool use_model_cache_ = false;
+
+  // Digests of the models known to be valid, if enabled.
+  std::unique_ptr<VerifiedModelsCache> verified_models_cache_;
+
+  // Sorted sizes set through `SetShapeBuckets`.
+  std::vector<int> shape_buckets_;
+
+  // Whether to attach an OpProfiler to each interpreter, see
+  // `EnableOpProfiling`.
+  bool op_profiling_enabled_ = false;
+  int max_op_trace_events_ = 0;
+
+  // CPUs set through `SetCpuAffinity`, empty if unrestricted.
+  std::vector<int> cpu_affinity_;
+
+  // Thread pool set through `UseSharedThreadPool`, if any. Declared before the
+  // interpreter contexts so as to outlive the interpreters using it.
+  std::shared_ptr<SharedThreadPool> shared_thread_pool_;
+
+  // Per-interpreter state. The interpreter wrapper is built from the model;
+  // the other fields track batched inference, see `ResizeInputBatch`.
+  struct InterpreterContext {
+    // Profiler attached to the interpreter if op profiling is enabled.
+    // Declared first so as to outlive the interpreter.
+    std::unique_ptr<OpProfiler> profiler;
+    InterpreterWrapper wrapper;
+    // Current batch size of the inputs.
+    int input_batch_size = 1;
+    // Currently selected batch slot, or -1 if none.
+    int batch_slot = -1;
+    // Whether a previous `ResizeInputTensors` call failed to allocate tensors,
+    // in which case allocation can't be skipped.
+    bool allocation_pending = false;
+    // Number of successful allocations made by `ResizeInputTensors`.
+    int num_input_tensor_allocations = 0;
+    // Per-slot views over the input and output tensors, built for the current
+    // batch size.
+    std::vector<TensorSlotView> input_slot_views;
+    std::vector<TensorSlotView> output_slot_views;
+    // Runner of the signature selected through `SelectSignature`, or null if
+    // the primary subgraph is addressed.
+    SignatureRunner* signature_runner = nullptr;
+    // Backend context of the shared thread pool currently assigned to the
+    // interpreter, see `UseCpuBackendContext`. Also set on the interpreters
+    // re-built on delegate fallback.
+    tflite::ExternalCpuBackendContext* cpu_backend_context = nullptr;
+  };
+
+  // Interpreter contexts. The first one is the primary context, used when the
+  // current thread holds no lease. The vector is only modified at
+  // initialization time.
+  std::vector<std::unique_ptr<InterpreterContext>> contexts_;
 
-  // Interpreter wrapper built from the model.
-  InterpreterWrapper interpreter_;
+  // Contexts available for checkout through `AcquireInterpreter`. Mutable
+  // since `GetMemoryStats` waits for all of them to be available.
+  mutable absl::Mutex pool_mutex_;
+  std::vector<InterpreterContext*> idle_contexts_
+      ABSL_GUARDED_BY(pool_mutex_);
 
   // TFLite Metadata extractor built from the model.
-  std::unique_ptr<tflite::metadata::ModelMetadataExtractor>
+  std::shared_ptr<const tflite::metadata::ModelMetadataExtractor>
       model_metadata_extractor_;
 
   // Mechanism used by TF Lite to map Ops referenced in the FlatBuffer model to
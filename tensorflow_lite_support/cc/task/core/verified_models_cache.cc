@@ -0,0 +1,67 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/escaping.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "openssl/sha.h"  // from @boringssl
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+namespace {
+
+using ::tflite::support::StatusOr;
+
+// Identifies the digest algorithm in the file, so that it can be changed
+// without risking false positives.
+constexpr char kDigestPrefix[] = "sha256";
+
+// Value of the records of verified models.
+constexpr char kVerifiedValue[] = "verified";
+
+}  // namespace
+
+/* static */
+std::string VerifiedModelsCache::ComputeDigest(
+    absl::string_view model_content) {
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const uint8_t*>(model_content.data()),
+         model_content.size(), hash);
+  return absl::StrFormat(
+      "%s:%d:%s", kDigestPrefix, model_content.size(),
+      absl::BytesToHexString(absl::string_view(
+          reinterpret_cast<const char*>(hash), sizeof(hash))));
+}
+
+StatusOr<bool> VerifiedModelsCache::Contains(absl::string_view digest) const {
+  ASSIGN_OR_RETURN(absl::optional<std::string> value, file_.Lookup(digest));
+  return value.has_value() && *value == kVerifiedValue;
+}
+
+absl::Status VerifiedModelsCache::Add(absl::string_view digest) const {
+  return file_.Store(digest, kVerifiedValue);
+}
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,72 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_VERIFIED_MODELS_CACHE_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_VERIFIED_MODELS_CACHE_H_
+
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/sidecar_file.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+
+// Sidecar file recording the digests of the models that already passed full
+// FlatBuffer verification, so that subsequent loads of the same models (e.g.
+// after a process restart) can skip it.
+//
+// The file is a `SidecarFile` with one record per digest, i.e. the SHA-256 of
+// the model content along with its size.
+//
+// Trust model: a model whose digest is listed in the file is loaded without
+// verification, so the file is as trusted as the code loading the models.
+// - The digest is collision resistant, so that an attacker able to supply
+//   models but not to write the file cannot get an unverified model loaded by
+//   crafting one with the same digest as a previously verified model.
+// - The file itself is not authenticated: it must live in a location that
+//   only trusted parties can write to, e.g. next to the application binaries
+//   or in its private data directory, never in a shared or world-writable
+//   directory.
+// - A corrupted or truncated file only causes models to be verified again.
+class VerifiedModelsCache {
+ public:
+  explicit VerifiedModelsCache(std::string file_path)
+      : file_(std::move(file_path), "verified models cache") {}
+
+  // Returns the digest of the provided model content, which is stable across
+  // processes and platforms.
+  static std::string ComputeDigest(absl::string_view model_content);
+
+  // Returns whether `digest` is recorded in the file. A missing file is
+  // considered empty.
+  tflite::support::StatusOr<bool> Contains(absl::string_view digest) const;
+
+  // Appends `digest` to the file, creating it if needed.
+  absl::Status Add(absl::string_view digest) const;
+
+ private:
+  const SidecarFile file_;
+};
+
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_CORE_VERIFIED_MODELS_CACHE_H_
@@ -149,13 +149,15 @@ absl::Status BertPreprocessor::Preprocess(const std::string& input_text) {
     input_tokens_size = std::min(bert_max_seq_len_, input_tokens_size);
     input_tensor_length = bert_max_seq_len_;
   } else {
-    engine_->interpreter()->ResizeInputTensorStrict(kIdsTensorIndex,
-                                                    {1, input_tensor_length});
-    engine_->interpreter()->ResizeInputTensorStrict(kMaskTensorIndex,
-                                                    {1, input_tensor_length});
-    engine_->interpreter()->ResizeInputTensorStrict(kSegmentIdsTensorIndex,
-                                                    {1, input_tensor_length});
-    engine_->interpreter()->AllocateTensors();
+    // Pad the sequence to the configured shape bucket, if any, so that inputs
+    // of similar lengths share the same shape and don't require re-allocating
+    // the interpreter tensors.
+    input_tensor_length = engine_->RoundUpToShapeBucket(input_tensor_length);
+    RETURN_IF_ERROR(engine_->ResizeInputTensors(
+        {{tensor_indices_.at(kIdsTensorIndex), {1, input_tensor_length}},
+         {tensor_indices_.at(kMaskTensorIndex), {1, input_tensor_length}},
+         {tensor_indices_.at(kSegmentIdsTensorIndex),
+          {1, input_tensor_length}}}));
   }
 
   std::vector<std::string> input_tokens;
@@ -41,6 +41,13 @@ class BertPreprocessor : public TextPreprocessor {
 
   absl::Status Preprocess(const std::string& text);
 
+  // Accounts for the tokenizer vocabulary.
+  void AddMemoryStats(core::MemoryStats* stats) const override {
+    if (tokenizer_ != nullptr) {
+      stats->task_bytes["tokenizer"] += tokenizer_->EstimateMemoryUsage();
+    }
+  }
+
  private:
   using TextPreprocessor::TextPreprocessor;
 
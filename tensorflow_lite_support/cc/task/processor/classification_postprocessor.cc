@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/processor/classification_postprocessor.h"
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
@@ -52,6 +54,15 @@ ClassificationPostprocessor::Create(
   return processor;
 }
 
+void ClassificationPostprocessor::AddMemoryStats(
+    core::MemoryStats* stats) const {
+  int64_t bytes = EstimateMemoryUsage(classification_head_);
+  for (const std::string& value : class_name_set_.values) {
+    bytes += sizeof(std::string) + core::EstimateHeapMemoryUsage(value);
+  }
+  stats->task_bytes["label_maps"] += bytes;
+}
+
 absl::Status ClassificationPostprocessor::Init(
     std::unique_ptr<ClassificationOptions> options) {
   // Sanity check options
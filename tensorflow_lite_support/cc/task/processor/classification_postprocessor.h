@@ -60,6 +60,8 @@ class ClassificationPostprocessor : public Postprocessor {
 
   const std::string GetHeadName() const { return classification_head_.name; }
 
+  void AddMemoryStats(core::MemoryStats* stats) const override;
+
  private:
   using Postprocessor::Postprocessor;
 
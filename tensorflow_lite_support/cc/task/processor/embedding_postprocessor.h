@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 #include "tensorflow_lite_support/cc/task/processor/processor.h"
 #include "tensorflow_lite_support/cc/task/processor/proto/embedding_options.pb.h"
@@ -84,15 +85,10 @@ template <typename T>
 absl::Status EmbeddingPostprocessor::Postprocess(T* embedding) {
   embedding->set_output_index(tensor_indices_.at(0));
   auto* feature_vector = embedding->mutable_feature_vector();
-  if (GetTensor()->type == kTfLiteUInt8) {
-    const uint8_t* output_data =
-        engine_->interpreter()->typed_output_tensor<uint8_t>(
-            tensor_indices_.at(0));
-    // Get the zero_point and scale parameters from the tensor metadata.
-    const int output_tensor_index =
-        engine_->interpreter()->outputs()[tensor_indices_.at(0)];
-    const TfLiteTensor* output_tensor =
-        engine_->interpreter()->tensor(output_tensor_index);
+  const TfLiteTensor* output_tensor = GetTensor();
+  if (output_tensor->type == kTfLiteUInt8) {
+    ASSIGN_OR_RETURN(const uint8_t* output_data,
+                     core::AssertAndReturnTypedTensor<uint8_t>(output_tensor));
     for (int j = 0; j < embedding_dimension_; ++j) {
       feature_vector->add_value_float(output_tensor->params.scale *
                                       (static_cast<int>(output_data[j]) -
@@ -100,9 +96,8 @@ absl::Status EmbeddingPostprocessor::Postprocess(T* embedding) {
     }
   } else {
     // Float
-    const float* output_data =
-        engine_->interpreter()->typed_output_tensor<float>(
-            tensor_indices_.at(0));
+    ASSIGN_OR_RETURN(const float* output_data,
+                     core::AssertAndReturnTypedTensor<float>(output_tensor));
     for (int j = 0; j < embedding_dimension_; ++j) {
       feature_vector->add_value_float(output_data[j]);
     }
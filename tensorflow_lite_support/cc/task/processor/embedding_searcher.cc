@@ -228,6 +228,16 @@ StatusOr<absl::string_view> EmbeddingSearcher::GetUserInfo() {
   return index_->GetUserInfo();
 }
 
+void EmbeddingSearcher::AddMemoryStats(core::MemoryStats* stats) const {
+  // The index config holds the partitioner centroids and quantization
+  // codebooks, which are also loaded by the partitioner and quantizer.
+  int64_t bytes = 2 * index_config_.ByteSizeLong();
+  if (index_file_handler_ != nullptr) {
+    bytes += index_file_handler_->GetFileContent().size();
+  }
+  stats->task_bytes["search_index"] += bytes;
+}
+
 absl::Status EmbeddingSearcher::Init(
     std::unique_ptr<SearchOptions> options,
     std::optional<absl::string_view> optional_index_file_content) {
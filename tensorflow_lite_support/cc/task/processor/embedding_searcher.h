@@ -29,6 +29,7 @@ limitations under the License.
 #include "absl/types/span.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/core/external_file_handler.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
 #include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
 #include "tensorflow_lite_support/cc/task/processor/proto/search_options.pb.h"
 #include "tensorflow_lite_support/cc/task/processor/proto/search_result.pb.h"
@@ -67,6 +68,10 @@ class EmbeddingSearcher {
   // user info.
   tflite::support::StatusOr<absl::string_view> GetUserInfo();
 
+  // Adds the memory used by the index to `stats`, unless it is read from the
+  // model metadata, which is already accounted for as part of the model.
+  void AddMemoryStats(core::MemoryStats* stats) const;
+
  private:
   absl::Status Init(
       std::unique_ptr<SearchOptions> options,
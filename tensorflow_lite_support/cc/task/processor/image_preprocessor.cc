@@ -19,7 +19,10 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/fused_preprocessing.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_normalization.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/task_executor_band_executor.h"
 
 namespace tflite {
 namespace task {
@@ -31,19 +34,46 @@ static constexpr int kRgbPixelBytes = 3;
 
 using ::tflite::task::vision::BoundingBox;
 using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::NormalizationOptions;
+
+absl::Status CheckNormalizationOptions(
+    const NormalizationOptions& normalization_options) {
+  for (int i = 0; i < normalization_options.num_values; i++) {
+    if (std::abs(normalization_options.std_values[i]) <
+        std::numeric_limits<float>::epsilon()) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInternal,
+          "NormalizationOptions.std_values can't be 0. Please check if the "
+          "tensor metadata has been populated correctly.");
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Returns the per-channel normalization `values`, which may hold a single value
+// shared by all channels.
+std::array<float, 3> GetPerChannelValues(const std::array<float, 3>& values,
+                                         int num_values) {
+  if (num_values == 1) {
+    return {values[0], values[0], values[0]};
+  }
+  return values;
+}
 }  // namespace
 
 /* static */
 tflite::support::StatusOr<std::unique_ptr<ImagePreprocessor>>
 ImagePreprocessor::Create(
     core::TfLiteEngine* engine, const std::initializer_list<int> input_indices,
-    const vision::FrameBufferUtils::ProcessEngine& process_engine) {
+    const vision::FrameBufferUtils::ProcessEngine& process_engine,
+    std::shared_ptr<vision::ScratchBufferPool> scratch_buffer_pool) {
   ASSIGN_OR_RETURN(auto processor,
                    Processor::Create<ImagePreprocessor>(
                        /* num_expected_tensors = */ 1, engine, input_indices,
                        /* requires_metadata = */ false));
 
-  RETURN_IF_ERROR(processor->Init(process_engine));
+  RETURN_IF_ERROR(
+      processor->Init(process_engine, std::move(scratch_buffer_pool)));
   return processor;
 }
 
@@ -60,8 +90,10 @@ bool ImagePreprocessor::IsImagePreprocessingNeeded(
   // Are image transformations required?
   if (frame_buffer.orientation() != FrameBuffer::Orientation::kTopLeft ||
       frame_buffer.format() != FrameBuffer::Format::kRGB ||
-      frame_buffer.dimension().width != input_specs_.image_width ||
-      frame_buffer.dimension().height != input_specs_.image_height) {
+      (!is_width_mutable_ &&
+       frame_buffer.dimension().width != input_specs_.image_width) ||
+      (!is_height_mutable_ &&
+       frame_buffer.dimension().height != input_specs_.image_height)) {
     return true;
   }
 
@@ -69,8 +101,13 @@ bool ImagePreprocessor::IsImagePreprocessingNeeded(
 }
 
 absl::Status ImagePreprocessor::Init(
-    const vision::FrameBufferUtils::ProcessEngine& process_engine) {
-  frame_buffer_utils_ = vision::FrameBufferUtils::Create(process_engine);
+    const vision::FrameBufferUtils::ProcessEngine& process_engine,
+    std::shared_ptr<vision::ScratchBufferPool> scratch_buffer_pool) {
+  scratch_buffer_pool_ = scratch_buffer_pool != nullptr
+                             ? std::move(scratch_buffer_pool)
+                             : std::make_shared<vision::ScratchBufferPool>();
+  process_engine_ = process_engine;
+  ResetFrameBufferUtils();
 
   ASSIGN_OR_RETURN(input_specs_, vision::BuildInputImageTensorSpecs(
                                      *engine_->interpreter(),
@@ -91,9 +128,75 @@ absl::Status ImagePreprocessor::Init(
     is_height_mutable_ = dims_signature->data[1] == -1;
     is_width_mutable_ = dims_signature->data[2] == -1;
   }
+
+  if (input_specs_.tensor_type == kTfLiteInt8) {
+    const TfLiteQuantizationParams& quantization_params = GetTensor()->params;
+    if (quantization_params.scale <= 0) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "kTfLiteInt8 input tensors require a positive quantization scale.",
+          tflite::support::TfLiteSupportStatus::kInvalidInputTensorTypeError);
+    }
+    // Without NormalizationOptions, pixel values are quantized as-is.
+    NormalizationOptions normalization_options{
+        /*mean_values=*/{0.0f, 0.0f, 0.0f},
+        /*std_values=*/{1.0f, 1.0f, 1.0f},
+        /*num_values=*/1};
+    if (input_specs_.normalization_options.has_value()) {
+      normalization_options = input_specs_.normalization_options.value();
+      RETURN_IF_ERROR(CheckNormalizationOptions(normalization_options));
+    }
+    int8_quantization_table_ = vision::BuildInt8QuantizationTable(
+        normalization_options.mean_values, normalization_options.std_values,
+        normalization_options.num_values, quantization_params.scale,
+        quantization_params.zero_point);
+  }
   return absl::OkStatus();
 }
 
+void ImagePreprocessor::SetProcessEngine(
+    const vision::FrameBufferUtils::ProcessEngine& process_engine) {
+  process_engine_ = process_engine;
+  ResetFrameBufferUtils();
+}
+
+void ImagePreprocessor::SetExecutor(
+    std::shared_ptr<core::TaskExecutor> executor) {
+  band_executor_ =
+      executor != nullptr
+          ? std::make_shared<vision::TaskExecutorBandExecutor>(
+                std::move(executor))
+          : nullptr;
+  ResetFrameBufferUtils();
+}
+
+void ImagePreprocessor::ResetFrameBufferUtils() {
+  frame_buffer_utils_ = vision::FrameBufferUtils::Create(
+      process_engine_, scratch_buffer_pool_, band_executor_);
+}
+
+absl::Status ImagePreprocessor::ResizeInputTensorIfNeeded(int image_width,
+                                                          int image_height) {
+  // If dynamic, it will re-dim the entire graph as per the input.
+  if (!is_height_mutable_ && !is_width_mutable_) {
+    return absl::OkStatus();
+  }
+  if (engine_->input_batch_size() != 1) {
+    return tflite::support::CreateStatusWithPayload(
+        absl::StatusCode::kFailedPrecondition,
+        "Batched inference is not supported for models with dynamic input "
+        "image dimensions.",
+        tflite::support::TfLiteSupportStatus::
+            kInvalidInputTensorDimensionsError);
+  }
+  // No-op if the input already has these dimensions, e.g. if the previous
+  // frame had the same size.
+  return engine_->ResizeInputTensors(
+      {{tensor_indices_.at(0),
+        {GetTensor()->dims->data[0], image_height, image_width,
+         GetTensor()->dims->data[3]}}});
+}
+
 absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer) {
   BoundingBox roi;
   roi.set_width(frame_buffer.dimension().width);
@@ -112,27 +215,58 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
 
   // Optional buffers in case image preprocessing is needed.
   std::unique_ptr<FrameBuffer> preprocessed_frame_buffer;
-  std::vector<uint8> preprocessed_data;
+  vision::ScratchBufferPool::Buffer preprocessed_data;
+
+  // Target image dimensions. These are kept local (rather than updating
+  // `input_specs_`) so that concurrent calls on pooled interpreters don't
+  // interfere.
+  const int image_width =
+      is_width_mutable_ ? roi.width() : input_specs_.image_width;
+  const int image_height =
+      is_height_mutable_ ? roi.height() : input_specs_.image_height;
 
-  if (IsImagePreprocessingNeeded(frame_buffer, roi)) {
+  const bool is_image_preprocessing_needed =
+      IsImagePreprocessingNeeded(frame_buffer, roi);
+  if (fused_preprocessing_ && is_image_preprocessing_needed &&
+      input_specs_.tensor_type == kTfLiteFloat32) {
+    // Preprocess and normalize the input image straight into the input tensor.
+    RETURN_IF_ERROR(ResizeInputTensorIfNeeded(image_width, image_height));
+    if (GetTensor()->bytes / sizeof(float) !=
+        static_cast<size_t>(image_width) * image_height * kRgbPixelBytes) {
+      return tflite::support::CreateStatusWithPayload(
+          absl::StatusCode::kInternal,
+          "Size mismatch or unsupported padding bytes between pixel data "
+          "and input tensor.");
+    }
+    ASSIGN_OR_RETURN(
+        float* normalized_input_data,
+        tflite::task::core::AssertAndReturnTypedTensor<float>(GetTensor()));
+    const NormalizationOptions& normalization_options =
+        input_specs_.normalization_options.value();
+    RETURN_IF_ERROR(CheckNormalizationOptions(normalization_options));
+    return vision::FusedPreprocess(
+        frame_buffer, roi, {image_width, image_height},
+        GetPerChannelValues(normalization_options.mean_values,
+                            normalization_options.num_values),
+        GetPerChannelValues(normalization_options.std_values,
+                            normalization_options.num_values),
+        normalized_input_data);
+  }
+
+  if (is_image_preprocessing_needed) {
     // Preprocess input image to fit model requirements.
     // For now RGB is the only color space supported, which is ensured by
     // `InitInternal`.
-    input_specs_.image_width =
-        is_width_mutable_ ? roi.width() : input_specs_.image_width;
-    input_specs_.image_height =
-        is_height_mutable_ ? roi.height() : input_specs_.image_height;
-
-    FrameBuffer::Dimension to_buffer_dimension = {input_specs_.image_width,
-                                                  input_specs_.image_height};
+    FrameBuffer::Dimension to_buffer_dimension = {image_width, image_height};
     input_data_byte_size =
         GetBufferByteSize(to_buffer_dimension, FrameBuffer::Format::kRGB);
-    preprocessed_data.resize(input_data_byte_size / sizeof(uint8), 0);
+    preprocessed_data = frame_buffer_utils_->scratch_buffer_pool()->Acquire(
+        input_data_byte_size);
     input_data = preprocessed_data.data();
 
     FrameBuffer::Plane preprocessed_plane = {
         /*buffer=*/preprocessed_data.data(),
-        /*stride=*/{input_specs_.image_width * kRgbPixelBytes, kRgbPixelBytes}};
+        /*stride=*/{image_width * kRgbPixelBytes, kRgbPixelBytes}};
     preprocessed_frame_buffer = FrameBuffer::Create(
         {preprocessed_plane}, to_buffer_dimension, FrameBuffer::Format::kRGB,
         FrameBuffer::Orientation::kTopLeft);
@@ -147,14 +281,7 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
                            frame_buffer.dimension().height;
   }
 
-  // If dynamic, it will re-dim the entire graph as per the input.
-  if (is_height_mutable_ || is_width_mutable_) {
-    engine_->interpreter()->ResizeInputTensorStrict(
-        0, {GetTensor()->dims->data[0], input_specs_.image_height,
-            input_specs_.image_width, GetTensor()->dims->data[3]});
-
-    engine_->interpreter()->AllocateTensors();
-  }
+  RETURN_IF_ERROR(ResizeInputTensorIfNeeded(image_width, image_height));
   // Then normalize pixel data (if needed) and populate the input tensor.
   switch (input_specs_.tensor_type) {
     case kTfLiteUInt8:
@@ -180,43 +307,31 @@ absl::Status ImagePreprocessor::Preprocess(const FrameBuffer& frame_buffer,
       ASSIGN_OR_RETURN(
           float* normalized_input_data,
           tflite::task::core::AssertAndReturnTypedTensor<float>(GetTensor()));
-      const tflite::task::vision::NormalizationOptions& normalization_options =
+      const NormalizationOptions& normalization_options =
           input_specs_.normalization_options.value();
-      for (int i = 0; i < normalization_options.num_values; i++) {
-        if (std::abs(normalization_options.std_values[i]) <
-            std::numeric_limits<float>::epsilon()) {
-          return tflite::support::CreateStatusWithPayload(
-              absl::StatusCode::kInternal,
-              "NormalizationOptions.std_values can't be 0. Please check if the "
-              "tensor metadata has been populated correctly.");
-        }
-      }
-      if (normalization_options.num_values == 1) {
-        float mean_value = normalization_options.mean_values[0];
-        float inv_std_value = (1.0f / normalization_options.std_values[0]);
-        for (size_t i = 0; i < input_data_byte_size / sizeof(uint8);
-             i++, input_data++, normalized_input_data++) {
-          *normalized_input_data =
-              inv_std_value * (static_cast<float>(*input_data) - mean_value);
-        }
-      } else {
-        std::array<float, 3> inv_std_values = {
-            1.0f / normalization_options.std_values[0],
-            1.0f / normalization_options.std_values[1],
-            1.0f / normalization_options.std_values[2]};
-        for (size_t i = 0; i < input_data_byte_size / sizeof(uint8);
-             i++, input_data++, normalized_input_data++) {
-          *normalized_input_data = inv_std_values[i % 3] *
-                                   (static_cast<float>(*input_data) -
-                                    normalization_options.mean_values[i % 3]);
-        }
+      RETURN_IF_ERROR(CheckNormalizationOptions(normalization_options));
+      vision::NormalizeToFloat(input_data, input_data_byte_size / sizeof(uint8),
+                               normalization_options.num_values,
+                               normalization_options.mean_values,
+                               normalization_options.std_values,
+                               normalized_input_data);
+      break;
+    }
+    case kTfLiteInt8: {
+      if (GetTensor()->bytes != input_data_byte_size) {
+        return tflite::support::CreateStatusWithPayload(
+            absl::StatusCode::kInternal,
+            "Size mismatch or unsupported padding bytes between pixel data "
+            "and input tensor.");
       }
+      // Requantize and populate.
+      ASSIGN_OR_RETURN(
+          int8_t* quantized_input_data,
+          tflite::task::core::AssertAndReturnTypedTensor<int8_t>(GetTensor()));
+      vision::QuantizeToInt8(input_data, input_data_byte_size / sizeof(uint8),
+                             int8_quantization_table_, quantized_input_data);
       break;
     }
-    case kTfLiteInt8:
-      return tflite::support::CreateStatusWithPayload(
-          absl::StatusCode::kUnimplemented,
-          "kTfLiteInt8 input type is not implemented yet.");
     default:
       return tflite::support::CreateStatusWithPayload(
           absl::StatusCode::kInternal, "Unexpected input tensor type.");
@@ -16,12 +16,18 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_IMAGE_PREPROCESSOR_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_PROCESSOR_IMAGE_PREPROCESSOR_H_
 
+#include <memory>
+
 #include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
 #include "tensorflow_lite_support/cc/task/processor/processor.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/band_executor.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_normalization.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_tensor_specs.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
 
 namespace tflite {
 namespace task {
@@ -29,19 +35,28 @@ namespace processor {
 
 // Process input image and populate the associate input tensor.
 // Requirement for the input tensor:
-//   (kTfLiteUInt8/kTfLiteFloat32)
+//   (kTfLiteUInt8/kTfLiteInt8/kTfLiteFloat32)
 //    - image input of size `[batch x height x width x channels]`.
-//    - batch inference is not supported (`batch` is required to be 1).
+//    - `batch` is required to be 1 in the model. Batched inference is
+//      supported through `BaseTaskApi::InferBatch`, in which case each image
+//      is written to its own slot of the resized input tensor.
 //    - only RGB inputs are supported (`channels` is required to be 3).
 //    - if type is kTfLiteFloat32, NormalizationOptions are required to be
 //      attached to the metadata for input normalization.
+//    - if type is kTfLiteInt8, pixels are requantized according to the tensor
+//      quantization parameters, after applying the NormalizationOptions from
+//      the metadata if any.
 class ImagePreprocessor : public Preprocessor {
  public:
+  // Intermediate image buffers are acquired from `scratch_buffer_pool`, which
+  // can be shared with other preprocessors. A pool owned by the preprocessor is
+  // used if none is provided.
   static tflite::support::StatusOr<std::unique_ptr<ImagePreprocessor>> Create(
       core::TfLiteEngine* engine,
       const std::initializer_list<int> input_indices,
       const vision::FrameBufferUtils::ProcessEngine& process_engine =
-          vision::FrameBufferUtils::ProcessEngine::kLibyuv);
+          vision::FrameBufferUtils::ProcessEngine::kLibyuv,
+      std::shared_ptr<vision::ScratchBufferPool> scratch_buffer_pool = nullptr);
 
   // Processes the provided FrameBuffer and populate tensor values.
   //
@@ -75,6 +90,33 @@ class ImagePreprocessor : public Preprocessor {
   // the inference as it bypasses image cropping and resizing.
   const vision::ImageTensorSpecs& GetInputSpecs() const { return input_specs_; }
 
+  // Enables or disables fused preprocessing (disabled by default). When
+  // enabled and the input tensor is kTfLiteFloat32, cropping, resizing, color
+  // space conversion, rotation and normalization are performed in a single
+  // pass writing directly into the input tensor, instead of going through
+  // intermediate RGB buffers. See `vision::FusedPreprocess` for details.
+  //
+  // Must not be called concurrently with `Preprocess`.
+  void SetFusedPreprocessing(bool enabled) { fused_preprocessing_ = enabled; }
+
+  // Replaces the engine performing the image processing operations, e.g. to
+  // switch to `vision::FrameBufferUtils::ProcessEngine::kSimd`. Intermediate
+  // image buffers keep being acquired from the same pool.
+  //
+  // Must not be called concurrently with `Preprocess`.
+  void SetProcessEngine(
+      const vision::FrameBufferUtils::ProcessEngine& process_engine);
+
+  // Splits the image processing operations on large images into bands of rows
+  // processed in parallel on the threads of `executor` and the calling thread,
+  // with identical results. See `vision::ParallelFrameBufferUtils` for the
+  // supported operations. The executor can be shared, e.g. with the
+  // asynchronous inference methods of the task. Passing null restores serial
+  // processing, the default.
+  //
+  // Must not be called concurrently with `Preprocess`.
+  void SetExecutor(std::shared_ptr<core::TaskExecutor> executor);
+
  private:
   using Preprocessor::Preprocessor;
 
@@ -83,7 +125,16 @@ class ImagePreprocessor : public Preprocessor {
                                   const vision::BoundingBox& roi);
 
   absl::Status Init(
-      const vision::FrameBufferUtils::ProcessEngine& process_engine);
+      const vision::FrameBufferUtils::ProcessEngine& process_engine,
+      std::shared_ptr<vision::ScratchBufferPool> scratch_buffer_pool);
+
+  // Rebuilds `frame_buffer_utils_` from `process_engine_` and
+  // `band_executor_`.
+  void ResetFrameBufferUtils();
+
+  // Resizes the input tensor to the provided image dimensions, if the model
+  // has dynamic input shape.
+  absl::Status ResizeInputTensorIfNeeded(int image_width, int image_height);
 
   // Parameters related to the input tensor which represents an image.
   vision::ImageTensorSpecs input_specs_;
@@ -91,9 +142,24 @@ class ImagePreprocessor : public Preprocessor {
   // Utils for input image preprocessing (resizing, colorspace conversion, etc).
   std::unique_ptr<vision::FrameBufferUtils> frame_buffer_utils_;
 
+  // Pool the intermediate image buffers of `frame_buffer_utils_` are acquired
+  // from.
+  std::shared_ptr<vision::ScratchBufferPool> scratch_buffer_pool_;
+
+  // Engine and executor `frame_buffer_utils_` is built with.
+  vision::FrameBufferUtils::ProcessEngine process_engine_ =
+      vision::FrameBufferUtils::ProcessEngine::kLibyuv;
+  std::shared_ptr<vision::BandExecutor> band_executor_;
+
   // Is true if the model expects dynamic image shape, false otherwise.
   bool is_height_mutable_ = false;
   bool is_width_mutable_ = false;
+
+  // Whether to use `vision::FusedPreprocess` for float input tensors.
+  bool fused_preprocessing_ = false;
+
+  // Maps pixel values to int8 values, for kTfLiteInt8 input tensors only.
+  vision::Int8QuantizationTable int8_quantization_table_;
 };
 
 }  // namespace processor
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
 
 namespace tflite {
@@ -74,6 +75,10 @@ class Processor {
   absl::Status SanityCheck(int num_expected_tensors,
                            bool requires_metadata = true);
 
+  // Adds the memory owned by the processor, e.g. label maps or tokenizer
+  // vocabularies, to `stats`. Does nothing by default.
+  virtual void AddMemoryStats(core::MemoryStats* stats) const {}
+
  protected:
   // Gets the associated tensor.
   // `i` refers to the element index in `tensor_indices`. For example,
@@ -129,7 +134,7 @@ class Preprocessor : public Processor {
   // Get the associated input tensor.
   // Note: Caller is responsible for passing in a valid `i`.
   inline TfLiteTensor* GetTensor(int i = 0) const override {
-    return engine_->GetInput(engine_->interpreter(), tensor_indices_.at(i));
+    return engine_->GetInputTensor(tensor_indices_.at(i));
   }
 
   // Get the associated input metadata.
@@ -170,7 +175,7 @@ class Postprocessor : public Processor {
   // Get the associated output tensor.
   // Note: Caller is responsible for passing in a valid `i`.
   inline TfLiteTensor* GetTensor(int i = 0) const override {
-    return engine_->GetOutput(engine_->interpreter(), tensor_indices_.at(i));
+    return engine_->GetOutputTensor(tensor_indices_.at(i));
   }
 
   // Get the associated output metadata.
@@ -120,6 +120,10 @@ StatusOr<absl::string_view> SearchPostprocessor::GetUserInfo() {
   return embedding_searcher_->GetUserInfo();
 }
 
+void SearchPostprocessor::AddMemoryStats(core::MemoryStats* stats) const {
+  embedding_searcher_->AddMemoryStats(stats);
+}
+
 absl::Status SearchPostprocessor::Init(
     std::unique_ptr<EmbeddingPostprocessor> embedding_postprocessor,
     std::unique_ptr<SearchOptions> options) {
@@ -60,6 +60,8 @@ class SearchPostprocessor : public Postprocessor {
   // user info.
   tflite::support::StatusOr<absl::string_view> GetUserInfo();
 
+  void AddMemoryStats(core::MemoryStats* stats) const override;
+
  private:
   using Postprocessor::Postprocessor;
 
@@ -65,6 +65,11 @@ class BertCluAnnotator : public CluAnnotator {
       const std::vector<const TfLiteTensor*>& output_tensors,
       const CluRequest& request) override;
 
+  // Accounts for the tokenizer vocabulary.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    stats->task_bytes["tokenizer"] += tokenizer_->EstimateMemoryUsage();
+  }
+
   std::unique_ptr<tflite::support::text::tokenizer::Tokenizer> tokenizer_;
 
   // A list of modules in topological ordering.
@@ -117,6 +117,12 @@ class BertNLClassifier : public tflite::task::text::nlclassifier::NLClassifier {
       const std::vector<const TfLiteTensor*>& output_tensors,
       const std::string& input) override;
 
+  // Accounts for the tokenizer vocabulary and labels.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    NLClassifier::AddTaskMemoryStats(stats);
+    preprocessor_->AddMemoryStats(stats);
+  }
+
  private:
   // Initialize the API with the tokenizer and label files set in the metadata.
   absl::Status Initialize(std::unique_ptr<BertNLClassifierOptions> options);
@@ -126,6 +126,11 @@ class BertQuestionAnswerer : public QuestionAnswerer {
       const std::string& lowercased_context,
       const std::string& lowercased_query) override;
 
+  // Accounts for the tokenizer vocabulary.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    stats->task_bytes["tokenizer"] += tokenizer_->EstimateMemoryUsage();
+  }
+
   // Initialize API with a BertTokenizer from the vocabulary file.
   void InitializeBertTokenizer(const std::string& path_to_vocab);
   // Initialize API with a BertTokenizer from the vocabulary buffer.
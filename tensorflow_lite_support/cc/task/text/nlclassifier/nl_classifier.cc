@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
 #include "tensorflow_lite_support/cc/task/core/category.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
 #include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/utils/common_utils.h"
@@ -145,6 +146,16 @@ StatusOr<std::vector<Category>> NLClassifier::Postprocess(
           struct_options_.output_label_tensor_index));
 }
 
+void NLClassifier::AddTaskMemoryStats(core::MemoryStats* stats) const {
+  if (preprocessor_ != nullptr) {
+    preprocessor_->AddMemoryStats(stats);
+  }
+  if (labels_vector_ != nullptr) {
+    stats->task_bytes["label_maps"] +=
+        core::EstimateHeapMemoryUsage(*labels_vector_);
+  }
+}
+
 std::vector<Category> NLClassifier::BuildResults(const TfLiteTensor* scores,
                                                  const TfLiteTensor* labels) {
   bool use_index_as_labels = (labels_vector_ == nullptr) && (labels == nullptr);
@@ -175,6 +175,9 @@ class NLClassifier : public core::BaseTaskApi<std::vector<core::Category>,
       const std::vector<const TfLiteTensor*>& output_tensors,
       const std::string& input) override;
 
+  // Accounts for the tokenizer vocabulary and labels.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override;
+
   std::vector<core::Category> BuildResults(const TfLiteTensor* scores,
                                            const TfLiteTensor* labels);
 
@@ -169,6 +169,11 @@ tflite::support::StatusOr<EmbeddingResult> TextEmbedder::Embed(
   return InferWithFallback(text);
 }
 
+tflite::support::StatusOr<EmbeddingResult> TextEmbedder::Embed(
+    const std::string& text, absl::string_view signature_key) {
+  return InferWithSignature(signature_key, text);
+}
+
 absl::Status TextEmbedder::Preprocess(
     const std::vector<TfLiteTensor*>& input_tensors, const std::string& input) {
   return preprocessor_->Preprocess(input);
@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/kernels/register.h"
 #include "tensorflow_lite_support/cc/port/statusor.h"
@@ -70,6 +71,14 @@ class TextEmbedder
   tflite::support::StatusOr<processor::EmbeddingResult> Embed(
       const std::string& text);
 
+  // Same as above, except that the signature of the model with the provided
+  // key (see `GetSignatureKeys`) is run instead of its primary subgraph, e.g.
+  // to embed queries and documents with two encoders sharing the same weights.
+  // Its inputs and outputs, sorted by name, must match those of the primary
+  // subgraph. See `BaseTaskApi::InferWithSignature`.
+  tflite::support::StatusOr<processor::EmbeddingResult> Embed(
+      const std::string& text, absl::string_view signature_key);
+
   // Returns the dimensionality of the embedding output by the output_index'th
   // output layer. Returns -1 if `output_index` is out of bounds.
   int GetEmbeddingDimension(int output_index) const;
@@ -102,6 +111,11 @@ class TextEmbedder
   // Initializes the TextEmbedder.
   absl::Status Init(std::unique_ptr<TextEmbedderOptions> options);
 
+  // Accounts for the tokenizer vocabulary, if any.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    preprocessor_->AddMemoryStats(stats);
+  }
+
  private:
   std::unique_ptr<tflite::task::processor::TextPreprocessor> preprocessor_ =
       nullptr;
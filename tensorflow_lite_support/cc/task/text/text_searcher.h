@@ -102,6 +102,12 @@ class TextSearcher
   // Initializes the TextSearcher.
   absl::Status Init(std::unique_ptr<TextSearcherOptions> options);
 
+  // Accounts for the tokenizer vocabulary, if any, and the search index.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    preprocessor_->AddMemoryStats(stats);
+    postprocessor_->AddMemoryStats(stats);
+  }
+
  private:
   std::unique_ptr<tflite::task::processor::TextPreprocessor> preprocessor_;
   std::unique_ptr<tflite::task::processor::SearchPostprocessor> postprocessor_;
@@ -55,11 +55,31 @@ class BaseVisionTaskApi
   BaseVisionTaskApi(const BaseVisionTaskApi&) = delete;
   BaseVisionTaskApi& operator=(const BaseVisionTaskApi&) = delete;
 
-  // Sets the ProcessEngine used for image pre-processing. Must be called before
-  // any inference is performed. Can be called between inferences to override
-  // the current process engine.
+  // Sets the ProcessEngine used for image pre-processing, e.g.
+  // `FrameBufferUtils::ProcessEngine::kSimd` for hand-vectorized resizing and
+  // conversion to RGB. Can be called between inferences to override the current
+  // process engine.
+  //
+  // Must not be called concurrently with inference.
   void SetProcessEngine(const FrameBufferUtils::ProcessEngine& process_engine) {
     process_engine_ = process_engine;
+    if (preprocessor_ != nullptr) {
+      preprocessor_->SetProcessEngine(process_engine);
+    }
+  }
+
+  // Enables or disables fused image pre-processing for models with float
+  // inputs, which crops, resizes, converts, rotates and normalizes the input
+  // frame buffer in a single pass straight into the input tensor. Results are
+  // close to, but not bit-exact with, the default pre-processing. See
+  // `processor::ImagePreprocessor::SetFusedPreprocessing`.
+  //
+  // Must not be called concurrently with inference.
+  void SetFusedPreprocessing(bool enabled) {
+    fused_preprocessing_ = enabled;
+    if (preprocessor_ != nullptr) {
+      preprocessor_->SetFusedPreprocessing(enabled);
+    }
   }
 
  protected:
@@ -75,6 +95,7 @@ class BaseVisionTaskApi
     ASSIGN_OR_RETURN(preprocessor_,
                      ::tflite::task::processor::ImagePreprocessor::Create(
                          this->GetTfLiteEngine(), {0}, process_engine_));
+    preprocessor_->SetFusedPreprocessing(fused_preprocessing_);
     return absl::OkStatus();
   }
 
@@ -123,6 +144,7 @@ class BaseVisionTaskApi
 
  private:
   std::unique_ptr<processor::ImagePreprocessor> preprocessor_ = nullptr;
+  bool fused_preprocessing_ = false;
 };
 
 }  // namespace vision
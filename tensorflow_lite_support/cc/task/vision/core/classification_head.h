@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_CORE_CLASSIFICATION_HEAD_ITEM_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_CORE_CLASSIFICATION_HEAD_ITEM_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -103,6 +104,9 @@ tflite::support::StatusOr<ClassificationHead> BuildClassificationHead(
     const tflite::TensorMetadata& output_tensor_metadata,
     absl::string_view display_names_locale = absl::string_view());
 
+// Returns the approximate memory used by `head`, i.e. mostly its label map.
+int64_t EstimateMemoryUsage(const ClassificationHead& head);
+
 }  // namespace vision
 }  // namespace task
 }  // namespace tflite
@@ -0,0 +1,179 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/detection_cascade.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+namespace {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::StatusOr;
+using ::tflite::support::TfLiteSupportStatus;
+
+// Returns the score of the top class of the detection, or 0 if it has none.
+float GetDetectionScore(const Detection& detection) {
+  return detection.classes().empty() ? 0.0f : detection.classes(0).score();
+}
+
+// Returns the bounding box of the detection enlarged by `margin` on each side
+// and clamped to the frame, which may be empty.
+BoundingBox GetClassificationRoi(const BoundingBox& box, float margin,
+                                 const FrameBuffer::Dimension& dimension) {
+  const float margin_x = margin * box.width();
+  const float margin_y = margin * box.height();
+  const int left =
+      std::max(0, static_cast<int>(std::floor(box.origin_x() - margin_x)));
+  const int top =
+      std::max(0, static_cast<int>(std::floor(box.origin_y() - margin_y)));
+  const int right = std::min(
+      dimension.width,
+      static_cast<int>(std::ceil(box.origin_x() + box.width() + margin_x)));
+  const int bottom = std::min(
+      dimension.height,
+      static_cast<int>(std::ceil(box.origin_y() + box.height() + margin_y)));
+  BoundingBox roi;
+  roi.set_origin_x(left);
+  roi.set_origin_y(top);
+  roi.set_width(std::max(0, right - left));
+  roi.set_height(std::max(0, bottom - top));
+  return roi;
+}
+
+}  // namespace
+
+/* static */
+StatusOr<std::unique_ptr<DetectionCascade>> DetectionCascade::Create(
+    ObjectDetector* object_detector, ImageClassifier* image_classifier,
+    const DetectionCascadeOptions& options) {
+  if (image_classifier == nullptr) {
+    return CreateStatusWithPayload(StatusCode::kInvalidArgument,
+                                   "Expected non-null `image_classifier`.",
+                                   TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (options.box_margin < 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected `box_margin` >= 0, got %f.",
+                        options.box_margin),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  if (options.max_batch_size < 0) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected `max_batch_size` >= 0, got %d.",
+                        options.max_batch_size),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  return absl::WrapUnique(
+      new DetectionCascade(object_detector, image_classifier, options));
+}
+
+StatusOr<std::vector<ClassifiedDetection>> DetectionCascade::Run(
+    const FrameBuffer& frame_buffer) {
+  if (object_detector_ == nullptr) {
+    return CreateStatusWithPayload(
+        StatusCode::kFailedPrecondition,
+        "Running the cascade requires an object detector: use "
+        "ClassifyDetections instead.");
+  }
+  ASSIGN_OR_RETURN(DetectionResult detection_result,
+                   object_detector_->Detect(frame_buffer));
+  return ClassifyDetections(frame_buffer, detection_result);
+}
+
+StatusOr<std::vector<ClassifiedDetection>>
+DetectionCascade::ClassifyDetections(const FrameBuffer& frame_buffer,
+                                     const DetectionResult& detection_result) {
+  // Select the detections to classify, by decreasing score.
+  std::vector<int> indices(detection_result.detections_size());
+  std::iota(indices.begin(), indices.end(), 0);
+  std::stable_sort(indices.begin(), indices.end(), [&](int a, int b) {
+    return GetDetectionScore(detection_result.detections(a)) >
+           GetDetectionScore(detection_result.detections(b));
+  });
+  std::vector<ClassifiedDetection> results;
+  std::vector<BoundingBox> rois;
+  for (int index : indices) {
+    if (options_.max_detections >= 0 &&
+        static_cast<int>(results.size()) >= options_.max_detections) {
+      break;
+    }
+    const Detection& detection = detection_result.detections(index);
+    if (GetDetectionScore(detection) < options_.min_detection_score) {
+      break;
+    }
+    BoundingBox roi =
+        GetClassificationRoi(detection.bounding_box(), options_.box_margin,
+                             frame_buffer.dimension());
+    if (roi.width() == 0 || roi.height() == 0) {
+      continue;
+    }
+    rois.push_back(roi);
+    results.emplace_back();
+    results.back().detection = detection;
+    results.back().roi = std::move(roi);
+  }
+  if (results.empty()) {
+    return results;
+  }
+
+  // Classify the crops, in batches if enabled.
+  if (options_.max_batch_size == 1) {
+    for (ClassifiedDetection& result : results) {
+      ASSIGN_OR_RETURN(result.classification_result,
+                       image_classifier_->Classify(frame_buffer, result.roi));
+    }
+    return results;
+  }
+  const int num_rois = static_cast<int>(rois.size());
+  const std::vector<const FrameBuffer*> frame_buffers(num_rois, &frame_buffer);
+  const int batch_size =
+      options_.max_batch_size > 0 ? options_.max_batch_size : num_rois;
+  for (int start = 0; start < num_rois; start += batch_size) {
+    const int size = std::min(batch_size, num_rois - start);
+    ASSIGN_OR_RETURN(
+        std::vector<ClassificationResult> classification_results,
+        image_classifier_->ClassifyBatch(
+            absl::MakeConstSpan(frame_buffers).subspan(start, size),
+            absl::MakeConstSpan(rois).subspan(start, size)));
+    for (int i = 0; i < size; ++i) {
+      results[start + i].classification_result =
+          std::move(classification_results[i]);
+    }
+  }
+  return results;
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
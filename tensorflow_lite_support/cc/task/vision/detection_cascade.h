@@ -0,0 +1,116 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_DETECTION_CASCADE_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_DETECTION_CASCADE_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/object_detector.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Options for `DetectionCascade`.
+struct DetectionCascadeOptions {
+  // Detections whose score (i.e. the score of their top class) is lower are
+  // not classified.
+  float min_detection_score = 0.0f;
+
+  // Maximum number of detections classified per frame, by decreasing score.
+  // Negative for no limit.
+  int max_detections = -1;
+
+  // Margin added on each side of the bounding boxes before cropping, as a
+  // fraction of their width (resp. height), e.g. to give the classifier some
+  // context around the objects. Boxes are then clamped to the frame.
+  float box_margin = 0.0f;
+
+  // Maximum number of crops classified per classifier invocation, or 0 to
+  // classify all the crops of a frame in a single invocation. Batching requires
+  // the classifier model to have a leading batch dimension on all its inputs
+  // and outputs (see `ImageClassifier::ClassifyBatch`): set this to 1 for
+  // other models, so that crops are classified one at a time.
+  int max_batch_size = 0;
+};
+
+// A detection, along with the classification of its crop.
+struct ClassifiedDetection {
+  // The detection, as returned by the object detector.
+  Detection detection;
+  // The region of the frame that was classified, i.e. the bounding box of the
+  // detection after applying the margin and clamping it to the frame.
+  BoundingBox roi;
+  ClassificationResult classification_result;
+};
+
+// Two-stage pipeline running an `ObjectDetector` on a frame, then an
+// `ImageClassifier` on the crops of the frame around the detected objects.
+//
+// Instead of classifying each detection through a separate `Classify` call,
+// which invokes the classifier model once per object, all the crops of a frame
+// are written to the slots of a batched input tensor and classified in a
+// single invocation, which makes crowded scenes much cheaper to process.
+//
+// This class is thread-compatible, like the tasks it runs.
+class DetectionCascade {
+ public:
+  // Creates a cascade running the provided tasks, which are not owned and must
+  // outlive the cascade. `object_detector` may be null if only
+  // `ClassifyDetections` is used.
+  static tflite::support::StatusOr<std::unique_ptr<DetectionCascade>> Create(
+      ObjectDetector* object_detector, ImageClassifier* image_classifier,
+      const DetectionCascadeOptions& options = DetectionCascadeOptions());
+
+  // Detects the objects in `frame_buffer`, then classifies them. See
+  // `ObjectDetector::Detect` for the supported frame buffers. The results are
+  // sorted by decreasing detection score.
+  tflite::support::StatusOr<std::vector<ClassifiedDetection>> Run(
+      const FrameBuffer& frame_buffer);
+
+  // Same as above, except that the detections, e.g. produced by another
+  // detector, are provided. Their bounding boxes are expressed in the unrotated
+  // frame of reference coordinates system of `frame_buffer`, as returned by
+  // `ObjectDetector::Detect`.
+  tflite::support::StatusOr<std::vector<ClassifiedDetection>>
+  ClassifyDetections(const FrameBuffer& frame_buffer,
+                     const DetectionResult& detection_result);
+
+ private:
+  DetectionCascade(ObjectDetector* object_detector,
+                   ImageClassifier* image_classifier,
+                   const DetectionCascadeOptions& options)
+      : object_detector_(object_detector),
+        image_classifier_(image_classifier),
+        options_(options) {}
+
+  ObjectDetector* object_detector_;
+  ImageClassifier* image_classifier_;
+  DetectionCascadeOptions options_;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_DETECTION_CASCADE_H_
@@ -15,12 +15,19 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
 
+#include <cstdint>
+#include <future>  // NOLINT(build/c++11)
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include "absl/algorithm/container.h"  // from @com_google_absl
 #include "absl/strings/str_format.h"  // from @com_google_absl
 #include "absl/strings/string_view.h"  // from @com_google_absl
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
 #include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
 #include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
@@ -383,6 +390,65 @@ StatusOr<ClassificationResult> ImageClassifier::Classify(
   return InferWithFallback(frame_buffer, roi);
 }
 
+StatusOr<ClassificationResult> ImageClassifier::Classify(
+    const FrameBuffer& frame_buffer, const BoundingBox& roi,
+    absl::Time deadline) {
+  return InferWithFallbackWithDeadline(deadline, frame_buffer, roi);
+}
+
+StatusOr<ClassificationResult> ImageClassifier::Classify(
+    const FrameBuffer& frame_buffer, const BoundingBox& roi,
+    absl::string_view signature_key) {
+  return InferWithSignature(signature_key, frame_buffer, roi);
+}
+
+std::future<StatusOr<ClassificationResult>> ImageClassifier::ClassifyAsync(
+    const FrameBuffer& frame_buffer, const BoundingBox& roi) {
+  return InferWithFallbackAsync(frame_buffer, roi);
+}
+
+StatusOr<std::vector<ClassificationResult>> ImageClassifier::ClassifyBatch(
+    absl::Span<const FrameBuffer* const> frame_buffers) {
+  std::vector<BoundingBox> rois(frame_buffers.size());
+  for (int i = 0; i < frame_buffers.size(); ++i) {
+    rois[i].set_width(frame_buffers[i]->dimension().width);
+    rois[i].set_height(frame_buffers[i]->dimension().height);
+  }
+  return ClassifyBatch(frame_buffers, rois);
+}
+
+StatusOr<std::vector<ClassificationResult>> ImageClassifier::ClassifyBatch(
+    absl::Span<const FrameBuffer* const> frame_buffers,
+    absl::Span<const BoundingBox> rois) {
+  if (frame_buffers.size() != rois.size()) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected as many regions of interest as frame "
+                        "buffers, got %d and %d.",
+                        rois.size(), frame_buffers.size()),
+        TfLiteSupportStatus::kInvalidArgumentError);
+  }
+  std::vector<std::tuple<const FrameBuffer&, const BoundingBox&>> batch;
+  batch.reserve(frame_buffers.size());
+  for (int i = 0; i < frame_buffers.size(); ++i) {
+    batch.emplace_back(*frame_buffers[i], rois[i]);
+  }
+  return InferBatchWithFallback(batch);
+}
+
+void ImageClassifier::AddTaskMemoryStats(core::MemoryStats* stats) const {
+  int64_t bytes =
+      (classification_heads_.capacity() - classification_heads_.size()) *
+      sizeof(ClassificationHead);
+  for (const ClassificationHead& head : classification_heads_) {
+    bytes += EstimateMemoryUsage(head);
+  }
+  for (const std::string& value : class_name_set_.values) {
+    bytes += sizeof(std::string) + core::EstimateHeapMemoryUsage(value);
+  }
+  stats->task_bytes["label_maps"] += bytes;
+}
+
 StatusOr<ClassificationResult> ImageClassifier::Postprocess(
     const std::vector<const TfLiteTensor*>& output_tensors,
     const FrameBuffer& /*frame_buffer*/, const BoundingBox& /*roi*/) {
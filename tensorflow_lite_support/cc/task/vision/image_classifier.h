@@ -16,11 +16,15 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_CLASSIFIER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_IMAGE_CLASSIFIER_H_
 
+#include <future>  // NOLINT(build/c++11)
 #include <memory>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/kernels/register.h"
@@ -110,6 +114,47 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
   tflite::support::StatusOr<ClassificationResult> Classify(
       const FrameBuffer& frame_buffer, const BoundingBox& roi);
 
+  // Same as above, except that a `DEADLINE_EXCEEDED` status is returned once
+  // `deadline` is exceeded, the inference being aborted if still running (see
+  // `BaseTaskApi::InferWithDeadline`).
+  tflite::support::StatusOr<ClassificationResult> Classify(
+      const FrameBuffer& frame_buffer, const BoundingBox& roi,
+      absl::Time deadline);
+
+  // Same as above, except that the signature of the model with the provided
+  // key (see `GetSignatureKeys`) is run instead of its primary subgraph, e.g.
+  // one of several classification heads sharing the same backbone weights.
+  // Its inputs and outputs, sorted by name, must match those of the primary
+  // subgraph. See `BaseTaskApi::InferWithSignature`.
+  tflite::support::StatusOr<ClassificationResult> Classify(
+      const FrameBuffer& frame_buffer, const BoundingBox& roi,
+      absl::string_view signature_key);
+
+  // Same as above, except that the classification is scheduled on the task
+  // executor (see `SetExecutor`) and a future holding its result is returned.
+  //
+  // IMPORTANT: `frame_buffer` and `roi` are captured by reference and must
+  // outlive the returned future.
+  std::future<tflite::support::StatusOr<ClassificationResult>> ClassifyAsync(
+      const FrameBuffer& frame_buffer, const BoundingBox& roi);
+
+  // Performs classification on a batch of FrameBuffers in a single model
+  // invocation. Each FrameBuffer is pre-processed as in `Classify` above and
+  // the results are returned in the same order as `frame_buffers`.
+  //
+  // IMPORTANT: the batch dimension of the model input is resized on the fly,
+  // so all input and output tensors are required to have a leading batch
+  // dimension. Models with dynamic input image dimensions are not supported.
+  tflite::support::StatusOr<std::vector<ClassificationResult>> ClassifyBatch(
+      absl::Span<const FrameBuffer* const> frame_buffers);
+
+  // Same as above, except that the classification of each FrameBuffer is
+  // performed based on the corresponding region of interest in `rois`, which
+  // must have the same size as `frame_buffers`.
+  tflite::support::StatusOr<std::vector<ClassificationResult>> ClassifyBatch(
+      absl::Span<const FrameBuffer* const> frame_buffers,
+      absl::Span<const BoundingBox> rois);
+
  protected:
   // The options used to build this ImageClassifier.
   std::unique_ptr<ImageClassifierOptions> options_;
@@ -124,6 +169,9 @@ class ImageClassifier : public BaseVisionTaskApi<ClassificationResult> {
       const std::vector<const TfLiteTensor*>& output_tensors,
       const FrameBuffer& frame_buffer, const BoundingBox& roi) override;
 
+  // Accounts for the label maps and class name filters.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override;
+
   // Performs sanity checks on the provided ImageClassifierOptions.
   static absl::Status SanityCheckOptions(const ImageClassifierOptions& options);
 
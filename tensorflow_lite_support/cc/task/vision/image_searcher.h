@@ -113,6 +113,11 @@ class ImageSearcher
   // Initializes the ImageSearcher.
   absl::Status Init(std::unique_ptr<ImageSearcherOptions> options);
 
+  // Accounts for the search index.
+  void AddTaskMemoryStats(core::MemoryStats* stats) const override {
+    postprocessor_->AddMemoryStats(stats);
+  }
+
   // Performs pre-initialization actions.
   virtual absl::Status PreInit();
 
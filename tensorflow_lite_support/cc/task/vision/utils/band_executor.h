@@ -0,0 +1,47 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_BAND_EXECUTOR_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_BAND_EXECUTOR_H_
+
+#include <functional>
+
+#include "absl/status/status.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Runs the bands of rows of an image processing operation on worker threads,
+// see `ParallelFrameBufferUtils`. Implementations must be thread-safe.
+class BandExecutor {
+ public:
+  virtual ~BandExecutor() = default;
+
+  // Returns the number of worker threads, which bounds the number of bands an
+  // operation is split into along with the calling thread.
+  virtual int num_threads() const = 0;
+
+  // Schedules `closure` to run on one of the worker threads. Returns an error
+  // if it can't be scheduled, in which case `closure` is not run and its band
+  // is processed by the calling thread.
+  virtual absl::Status Schedule(std::function<void()> closure) = 0;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_BAND_EXECUTOR_H_
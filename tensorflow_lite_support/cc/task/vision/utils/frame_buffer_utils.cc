@@ -30,6 +30,8 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/port/status_macros.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/libyuv_frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/parallel_frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/simd_frame_buffer_utils.h"
 
 namespace tflite {
 namespace task {
@@ -160,15 +162,28 @@ int GetBufferByteSize(FrameBuffer::Dimension dimension,
   return GetFrameBufferByteSize(dimension, format);
 }
 
-FrameBufferUtils::FrameBufferUtils(ProcessEngine engine) {
+FrameBufferUtils::FrameBufferUtils(
+    ProcessEngine engine,
+    std::shared_ptr<ScratchBufferPool> scratch_buffer_pool,
+    std::shared_ptr<BandExecutor> executor)
+    : scratch_buffer_pool_(scratch_buffer_pool != nullptr
+                               ? std::move(scratch_buffer_pool)
+                               : std::make_shared<ScratchBufferPool>()) {
   switch (engine) {
     case ProcessEngine::kLibyuv:
-      utils_ = absl::make_unique<LibyuvFrameBufferUtils>();
+      utils_ = absl::make_unique<LibyuvFrameBufferUtils>(scratch_buffer_pool_);
+      break;
+    case ProcessEngine::kSimd:
+      utils_ = absl::make_unique<SimdFrameBufferUtils>(scratch_buffer_pool_);
       break;
     default:
       TF_LITE_FATAL(
           absl::StrFormat("Unexpected ProcessEngine: %d.", engine).c_str());
   }
+  if (executor != nullptr) {
+    utils_ = absl::make_unique<ParallelFrameBufferUtils>(std::move(utils_),
+                                                         std::move(executor));
+  }
 }
 
 BoundingBox OrientBoundingBox(const BoundingBox& from_box,
@@ -487,10 +502,10 @@ absl::Status FrameBufferUtils::Orient(const FrameBuffer& buffer,
 
   // Perform rotation and flip operations.
   // Create a temporary buffer to hold the rotation result.
-  auto tmp_buffer = std::make_unique<uint8_t[]>(
+  ScratchBufferPool::Buffer tmp_buffer = scratch_buffer_pool_->Acquire(
       GetBufferByteSize(output_buffer->dimension(), output_buffer->format()));
   auto tmp_frame_buffer = FrameBuffer::Create(
-      GetPlanes(tmp_buffer.get(), output_buffer->dimension(),
+      GetPlanes(tmp_buffer.data(), output_buffer->dimension(),
                 output_buffer->format()),
       output_buffer->dimension(), buffer.format(), buffer.orientation());
 
@@ -511,11 +526,9 @@ absl::Status FrameBufferUtils::Execute(
   FrameBuffer input_frame_buffer = buffer;
   FrameBuffer temp_frame_buffer = buffer;
 
-  // Temporary buffers and its size to hold intermediate results.
-  int buffer1_size = 0;
-  int buffer2_size = 0;
-  std::unique_ptr<uint8_t[]> buffer1;
-  std::unique_ptr<uint8_t[]> buffer2;
+  // Temporary buffers to hold intermediate results.
+  ScratchBufferPool::Buffer buffer1;
+  ScratchBufferPool::Buffer buffer2;
 
   for (size_t i = 0; i < operations.size(); i++) {
     const FrameBufferOperation& operation = operations[i];
@@ -560,17 +573,19 @@ absl::Status FrameBufferUtils::Execute(
       // index to swap between buffers.
       std::vector<FrameBuffer::Plane> planes;
       if (i % 2 == 0) {
-        if (buffer1_size < byte_size) {
-          buffer1_size = byte_size;
-          buffer1 = std::make_unique<uint8_t[]>(byte_size);
+        if (buffer1.size() < static_cast<size_t>(byte_size)) {
+          // Return the current buffer to the pool first, so that it can be
+          // reused if large enough.
+          buffer1 = ScratchBufferPool::Buffer();
+          buffer1 = scratch_buffer_pool_->Acquire(byte_size);
         }
-        planes = GetPlanes(buffer1.get(), new_size, new_format);
+        planes = GetPlanes(buffer1.data(), new_size, new_format);
       } else {
-        if (buffer2_size < byte_size) {
-          buffer2_size = byte_size;
-          buffer2 = std::make_unique<uint8_t[]>(byte_size);
+        if (buffer2.size() < static_cast<size_t>(byte_size)) {
+          buffer2 = ScratchBufferPool::Buffer();
+          buffer2 = scratch_buffer_pool_->Acquire(byte_size);
         }
-        planes = GetPlanes(buffer2.get(), new_size, new_format);
+        planes = GetPlanes(buffer2.data(), new_size, new_format);
       }
       if (planes.empty()) {
         return absl::InternalError("Failed to construct temporary buffer.");
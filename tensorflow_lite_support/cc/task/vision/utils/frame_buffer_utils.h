@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
@@ -25,7 +26,9 @@ limitations under the License.
 #include "absl/types/variant.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 #include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/band_executor.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils_interface.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
 
 namespace tflite {
 namespace task {
@@ -191,15 +194,40 @@ class FrameBufferUtils {
   // Underlying process engine used for performing operations.
   enum class ProcessEngine {
     kLibyuv,
+    // Hand-vectorized resizing and conversion to kRGB, falling back to libyuv
+    // for the other operations. See `SimdFrameBufferUtils`.
+    kSimd,
   };
 
   // Factory method FrameBufferUtils instance. The processing engine is
   // defined by `engine`.
-  static std::unique_ptr<FrameBufferUtils> Create(ProcessEngine engine) {
-    return absl::make_unique<FrameBufferUtils>(engine);
+  //
+  // Intermediate results are held in buffers acquired from
+  // `scratch_buffer_pool`, which can be shared with other instances (e.g. one
+  // per thread). A pool owned by this instance is used if none is provided.
+  //
+  // If `executor` is provided, operations on large images are split into bands
+  // of rows processed in parallel on its threads, with identical results. See
+  // `ParallelFrameBufferUtils` for the supported operations, and
+  // `TaskExecutorBandExecutor` to run bands on a `core::TaskExecutor`.
+  static std::unique_ptr<FrameBufferUtils> Create(
+      ProcessEngine engine,
+      std::shared_ptr<ScratchBufferPool> scratch_buffer_pool = nullptr,
+      std::shared_ptr<BandExecutor> executor = nullptr) {
+    return absl::make_unique<FrameBufferUtils>(
+        engine, std::move(scratch_buffer_pool), std::move(executor));
   }
 
-  explicit FrameBufferUtils(ProcessEngine engine);
+  explicit FrameBufferUtils(
+      ProcessEngine engine,
+      std::shared_ptr<ScratchBufferPool> scratch_buffer_pool = nullptr,
+      std::shared_ptr<BandExecutor> executor = nullptr);
+
+  // Returns the pool intermediate buffers are acquired from, e.g. to monitor
+  // its allocations.
+  ScratchBufferPool* scratch_buffer_pool() const {
+    return scratch_buffer_pool_.get();
+  }
 
   // Performs cropping operation.
   //
@@ -331,6 +359,9 @@ class FrameBufferUtils {
                        const FrameBufferOperation& operation,
                        FrameBuffer* output_buffer);
 
+  // Pool of buffers for intermediate results, shared with `utils_`.
+  std::shared_ptr<ScratchBufferPool> scratch_buffer_pool_;
+
   // Execution engine conforms to FrameBufferUtilsInterface.
   std::unique_ptr<FrameBufferUtilsInterface> utils_;
 };
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FRAME_BUFFER_UTILS_INTERFACE_H_
 
 #include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 
 namespace tflite {
@@ -91,6 +92,29 @@ class FrameBufferUtilsInterface {
   // should be big enough to store the operation result.
   virtual absl::Status Convert(const FrameBuffer& buffer,
                                FrameBuffer* output_buffer) = 0;
+
+  // Returns whether `CropResizeRows` supports buffers of the given `format`.
+  // No format is supported by default.
+  virtual bool SupportsCropResizeRows(FrameBuffer::Format format) const {
+    return false;
+  }
+
+  // Computes rows `[first_row, first_row + num_rows)` of the output of
+  // `Crop(buffer, x0, y0, x1, y1, output_buffer)`, resizing with bilinear
+  // interpolation, and leaves the other rows of `output_buffer` untouched.
+  // Results are identical to those of `Crop`, so that bands of rows can be
+  // resized concurrently.
+  //
+  // Returns an UNIMPLEMENTED error by default, see `SupportsCropResizeRows`.
+  virtual absl::Status CropResizeRows(const FrameBuffer& buffer, int x0,
+                                      int y0, int x1, int y1, int first_row,
+                                      int num_rows,
+                                      FrameBuffer* output_buffer) {
+    return tflite::support::CreateStatusWithPayload(
+        absl::StatusCode::kUnimplemented,
+        "Resizing bands of rows is not supported by this engine.",
+        tflite::support::TfLiteSupportStatus::kImageProcessingError);
+  }
 };
 }  // namespace vision
 }  // namespace task
@@ -0,0 +1,278 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/fused_preprocessing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+namespace {
+
+// Number of channels of the output image.
+constexpr int kRgbChannels = 3;
+
+// Linear interpolation weights along one axis of a plane: the interpolated
+// value is `(1 - weight) * value[index0] + weight * value[index1]`.
+struct Tap {
+  int index0;
+  int index1;
+  float weight;
+};
+
+// Interpolation weights along one axis of a source image, for both the full
+// resolution planes and the 2x subsampled chroma planes of YUV420 formats.
+struct AxisTaps {
+  Tap luma;
+  Tap chroma;
+};
+
+Tap MakeTap(float position, int first, int last) {
+  position = std::min(std::max(position, static_cast<float>(first)),
+                      static_cast<float>(last));
+  const int index0 = static_cast<int>(position);
+  return {index0, std::min(index0 + 1, last), position - index0};
+}
+
+// Returns the taps needed to resize `[origin, origin + length)` along one axis
+// to `resized_length` pixels. This follows libyuv's bilinear scaler so as to
+// stay close to `FrameBufferUtils::Preprocess`: pixel centers are aligned when
+// downscaling, edges when upscaling.
+std::vector<AxisTaps> ComputeAxisTaps(int origin, int length,
+                                      int resized_length) {
+  float scale = 0;
+  float offset = 0;
+  if (resized_length <= length) {
+    scale = static_cast<float>(length) / resized_length;
+    offset = 0.5f * scale - 0.5f;
+  } else if (length > 1) {
+    scale = static_cast<float>(length - 1) / (resized_length - 1);
+  }
+  const int last = origin + length - 1;
+  std::vector<AxisTaps> taps(resized_length);
+  for (int i = 0; i < resized_length; ++i) {
+    const float position = origin + offset + i * scale;
+    taps[i].luma = MakeTap(position, origin, last);
+    // Chroma samples are located at the center of each 2x2 block of luma
+    // samples.
+    taps[i].chroma = MakeTap(0.5f * position - 0.25f, origin / 2, last / 2);
+  }
+  return taps;
+}
+
+inline float Interpolate(const uint8_t* row0, const uint8_t* row1, int offset0,
+                         int offset1, float x_weight, float y_weight) {
+  const float top = row0[offset0] + x_weight * (row0[offset1] - row0[offset0]);
+  const float bottom =
+      row1[offset0] + x_weight * (row1[offset1] - row1[offset0]);
+  return top + y_weight * (bottom - top);
+}
+
+// Samples RGB values from a RGB, RGBA or GRAY plane.
+class InterleavedSampler {
+ public:
+  InterleavedSampler(const FrameBuffer::Plane& plane, int num_channels)
+      : data_(plane.buffer),
+        row_stride_(plane.stride.row_stride_bytes),
+        pixel_stride_(plane.stride.pixel_stride_bytes),
+        num_channels_(num_channels) {}
+
+  void Sample(const AxisTaps& x, const AxisTaps& y, float* rgb) const {
+    const uint8_t* row0 = data_ + y.luma.index0 * row_stride_;
+    const uint8_t* row1 = data_ + y.luma.index1 * row_stride_;
+    const int offset0 = x.luma.index0 * pixel_stride_;
+    const int offset1 = x.luma.index1 * pixel_stride_;
+    for (int c = 0; c < num_channels_; ++c) {
+      rgb[c] = Interpolate(row0 + c, row1 + c, offset0, offset1,
+                           x.luma.weight, y.luma.weight);
+    }
+    if (num_channels_ == 1) {
+      rgb[1] = rgb[0];
+      rgb[2] = rgb[0];
+    }
+  }
+
+ private:
+  const uint8_t* data_;
+  const int row_stride_;
+  const int pixel_stride_;
+  const int num_channels_;
+};
+
+// Samples RGB values from YUV420 planes, using the BT.601 limited range
+// conversion matrix as libyuv does.
+class YuvSampler {
+ public:
+  explicit YuvSampler(const FrameBuffer::YuvData& yuv_data)
+      : yuv_data_(yuv_data) {}
+
+  void Sample(const AxisTaps& x, const AxisTaps& y, float* rgb) const {
+    const float luma = Interpolate(
+        yuv_data_.y_buffer + y.luma.index0 * yuv_data_.y_row_stride,
+        yuv_data_.y_buffer + y.luma.index1 * yuv_data_.y_row_stride,
+        x.luma.index0, x.luma.index1, x.luma.weight, y.luma.weight);
+    const int row0 = y.chroma.index0 * yuv_data_.uv_row_stride;
+    const int row1 = y.chroma.index1 * yuv_data_.uv_row_stride;
+    const int offset0 = x.chroma.index0 * yuv_data_.uv_pixel_stride;
+    const int offset1 = x.chroma.index1 * yuv_data_.uv_pixel_stride;
+    const float u =
+        Interpolate(yuv_data_.u_buffer + row0, yuv_data_.u_buffer + row1,
+                    offset0, offset1, x.chroma.weight, y.chroma.weight) -
+        128.0f;
+    const float v =
+        Interpolate(yuv_data_.v_buffer + row0, yuv_data_.v_buffer + row1,
+                    offset0, offset1, x.chroma.weight, y.chroma.weight) -
+        128.0f;
+    const float scaled_luma = 1.164f * (luma - 16.0f);
+    rgb[0] = Clamp(scaled_luma + 1.596f * v);
+    rgb[1] = Clamp(scaled_luma - 0.813f * v - 0.391f * u);
+    rgb[2] = Clamp(scaled_luma + 2.018f * u);
+  }
+
+ private:
+  static float Clamp(float value) {
+    return std::min(std::max(value, 0.0f), 255.0f);
+  }
+
+  const FrameBuffer::YuvData yuv_data_;
+};
+
+// Fills `output` with the normalized samples returned by `sampler`, where
+// `column_taps[x]` and `row_taps[y]` are the taps corresponding to the output
+// pixel at `(x, y)`, along the horizontal and vertical source axes
+// respectively if `swap_axes` is false, the other way round otherwise.
+template <typename Sampler>
+void FillOutput(const Sampler& sampler,
+                const std::vector<AxisTaps>& column_taps,
+                const std::vector<AxisTaps>& row_taps, bool swap_axes,
+                const std::array<float, 3>& mean_values,
+                const std::array<float, 3>& inv_std_values, float* output) {
+  float rgb[kRgbChannels];
+  for (const AxisTaps& row_tap : row_taps) {
+    for (const AxisTaps& column_tap : column_taps) {
+      if (swap_axes) {
+        sampler.Sample(row_tap, column_tap, rgb);
+      } else {
+        sampler.Sample(column_tap, row_tap, rgb);
+      }
+      for (int c = 0; c < kRgbChannels; ++c) {
+        *output++ = (rgb[c] - mean_values[c]) * inv_std_values[c];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+absl::Status FusedPreprocess(const FrameBuffer& buffer, const BoundingBox& roi,
+                             FrameBuffer::Dimension output_dimension,
+                             const std::array<float, 3>& mean_values,
+                             const std::array<float, 3>& std_values,
+                             float* output) {
+  if (output_dimension.width <= 0 || output_dimension.height <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Invalid output dimension: %dx%d.",
+                        output_dimension.width, output_dimension.height));
+  }
+  if (roi.origin_x() < 0 || roi.origin_y() < 0 || roi.width() <= 0 ||
+      roi.height() <= 0 ||
+      roi.origin_x() + roi.width() > buffer.dimension().width ||
+      roi.origin_y() + roi.height() > buffer.dimension().height) {
+    return absl::InvalidArgumentError("Invalid crop coordinates.");
+  }
+  std::array<float, 3> inv_std_values;
+  for (int c = 0; c < kRgbChannels; ++c) {
+    if (std::abs(std_values[c]) < std::numeric_limits<float>::epsilon()) {
+      return absl::InvalidArgumentError(
+          "Standard deviation values can't be 0.");
+    }
+    inv_std_values[c] = 1.0f / std_values[c];
+  }
+
+  // Dimensions of the resized image, before it gets rotated.
+  const bool swap_axes = RequireDimensionSwap(
+      buffer.orientation(), FrameBuffer::Orientation::kTopLeft);
+  FrameBuffer::Dimension pre_orient_dimension = output_dimension;
+  if (swap_axes) {
+    pre_orient_dimension.Swap();
+  }
+  const std::vector<AxisTaps> x_taps = ComputeAxisTaps(
+      roi.origin_x(), roi.width(), pre_orient_dimension.width);
+  const std::vector<AxisTaps> y_taps = ComputeAxisTaps(
+      roi.origin_y(), roi.height(), pre_orient_dimension.height);
+
+  // Rotations and flips map each output axis to a single source axis: resolve
+  // the taps corresponding to each output column and row once and for all.
+  std::vector<AxisTaps> column_taps(output_dimension.width);
+  for (int x = 0; x < output_dimension.width; ++x) {
+    int from_x, from_y;
+    OrientCoordinates(x, 0, FrameBuffer::Orientation::kTopLeft,
+                      buffer.orientation(), output_dimension, &from_x,
+                      &from_y);
+    column_taps[x] = swap_axes ? y_taps[from_y] : x_taps[from_x];
+  }
+  std::vector<AxisTaps> row_taps(output_dimension.height);
+  for (int y = 0; y < output_dimension.height; ++y) {
+    int from_x, from_y;
+    OrientCoordinates(0, y, FrameBuffer::Orientation::kTopLeft,
+                      buffer.orientation(), output_dimension, &from_x,
+                      &from_y);
+    row_taps[y] = swap_axes ? x_taps[from_x] : y_taps[from_y];
+  }
+
+  switch (buffer.format()) {
+    case FrameBuffer::Format::kRGB:
+    case FrameBuffer::Format::kRGBA:
+      FillOutput(InterleavedSampler(buffer.plane(0), kRgbChannels),
+                 column_taps, row_taps, swap_axes, mean_values, inv_std_values,
+                 output);
+      break;
+    case FrameBuffer::Format::kGRAY:
+      FillOutput(InterleavedSampler(buffer.plane(0), /*num_channels=*/1),
+                 column_taps, row_taps, swap_axes, mean_values, inv_std_values,
+                 output);
+      break;
+    case FrameBuffer::Format::kNV12:
+    case FrameBuffer::Format::kNV21:
+    case FrameBuffer::Format::kYV12:
+    case FrameBuffer::Format::kYV21: {
+      ASSIGN_OR_RETURN(FrameBuffer::YuvData yuv_data,
+                       FrameBuffer::GetYuvDataFromFrameBuffer(buffer));
+      FillOutput(YuvSampler(yuv_data), column_taps, row_taps, swap_axes,
+                 mean_values, inv_std_values, output);
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Format %i is not supported.", buffer.format()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
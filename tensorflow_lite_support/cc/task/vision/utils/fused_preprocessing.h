@@ -0,0 +1,54 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FUSED_PREPROCESSING_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FUSED_PREPROCESSING_H_
+
+#include <array>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Performs the same operations as `FrameBufferUtils::Preprocess` to produce an
+// upright RGB image of `output_dimension` from `buffer` (i.e. crop to `roi`,
+// bilinear resize, conversion to RGB and rotation according to the buffer
+// orientation), then normalizes each channel `c` of this image as
+// `(value - mean_values[c]) / std_values[c]` and writes the result to
+// `output`, which must hold `output_dimension.Size() * 3` floats.
+//
+// Unlike `FrameBufferUtils::Preprocess`, which chains each operation through
+// an intermediate 8-bit buffer, this is done in a single pass over the output
+// pixels: each one is interpolated directly from the source planes, converted
+// and normalized in floating point. Results are therefore not bit-exact with
+// the former, but within the 8-bit rounding errors it accumulates.
+//
+// Supports all the FrameBuffer formats, i.e. RGBA, RGB, GRAY, NV12, NV21, YV12
+// and YV21. As with `FrameBufferUtils::Preprocess`, `roi` is expressed in the
+// unrotated coordinate system of `buffer` and must lie within its bounds.
+absl::Status FusedPreprocess(const FrameBuffer& buffer, const BoundingBox& roi,
+                             FrameBuffer::Dimension output_dimension,
+                             const std::array<float, 3>& mean_values,
+                             const std::array<float, 3>& std_values,
+                             float* output);
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_FUSED_PREPROCESSING_H_
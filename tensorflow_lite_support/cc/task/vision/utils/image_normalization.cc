@@ -0,0 +1,203 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/image_normalization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__
+#include <emmintrin.h>
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+// Number of bytes normalized per iteration by the vectorized kernels. This is a
+// multiple of both the channel count and the vector sizes, so that each vector
+// always starts on the same channel within a block.
+constexpr int kBlockSize = 48;
+
+// Per-channel normalization values, repeated so that `mean[j]` and `inv_std[j]`
+// apply to the j-th value of any block. Vectors of `n` floats therefore load
+// their values from offsets 0, n or 2 * n.
+struct NormalizationPattern {
+  float mean[24];
+  float inv_std[24];
+};
+
+// Normalizes `num_blocks` blocks of `kBlockSize` values.
+void NormalizeBlocks(const uint8_t* input, size_t num_blocks,
+                     const NormalizationPattern& pattern, float* output) {
+#ifdef __AVX2__
+  const __m256 mean[3] = {_mm256_loadu_ps(pattern.mean),
+                          _mm256_loadu_ps(pattern.mean + 8),
+                          _mm256_loadu_ps(pattern.mean + 16)};
+  const __m256 inv_std[3] = {_mm256_loadu_ps(pattern.inv_std),
+                             _mm256_loadu_ps(pattern.inv_std + 8),
+                             _mm256_loadu_ps(pattern.inv_std + 16)};
+  for (size_t b = 0; b < num_blocks;
+       ++b, input += kBlockSize, output += kBlockSize) {
+    for (int k = 0; k < kBlockSize / 8; ++k) {
+      const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + 8 * k))));
+      _mm256_storeu_ps(output + 8 * k,
+                       _mm256_mul_ps(_mm256_sub_ps(values, mean[k % 3]),
+                                     inv_std[k % 3]));
+    }
+  }
+#elif defined __SSE2__
+  const __m128 mean[3] = {_mm_loadu_ps(pattern.mean),
+                          _mm_loadu_ps(pattern.mean + 4),
+                          _mm_loadu_ps(pattern.mean + 8)};
+  const __m128 inv_std[3] = {_mm_loadu_ps(pattern.inv_std),
+                             _mm_loadu_ps(pattern.inv_std + 4),
+                             _mm_loadu_ps(pattern.inv_std + 8)};
+  const __m128i zero = _mm_setzero_si128();
+  for (size_t b = 0; b < num_blocks;
+       ++b, input += kBlockSize, output += kBlockSize) {
+    for (int l = 0; l < kBlockSize / 16; ++l) {
+      const __m128i bytes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16 * l));
+      const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      const __m128 values[4] = {
+          _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)),
+          _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)),
+          _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)),
+          _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero))};
+      for (int v = 0; v < 4; ++v) {
+        const int k = 4 * l + v;
+        _mm_storeu_ps(output + 4 * k,
+                      _mm_mul_ps(_mm_sub_ps(values[v], mean[k % 3]),
+                                 inv_std[k % 3]));
+      }
+    }
+  }
+#elif defined __ARM_NEON
+  const float32x4_t mean[3] = {vld1q_f32(pattern.mean),
+                               vld1q_f32(pattern.mean + 4),
+                               vld1q_f32(pattern.mean + 8)};
+  const float32x4_t inv_std[3] = {vld1q_f32(pattern.inv_std),
+                                  vld1q_f32(pattern.inv_std + 4),
+                                  vld1q_f32(pattern.inv_std + 8)};
+  for (size_t b = 0; b < num_blocks;
+       ++b, input += kBlockSize, output += kBlockSize) {
+    for (int l = 0; l < kBlockSize / 16; ++l) {
+      const uint8x16_t bytes = vld1q_u8(input + 16 * l);
+      const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+      const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+      const float32x4_t values[4] = {
+          vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))),
+          vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))),
+          vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))),
+          vcvtq_f32_u32(vmovl_u16(vget_high_u16(high)))};
+      for (int v = 0; v < 4; ++v) {
+        const int k = 4 * l + v;
+        vst1q_f32(output + 4 * k,
+                  vmulq_f32(vsubq_f32(values[v], mean[k % 3]),
+                            inv_std[k % 3]));
+      }
+    }
+  }
+#else
+  for (size_t i = 0; i < num_blocks * kBlockSize; ++i) {
+    const size_t j = i % 24;
+    output[i] =
+        (static_cast<float>(input[i]) - pattern.mean[j]) * pattern.inv_std[j];
+  }
+#endif
+}
+
+}  // namespace
+
+void NormalizeToFloat(const uint8_t* input, size_t size, int num_channels,
+                      const std::array<float, 3>& mean_values,
+                      const std::array<float, 3>& std_values, float* output) {
+  NormalizationPattern pattern;
+  for (int j = 0; j < 24; ++j) {
+    const int c = j % num_channels;
+    pattern.mean[j] = mean_values[c];
+    pattern.inv_std[j] = 1.0f / std_values[c];
+  }
+
+  const size_t num_blocks = size / kBlockSize;
+  NormalizeBlocks(input, num_blocks, pattern, output);
+
+  // Leftover values, which start on the first channel since the block size is a
+  // multiple of the number of channels.
+  for (size_t i = num_blocks * kBlockSize; i < size; ++i) {
+    const size_t j = (i - num_blocks * kBlockSize) % 24;
+    output[i] =
+        (static_cast<float>(input[i]) - pattern.mean[j]) * pattern.inv_std[j];
+  }
+}
+
+Int8QuantizationTable BuildInt8QuantizationTable(
+    const std::array<float, 3>& mean_values,
+    const std::array<float, 3>& std_values, int num_values, float scale,
+    int32_t zero_point) {
+  Int8QuantizationTable table;
+  table.is_offset_by_128 = true;
+  for (int c = 0; c < 3; ++c) {
+    const int index = num_values == 1 ? 0 : c;
+    const float mean_value = mean_values[index];
+    const float inv_std_value = 1.0f / std_values[index];
+    for (int p = 0; p < 256; ++p) {
+      const float normalized =
+          (static_cast<float>(p) - mean_value) * inv_std_value;
+      const int32_t quantized =
+          static_cast<int32_t>(std::round(normalized / scale)) + zero_point;
+      table.values[c][p] = static_cast<int8_t>(std::min<int32_t>(
+          std::max<int32_t>(quantized, std::numeric_limits<int8_t>::min()),
+          std::numeric_limits<int8_t>::max()));
+      table.is_offset_by_128 &= table.values[c][p] == p - 128;
+    }
+  }
+  return table;
+}
+
+void QuantizeToInt8(const uint8_t* input, size_t size,
+                    const Int8QuantizationTable& table, int8_t* output) {
+  if (table.is_offset_by_128) {
+    // Flipping the most significant bit subtracts 128, which compilers
+    // vectorize on all targets.
+    for (size_t i = 0; i < size; ++i) {
+      output[i] = static_cast<int8_t>(input[i] ^ 0x80);
+    }
+    return;
+  }
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    output[i] = table.values[0][input[i]];
+    output[i + 1] = table.values[1][input[i + 1]];
+    output[i + 2] = table.values[2][input[i + 2]];
+  }
+  // Leftover values of a truncated pixel, if any.
+  for (; i < size; ++i) {
+    output[i] = table.values[i % 3][input[i]];
+  }
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,75 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_NORMALIZATION_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_NORMALIZATION_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Normalizes `size` 8-bit values from `input`, which holds interleaved pixels
+// with `num_channels` channels (1 or 3), and writes them to `output` as:
+//
+//   output[i] = (input[i] - mean_values[c]) / std_values[c]
+//
+// where `c = i % num_channels`. Only the first value of `mean_values` and
+// `std_values` is used for single-channel pixels, and `std_values` are expected
+// to be non-zero.
+//
+// Uses AVX2, SSE2 or NEON kernels when available at compile time, falling back
+// to a scalar loop otherwise. All of them produce the same results.
+void NormalizeToFloat(const uint8_t* input, size_t size, int num_channels,
+                      const std::array<float, 3>& mean_values,
+                      const std::array<float, 3>& std_values, float* output);
+
+// Lookup table requantizing 8-bit pixel values into the values expected by an
+// int8 quantized input tensor, for each of the 3 channels of RGB pixels.
+struct Int8QuantizationTable {
+  // `values[c][p]` is the int8 value of channel `c` for pixel value `p`.
+  std::array<std::array<int8_t, 256>, 3> values;
+  // Whether `values[c][p] == p - 128` for all channels, which is the case of
+  // most int8 models with uint8 inputs and allows a faster conversion.
+  bool is_offset_by_128;
+};
+
+// Builds the table requantizing pixel values for an input tensor with the
+// provided quantization `scale` and `zero_point`. Each pixel value `p` of
+// channel `c` is first normalized as in `NormalizeToFloat`, then quantized as:
+//
+//   round((p - mean_values[c]) / std_values[c] / scale) + zero_point
+//
+// clamped to the int8 range. `scale` and `std_values` are expected to be
+// non-zero. Pass `num_values = 1` to use the first values of `mean_values` and
+// `std_values` for all channels.
+Int8QuantizationTable BuildInt8QuantizationTable(
+    const std::array<float, 3>& mean_values,
+    const std::array<float, 3>& std_values, int num_values, float scale,
+    int32_t zero_point);
+
+// Requantizes `size` 8-bit values from `input`, which holds interleaved RGB
+// pixels, into `output` according to `table`: the i-th value is mapped through
+// the table of channel `i % 3`, even if `size` is not a multiple of 3.
+void QuantizeToInt8(const uint8_t* input, size_t size,
+                    const Int8QuantizationTable& table, int8_t* output);
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_IMAGE_NORMALIZATION_H_
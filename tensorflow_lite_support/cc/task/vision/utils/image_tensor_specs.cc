@@ -167,14 +167,16 @@ StatusOr<ImageTensorSpecs> BuildInputImageTensorSpecs(
         "Only 4D tensors in BHWD layout are supported.",
         TfLiteSupportStatus::kInvalidInputTensorDimensionsError);
   }
-  static constexpr TfLiteType valid_types[] = {kTfLiteUInt8, kTfLiteFloat32};
+  static constexpr TfLiteType valid_types[] = {kTfLiteUInt8, kTfLiteInt8,
+                                               kTfLiteFloat32};
   TfLiteType input_type = input_tensor->type;
   if (!absl::c_linear_search(valid_types, input_type)) {
     return CreateStatusWithPayload(
         StatusCode::kInvalidArgument,
         absl::StrCat(
             "Type mismatch for input tensor ", input_tensor->name,
-            ". Requested one of these types: kTfLiteUint8/kTfLiteFloat32, got ",
+            ". Requested one of these types: "
+            "kTfLiteUint8/kTfLiteInt8/kTfLiteFloat32, got ",
             TfLiteTypeGetName(input_type), "."),
         TfLiteSupportStatus::kInvalidInputTensorTypeError);
   }
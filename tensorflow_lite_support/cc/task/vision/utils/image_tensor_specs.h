@@ -68,8 +68,9 @@ struct ImageTensorSpecs {
   // Optional normalization parameters read from TF Lite Metadata. Those are
   // mandatory when tensor_type=kTfLiteFloat32 in order to convert the input
   // image data into the expected range of floating point values, an error is
-  // returned otherwise (see sanity checks below). They should be ignored for
-  // other tensor input types, e.g. kTfLiteUInt8.
+  // returned otherwise (see sanity checks below). They are optional for
+  // kTfLiteInt8, where they apply before quantization, and should be ignored
+  // for kTfLiteUInt8.
   absl::optional<NormalizationOptions> normalization_options;
 };
 
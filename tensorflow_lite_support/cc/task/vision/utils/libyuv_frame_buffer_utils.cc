@@ -499,7 +499,8 @@ absl::Status ConvertRgbaToArgb(const FrameBuffer& buffer, uint8_t* dest_argb,
 
 // Converts kRGB `buffer` to the `output_buffer` of the target color space.
 absl::Status ConvertFromRgb(const FrameBuffer& buffer,
-                            FrameBuffer* output_buffer) {
+                            FrameBuffer* output_buffer,
+                            ScratchBufferPool* scratch_buffer_pool) {
   if (output_buffer->format() == FrameBuffer::Format::kGRAY) {
     int ret = libyuv::RAWToJ400(
         buffer.plane(0).buffer, buffer.plane(0).stride.row_stride_bytes,
@@ -522,15 +523,15 @@ absl::Status ConvertFromRgb(const FrameBuffer& buffer,
     // TODO(b/153000936): use libyuv::RawToNV12 / libyuv::RawToNV21 when they
     // are ready.
     FrameBuffer::YuvData yuv_data;
-    std::unique_ptr<uint8_t[]> tmp_yuv_buffer;
+    ScratchBufferPool::Buffer tmp_yuv_buffer;
     std::unique_ptr<FrameBuffer> yuv_frame_buffer;
     if (output_buffer->format() == FrameBuffer::Format::kNV12 ||
         output_buffer->format() == FrameBuffer::Format::kNV21) {
-      tmp_yuv_buffer = std::make_unique<uint8_t[]>(
+      tmp_yuv_buffer = scratch_buffer_pool->Acquire(
           GetFrameBufferByteSize(buffer.dimension(), output_buffer->format()));
       ASSIGN_OR_RETURN(
           yuv_frame_buffer,
-          CreateFromRawBuffer(tmp_yuv_buffer.get(), buffer.dimension(),
+          CreateFromRawBuffer(tmp_yuv_buffer.data(), buffer.dimension(),
                               FrameBuffer::Format::kYV21,
                               output_buffer->orientation()));
       ASSIGN_OR_RETURN(
@@ -578,7 +579,8 @@ absl::Status ConvertFromRgb(const FrameBuffer& buffer,
 
 // Converts kRGBA `buffer` to the `output_buffer` of the target color space.
 absl::Status ConvertFromRgba(const FrameBuffer& buffer,
-                             FrameBuffer* output_buffer) {
+                             FrameBuffer* output_buffer,
+                             ScratchBufferPool* scratch_buffer_pool) {
   switch (output_buffer->format()) {
     case FrameBuffer::Format::kGRAY: {
       // libyuv does not support convert kRGBA (ABGR) foramat. In this method,
@@ -589,14 +591,15 @@ absl::Status ConvertFromRgba(const FrameBuffer& buffer,
       // Convert kRGBA to ARGB
       int argb_buffer_size = GetFrameBufferByteSize(buffer.dimension(),
                                                     FrameBuffer::Format::kRGBA);
-      auto argb_buffer = std::make_unique<uint8_t[]>(argb_buffer_size);
+      ScratchBufferPool::Buffer argb_buffer =
+          scratch_buffer_pool->Acquire(argb_buffer_size);
       const int argb_row_bytes = buffer.dimension().width * kRgbaPixelBytes;
       RETURN_IF_ERROR(
-          ConvertRgbaToArgb(buffer, argb_buffer.get(), argb_row_bytes));
+          ConvertRgbaToArgb(buffer, argb_buffer.data(), argb_row_bytes));
 
       // Convert ARGB to kGRAY
       int ret = libyuv::ARGBToJ400(
-          argb_buffer.get(), argb_row_bytes,
+          argb_buffer.data(), argb_row_bytes,
           const_cast<uint8_t*>(output_buffer->plane(0).buffer),
           output_buffer->plane(0).stride.row_stride_bytes,
           buffer.dimension().width, buffer.dimension().height);
@@ -718,7 +721,8 @@ absl::Status RotateRgba(const FrameBuffer& buffer, int angle_deg,
 }
 
 absl::Status RotateRgb(const FrameBuffer& buffer, int angle_deg,
-                       FrameBuffer* output_buffer) {
+                       FrameBuffer* output_buffer,
+                       ScratchBufferPool* scratch_buffer_pool) {
   // libyuv does not support rotate kRGB (RGB24) foramat. In this method, the
   // implementation converts kRGB format to ARGB and use ARGB buffer for
   // rotation. The result is then convert back to RGB.
@@ -726,17 +730,19 @@ absl::Status RotateRgb(const FrameBuffer& buffer, int angle_deg,
   // Convert RGB to ARGB
   int argb_buffer_size =
       GetFrameBufferByteSize(buffer.dimension(), FrameBuffer::Format::kRGBA);
-  auto argb_buffer = std::make_unique<uint8_t[]>(argb_buffer_size);
+  ScratchBufferPool::Buffer argb_buffer =
+      scratch_buffer_pool->Acquire(argb_buffer_size);
   const int argb_row_bytes = buffer.dimension().width * kRgbaPixelBytes;
-  RETURN_IF_ERROR(ConvertRgbToArgb(buffer, argb_buffer.get(), argb_row_bytes));
+  RETURN_IF_ERROR(ConvertRgbToArgb(buffer, argb_buffer.data(), argb_row_bytes));
 
   // Rotate ARGB
-  auto argb_rotated_buffer = std::make_unique<uint8_t[]>(argb_buffer_size);
+  ScratchBufferPool::Buffer argb_rotated_buffer =
+      scratch_buffer_pool->Acquire(argb_buffer_size);
   int rotated_row_bytes = output_buffer->dimension().width * kRgbaPixelBytes;
   // TODO(b/151954340): Optimize the current implementation by utilizing
   // ARGBMirror for 180 degree rotation.
   int ret = libyuv::ARGBRotate(
-      argb_buffer.get(), argb_row_bytes, argb_rotated_buffer.get(),
+      argb_buffer.data(), argb_row_bytes, argb_rotated_buffer.data(),
       rotated_row_bytes, buffer.dimension().width, buffer.dimension().height,
       GetLibyuvRotationMode(angle_deg % 360));
   if (ret != 0) {
@@ -746,7 +752,7 @@ absl::Status RotateRgb(const FrameBuffer& buffer, int angle_deg,
   }
 
   // Convert ARGB to RGB
-  return ConvertArgbToRgb(argb_rotated_buffer.get(), rotated_row_bytes,
+  return ConvertArgbToRgb(argb_rotated_buffer.data(), rotated_row_bytes,
                           output_buffer);
 }
 
@@ -799,7 +805,8 @@ absl::Status RotateYv(const FrameBuffer& buffer, int angle_deg,
 // TODO(b/152097364): Refactor NV12/NV21 rotation after libyuv explicitly
 // support that.
 absl::Status RotateNv(const FrameBuffer& buffer, int angle_deg,
-                      FrameBuffer* output_buffer) {
+                      FrameBuffer* output_buffer,
+                      ScratchBufferPool* scratch_buffer_pool) {
   if (buffer.format() != FrameBuffer::Format::kNV12 &&
       buffer.format() != FrameBuffer::Format::kNV21) {
     return CreateStatusWithPayload(StatusCode::kInternal,
@@ -812,13 +819,14 @@ absl::Status RotateNv(const FrameBuffer& buffer, int angle_deg,
                    FrameBuffer::GetYuvDataFromFrameBuffer(*output_buffer));
   const int rotated_buffer_size = GetFrameBufferByteSize(
       output_buffer->dimension(), FrameBuffer::Format::kYV21);
-  auto rotated_yuv_raw_buffer =
-      std::make_unique<uint8_t[]>(rotated_buffer_size);
-  ASSIGN_OR_RETURN(std::unique_ptr<FrameBuffer> rotated_yuv_buffer,
-                   CreateFromRawBuffer(
-                       rotated_yuv_raw_buffer.get(), output_buffer->dimension(),
-                       /*target_format=*/FrameBuffer::Format::kYV21,
-                       output_buffer->orientation()));
+  ScratchBufferPool::Buffer rotated_yuv_raw_buffer =
+      scratch_buffer_pool->Acquire(rotated_buffer_size);
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<FrameBuffer> rotated_yuv_buffer,
+      CreateFromRawBuffer(rotated_yuv_raw_buffer.data(),
+                          output_buffer->dimension(),
+                          /*target_format=*/FrameBuffer::Format::kYV21,
+                          output_buffer->orientation()));
   ASSIGN_OR_RETURN(FrameBuffer::YuvData rotated_yuv_data,
                    FrameBuffer::GetYuvDataFromFrameBuffer(*rotated_yuv_buffer));
   // Get the first chroma plane and use it as the u plane. This is a workaround
@@ -1101,6 +1109,7 @@ absl::Status FlipHorizontallyPlane(const FrameBuffer& buffer,
 
 absl::Status ResizeRgb(
     const FrameBuffer& buffer, FrameBuffer* output_buffer,
+    ScratchBufferPool* scratch_buffer_pool,
     libyuv::FilterMode interpolation = libyuv::FilterMode::kFilterBilinear) {
   if (buffer.plane_count() > 1) {
     return CreateStatusWithPayload(
@@ -1117,20 +1126,21 @@ absl::Status ResizeRgb(
   // Convert RGB to ARGB
   int argb_buffer_size =
       GetFrameBufferByteSize(buffer.dimension(), FrameBuffer::Format::kRGBA);
-  auto argb_buffer = std::make_unique<uint8_t[]>(argb_buffer_size);
+  ScratchBufferPool::Buffer argb_buffer =
+      scratch_buffer_pool->Acquire(argb_buffer_size);
   const int argb_row_bytes = buffer.dimension().width * kRgbaPixelBytes;
-  RETURN_IF_ERROR(ConvertRgbToArgb(buffer, argb_buffer.get(), argb_row_bytes));
+  RETURN_IF_ERROR(ConvertRgbToArgb(buffer, argb_buffer.data(), argb_row_bytes));
 
   // Resize ARGB
   int resized_argb_buffer_size = GetFrameBufferByteSize(
       output_buffer->dimension(), FrameBuffer::Format::kRGBA);
-  auto resized_argb_buffer =
-      std::make_unique<uint8_t[]>(resized_argb_buffer_size);
+  ScratchBufferPool::Buffer resized_argb_buffer =
+      scratch_buffer_pool->Acquire(resized_argb_buffer_size);
   int resized_argb_row_bytes =
       output_buffer->dimension().width * kRgbaPixelBytes;
   int ret = libyuv::ARGBScale(
-      argb_buffer.get(), argb_row_bytes, buffer.dimension().width,
-      buffer.dimension().height, resized_argb_buffer.get(),
+      argb_buffer.data(), argb_row_bytes, buffer.dimension().width,
+      buffer.dimension().height, resized_argb_buffer.data(),
       resized_argb_row_bytes, output_buffer->dimension().width,
       output_buffer->dimension().height, interpolation);
   if (ret != 0) {
@@ -1140,7 +1150,7 @@ absl::Status ResizeRgb(
   }
 
   // Convert ARGB to RGB
-  return ConvertArgbToRgb(resized_argb_buffer.get(), resized_argb_row_bytes,
+  return ConvertArgbToRgb(resized_argb_buffer.data(), resized_argb_row_bytes,
                           output_buffer);
 }
 
@@ -1320,7 +1330,8 @@ absl::Status ResizeGray(
 
 // This method only supports kGRAY, kRGBA, and kRGB formats.
 absl::Status CropResize(const FrameBuffer& buffer, int x0, int y0, int x1,
-                        int y1, FrameBuffer* output_buffer) {
+                        int y1, FrameBuffer* output_buffer,
+                        ScratchBufferPool* scratch_buffer_pool) {
   FrameBuffer::Dimension crop_dimension = GetCropDimension(x0, x1, y0, y1);
   if (crop_dimension == output_buffer->dimension()) {
     return CropPlane(buffer, x0, y0, x1, y1, output_buffer);
@@ -1339,7 +1350,7 @@ absl::Status CropResize(const FrameBuffer& buffer, int x0, int y0, int x1,
 
   switch (buffer.format()) {
     case FrameBuffer::Format::kRGB:
-      return ResizeRgb(*adjusted_buffer, output_buffer);
+      return ResizeRgb(*adjusted_buffer, output_buffer, scratch_buffer_pool);
     case FrameBuffer::Format::kRGBA:
       return ResizeRgba(*adjusted_buffer, output_buffer);
     case FrameBuffer::Format::kGRAY:
@@ -1367,7 +1378,8 @@ absl::Status LibyuvFrameBufferUtils::Crop(const FrameBuffer& buffer, int x0,
     case FrameBuffer::Format::kRGBA:
     case FrameBuffer::Format::kRGB:
     case FrameBuffer::Format::kGRAY:
-      return CropResize(buffer, x0, y0, x1, y1, output_buffer);
+      return CropResize(buffer, x0, y0, x1, y1, output_buffer,
+                        scratch_buffer_pool_.get());
     case FrameBuffer::Format::kNV12:
     case FrameBuffer::Format::kNV21:
     case FrameBuffer::Format::kYV12:
@@ -1392,7 +1404,7 @@ absl::Status LibyuvFrameBufferUtils::Resize(const FrameBuffer& buffer,
     case FrameBuffer::Format::kNV21:
       return ResizeNv(buffer, output_buffer);
     case FrameBuffer::Format::kRGB:
-      return ResizeRgb(buffer, output_buffer);
+      return ResizeRgb(buffer, output_buffer, scratch_buffer_pool_.get());
     case FrameBuffer::Format::kRGBA:
       return ResizeRgba(buffer, output_buffer);
     case FrameBuffer::Format::kGRAY:
@@ -1416,7 +1428,8 @@ absl::Status LibyuvFrameBufferUtils::ResizeNearestNeighbor(
     case FrameBuffer::Format::kNV21:
       return ResizeNv(buffer, output_buffer, libyuv::FilterMode::kFilterNone);
     case FrameBuffer::Format::kRGB:
-      return ResizeRgb(buffer, output_buffer, libyuv::FilterMode::kFilterNone);
+      return ResizeRgb(buffer, output_buffer, scratch_buffer_pool_.get(),
+                       libyuv::FilterMode::kFilterNone);
     case FrameBuffer::Format::kRGBA:
       return ResizeRgba(buffer, output_buffer, libyuv::FilterMode::kFilterNone);
     case FrameBuffer::Format::kGRAY:
@@ -1445,12 +1458,14 @@ absl::Status LibyuvFrameBufferUtils::Rotate(const FrameBuffer& buffer,
       return RotateRgba(buffer, angle_deg, output_buffer);
     case FrameBuffer::Format::kNV12:
     case FrameBuffer::Format::kNV21:
-      return RotateNv(buffer, angle_deg, output_buffer);
+      return RotateNv(buffer, angle_deg, output_buffer,
+                      scratch_buffer_pool_.get());
     case FrameBuffer::Format::kYV12:
     case FrameBuffer::Format::kYV21:
       return RotateYv(buffer, angle_deg, output_buffer);
     case FrameBuffer::Format::kRGB:
-      return RotateRgb(buffer, angle_deg, output_buffer);
+      return RotateRgb(buffer, angle_deg, output_buffer,
+                       scratch_buffer_pool_.get());
     default:
       return CreateStatusWithPayload(
           StatusCode::kInternal,
@@ -1526,9 +1541,9 @@ absl::Status LibyuvFrameBufferUtils::Convert(const FrameBuffer& buffer,
     case FrameBuffer::Format::kYV21:
       return ConvertFromYv(buffer, output_buffer);
     case FrameBuffer::Format::kRGB:
-      return ConvertFromRgb(buffer, output_buffer);
+      return ConvertFromRgb(buffer, output_buffer, scratch_buffer_pool_.get());
     case FrameBuffer::Format::kRGBA:
-      return ConvertFromRgba(buffer, output_buffer);
+      return ConvertFromRgba(buffer, output_buffer, scratch_buffer_pool_.get());
     default:
       return CreateStatusWithPayload(
           StatusCode::kInternal,
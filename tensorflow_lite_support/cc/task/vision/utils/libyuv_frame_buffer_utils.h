@@ -16,9 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_LIBYUV_FRAME_BUFFER_UTILS_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_LIBYUV_FRAME_BUFFER_UTILS_H_
 
+#include <memory>
+#include <utility>
+
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils_interface.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
 
 namespace tflite {
 namespace task {
@@ -30,7 +34,14 @@ namespace vision {
 // functionality support.
 class LibyuvFrameBufferUtils : public FrameBufferUtilsInterface {
  public:
-  LibyuvFrameBufferUtils() = default;
+  // Intermediate buffers, needed by the operations libyuv doesn't support
+  // natively (e.g. kRGB rotation), are acquired from `scratch_buffer_pool`. A
+  // pool owned by this instance is used if none is provided.
+  explicit LibyuvFrameBufferUtils(
+      std::shared_ptr<ScratchBufferPool> scratch_buffer_pool = nullptr)
+      : scratch_buffer_pool_(scratch_buffer_pool != nullptr
+                                 ? std::move(scratch_buffer_pool)
+                                 : std::make_shared<ScratchBufferPool>()) {}
   ~LibyuvFrameBufferUtils() override = default;
 
   // Crops input `buffer` to the specified subregions and resizes the cropped
@@ -73,6 +84,9 @@ class LibyuvFrameBufferUtils : public FrameBufferUtilsInterface {
   // Grayscale format cannot be converted to other formats.
   absl::Status Convert(const FrameBuffer& buffer,
                        FrameBuffer* output_buffer) override;
+
+ private:
+  std::shared_ptr<ScratchBufferPool> scratch_buffer_pool_;
 };
 
 }  // namespace vision
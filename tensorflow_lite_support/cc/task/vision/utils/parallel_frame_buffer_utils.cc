@@ -0,0 +1,271 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/parallel_frame_buffer_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/synchronization/blocking_counter.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+// Minimum number of rows per band, below which the cost of scheduling bands
+// outweighs the gain of processing them in parallel.
+constexpr int kMinRowsPerBand = 64;
+
+bool IsYuv(FrameBuffer::Format format) {
+  return format == FrameBuffer::Format::kNV12 ||
+         format == FrameBuffer::Format::kNV21 ||
+         format == FrameBuffer::Format::kYV12 ||
+         format == FrameBuffer::Format::kYV21;
+}
+
+// Returns the `width` x `height` region of `buffer` whose top-left corner is
+// (`x0`, `y0`), sharing its data. For YUV formats, `x0` and `y0` must be even.
+FrameBuffer GetRegion(const FrameBuffer& buffer, int x0, int y0, int width,
+                      int height) {
+  std::vector<FrameBuffer::Plane> planes;
+  planes.reserve(buffer.plane_count());
+  for (int i = 0; i < buffer.plane_count(); ++i) {
+    FrameBuffer::Plane plane = buffer.plane(i);
+    // Chroma planes are subsampled by 2 in both directions.
+    const int divisor = (i > 0 && IsYuv(buffer.format())) ? 2 : 1;
+    plane.buffer += (y0 / divisor) * plane.stride.row_stride_bytes +
+                    (x0 / divisor) * plane.stride.pixel_stride_bytes;
+    planes.push_back(plane);
+  }
+  return FrameBuffer(planes, {width, height}, buffer.format(),
+                     buffer.orientation(), buffer.timestamp());
+}
+
+// State shared between the calling thread and the scheduled closures, which
+// may outlive the call: closures starting after all bands have been claimed
+// return immediately.
+struct BandsState {
+  BandsState(int height, int band_rows, int num_bands,
+             std::function<absl::Status(int, int)> process_band)
+      : height(height),
+        band_rows(band_rows),
+        num_bands(num_bands),
+        process_band(std::move(process_band)),
+        pending_bands(num_bands) {}
+
+  // Claims and processes bands until none is left.
+  void Run() {
+    for (int band = next_band++; band < num_bands; band = next_band++) {
+      const int first_row = band * band_rows;
+      absl::Status band_status =
+          process_band(first_row, std::min(band_rows, height - first_row));
+      if (!band_status.ok()) {
+        absl::MutexLock lock(&mutex);
+        if (status.ok()) {
+          status = std::move(band_status);
+        }
+      }
+      pending_bands.DecrementCount();
+    }
+  }
+
+  const int height;
+  const int band_rows;
+  const int num_bands;
+  const std::function<absl::Status(int, int)> process_band;
+  std::atomic<int> next_band{0};
+  absl::BlockingCounter pending_bands;
+  absl::Mutex mutex;
+  absl::Status status ABSL_GUARDED_BY(mutex);
+};
+
+}  // namespace
+
+ParallelFrameBufferUtils::ParallelFrameBufferUtils(
+    std::unique_ptr<FrameBufferUtilsInterface> utils,
+    std::shared_ptr<BandExecutor> executor)
+    : utils_(std::move(utils)), executor_(std::move(executor)) {}
+
+absl::Status ParallelFrameBufferUtils::ProcessBands(
+    int height, std::function<absl::Status(int, int)> process_band) {
+  const int num_bands =
+      std::min(executor_->num_threads() + 1, height / kMinRowsPerBand);
+  if (num_bands <= 1) {
+    return process_band(0, height);
+  }
+  // Round band heights up to an even number of rows.
+  const int band_rows = ((height + num_bands - 1) / num_bands + 1) / 2 * 2;
+  auto state = std::make_shared<BandsState>(
+      height, band_rows, (height + band_rows - 1) / band_rows,
+      std::move(process_band));
+  for (int i = 1; i < state->num_bands; ++i) {
+    // Bands that can't be scheduled are processed by the calling thread.
+    if (!executor_->Schedule([state]() { state->Run(); }).ok()) {
+      break;
+    }
+  }
+  state->Run();
+  state->pending_bands.Wait();
+  absl::MutexLock lock(&state->mutex);
+  return state->status;
+}
+
+absl::Status ParallelFrameBufferUtils::Crop(const FrameBuffer& buffer, int x0,
+                                            int y0, int x1, int y1,
+                                            FrameBuffer* output_buffer) {
+  const FrameBuffer::Dimension crop_dimension = {x1 - x0 + 1, y1 - y0 + 1};
+  if (output_buffer->dimension() != crop_dimension) {
+    // Cropping involves resizing.
+    return CropResize(buffer, x0, y0, x1, y1, output_buffer);
+  }
+  return ProcessBands(crop_dimension.height, [&](int first_row, int num_rows) {
+    FrameBuffer output_band = GetRegion(*output_buffer, 0, first_row,
+                                        crop_dimension.width, num_rows);
+    return utils_->Crop(buffer, x0, y0 + first_row, x1,
+                        y0 + first_row + num_rows - 1, &output_band);
+  });
+}
+
+absl::Status ParallelFrameBufferUtils::Resize(const FrameBuffer& buffer,
+                                              FrameBuffer* output_buffer) {
+  if (!utils_->SupportsCropResizeRows(buffer.format())) {
+    return utils_->Resize(buffer, output_buffer);
+  }
+  return CropResize(buffer, /*x0=*/0, /*y0=*/0, buffer.dimension().width - 1,
+                    buffer.dimension().height - 1, output_buffer);
+}
+
+absl::Status ParallelFrameBufferUtils::CropResize(const FrameBuffer& buffer,
+                                                  int x0, int y0, int x1,
+                                                  int y1,
+                                                  FrameBuffer* output_buffer) {
+  if (!utils_->SupportsCropResizeRows(buffer.format())) {
+    return utils_->Crop(buffer, x0, y0, x1, y1, output_buffer);
+  }
+  return ProcessBands(
+      output_buffer->dimension().height, [&](int first_row, int num_rows) {
+        return utils_->CropResizeRows(buffer, x0, y0, x1, y1, first_row,
+                                      num_rows, output_buffer);
+      });
+}
+
+absl::Status ParallelFrameBufferUtils::ResizeNearestNeighbor(
+    const FrameBuffer& buffer, FrameBuffer* output_buffer) {
+  return utils_->ResizeNearestNeighbor(buffer, output_buffer);
+}
+
+absl::Status ParallelFrameBufferUtils::Rotate(const FrameBuffer& buffer,
+                                              int angle_deg,
+                                              FrameBuffer* output_buffer) {
+  const int width = buffer.dimension().width;
+  const int height = buffer.dimension().height;
+  const bool is_yuv = IsYuv(buffer.format());
+  const FrameBuffer::Dimension output_dimension = output_buffer->dimension();
+  if (angle_deg == 180 && output_dimension == buffer.dimension() &&
+      !(is_yuv && height % 2 != 0)) {
+    // Output rows come from the mirrored input rows.
+    return ProcessBands(height, [&](int first_row, int num_rows) {
+      FrameBuffer input_band = GetRegion(
+          buffer, 0, height - first_row - num_rows, width, num_rows);
+      FrameBuffer output_band =
+          GetRegion(*output_buffer, 0, first_row, width, num_rows);
+      return utils_->Rotate(input_band, angle_deg, &output_band);
+    });
+  }
+  if ((angle_deg == 90 || angle_deg == 270) &&
+      output_dimension.width == height && output_dimension.height == width &&
+      !(is_yuv && angle_deg == 90 && width % 2 != 0)) {
+    // Output rows come from input columns: for a counter-clockwise rotation by
+    // 90 degrees, the last column becomes the first row.
+    return ProcessBands(width, [&](int first_row, int num_rows) {
+      const int first_column =
+          angle_deg == 90 ? width - first_row - num_rows : first_row;
+      FrameBuffer input_band =
+          GetRegion(buffer, first_column, 0, num_rows, height);
+      FrameBuffer output_band =
+          GetRegion(*output_buffer, 0, first_row, height, num_rows);
+      return utils_->Rotate(input_band, angle_deg, &output_band);
+    });
+  }
+  return utils_->Rotate(buffer, angle_deg, output_buffer);
+}
+
+absl::Status ParallelFrameBufferUtils::FlipHorizontally(
+    const FrameBuffer& buffer, FrameBuffer* output_buffer) {
+  if (output_buffer->dimension() != buffer.dimension()) {
+    return utils_->FlipHorizontally(buffer, output_buffer);
+  }
+  const int width = buffer.dimension().width;
+  return ProcessBands(buffer.dimension().height, [&](int first_row,
+                                                     int num_rows) {
+    FrameBuffer input_band = GetRegion(buffer, 0, first_row, width, num_rows);
+    FrameBuffer output_band =
+        GetRegion(*output_buffer, 0, first_row, width, num_rows);
+    return utils_->FlipHorizontally(input_band, &output_band);
+  });
+}
+
+absl::Status ParallelFrameBufferUtils::FlipVertically(
+    const FrameBuffer& buffer, FrameBuffer* output_buffer) {
+  const int width = buffer.dimension().width;
+  const int height = buffer.dimension().height;
+  if (output_buffer->dimension() != buffer.dimension() ||
+      (IsYuv(buffer.format()) && height % 2 != 0)) {
+    return utils_->FlipVertically(buffer, output_buffer);
+  }
+  return ProcessBands(height, [&](int first_row, int num_rows) {
+    FrameBuffer input_band = GetRegion(
+        buffer, 0, height - first_row - num_rows, width, num_rows);
+    FrameBuffer output_band =
+        GetRegion(*output_buffer, 0, first_row, width, num_rows);
+    return utils_->FlipVertically(input_band, &output_band);
+  });
+}
+
+absl::Status ParallelFrameBufferUtils::Convert(const FrameBuffer& buffer,
+                                               FrameBuffer* output_buffer) {
+  if (output_buffer->dimension() != buffer.dimension()) {
+    return utils_->Convert(buffer, output_buffer);
+  }
+  const int width = buffer.dimension().width;
+  return ProcessBands(buffer.dimension().height, [&](int first_row,
+                                                     int num_rows) {
+    FrameBuffer input_band = GetRegion(buffer, 0, first_row, width, num_rows);
+    FrameBuffer output_band =
+        GetRegion(*output_buffer, 0, first_row, width, num_rows);
+    return utils_->Convert(input_band, &output_band);
+  });
+}
+
+bool ParallelFrameBufferUtils::SupportsCropResizeRows(
+    FrameBuffer::Format format) const {
+  return utils_->SupportsCropResizeRows(format);
+}
+
+absl::Status ParallelFrameBufferUtils::CropResizeRows(
+    const FrameBuffer& buffer, int x0, int y0, int x1, int y1, int first_row,
+    int num_rows, FrameBuffer* output_buffer) {
+  return utils_->CropResizeRows(buffer, x0, y0, x1, y1, first_row, num_rows,
+                                output_buffer);
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
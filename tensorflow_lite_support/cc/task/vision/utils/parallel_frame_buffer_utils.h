@@ -0,0 +1,102 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PARALLEL_FRAME_BUFFER_UTILS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PARALLEL_FRAME_BUFFER_UTILS_H_
+
+#include <functional>
+#include <memory>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/band_executor.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils_interface.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Image processing engine running the operations of another engine in
+// parallel, by splitting the output buffer into horizontal bands of rows which
+// are processed independently on the threads of a `BandExecutor`, the calling
+// thread included.
+//
+// Operations where each output row depends on a fixed set of input rows or
+// columns are split: crop without resizing, rotation, flips and format
+// conversion. Band boundaries are kept on even rows so that chroma planes of
+// YUV formats are split consistently, and YUV operations that would map them
+// to odd input rows or columns (e.g. vertical flip of an odd-height frame) are
+// run serially. Bilinear resizing, with or without cropping, is split for the
+// formats the wrapped engine supports in `CropResizeRows`, which interpolates
+// each band on the sampling grid of the whole image: splitting the image
+// itself would change the results. Other resizing operations and small images
+// are processed serially.
+//
+// Results are identical to those of the wrapped engine, which must support
+// concurrent calls. Scheduled bands that don't get a free worker are processed
+// by the calling thread, so that calls never wait on busy workers: it is safe
+// to use the executor running the calls themselves.
+class ParallelFrameBufferUtils : public FrameBufferUtilsInterface {
+ public:
+  ParallelFrameBufferUtils(std::unique_ptr<FrameBufferUtilsInterface> utils,
+                           std::shared_ptr<BandExecutor> executor);
+  ~ParallelFrameBufferUtils() override = default;
+
+  absl::Status Crop(const FrameBuffer& buffer, int x0, int y0, int x1, int y1,
+                    FrameBuffer* output_buffer) override;
+
+  absl::Status Resize(const FrameBuffer& buffer,
+                      FrameBuffer* output_buffer) override;
+
+  absl::Status ResizeNearestNeighbor(const FrameBuffer& buffer,
+                                     FrameBuffer* output_buffer) override;
+
+  absl::Status Rotate(const FrameBuffer& buffer, int angle_deg,
+                      FrameBuffer* output_buffer) override;
+
+  absl::Status FlipHorizontally(const FrameBuffer& buffer,
+                                FrameBuffer* output_buffer) override;
+
+  absl::Status FlipVertically(const FrameBuffer& buffer,
+                              FrameBuffer* output_buffer) override;
+
+  absl::Status Convert(const FrameBuffer& buffer,
+                       FrameBuffer* output_buffer) override;
+
+  bool SupportsCropResizeRows(FrameBuffer::Format format) const override;
+
+  absl::Status CropResizeRows(const FrameBuffer& buffer, int x0, int y0,
+                              int x1, int y1, int first_row, int num_rows,
+                              FrameBuffer* output_buffer) override;
+
+ private:
+  // Crops and resizes `buffer` through `CropResizeRows` on bands of output
+  // rows if the wrapped engine supports it, or through `Crop` otherwise.
+  absl::Status CropResize(const FrameBuffer& buffer, int x0, int y0, int x1,
+                          int y1, FrameBuffer* output_buffer);
+
+  // Splits rows `[0, height)` into bands and calls `process_band(first_row,
+  // num_rows)` for each of them in parallel. Returns the first error, if any.
+  absl::Status ProcessBands(
+      int height, std::function<absl::Status(int, int)> process_band);
+
+  std::unique_ptr<FrameBufferUtilsInterface> utils_;
+  std::shared_ptr<BandExecutor> executor_;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_PARALLEL_FRAME_BUFFER_UTILS_H_
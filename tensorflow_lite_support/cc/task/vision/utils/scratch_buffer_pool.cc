@@ -0,0 +1,96 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+ScratchBufferPool::Buffer& ScratchBufferPool::Buffer::operator=(
+    Buffer&& other) {
+  if (this != &other) {
+    Release();
+    pool_ = other.pool_;
+    data_ = std::move(other.data_);
+    size_ = other.size_;
+    other.pool_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+void ScratchBufferPool::Buffer::Release() {
+  if (pool_ != nullptr && data_ != nullptr) {
+    pool_->Release(std::move(data_), size_);
+  }
+  pool_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+ScratchBufferPool::Buffer ScratchBufferPool::Acquire(size_t size) {
+  Buffer buffer;
+  buffer.pool_ = this;
+  {
+    absl::MutexLock lock(&mutex_);
+    ++stats_.num_acquisitions;
+    // Look for the smallest free buffer that fits, and for the largest one in
+    // case none does.
+    auto best_fit = free_buffers_.end();
+    auto largest = free_buffers_.end();
+    for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+      if (it->first >= size &&
+          (best_fit == free_buffers_.end() || it->first < best_fit->first)) {
+        best_fit = it;
+      }
+      if (largest == free_buffers_.end() || it->first > largest->first) {
+        largest = it;
+      }
+    }
+    if (best_fit != free_buffers_.end()) {
+      buffer.size_ = best_fit->first;
+      buffer.data_ = std::move(best_fit->second);
+      free_buffers_.erase(best_fit);
+      return buffer;
+    }
+    // Replace the largest free buffer, if any, rather than keeping buffers
+    // that are too small around.
+    if (largest != free_buffers_.end()) {
+      stats_.allocated_bytes -= largest->first;
+      free_buffers_.erase(largest);
+    }
+    ++stats_.num_allocations;
+    stats_.allocated_bytes += size;
+  }
+  // Default-initialized: the caller overwrites the content anyway.
+  buffer.data_ = std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+  buffer.size_ = size;
+  return buffer;
+}
+
+ScratchBufferPool::Stats ScratchBufferPool::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+void ScratchBufferPool::Release(std::unique_ptr<uint8_t[]> data, size_t size) {
+  absl::MutexLock lock(&mutex_);
+  free_buffers_.emplace_back(size, std::move(data));
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
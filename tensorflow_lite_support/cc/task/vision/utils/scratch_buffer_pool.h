@@ -0,0 +1,107 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SCRATCH_BUFFER_POOL_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SCRATCH_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Thread-safe pool of scratch buffers, used by image processing to hold
+// intermediate results. Buffers are acquired for the duration of an operation
+// and returned to the pool when their handle goes out of scope, so that the
+// memory is reused across frames instead of being allocated for each of them.
+//
+// Free buffers are released along with the pool, or when a request does not
+// fit in any of them: the largest free buffer is then replaced by a new one of
+// the requested size. The footprint of the pool is therefore bounded by the
+// peak demand: e.g. processing frames of a constant size on a single thread
+// only allocates memory for the first frame, and frames of growing sizes do
+// not leave outgrown buffers behind.
+class ScratchBufferPool {
+ public:
+  // Handle on a buffer of the pool, which is returned to it on destruction.
+  class Buffer {
+   public:
+    Buffer() = default;
+    ~Buffer() { Release(); }
+    Buffer(Buffer&& other) { *this = std::move(other); }
+    Buffer& operator=(Buffer&& other);
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    uint8_t* data() const { return data_.get(); }
+    // Capacity of the buffer, which may exceed the requested size.
+    size_t size() const { return size_; }
+
+   private:
+    friend class ScratchBufferPool;
+
+    void Release();
+
+    ScratchBufferPool* pool_ = nullptr;
+    std::unique_ptr<uint8_t[]> data_;
+    size_t size_ = 0;
+  };
+
+  // Allocation counters, for monitoring and testing purposes.
+  struct Stats {
+    // Number of calls to `Acquire`.
+    int64_t num_acquisitions = 0;
+    // Number of calls to `Acquire` that could not reuse a free buffer, and
+    // allocated a new one instead.
+    int64_t num_allocations = 0;
+    // Total size of the buffers currently owned by the pool, including the
+    // acquired ones.
+    int64_t allocated_bytes = 0;
+  };
+
+  ScratchBufferPool() = default;
+  // ScratchBufferPool is neither copyable nor movable.
+  ScratchBufferPool(const ScratchBufferPool&) = delete;
+  ScratchBufferPool& operator=(const ScratchBufferPool&) = delete;
+
+  // Returns a buffer of at least `size` bytes, reusing the smallest free buffer
+  // that is large enough if any, and otherwise allocating a new one in place of
+  // the largest free buffer. The content of the buffer is unspecified.
+  //
+  // The pool must outlive the returned buffer.
+  Buffer Acquire(size_t size);
+
+  Stats GetStats() const;
+
+ private:
+  void Release(std::unique_ptr<uint8_t[]> data, size_t size);
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::pair<size_t, std::unique_ptr<uint8_t[]>>> free_buffers_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SCRATCH_BUFFER_POOL_H_
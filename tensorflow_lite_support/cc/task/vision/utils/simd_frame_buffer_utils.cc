@@ -0,0 +1,598 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/simd_frame_buffer_utils.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/common.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+using ::absl::StatusCode;
+using ::tflite::support::CreateStatusWithPayload;
+using ::tflite::support::TfLiteSupportStatus;
+
+namespace {
+
+// Number of fractional bits of the bilinear interpolation weights. With 7 bits,
+// horizontally interpolated values fit in 15 bits, so that the vertical pass
+// can use signed 16-bit multiply-adds.
+constexpr int kWeightBits = 7;
+constexpr int kWeightOne = 1 << kWeightBits;
+// Rounding offset of the vertical pass, which scales the interpolated values
+// down by the weights of both passes.
+constexpr int kInterpolationRounding = 1 << (2 * kWeightBits - 1);
+
+// BT.601 limited range YUV to RGB conversion coefficients, in 6-bit fixed point
+// as in libyuv. The luma term is computed from `y * 0x0101` with 16 extra
+// fractional bits and includes the offset of the luma range as well as the
+// rounding of the final shift.
+constexpr int kYuvBits = 6;
+constexpr int kYToRgb = 18997;      // 1.164 * 64 * 65536 / 257
+constexpr int kYToRgbBias = -1160;  // 1.164 * 64 * -16 + 32
+constexpr int kUToB = 129;          // 2.018 * 64
+constexpr int kUToG = 25;           // 0.391 * 64
+constexpr int kVToG = 52;           // 0.813 * 64
+constexpr int kVToR = 102;          // 1.596 * 64
+
+// Bilinear interpolation taps along one axis: output sample `i` is
+// `(kWeightOne - weight) * input[index0] + weight * input[index1]`, scaled down
+// by `kWeightOne`.
+struct Tap {
+  int index0;
+  int index1;
+  int weight;
+};
+
+// Returns the taps resizing `input_size` samples to `output_size` samples. The
+// 16.16 fixed point positions are those of libyuv's bilinear scaler: pixel
+// centers are aligned when downscaling, edges when upscaling.
+std::vector<Tap> ComputeTaps(int input_size, int output_size) {
+  int64_t step = 0;
+  int64_t position = 0;
+  if (output_size <= input_size) {
+    step = (static_cast<int64_t>(input_size) << 16) / output_size;
+    position = (step >> 1) - 32768;
+  } else if (input_size > 1) {
+    step = ((static_cast<int64_t>(input_size) << 16) - 0x00010001) /
+           (output_size - 1);
+  }
+  const int64_t max_position = static_cast<int64_t>(input_size - 1) << 16;
+  std::vector<Tap> taps(output_size);
+  for (int i = 0; i < output_size; ++i, position += step) {
+    const int64_t clamped_position =
+        std::min(std::max<int64_t>(position, 0), max_position);
+    const int index0 = static_cast<int>(clamped_position >> 16);
+    taps[i] = {index0, std::min(index0 + 1, input_size - 1),
+               static_cast<int>(clamped_position >> (16 - kWeightBits)) &
+                   (kWeightOne - 1)};
+  }
+  return taps;
+}
+
+// Interpolates `input_row` horizontally at the given taps, keeping the
+// `kWeightBits` fractional bits of the results.
+template <int kChannels>
+void InterpolateRow(const uint8_t* input_row, const std::vector<Tap>& taps,
+                    int16_t* output_row) {
+  for (const Tap& tap : taps) {
+    const uint8_t* pixel0 = input_row + tap.index0 * kChannels;
+    const uint8_t* pixel1 = input_row + tap.index1 * kChannels;
+    const int weight0 = kWeightOne - tap.weight;
+    for (int c = 0; c < kChannels; ++c) {
+      *output_row++ =
+          static_cast<int16_t>(weight0 * pixel0[c] + tap.weight * pixel1[c]);
+    }
+  }
+}
+
+// Interpolates vertically between the `size` values of two rows produced by
+// `InterpolateRow`, and rounds the results to 8 bits.
+void BlendRows(const int16_t* row0, const int16_t* row1, int weight, int size,
+               uint8_t* output_row) {
+  const int weight0 = kWeightOne - weight;
+  int i = 0;
+#ifdef __SSE2__
+  // Interleaving both rows lets a single multiply-add apply both weights.
+  const __m128i weights = _mm_set1_epi32((weight << 16) | weight0);
+  const __m128i rounding = _mm_set1_epi32(kInterpolationRounding);
+  for (; i + 16 <= size; i += 16) {
+    __m128i blended[2];
+    for (int half = 0; half < 2; ++half) {
+      const __m128i values0 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(row0 + i + 8 * half));
+      const __m128i values1 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(row1 + i + 8 * half));
+      const __m128i low = _mm_srai_epi32(
+          _mm_add_epi32(
+              _mm_madd_epi16(_mm_unpacklo_epi16(values0, values1), weights),
+              rounding),
+          2 * kWeightBits);
+      const __m128i high = _mm_srai_epi32(
+          _mm_add_epi32(
+              _mm_madd_epi16(_mm_unpackhi_epi16(values0, values1), weights),
+              rounding),
+          2 * kWeightBits);
+      blended[half] = _mm_packs_epi32(low, high);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output_row + i),
+                     _mm_packus_epi16(blended[0], blended[1]));
+  }
+#elif defined __ARM_NEON
+  for (; i + 8 <= size; i += 8) {
+    const uint16x8_t values0 = vreinterpretq_u16_s16(vld1q_s16(row0 + i));
+    const uint16x8_t values1 = vreinterpretq_u16_s16(vld1q_s16(row1 + i));
+    uint32x4_t low = vmull_n_u16(vget_low_u16(values0), weight0);
+    low = vmlal_n_u16(low, vget_low_u16(values1), weight);
+    uint32x4_t high = vmull_n_u16(vget_high_u16(values0), weight0);
+    high = vmlal_n_u16(high, vget_high_u16(values1), weight);
+    const uint16x8_t blended =
+        vcombine_u16(vrshrn_n_u32(low, 2 * kWeightBits),
+                     vrshrn_n_u32(high, 2 * kWeightBits));
+    vst1_u8(output_row + i, vqmovn_u16(blended));
+  }
+#endif
+  for (; i < size; ++i) {
+    output_row[i] = static_cast<uint8_t>(
+        (weight0 * row0[i] + weight * row1[i] + kInterpolationRounding) >>
+        (2 * kWeightBits));
+  }
+}
+
+// Resizes the `input_dimension` interleaved pixels at `input` to the dimension
+// of `output_buffer` using bilinear interpolation, and writes output rows
+// `[first_row, first_row + num_rows)`. Each input row is interpolated
+// horizontally once, into one of two cached rows which are then blended into
+// as many output rows as needed.
+template <int kChannels>
+absl::Status ResizeInterleaved(const uint8_t* input, int input_row_stride,
+                               FrameBuffer::Dimension input_dimension,
+                               int first_row, int num_rows,
+                               FrameBuffer* output_buffer,
+                               ScratchBufferPool* scratch_buffer_pool) {
+  const FrameBuffer::Dimension output_dimension = output_buffer->dimension();
+  const std::vector<Tap> x_taps =
+      ComputeTaps(input_dimension.width, output_dimension.width);
+  const std::vector<Tap> y_taps =
+      ComputeTaps(input_dimension.height, output_dimension.height);
+
+  const int row_size = output_dimension.width * kChannels;
+  ScratchBufferPool::Buffer rows_buffer =
+      scratch_buffer_pool->Acquire(2 * row_size * sizeof(int16_t));
+  int16_t* rows[2] = {reinterpret_cast<int16_t*>(rows_buffer.data()),
+                      reinterpret_cast<int16_t*>(rows_buffer.data()) +
+                          row_size};
+  int row_indices[2] = {-1, -1};
+  // Returns input row `index` interpolated horizontally, overwriting the cached
+  // row which doesn't hold input row `kept_index` if needed.
+  auto get_row = [&](int index, int kept_index) -> const int16_t* {
+    for (int slot = 0; slot < 2; ++slot) {
+      if (row_indices[slot] == index) return rows[slot];
+    }
+    const int slot = row_indices[0] == kept_index ? 1 : 0;
+    InterpolateRow<kChannels>(input + index * input_row_stride, x_taps,
+                              rows[slot]);
+    row_indices[slot] = index;
+    return rows[slot];
+  };
+
+  uint8_t* output = const_cast<uint8_t*>(output_buffer->plane(0).buffer);
+  const int output_row_stride = output_buffer->plane(0).stride.row_stride_bytes;
+  for (int y = first_row; y < first_row + num_rows; ++y) {
+    const Tap& tap = y_taps[y];
+    const int16_t* row0 = get_row(tap.index0, tap.index1);
+    const int16_t* row1 =
+        tap.weight == 0 ? row0 : get_row(tap.index1, tap.index0);
+    BlendRows(row0, row1, tap.weight, row_size, output + y * output_row_stride);
+  }
+  return absl::OkStatus();
+}
+
+bool IsInterleavedFormat(FrameBuffer::Format format) {
+  return format == FrameBuffer::Format::kRGB ||
+         format == FrameBuffer::Format::kRGBA ||
+         format == FrameBuffer::Format::kGRAY;
+}
+
+// Resizes the (x0, y0), (x1, y1) region of a kRGB, kRGBA or kGRAY `buffer`
+// to the dimension of `output_buffer`, and writes output rows
+// `[first_row, first_row + num_rows)`.
+absl::Status CropResizeInterleaved(const FrameBuffer& buffer, int x0, int y0,
+                                   int x1, int y1, int first_row, int num_rows,
+                                   FrameBuffer* output_buffer,
+                                   ScratchBufferPool* scratch_buffer_pool) {
+  if (buffer.plane_count() > 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Only single plane is supported for format %i.",
+                        buffer.format()),
+        TfLiteSupportStatus::kImageProcessingError);
+  }
+  ASSIGN_OR_RETURN(int pixel_stride, GetPixelStrides(buffer.format()));
+  const int row_stride = buffer.plane(0).stride.row_stride_bytes;
+  // Cropping is achieved by adjusting origin to (x0, y0).
+  const uint8_t* input =
+      buffer.plane(0).buffer + row_stride * y0 + x0 * pixel_stride;
+  const FrameBuffer::Dimension crop_dimension = {x1 - x0 + 1, y1 - y0 + 1};
+  switch (buffer.format()) {
+    case FrameBuffer::Format::kRGB:
+      return ResizeInterleaved<kRgbPixelBytes>(
+          input, row_stride, crop_dimension, first_row, num_rows,
+          output_buffer, scratch_buffer_pool);
+    case FrameBuffer::Format::kRGBA:
+      return ResizeInterleaved<kRgbaPixelBytes>(
+          input, row_stride, crop_dimension, first_row, num_rows,
+          output_buffer, scratch_buffer_pool);
+    case FrameBuffer::Format::kGRAY:
+      return ResizeInterleaved<kGrayPixelBytes>(
+          input, row_stride, crop_dimension, first_row, num_rows,
+          output_buffer, scratch_buffer_pool);
+    default:
+      return CreateStatusWithPayload(
+          StatusCode::kInternal,
+          absl::StrFormat("Format %i is not supported.", buffer.format()),
+          TfLiteSupportStatus::kImageProcessingError);
+  }
+}
+
+inline uint8_t ClampToUint8(int value) {
+  return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+void ConvertYuvPixelToRgb(int y, int u, int v, uint8_t* rgb) {
+  const int luma = ((y * 0x0101 * kYToRgb) >> 16) + kYToRgbBias;
+  u -= 128;
+  v -= 128;
+  rgb[0] = ClampToUint8((luma + kVToR * v) >> kYuvBits);
+  rgb[1] = ClampToUint8((luma - kUToG * u - kVToG * v) >> kYuvBits);
+  rgb[2] = ClampToUint8((luma + kUToB * u) >> kYuvBits);
+}
+
+// Converts a row of YUV420 pixels to RGB, where the chroma samples of pixel `x`
+// are at `(x / 2) * kUvPixelStride` in `u_row` and `v_row`. Vectorized blocks
+// of 8 pixels use 16-bit lanes, whose saturation only affects values which are
+// clamped to 255 anyway, so that results match the scalar code.
+template <int kUvPixelStride>
+void ConvertYuvRowToRgb(const uint8_t* y_row, const uint8_t* u_row,
+                        const uint8_t* v_row, int width, uint8_t* rgb_row) {
+  static_assert(kUvPixelStride == 1 || kUvPixelStride == 2,
+                "Only planar and semi-planar chroma are supported.");
+  int x = 0;
+#if defined __SSE2__ || defined __ARM_NEON
+  // Semi-planar chroma samples are loaded from the first of both interleaved
+  // planes, so as not to read past the end of the row.
+  const uint8_t* uv_row = std::min(u_row, v_row);
+  const bool is_u_first = u_row < v_row;
+#endif
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i low_word_mask = _mm_set1_epi32(0xffff);
+  for (; x + 8 <= width; x += 8) {
+    // Chroma samples, each repeated for the two pixels it covers.
+    __m128i u;
+    __m128i v;
+    if (kUvPixelStride == 1) {
+      int32_t u_bits;
+      int32_t v_bits;
+      std::memcpy(&u_bits, u_row + x / 2, sizeof(u_bits));
+      std::memcpy(&v_bits, v_row + x / 2, sizeof(v_bits));
+      u = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u_bits), zero);
+      v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v_bits), zero);
+      u = _mm_unpacklo_epi16(u, u);
+      v = _mm_unpacklo_epi16(v, v);
+    } else {
+      const __m128i uv = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(uv_row + x)), zero);
+      const __m128i first = _mm_and_si128(uv, low_word_mask);
+      const __m128i second = _mm_srli_epi32(uv, 16);
+      const __m128i first_pairs =
+          _mm_or_si128(first, _mm_slli_epi32(first, 16));
+      const __m128i second_pairs =
+          _mm_or_si128(second, _mm_slli_epi32(second, 16));
+      u = is_u_first ? first_pairs : second_pairs;
+      v = is_u_first ? second_pairs : first_pairs;
+    }
+    u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+    // Unpacking luma with itself yields `y * 0x0101`.
+    const __m128i y =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y_row + x));
+    const __m128i luma =
+        _mm_add_epi16(_mm_mulhi_epu16(_mm_unpacklo_epi8(y, y),
+                                      _mm_set1_epi16(kYToRgb)),
+                      _mm_set1_epi16(kYToRgbBias));
+
+    const __m128i r = _mm_srai_epi16(
+        _mm_adds_epi16(luma, _mm_mullo_epi16(v, _mm_set1_epi16(kVToR))),
+        kYuvBits);
+    const __m128i g = _mm_srai_epi16(
+        _mm_subs_epi16(
+            _mm_subs_epi16(luma, _mm_mullo_epi16(u, _mm_set1_epi16(kUToG))),
+            _mm_mullo_epi16(v, _mm_set1_epi16(kVToG))),
+        kYuvBits);
+    const __m128i b = _mm_srai_epi16(
+        _mm_adds_epi16(luma, _mm_mullo_epi16(u, _mm_set1_epi16(kUToB))),
+        kYuvBits);
+
+    // SSE2 has no byte shuffle to pack the channels: pixels are interleaved
+    // as (r, g, b, 0) words, whose stores overlap by one byte.
+    const __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r),
+                                         _mm_packus_epi16(g, g));
+    const __m128i b0 = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), zero);
+    alignas(16) uint32_t pixels[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(pixels),
+                    _mm_unpacklo_epi16(rg, b0));
+    _mm_store_si128(reinterpret_cast<__m128i*>(pixels + 4),
+                    _mm_unpackhi_epi16(rg, b0));
+    uint8_t* rgb = rgb_row + x * kRgbPixelBytes;
+    for (int i = 0; i < 7; ++i) {
+      std::memcpy(rgb + kRgbPixelBytes * i, &pixels[i], sizeof(pixels[i]));
+    }
+    std::memcpy(rgb + kRgbPixelBytes * 7, &pixels[7], kRgbPixelBytes);
+  }
+#elif defined __ARM_NEON
+  for (; x + 8 <= width; x += 8) {
+    // Chroma samples, each repeated for the two pixels it covers.
+    uint8x8_t u;
+    uint8x8_t v;
+    if (kUvPixelStride == 1) {
+      uint32_t u_bits;
+      uint32_t v_bits;
+      std::memcpy(&u_bits, u_row + x / 2, sizeof(u_bits));
+      std::memcpy(&v_bits, v_row + x / 2, sizeof(v_bits));
+      const uint8x8_t u_samples = vreinterpret_u8_u32(vdup_n_u32(u_bits));
+      const uint8x8_t v_samples = vreinterpret_u8_u32(vdup_n_u32(v_bits));
+      u = vzip_u8(u_samples, u_samples).val[0];
+      v = vzip_u8(v_samples, v_samples).val[0];
+    } else {
+      uint64_t uv_bits;
+      std::memcpy(&uv_bits, uv_row + x, sizeof(uv_bits));
+      const uint8x8_t uv = vcreate_u8(uv_bits);
+      const uint8x8x2_t planes = vuzp_u8(uv, uv);
+      const uint8x8_t first = vzip_u8(planes.val[0], planes.val[0]).val[0];
+      const uint8x8_t second = vzip_u8(planes.val[1], planes.val[1]).val[0];
+      u = is_u_first ? first : second;
+      v = is_u_first ? second : first;
+    }
+    const int16x8_t u_centered = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128));
+    const int16x8_t v_centered = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128));
+
+    const uint16x8_t y = vmulq_n_u16(vmovl_u8(vld1_u8(y_row + x)), 0x0101);
+    const uint16x8_t scaled_y =
+        vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(y), kYToRgb), 16),
+                     vshrn_n_u32(vmull_n_u16(vget_high_u16(y), kYToRgb), 16));
+    const int16x8_t luma =
+        vaddq_s16(vreinterpretq_s16_u16(scaled_y), vdupq_n_s16(kYToRgbBias));
+
+    uint8x8x3_t rgb;
+    rgb.val[0] = vqmovun_s16(vshrq_n_s16(
+        vqaddq_s16(luma, vmulq_n_s16(v_centered, kVToR)), kYuvBits));
+    rgb.val[1] = vqmovun_s16(vshrq_n_s16(
+        vqsubq_s16(vqsubq_s16(luma, vmulq_n_s16(u_centered, kUToG)),
+                   vmulq_n_s16(v_centered, kVToG)),
+        kYuvBits));
+    rgb.val[2] = vqmovun_s16(vshrq_n_s16(
+        vqaddq_s16(luma, vmulq_n_s16(u_centered, kUToB)), kYuvBits));
+    vst3_u8(rgb_row + x * kRgbPixelBytes, rgb);
+  }
+#endif
+  for (; x < width; ++x) {
+    const int uv_offset = (x / 2) * kUvPixelStride;
+    ConvertYuvPixelToRgb(y_row[x], u_row[uv_offset], v_row[uv_offset],
+                         rgb_row + x * kRgbPixelBytes);
+  }
+}
+
+// Converts a kNV12, kNV21, kYV12 or kYV21 `buffer` to the kRGB
+// `output_buffer`.
+absl::Status ConvertYuvToRgb(const FrameBuffer& buffer,
+                             FrameBuffer* output_buffer) {
+  ASSIGN_OR_RETURN(FrameBuffer::YuvData yuv_data,
+                   FrameBuffer::GetYuvDataFromFrameBuffer(buffer));
+  if (yuv_data.uv_pixel_stride != 1 && yuv_data.uv_pixel_stride != 2) {
+    return CreateStatusWithPayload(
+        StatusCode::kInternal,
+        absl::StrFormat("Unsupported UV pixel stride %d.",
+                        yuv_data.uv_pixel_stride),
+        TfLiteSupportStatus::kImageProcessingError);
+  }
+  uint8_t* output = const_cast<uint8_t*>(output_buffer->plane(0).buffer);
+  const int output_row_stride = output_buffer->plane(0).stride.row_stride_bytes;
+  const FrameBuffer::Dimension dimension = buffer.dimension();
+  for (int y = 0; y < dimension.height; ++y) {
+    const uint8_t* y_row = yuv_data.y_buffer + y * yuv_data.y_row_stride;
+    const int uv_row_offset = (y / 2) * yuv_data.uv_row_stride;
+    uint8_t* rgb_row = output + y * output_row_stride;
+    if (yuv_data.uv_pixel_stride == 1) {
+      ConvertYuvRowToRgb<1>(y_row, yuv_data.u_buffer + uv_row_offset,
+                            yuv_data.v_buffer + uv_row_offset,
+                            dimension.width, rgb_row);
+    } else {
+      ConvertYuvRowToRgb<2>(y_row, yuv_data.u_buffer + uv_row_offset,
+                            yuv_data.v_buffer + uv_row_offset,
+                            dimension.width, rgb_row);
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Converts a kRGBA `buffer` to the kRGB `output_buffer` by dropping the alpha
+// channel.
+absl::Status ConvertRgbaToRgb(const FrameBuffer& buffer,
+                              FrameBuffer* output_buffer) {
+  const uint8_t* input = buffer.plane(0).buffer;
+  const int input_row_stride = buffer.plane(0).stride.row_stride_bytes;
+  uint8_t* output = const_cast<uint8_t*>(output_buffer->plane(0).buffer);
+  const int output_row_stride = output_buffer->plane(0).stride.row_stride_bytes;
+  const FrameBuffer::Dimension dimension = buffer.dimension();
+  for (int y = 0; y < dimension.height; ++y) {
+    const uint8_t* rgba_row = input + y * input_row_stride;
+    uint8_t* rgb_row = output + y * output_row_stride;
+    int x = 0;
+#ifdef __ARM_NEON
+    for (; x + 16 <= dimension.width; x += 16) {
+      const uint8x16x4_t rgba = vld4q_u8(rgba_row + x * kRgbaPixelBytes);
+      uint8x16x3_t rgb;
+      rgb.val[0] = rgba.val[0];
+      rgb.val[1] = rgba.val[1];
+      rgb.val[2] = rgba.val[2];
+      vst3q_u8(rgb_row + x * kRgbPixelBytes, rgb);
+    }
+#endif
+    for (; x < dimension.width; ++x) {
+      std::memcpy(rgb_row + x * kRgbPixelBytes, rgba_row + x * kRgbaPixelBytes,
+                  kRgbPixelBytes);
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+SimdFrameBufferUtils::SimdFrameBufferUtils(
+    std::shared_ptr<ScratchBufferPool> scratch_buffer_pool)
+    : scratch_buffer_pool_(scratch_buffer_pool != nullptr
+                               ? std::move(scratch_buffer_pool)
+                               : std::make_shared<ScratchBufferPool>()),
+      libyuv_utils_(scratch_buffer_pool_) {}
+
+absl::Status SimdFrameBufferUtils::Crop(const FrameBuffer& buffer, int x0,
+                                        int y0, int x1, int y1,
+                                        FrameBuffer* output_buffer) {
+  RETURN_IF_ERROR(ValidateBufferPlaneMetadata(buffer));
+  RETURN_IF_ERROR(ValidateBufferPlaneMetadata(*output_buffer));
+  RETURN_IF_ERROR(
+      ValidateCropBufferInputs(buffer, *output_buffer, x0, y0, x1, y1));
+  RETURN_IF_ERROR(ValidateBufferFormats(buffer, *output_buffer));
+
+  // Plain crops are row copies, which libyuv already performs optimally.
+  const FrameBuffer::Dimension crop_dimension = {x1 - x0 + 1, y1 - y0 + 1};
+  if (IsInterleavedFormat(buffer.format()) &&
+      crop_dimension != output_buffer->dimension()) {
+    return CropResizeInterleaved(buffer, x0, y0, x1, y1, /*first_row=*/0,
+                                 output_buffer->dimension().height,
+                                 output_buffer, scratch_buffer_pool_.get());
+  }
+  return libyuv_utils_.Crop(buffer, x0, y0, x1, y1, output_buffer);
+}
+
+absl::Status SimdFrameBufferUtils::Resize(const FrameBuffer& buffer,
+                                          FrameBuffer* output_buffer) {
+  RETURN_IF_ERROR(ValidateResizeBufferInputs(buffer, *output_buffer));
+  if (IsInterleavedFormat(buffer.format())) {
+    return CropResizeInterleaved(
+        buffer, /*x0=*/0, /*y0=*/0, buffer.dimension().width - 1,
+        buffer.dimension().height - 1, /*first_row=*/0,
+        output_buffer->dimension().height, output_buffer,
+        scratch_buffer_pool_.get());
+  }
+  // libyuv resizes YUV planes natively.
+  return libyuv_utils_.Resize(buffer, output_buffer);
+}
+
+bool SimdFrameBufferUtils::SupportsCropResizeRows(
+    FrameBuffer::Format format) const {
+  return IsInterleavedFormat(format);
+}
+
+absl::Status SimdFrameBufferUtils::CropResizeRows(const FrameBuffer& buffer,
+                                                  int x0, int y0, int x1,
+                                                  int y1, int first_row,
+                                                  int num_rows,
+                                                  FrameBuffer* output_buffer) {
+  RETURN_IF_ERROR(ValidateBufferPlaneMetadata(buffer));
+  RETURN_IF_ERROR(ValidateBufferPlaneMetadata(*output_buffer));
+  RETURN_IF_ERROR(
+      ValidateCropBufferInputs(buffer, *output_buffer, x0, y0, x1, y1));
+  RETURN_IF_ERROR(ValidateBufferFormats(buffer, *output_buffer));
+  if (first_row < 0 || num_rows < 0 ||
+      first_row + num_rows > output_buffer->dimension().height) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid rows [%d, %d) for an output of height %d.",
+                        first_row, first_row + num_rows,
+                        output_buffer->dimension().height),
+        TfLiteSupportStatus::kImageProcessingError);
+  }
+  return CropResizeInterleaved(buffer, x0, y0, x1, y1, first_row, num_rows,
+                               output_buffer, scratch_buffer_pool_.get());
+}
+
+absl::Status SimdFrameBufferUtils::ResizeNearestNeighbor(
+    const FrameBuffer& buffer, FrameBuffer* output_buffer) {
+  return libyuv_utils_.ResizeNearestNeighbor(buffer, output_buffer);
+}
+
+absl::Status SimdFrameBufferUtils::Rotate(const FrameBuffer& buffer,
+                                          int angle_deg,
+                                          FrameBuffer* output_buffer) {
+  return libyuv_utils_.Rotate(buffer, angle_deg, output_buffer);
+}
+
+absl::Status SimdFrameBufferUtils::FlipHorizontally(
+    const FrameBuffer& buffer, FrameBuffer* output_buffer) {
+  return libyuv_utils_.FlipHorizontally(buffer, output_buffer);
+}
+
+absl::Status SimdFrameBufferUtils::FlipVertically(const FrameBuffer& buffer,
+                                                  FrameBuffer* output_buffer) {
+  return libyuv_utils_.FlipVertically(buffer, output_buffer);
+}
+
+absl::Status SimdFrameBufferUtils::Convert(const FrameBuffer& buffer,
+                                           FrameBuffer* output_buffer) {
+  RETURN_IF_ERROR(
+      ValidateConvertFormats(buffer.format(), output_buffer->format()));
+  if (output_buffer->format() != FrameBuffer::Format::kRGB) {
+    return libyuv_utils_.Convert(buffer, output_buffer);
+  }
+  switch (buffer.format()) {
+    case FrameBuffer::Format::kNV12:
+    case FrameBuffer::Format::kNV21:
+    case FrameBuffer::Format::kYV12:
+    case FrameBuffer::Format::kYV21:
+      return ConvertYuvToRgb(buffer, output_buffer);
+    case FrameBuffer::Format::kRGBA:
+      return ConvertRgbaToRgb(buffer, output_buffer);
+    default:
+      return libyuv_utils_.Convert(buffer, output_buffer);
+  }
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,118 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SIMD_FRAME_BUFFER_UTILS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SIMD_FRAME_BUFFER_UTILS_H_
+
+#include <memory>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils_interface.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/libyuv_frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Image processing engine with hand-vectorized kernels for the operations on
+// the hot path of vision tasks preprocessing. Kernels use SSE2 or NEON when
+// available at compile time, and portable scalar code otherwise:
+//
+// - bilinear resizing (and cropping with resizing) of kRGB, kRGBA and kGRAY
+//   buffers, which are interpolated in place: libyuv goes through a kRGBA
+//   copy of kRGB buffers for resizing.
+// - conversion of kNV12, kNV21, kYV12, kYV21 and kRGBA buffers to kRGB.
+//
+// The other operations and formats are delegated to `LibyuvFrameBufferUtils`.
+//
+// Results are close to, but not bit-exact with, those of libyuv: interpolation
+// follows the same sampling grid with 7-bit weights, and YUV to RGB conversion
+// uses the same BT.601 limited range matrix in 6-bit fixed point. Vectorized
+// and scalar kernels produce the same bytes.
+//
+// Although this class provides public APIs, it is recommended to use the public
+// APIs defined in frame_buffer_utils.h for higher level abstraction and better
+// functionality support.
+class SimdFrameBufferUtils : public FrameBufferUtilsInterface {
+ public:
+  // Intermediate buffers, e.g. interpolated rows, are acquired from
+  // `scratch_buffer_pool`. A pool owned by this instance is used if none is
+  // provided.
+  explicit SimdFrameBufferUtils(
+      std::shared_ptr<ScratchBufferPool> scratch_buffer_pool = nullptr);
+  ~SimdFrameBufferUtils() override = default;
+
+  // Crops input `buffer` to the specified subregions and resizes the cropped
+  // region to the target image resolution defined by the `output_buffer`.
+  //
+  // (x0, y0) represents the top-left point of the buffer.
+  // (x1, y1) represents the bottom-right point of the buffer.
+  //
+  // Crop region dimensions must be equal or smaller than input `buffer`
+  // dimensions.
+  absl::Status Crop(const FrameBuffer& buffer, int x0, int y0, int x1, int y1,
+                    FrameBuffer* output_buffer) override;
+
+  // Resizes `buffer` to the size of the given `output_buffer` using bilinear
+  // interpolation.
+  absl::Status Resize(const FrameBuffer& buffer,
+                      FrameBuffer* output_buffer) override;
+
+  // Resizes `buffer` to the size of the given `output_buffer` using
+  // nearest-neighbor interpolation.
+  absl::Status ResizeNearestNeighbor(const FrameBuffer& buffer,
+                                     FrameBuffer* output_buffer) override;
+
+  // Rotates `buffer` counter-clockwise by the given `angle_deg` (in degrees).
+  //
+  // The given angle must be a multiple of 90 degrees.
+  absl::Status Rotate(const FrameBuffer& buffer, int angle_deg,
+                      FrameBuffer* output_buffer) override;
+
+  // Flips `buffer` horizontally.
+  absl::Status FlipHorizontally(const FrameBuffer& buffer,
+                                FrameBuffer* output_buffer) override;
+
+  // Flips `buffer` vertically.
+  absl::Status FlipVertically(const FrameBuffer& buffer,
+                              FrameBuffer* output_buffer) override;
+
+  // Converts `buffer`'s format to the format of the given `output_buffer`.
+  //
+  // Grayscale format cannot be converted to other formats.
+  absl::Status Convert(const FrameBuffer& buffer,
+                       FrameBuffer* output_buffer) override;
+
+  // Supports kRGB, kRGBA and kGRAY buffers, whose output rows are interpolated
+  // independently of each other.
+  bool SupportsCropResizeRows(FrameBuffer::Format format) const override;
+
+  absl::Status CropResizeRows(const FrameBuffer& buffer, int x0, int y0,
+                              int x1, int y1, int first_row, int num_rows,
+                              FrameBuffer* output_buffer) override;
+
+ private:
+  std::shared_ptr<ScratchBufferPool> scratch_buffer_pool_;
+
+  // Engine the unsupported operations are delegated to.
+  LibyuvFrameBufferUtils libyuv_utils_;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_SIMD_FRAME_BUFFER_UTILS_H_
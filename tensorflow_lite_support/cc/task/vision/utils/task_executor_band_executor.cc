@@ -0,0 +1,43 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/task_executor_band_executor.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+TaskExecutorBandExecutor::TaskExecutorBandExecutor(
+    std::shared_ptr<core::TaskExecutor> executor)
+    : executor_(std::move(executor)) {}
+
+int TaskExecutorBandExecutor::num_threads() const {
+  return executor_->num_threads();
+}
+
+absl::Status TaskExecutorBandExecutor::Schedule(
+    std::function<void()> closure) {
+  return executor_->Schedule(std::move(closure));
+}
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
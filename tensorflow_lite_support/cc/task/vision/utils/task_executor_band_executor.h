@@ -0,0 +1,51 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_TASK_EXECUTOR_BAND_EXECUTOR_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_TASK_EXECUTOR_BAND_EXECUTOR_H_
+
+#include <functional>
+#include <memory>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/band_executor.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+
+// Runs bands of rows on the worker threads of a `core::TaskExecutor`, which
+// can be shared with other users, e.g. the asynchronous inference methods of
+// `BaseTaskApi`.
+class TaskExecutorBandExecutor : public BandExecutor {
+ public:
+  explicit TaskExecutorBandExecutor(
+      std::shared_ptr<core::TaskExecutor> executor);
+  ~TaskExecutorBandExecutor() override = default;
+
+  int num_threads() const override;
+
+  absl::Status Schedule(std::function<void()> closure) override;
+
+ private:
+  std::shared_ptr<core::TaskExecutor> executor_;
+};
+
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TASK_VISION_UTILS_TASK_EXECUTOR_BAND_EXECUTOR_H_
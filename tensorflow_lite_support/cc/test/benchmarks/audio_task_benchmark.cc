@@ -0,0 +1,108 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// End-to-end benchmarks for the audio Task APIs.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/audio/audio_classifier.h"
+#include "tensorflow_lite_support/cc/task/audio/audio_embedder.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_classifier_options.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_embedder_options.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/audio/utils/audio_utils.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+
+namespace tflite {
+namespace task {
+namespace audio {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::processor::EmbeddingResult;
+
+constexpr char kAudio[] = "audio";
+constexpr char kYamNetAudioClassifierWithMetadata[] =
+    "yamnet_audio_classifier_with_metadata.tflite";
+constexpr char kSpeechClip[] = "speech.wav";
+
+void BM_AudioClassifierClassify(benchmark::State& state) {
+  AudioClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kAudio, kYamNetAudioClassifierWithMetadata));
+  StatusOr<std::unique_ptr<AudioClassifier>> audio_classifier =
+      AudioClassifier::CreateFromOptions(options);
+  if (SkipIfError(state, audio_classifier.status())) return;
+
+  // `wav_data` backs `audio_buffer` and needs to outlive it.
+  std::vector<float> wav_data;
+  uint32_t offset = 0;
+  uint32_t buffer_size = (*audio_classifier)->GetRequiredInputBufferSize();
+  StatusOr<AudioBuffer> audio_buffer =
+      LoadAudioBufferFromFile(GetBenchmarkDataPath(kAudio, kSpeechClip),
+                              &buffer_size, &offset, &wav_data);
+  if (SkipIfError(state, audio_buffer.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<ClassificationResult> result =
+        (*audio_classifier)->Classify(*audio_buffer);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1,
+                audio_buffer->GetBufferSize() * sizeof(float));
+}
+BENCHMARK(BM_AudioClassifierClassify)->Unit(benchmark::kMillisecond);
+
+// There is no audio embedding model in the test data: the embedder treats the
+// single float output of the YAMNet classifier as an embedding.
+void BM_AudioEmbedderEmbed(benchmark::State& state) {
+  AudioEmbedderOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kAudio, kYamNetAudioClassifierWithMetadata));
+  options.add_embedding_options()->set_l2_normalize(true);
+  StatusOr<std::unique_ptr<AudioEmbedder>> audio_embedder =
+      AudioEmbedder::CreateFromOptions(options);
+  if (SkipIfError(state, audio_embedder.status())) return;
+
+  // `wav_data` backs `audio_buffer` and needs to outlive it.
+  std::vector<float> wav_data;
+  uint32_t offset = 0;
+  uint32_t buffer_size = (*audio_embedder)->GetRequiredInputBufferSize();
+  StatusOr<AudioBuffer> audio_buffer =
+      LoadAudioBufferFromFile(GetBenchmarkDataPath(kAudio, kSpeechClip),
+                              &buffer_size, &offset, &wav_data);
+  if (SkipIfError(state, audio_buffer.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<EmbeddingResult> result = (*audio_embedder)->Embed(*audio_buffer);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1,
+                audio_buffer->GetBufferSize() * sizeof(float));
+}
+BENCHMARK(BM_AudioEmbedderEmbed)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace audio
+}  // namespace task
+}  // namespace tflite
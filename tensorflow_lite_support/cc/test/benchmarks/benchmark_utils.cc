@@ -0,0 +1,50 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace {
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/";
+
+}  // namespace
+
+std::string GetBenchmarkDataPath(absl::string_view task_type,
+                                 absl::string_view file_name) {
+  return JoinPath("./" /*test src dir*/, kTestDataDirectory, task_type,
+                  file_name);
+}
+
+bool SkipIfError(benchmark::State& state, const absl::Status& status) {
+  if (status.ok()) {
+    return false;
+  }
+  state.SkipWithError(status.ToString().c_str());
+  return true;
+}
+
+void SetThroughput(benchmark::State& state, int64_t items_per_iteration,
+                   int64_t bytes_per_iteration) {
+  state.SetItemsProcessed(state.iterations() * items_per_iteration);
+  state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+}
+
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,46 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_CC_TEST_BENCHMARKS_BENCHMARK_UTILS_H_
+#define TENSORFLOW_LITE_SUPPORT_CC_TEST_BENCHMARKS_BENCHMARK_UTILS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+
+namespace tflite {
+namespace task {
+
+// Returns the path of `file_name` in the `cc/test/testdata/task/<task_type>`
+// directory, relative to the runfiles root of the benchmark binary.
+std::string GetBenchmarkDataPath(absl::string_view task_type,
+                                 absl::string_view file_name);
+
+// Reports `status` as a benchmark error if it is not OK. Returns true if the
+// benchmark was skipped, in which case the caller must return immediately.
+bool SkipIfError(benchmark::State& state, const absl::Status& status);
+
+// Reports items/sec and bytes/sec counters based on the number of iterations
+// run so far, given the amount of work done by a single iteration.
+void SetThroughput(benchmark::State& state, int64_t items_per_iteration,
+                   int64_t bytes_per_iteration);
+
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_CC_TEST_BENCHMARKS_BENCHMARK_UTILS_H_
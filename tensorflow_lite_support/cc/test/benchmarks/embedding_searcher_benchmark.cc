@@ -0,0 +1,83 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Micro-benchmarks for nearest-neighbor search through EmbeddingSearcher.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/task_utils.h"
+#include "tensorflow_lite_support/cc/task/processor/embedding_searcher.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/search_options.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/search_result.pb.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace processor {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::LoadBinaryContent;
+
+constexpr char kVision[] = "vision";
+// Standalone test index.
+constexpr char kIndex[] = "searcher_index.ldb";
+// The embedding of burger.jpg, computed with the model the index was built
+// from.
+constexpr char kBurgerJpgEmbeddingProto[] = "burger_jpg_embedding.pbtxt";
+
+// The benchmark argument is the number of nearest neighbors to return.
+void BM_EmbeddingSearcherSearch(benchmark::State& state) {
+  auto options = std::make_unique<SearchOptions>();
+  options->mutable_index_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kIndex));
+  options->set_max_results(state.range(0));
+  StatusOr<std::unique_ptr<EmbeddingSearcher>> embedding_searcher =
+      EmbeddingSearcher::Create(std::move(options));
+  if (SkipIfError(state, embedding_searcher.status())) return;
+  const Embedding embedding =
+      ParseTextProtoOrDie<Embedding>(LoadBinaryContent(
+          GetBenchmarkDataPath(kVision, kBurgerJpgEmbeddingProto).c_str()));
+  const FeatureVector& feature_vector = embedding.feature_vector();
+  const int64_t query_bytes =
+      feature_vector.value_float_size() * sizeof(float) +
+      feature_vector.value_string().size();
+
+  for (auto _ : state) {
+    absl::StatusOr<SearchResult> result =
+        (*embedding_searcher)->Search(embedding);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, query_bytes);
+}
+BENCHMARK(BM_EmbeddingSearcherSearch)
+    ->ArgName("max_results")
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(25);
+
+}  // namespace
+}  // namespace processor
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,406 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Micro-benchmarks for the FrameBufferUtils operations, run on synthetic
+// frames of common camera resolutions.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/fused_preprocessing.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/task_executor_band_executor.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::tflite::support::StatusOr;
+
+// Input size of typical image models, used as target size for resizing.
+constexpr int kModelInputSize = 224;
+
+// A synthetic frame, along with the buffer backing its pixels.
+struct TestFrame {
+  std::vector<uint8_t> data;
+  std::unique_ptr<FrameBuffer> buffer;
+};
+
+// Creates a frame of the given dimension and format, filled with a
+// deterministic non-uniform pattern.
+StatusOr<TestFrame> CreateTestFrame(
+    FrameBuffer::Dimension dimension, FrameBuffer::Format format,
+    FrameBuffer::Orientation orientation = FrameBuffer::Orientation::kTopLeft) {
+  TestFrame frame;
+  frame.data.resize(GetFrameBufferByteSize(dimension, format));
+  for (size_t i = 0; i < frame.data.size(); ++i) {
+    frame.data[i] = static_cast<uint8_t>((i * 31) ^ (i >> 8));
+  }
+  ASSIGN_OR_RETURN(frame.buffer, CreateFromRawBuffer(frame.data.data(),
+                                                     dimension, format,
+                                                     orientation));
+  return frame;
+}
+
+// Returns the input frame dimension from the benchmark arguments.
+FrameBuffer::Dimension GetInputDimension(const benchmark::State& state) {
+  return {static_cast<int>(state.range(0)), static_cast<int>(state.range(1))};
+}
+
+// Registers the VGA, HD and Full HD input sizes.
+void FrameSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"width", "height"})
+      ->Args({640, 480})
+      ->Args({1280, 720})
+      ->Args({1920, 1080});
+}
+
+// Performs `operation` with the libyuv engine, and reports the largest
+// difference between the resulting pixels and those of `output` as a counter,
+// so as to validate the other engines on the benchmarked frames.
+template <typename Operation>
+void ReportMaxDifferenceWithLibyuv(benchmark::State& state,
+                                   const TestFrame& output,
+                                   Operation operation) {
+  StatusOr<TestFrame> expected = CreateTestFrame(output.buffer->dimension(),
+                                                 output.buffer->format());
+  if (SkipIfError(state, expected.status())) return;
+  auto utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+  if (SkipIfError(state, operation(*utils, expected->buffer.get()))) return;
+  int max_difference = 0;
+  for (size_t i = 0; i < output.data.size(); ++i) {
+    max_difference = std::max(
+        max_difference, std::abs(output.data[i] - expected->data[i]));
+  }
+  state.counters["max_diff_vs_libyuv"] = max_difference;
+}
+
+// Crops the central half of the input, without resizing.
+void BM_Crop(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  const int x0 = dimension.width / 4;
+  const int y0 = dimension.height / 4;
+  const int x1 = x0 + dimension.width / 2 - 1;
+  const int y1 = y0 + dimension.height / 2 - 1;
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output =
+      CreateTestFrame({x1 - x0 + 1, y1 - y0 + 1}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  auto utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+
+  for (auto _ : state) {
+    if (SkipIfError(state, utils->Crop(*input->buffer, x0, y0, x1, y1,
+                                       output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, output->data.size());
+}
+BENCHMARK(BM_Crop)->Apply(FrameSizes);
+
+template <FrameBufferUtils::ProcessEngine kEngine>
+void BM_Resize(benchmark::State& state) {
+  StatusOr<TestFrame> input =
+      CreateTestFrame(GetInputDimension(state), FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output = CreateTestFrame(
+      {kModelInputSize, kModelInputSize}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  auto utils = FrameBufferUtils::Create(kEngine);
+  auto resize = [&input](FrameBufferUtils& utils, FrameBuffer* output_buffer) {
+    return utils.Resize(*input->buffer, output_buffer);
+  };
+
+  for (auto _ : state) {
+    if (SkipIfError(state, resize(*utils, output->buffer.get()))) {
+      break;
+    }
+  }
+  if (kEngine != FrameBufferUtils::ProcessEngine::kLibyuv) {
+    ReportMaxDifferenceWithLibyuv(state, *output, resize);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK_TEMPLATE(BM_Resize, FrameBufferUtils::ProcessEngine::kLibyuv)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Resize, FrameBufferUtils::ProcessEngine::kSimd)
+    ->Apply(FrameSizes);
+
+void BM_ResizeNearestNeighbor(benchmark::State& state) {
+  StatusOr<TestFrame> input =
+      CreateTestFrame(GetInputDimension(state), FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output = CreateTestFrame(
+      {kModelInputSize, kModelInputSize}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  auto utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+
+  for (auto _ : state) {
+    if (SkipIfError(state, utils->ResizeNearestNeighbor(
+                               *input->buffer, output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK(BM_ResizeNearestNeighbor)->Apply(FrameSizes);
+
+void BM_Rotate(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output = CreateTestFrame(
+      {dimension.height, dimension.width}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  auto utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+
+  for (auto _ : state) {
+    if (SkipIfError(state, utils->Rotate(*input->buffer,
+                                         FrameBufferUtils::RotationDegree::k90,
+                                         output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK(BM_Rotate)->Apply(FrameSizes);
+
+void BM_FlipHorizontally(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  auto utils =
+      FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv);
+
+  for (auto _ : state) {
+    if (SkipIfError(state, utils->FlipHorizontally(*input->buffer,
+                                                   output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK(BM_FlipHorizontally)->Apply(FrameSizes);
+
+template <FrameBuffer::Format kFromFormat, FrameBuffer::Format kToFormat,
+          FrameBufferUtils::ProcessEngine kEngine =
+              FrameBufferUtils::ProcessEngine::kLibyuv>
+void BM_Convert(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input = CreateTestFrame(dimension, kFromFormat);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output = CreateTestFrame(dimension, kToFormat);
+  if (SkipIfError(state, output.status())) return;
+  auto utils = FrameBufferUtils::Create(kEngine);
+  auto convert = [&input](FrameBufferUtils& utils,
+                          FrameBuffer* output_buffer) {
+    return utils.Convert(*input->buffer, output_buffer);
+  };
+
+  for (auto _ : state) {
+    if (SkipIfError(state, convert(*utils, output->buffer.get()))) {
+      break;
+    }
+  }
+  if (kEngine != FrameBufferUtils::ProcessEngine::kLibyuv) {
+    ReportMaxDifferenceWithLibyuv(state, *output, convert);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK_TEMPLATE(BM_Convert, FrameBuffer::Format::kNV21,
+                   FrameBuffer::Format::kRGB)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Convert, FrameBuffer::Format::kNV21,
+                   FrameBuffer::Format::kRGB,
+                   FrameBufferUtils::ProcessEngine::kSimd)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Convert, FrameBuffer::Format::kRGBA,
+                   FrameBuffer::Format::kRGB)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Convert, FrameBuffer::Format::kRGBA,
+                   FrameBuffer::Format::kRGB,
+                   FrameBufferUtils::ProcessEngine::kSimd)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Convert, FrameBuffer::Format::kRGB,
+                   FrameBuffer::Format::kGRAY)
+    ->Apply(FrameSizes);
+
+// Same as BM_Convert from kNV21 to kRGB, split into row bands processed by the
+// number of threads given as third argument.
+void BM_ParallelConvert(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kNV21);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  // The calling thread processes bands too.
+  StatusOr<std::unique_ptr<core::TaskExecutor>> executor =
+      core::TaskExecutor::Create(state.range(2) - 1);
+  if (SkipIfError(state, executor.status())) return;
+  auto utils = FrameBufferUtils::Create(
+      FrameBufferUtils::ProcessEngine::kLibyuv, /*scratch_buffer_pool=*/nullptr,
+      std::make_shared<TaskExecutorBandExecutor>(std::move(executor).value()));
+
+  for (auto _ : state) {
+    if (SkipIfError(state,
+                    utils->Convert(*input->buffer, output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK(BM_ParallelConvert)
+    ->ArgNames({"width", "height", "threads"})
+    ->Args({1920, 1080, 2})
+    ->Args({1920, 1080, 4});
+
+// Bilinear resizing with the SIMD engine, split into row bands processed by the
+// number of threads given as third argument. The model input size is upscaled
+// to the frame size given as first arguments, so that the output spans several
+// bands.
+void BM_ParallelResize(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input = CreateTestFrame(
+      {kModelInputSize, kModelInputSize}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output =
+      CreateTestFrame(dimension, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  StatusOr<std::unique_ptr<core::TaskExecutor>> executor =
+      core::TaskExecutor::Create(state.range(2) - 1);
+  if (SkipIfError(state, executor.status())) return;
+  auto utils = FrameBufferUtils::Create(
+      FrameBufferUtils::ProcessEngine::kSimd, /*scratch_buffer_pool=*/nullptr,
+      std::make_shared<TaskExecutorBandExecutor>(std::move(executor).value()));
+
+  for (auto _ : state) {
+    if (SkipIfError(state,
+                    utils->Resize(*input->buffer, output->buffer.get()))) {
+      break;
+    }
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, output->data.size());
+}
+BENCHMARK(BM_ParallelResize)
+    ->ArgNames({"width", "height", "threads"})
+    ->Args({1920, 1080, 1})
+    ->Args({1920, 1080, 2})
+    ->Args({1920, 1080, 4});
+
+// Returns the largest centered square region of interest of a landscape frame.
+// As expected by FrameBufferUtils, it is expressed in the unrotated coordinate
+// space of the frame.
+BoundingBox GetCenteredSquareRoi(FrameBuffer::Dimension dimension) {
+  BoundingBox roi;
+  roi.set_origin_x((dimension.width - dimension.height) / 2);
+  roi.set_origin_y(0);
+  roi.set_width(dimension.height);
+  roi.set_height(dimension.height);
+  return roi;
+}
+
+// Mirrors the preprocessing applied by vision tasks to camera frames: crops a
+// centered square region of interest out of a rotated NV21 frame, and turns it
+// into an upright RGB model input.
+template <FrameBufferUtils::ProcessEngine kEngine>
+void BM_Preprocess(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kNV21,
+                      FrameBuffer::Orientation::kRightTop);
+  if (SkipIfError(state, input.status())) return;
+  StatusOr<TestFrame> output = CreateTestFrame(
+      {kModelInputSize, kModelInputSize}, FrameBuffer::Format::kRGB);
+  if (SkipIfError(state, output.status())) return;
+  const BoundingBox roi = GetCenteredSquareRoi(dimension);
+  auto utils = FrameBufferUtils::Create(kEngine);
+  auto preprocess = [&input, &roi](FrameBufferUtils& utils,
+                                   FrameBuffer* output_buffer) {
+    return utils.Preprocess(*input->buffer, roi, output_buffer);
+  };
+
+  for (auto _ : state) {
+    if (SkipIfError(state, preprocess(*utils, output->buffer.get()))) {
+      break;
+    }
+  }
+  if (kEngine != FrameBufferUtils::ProcessEngine::kLibyuv) {
+    ReportMaxDifferenceWithLibyuv(state, *output, preprocess);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK_TEMPLATE(BM_Preprocess, FrameBufferUtils::ProcessEngine::kLibyuv)
+    ->Apply(FrameSizes);
+BENCHMARK_TEMPLATE(BM_Preprocess, FrameBufferUtils::ProcessEngine::kSimd)
+    ->Apply(FrameSizes);
+
+// Same as BM_Preprocess, followed by the normalization applied to float model
+// inputs, but performed in a single pass by FusedPreprocess.
+void BM_FusedPreprocess(benchmark::State& state) {
+  const FrameBuffer::Dimension dimension = GetInputDimension(state);
+  StatusOr<TestFrame> input =
+      CreateTestFrame(dimension, FrameBuffer::Format::kNV21,
+                      FrameBuffer::Orientation::kRightTop);
+  if (SkipIfError(state, input.status())) return;
+  const BoundingBox roi = GetCenteredSquareRoi(dimension);
+  const std::array<float, 3> mean_values = {127.5f, 127.5f, 127.5f};
+  const std::array<float, 3> std_values = {127.5f, 127.5f, 127.5f};
+  std::vector<float> output(kModelInputSize * kModelInputSize * 3);
+
+  for (auto _ : state) {
+    if (SkipIfError(state, FusedPreprocess(*input->buffer, roi,
+                                           {kModelInputSize, kModelInputSize},
+                                           mean_values, std_values,
+                                           output.data()))) {
+      break;
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input->data.size());
+}
+BENCHMARK(BM_FusedPreprocess)->Apply(FrameSizes);
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,241 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// End-to-end benchmarks for the text Task APIs.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/category.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/embedding.pb.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/search_result.pb.h"
+#include "tensorflow_lite_support/cc/task/text/bert_clu_annotator.h"
+#include "tensorflow_lite_support/cc/task/text/bert_nl_classifier.h"
+#include "tensorflow_lite_support/cc/task/text/bert_question_answerer.h"
+#include "tensorflow_lite_support/cc/task/text/clu_annotator.h"
+#include "tensorflow_lite_support/cc/task/text/nlclassifier/nl_classifier.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_clu_annotator_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_nl_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_question_answerer_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/clu_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/nl_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/retrieval_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/text_embedder_options.pb.h"
+#include "tensorflow_lite_support/cc/task/text/proto/text_searcher_options.pb.h"
+#include "tensorflow_lite_support/cc/task/text/question_answerer.h"
+#include "tensorflow_lite_support/cc/task/text/text_embedder.h"
+#include "tensorflow_lite_support/cc/task/text/text_searcher.h"
+#include "tensorflow_lite_support/cc/task/text/universal_sentence_encoder_qa.h"
+#include "tensorflow_lite_support/cc/task/text/utils/text_op_resolver.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+
+namespace tflite {
+namespace task {
+namespace text {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::Category;
+using ::tflite::task::processor::EmbeddingResult;
+using ::tflite::task::processor::SearchResult;
+using ::tflite::task::text::clu::BertCluAnnotator;
+using ::tflite::task::text::clu::CluAnnotator;
+using ::tflite::task::text::nlclassifier::NLClassifier;
+
+constexpr char kText[] = "text";
+// Classifier expecting its input to be tokenized by a regex tokenizer.
+constexpr char kNLClassifierWithRegexTokenizer[] =
+    "test_model_nl_classifier_with_regex_tokenizer.tflite";
+constexpr char kBertNLClassifier[] = "bert_nl_classifier.tflite";
+constexpr char kMobileBertWithMetadata[] = "mobilebert_with_metadata.tflite";
+// Embedder using a regex tokenizer.
+constexpr char kRegexEmbedder[] = "regex_one_embedding_with_metadata.tflite";
+// Searcher using a regex tokenizer, with a search index baked into the
+// metadata.
+constexpr char kRegexSearcher[] = "regex_searcher.tflite";
+constexpr char kBertCluAnnotatorWithMetadata[] =
+    "bert_clu_annotator_with_metadata.tflite";
+constexpr char kUniversalSentenceEncoderQa[] =
+    "universal_sentence_encoder_qa_with_metadata.tflite";
+
+constexpr char kInput[] =
+    "This is the best movie I've seen in recent years. Strongly recommend it!";
+constexpr char kQuestion[] = "What is a course of study called?";
+constexpr char kContext[] =
+    "The role of teacher is often formal and ongoing, carried out at a school "
+    "or other place of formal education. In many countries, a person who "
+    "wishes to become a teacher must first obtain specified professional "
+    "qualifications or credentials from a university or college. These "
+    "professional qualifications may include the study of pedagogy, the "
+    "science of teaching. Teachers, like other professionals, may have to "
+    "continue their education after they qualify, a process known as "
+    "continuing professional development. Teachers may use a lesson plan to "
+    "facilitate student learning, providing a course of study which is called "
+    "the curriculum.";
+
+void BM_NLClassifierClassify(benchmark::State& state) {
+  NLClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kNLClassifierWithRegexTokenizer));
+  StatusOr<std::unique_ptr<NLClassifier>> classifier =
+      NLClassifier::CreateFromOptions(options);
+  if (SkipIfError(state, classifier.status())) return;
+  const std::string input = kInput;
+
+  for (auto _ : state) {
+    StatusOr<std::vector<Category>> result =
+        (*classifier)->ClassifyText(input);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_NLClassifierClassify);
+
+void BM_BertNLClassifierClassify(benchmark::State& state) {
+  BertNLClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kBertNLClassifier));
+  StatusOr<std::unique_ptr<BertNLClassifier>> classifier =
+      BertNLClassifier::CreateFromOptions(options);
+  if (SkipIfError(state, classifier.status())) return;
+  const std::string input = kInput;
+
+  for (auto _ : state) {
+    StatusOr<std::vector<Category>> result =
+        (*classifier)->ClassifyText(input);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_BertNLClassifierClassify)->Unit(benchmark::kMillisecond);
+
+void BM_BertQuestionAnswererAnswer(benchmark::State& state) {
+  BertQuestionAnswererOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kMobileBertWithMetadata));
+  StatusOr<std::unique_ptr<QuestionAnswerer>> question_answerer =
+      BertQuestionAnswerer::CreateFromOptions(options);
+  if (SkipIfError(state, question_answerer.status())) return;
+  const std::string context = kContext;
+  const std::string question = kQuestion;
+
+  for (auto _ : state) {
+    std::vector<QaAnswer> answers =
+        (*question_answerer)->Answer(context, question);
+    benchmark::DoNotOptimize(answers);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1,
+                context.size() + question.size());
+}
+BENCHMARK(BM_BertQuestionAnswererAnswer)->Unit(benchmark::kMillisecond);
+
+void BM_TextEmbedderEmbed(benchmark::State& state) {
+  TextEmbedderOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kRegexEmbedder));
+  StatusOr<std::unique_ptr<TextEmbedder>> text_embedder =
+      TextEmbedder::CreateFromOptions(options);
+  if (SkipIfError(state, text_embedder.status())) return;
+  const std::string input = kInput;
+
+  for (auto _ : state) {
+    StatusOr<EmbeddingResult> result = (*text_embedder)->Embed(input);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_TextEmbedderEmbed);
+
+void BM_TextSearcherSearch(benchmark::State& state) {
+  TextSearcherOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kRegexSearcher));
+  StatusOr<std::unique_ptr<TextSearcher>> text_searcher =
+      TextSearcher::CreateFromOptions(options);
+  if (SkipIfError(state, text_searcher.status())) return;
+  const std::string input = kInput;
+
+  for (auto _ : state) {
+    StatusOr<SearchResult> result = (*text_searcher)->Search(input);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_TextSearcherSearch);
+
+void BM_BertCluAnnotatorAnnotate(benchmark::State& state) {
+  BertCluAnnotatorOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kBertCluAnnotatorWithMetadata));
+  StatusOr<std::unique_ptr<CluAnnotator>> clu_annotator =
+      BertCluAnnotator::CreateFromOptions(options);
+  if (SkipIfError(state, clu_annotator.status())) return;
+  CluRequest request;
+  request.add_utterances(kInput);
+
+  for (auto _ : state) {
+    StatusOr<CluResponse> response = (*clu_annotator)->Annotate(request);
+    if (SkipIfError(state, response.status())) break;
+    benchmark::DoNotOptimize(response);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, request.utterances(0).size());
+}
+BENCHMARK(BM_BertCluAnnotatorAnnotate)->Unit(benchmark::kMillisecond);
+
+// The benchmark argument is the number of candidate responses to rank.
+void BM_UniversalSentenceEncoderQARetrieve(benchmark::State& state) {
+  RetrievalOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kText, kUniversalSentenceEncoderQa));
+  StatusOr<std::unique_ptr<UniversalSentenceEncoderQA>> qa_client =
+      UniversalSentenceEncoderQA::CreateFromOption(options,
+                                                   CreateTextOpResolver());
+  if (SkipIfError(state, qa_client.status())) return;
+  RetrievalInput input;
+  input.set_query_text(kQuestion);
+  int64_t input_bytes = input.query_text().size();
+  for (int i = 0; i < state.range(0); ++i) {
+    ResponseEntry::RawText* raw_text =
+        input.add_responses()->mutable_raw_text();
+    raw_text->set_text(kInput);
+    raw_text->set_context(kContext);
+    input_bytes += raw_text->text().size() + raw_text->context().size();
+  }
+
+  for (auto _ : state) {
+    StatusOr<RetrievalOutput> output = (*qa_client)->Retrieve(input);
+    if (SkipIfError(state, output.status())) break;
+    benchmark::DoNotOptimize(output);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input_bytes);
+}
+BENCHMARK(BM_UniversalSentenceEncoderQARetrieve)
+    ->ArgName("responses")
+    ->Arg(1)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace text
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,95 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Micro-benchmarks for the tokenizers used by the text Task APIs.
+
+#include <string>
+
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/task/core/task_utils.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/bert_tokenizer.h"
+#include "tensorflow_lite_support/cc/text/tokenizers/tokenizer.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/model_converter.h"
+#include "tensorflow_lite_support/custom_ops/kernel/sentencepiece/optimized_encoder.h"
+
+namespace tflite {
+namespace task {
+namespace {
+
+using ::tflite::ops::custom::sentencepiece::ConvertSentencepieceModel;
+using ::tflite::ops::custom::sentencepiece::EncoderResult;
+using ::tflite::ops::custom::sentencepiece::EncoderResultType;
+using ::tflite::ops::custom::sentencepiece::EncodeString;
+using ::tflite::support::text::tokenizer::BertTokenizer;
+using ::tflite::support::text::tokenizer::TokenizerResult;
+using ::tflite::task::core::LoadBinaryContent;
+
+constexpr char kText[] = "text";
+constexpr char kMobileBertVocab[] = "mobilebert_vocab.txt";
+constexpr char kAlbertSentencePieceModel[] = "30k-clean.model";
+
+constexpr char kSentence[] =
+    "Teachers may use a lesson plan to facilitate student learning, providing "
+    "a course of study which is called the curriculum. ";
+
+// Returns an input made of the benchmark argument number of sentences.
+std::string GetInput(const benchmark::State& state) {
+  std::string input;
+  for (int i = 0; i < state.range(0); ++i) {
+    absl::StrAppend(&input, kSentence);
+  }
+  return input;
+}
+
+void BM_BertTokenizerTokenize(benchmark::State& state) {
+  BertTokenizer tokenizer(GetBenchmarkDataPath(kText, kMobileBertVocab));
+  const std::string input = GetInput(state);
+
+  for (auto _ : state) {
+    TokenizerResult result = tokenizer.Tokenize(input);
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_BertTokenizerTokenize)->ArgName("sentences")->Arg(1)->Arg(16);
+
+void BM_SentencePieceEncodeString(benchmark::State& state) {
+  const std::string model = LoadBinaryContent(
+      GetBenchmarkDataPath(kText, kAlbertSentencePieceModel).c_str());
+  const std::string config = ConvertSentencepieceModel(model);
+  const std::string input = GetInput(state);
+
+  for (auto _ : state) {
+    EncoderResult result = EncodeString(input, config.data(),
+                                        /*add_bos=*/false, /*add_eos=*/false,
+                                        /*reverse=*/false);
+    if (result.type != EncoderResultType::SUCCESS) {
+      state.SkipWithError("Invalid sentencepiece encoder config.");
+      break;
+    }
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, input.size());
+}
+BENCHMARK(BM_SentencePieceEncodeString)
+    ->ArgName("sentences")
+    ->Arg(1)
+    ->Arg(16);
+
+}  // namespace
+}  // namespace task
+}  // namespace tflite
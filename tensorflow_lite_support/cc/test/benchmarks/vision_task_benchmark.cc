@@ -0,0 +1,296 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// End-to-end benchmarks for the vision Task APIs, plus a micro-benchmark of
+// ImageSegmenter postprocessing in isolation.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow_lite_support/cc/port/benchmark.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
+#include "tensorflow_lite_support/cc/task/processor/proto/search_result.pb.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/image_embedder.h"
+#include "tensorflow_lite_support/cc/task/vision/image_searcher.h"
+#include "tensorflow_lite_support/cc/task/vision/image_segmenter.h"
+#include "tensorflow_lite_support/cc/task/vision/object_detector.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/embeddings_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_embedder_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_searcher_options.pb.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_segmenter_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/object_detector_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/segmentations_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_utils.h"
+#include "tensorflow_lite_support/cc/test/benchmarks/benchmark_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::TaskAPIFactory;
+using ::tflite::task::processor::SearchResult;
+
+constexpr char kVision[] = "vision";
+// Float classification model.
+constexpr char kMobileNetFloatWithMetadata[] = "mobilenet_v2_1.0_224.tflite";
+// Quantized detection model.
+constexpr char kMobileSsdWithMetadata[] =
+    "coco_ssd_mobilenet_v1_1.0_quant_2018_06_29.tflite";
+// Float segmentation model, producing 257x257x21 confidence scores.
+constexpr char kDeepLabV3[] = "deeplabv3.tflite";
+// Float embedder model.
+constexpr char kMobileNetV3Embedder[] =
+    "mobilenet_v3_small_100_224_embedder.tflite";
+// Same as kMobileNetV3Embedder, with a search index baked into the metadata.
+constexpr char kMobileNetV3Searcher[] =
+    "mobilenet_v3_small_100_224_searcher.tflite";
+
+constexpr char kBurgerImage[] = "burger.jpg";
+constexpr char kCatsAndDogsImage[] = "cats_and_dogs.jpg";
+constexpr char kSegmentationImage[] = "segmentation_input_rotation0.jpg";
+
+// A decoded test image, along with the FrameBuffer wrapping its pixels.
+class TestImage {
+ public:
+  static StatusOr<std::unique_ptr<TestImage>> Load(
+      absl::string_view image_name) {
+    ASSIGN_OR_RETURN(
+        ImageData image_data,
+        DecodeImageFromFile(GetBenchmarkDataPath(kVision, image_name)));
+    return std::unique_ptr<TestImage>(new TestImage(image_data));
+  }
+
+  ~TestImage() { ImageDataFree(&image_data_); }
+
+  TestImage(const TestImage&) = delete;
+  TestImage& operator=(const TestImage&) = delete;
+
+  const FrameBuffer& frame_buffer() const { return *frame_buffer_; }
+
+  // Size of the decoded pixel data, in bytes.
+  int64_t byte_size() const {
+    return static_cast<int64_t>(image_data_.width) * image_data_.height *
+           image_data_.channels;
+  }
+
+ private:
+  explicit TestImage(ImageData image_data)
+      : image_data_(image_data),
+        frame_buffer_(CreateFromRgbRawBuffer(
+            image_data.pixel_data, {image_data.width, image_data.height})) {}
+
+  ImageData image_data_;
+  std::unique_ptr<FrameBuffer> frame_buffer_;
+};
+
+void BM_ImageClassifierClassify(benchmark::State& state) {
+  ImageClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kMobileNetFloatWithMetadata));
+  StatusOr<std::unique_ptr<ImageClassifier>> image_classifier =
+      ImageClassifier::CreateFromOptions(options);
+  if (SkipIfError(state, image_classifier.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image = TestImage::Load(kBurgerImage);
+  if (SkipIfError(state, image.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<ClassificationResult> result =
+        (*image_classifier)->Classify((*image)->frame_buffer());
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, (*image)->byte_size());
+}
+BENCHMARK(BM_ImageClassifierClassify)->Unit(benchmark::kMillisecond);
+
+void BM_ObjectDetectorDetect(benchmark::State& state) {
+  ObjectDetectorOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kMobileSsdWithMetadata));
+  StatusOr<std::unique_ptr<ObjectDetector>> object_detector =
+      ObjectDetector::CreateFromOptions(options);
+  if (SkipIfError(state, object_detector.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image =
+      TestImage::Load(kCatsAndDogsImage);
+  if (SkipIfError(state, image.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<DetectionResult> result =
+        (*object_detector)->Detect((*image)->frame_buffer());
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, (*image)->byte_size());
+}
+BENCHMARK(BM_ObjectDetectorDetect)->Unit(benchmark::kMillisecond);
+
+// The benchmark argument is the ImageSegmenterOptions::OutputType to use.
+void BM_ImageSegmenterSegment(benchmark::State& state) {
+  ImageSegmenterOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kDeepLabV3));
+  options.set_output_type(
+      static_cast<ImageSegmenterOptions::OutputType>(state.range(0)));
+  StatusOr<std::unique_ptr<ImageSegmenter>> image_segmenter =
+      ImageSegmenter::CreateFromOptions(options);
+  if (SkipIfError(state, image_segmenter.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image =
+      TestImage::Load(kSegmentationImage);
+  if (SkipIfError(state, image.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<SegmentationResult> result =
+        (*image_segmenter)->Segment((*image)->frame_buffer());
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, (*image)->byte_size());
+}
+BENCHMARK(BM_ImageSegmenterSegment)
+    ->ArgName("output_type")
+    ->Arg(ImageSegmenterOptions::CATEGORY_MASK)
+    ->Arg(ImageSegmenterOptions::CONFIDENCE_MASK)
+    ->Unit(benchmark::kMillisecond);
+
+// Exposes ImageSegmenter::Postprocess so that it can be benchmarked without
+// the cost of preprocessing and inference.
+class BenchmarkImageSegmenter : public ImageSegmenter {
+ public:
+  using ImageSegmenter::GetOutputTensors;
+  using ImageSegmenter::ImageSegmenter;
+  using ImageSegmenter::Postprocess;
+
+  static StatusOr<std::unique_ptr<BenchmarkImageSegmenter>> CreateFromOptions(
+      const ImageSegmenterOptions& options) {
+    RETURN_IF_ERROR(SanityCheckOptions(options));
+
+    auto options_copy = std::make_unique<ImageSegmenterOptions>(options);
+
+    ASSIGN_OR_RETURN(
+        auto image_segmenter,
+        TaskAPIFactory::CreateFromBaseOptions<BenchmarkImageSegmenter>(
+            &options_copy->base_options()));
+
+    RETURN_IF_ERROR(image_segmenter->Init(std::move(options_copy)));
+
+    return image_segmenter;
+  }
+};
+
+// The benchmark argument is the ImageSegmenterOptions::OutputType to use.
+// Output tensors are populated by running a full segmentation once before
+// timing starts.
+void BM_ImageSegmenterPostprocess(benchmark::State& state) {
+  ImageSegmenterOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kDeepLabV3));
+  options.set_output_type(
+      static_cast<ImageSegmenterOptions::OutputType>(state.range(0)));
+  StatusOr<std::unique_ptr<BenchmarkImageSegmenter>> image_segmenter =
+      BenchmarkImageSegmenter::CreateFromOptions(options);
+  if (SkipIfError(state, image_segmenter.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image =
+      TestImage::Load(kSegmentationImage);
+  if (SkipIfError(state, image.status())) return;
+  const FrameBuffer& frame_buffer = (*image)->frame_buffer();
+  if (SkipIfError(state,
+                  (*image_segmenter)->Segment(frame_buffer).status())) {
+    return;
+  }
+
+  std::vector<const TfLiteTensor*> output_tensors =
+      (*image_segmenter)->GetOutputTensors();
+  int64_t output_bytes = 0;
+  for (const TfLiteTensor* tensor : output_tensors) {
+    output_bytes += tensor->bytes;
+  }
+  BoundingBox roi;
+  roi.set_width(frame_buffer.dimension().width);
+  roi.set_height(frame_buffer.dimension().height);
+
+  for (auto _ : state) {
+    StatusOr<SegmentationResult> result =
+        (*image_segmenter)->Postprocess(output_tensors, frame_buffer, roi);
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, output_bytes);
+}
+BENCHMARK(BM_ImageSegmenterPostprocess)
+    ->ArgName("output_type")
+    ->Arg(ImageSegmenterOptions::CATEGORY_MASK)
+    ->Arg(ImageSegmenterOptions::CONFIDENCE_MASK)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ImageEmbedderEmbed(benchmark::State& state) {
+  ImageEmbedderOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kMobileNetV3Embedder));
+  StatusOr<std::unique_ptr<ImageEmbedder>> image_embedder =
+      ImageEmbedder::CreateFromOptions(options);
+  if (SkipIfError(state, image_embedder.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image = TestImage::Load(kBurgerImage);
+  if (SkipIfError(state, image.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<EmbeddingResult> result =
+        (*image_embedder)->Embed((*image)->frame_buffer());
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, (*image)->byte_size());
+}
+BENCHMARK(BM_ImageEmbedderEmbed)->Unit(benchmark::kMillisecond);
+
+void BM_ImageSearcherSearch(benchmark::State& state) {
+  ImageSearcherOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      GetBenchmarkDataPath(kVision, kMobileNetV3Searcher));
+  StatusOr<std::unique_ptr<ImageSearcher>> image_searcher =
+      ImageSearcher::CreateFromOptions(options);
+  if (SkipIfError(state, image_searcher.status())) return;
+  StatusOr<std::unique_ptr<TestImage>> image = TestImage::Load(kBurgerImage);
+  if (SkipIfError(state, image.status())) return;
+
+  for (auto _ : state) {
+    StatusOr<SearchResult> result =
+        (*image_searcher)->Search((*image)->frame_buffer());
+    if (SkipIfError(state, result.status())) break;
+    benchmark::DoNotOptimize(result);
+  }
+  SetThroughput(state, /*items_per_iteration=*/1, (*image)->byte_size());
+}
+BENCHMARK(BM_ImageSearcherSearch)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,97 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/auto_tuner.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+class AutoTuneCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = JoinPath(::testing::TempDir(),
+                     ::testing::UnitTest::GetInstance()->current_test_info()
+                         ->name());
+    std::remove(path_.c_str());
+  }
+
+  std::string path_;
+};
+
+TEST_F(AutoTuneCacheTest, LookupReturnsStoredCandidate) {
+  AutoTuneCache cache(path_);
+  AutoTuneCandidate candidate;
+  candidate.num_threads = 4;
+  candidate.use_xnnpack = true;
+
+  SUPPORT_ASSERT_OK(cache.Store("model|cpu", candidate));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<AutoTuneCandidate> result,
+                               cache.Lookup("model|cpu"));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, candidate);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<AutoTuneCandidate> other,
+                               cache.Lookup("model|other_cpu"));
+  EXPECT_FALSE(other.has_value());
+}
+
+TEST_F(AutoTuneCacheTest, LookupReturnsLastStoredCandidate) {
+  AutoTuneCache cache(path_);
+  AutoTuneCandidate first;
+  first.num_threads = 1;
+  AutoTuneCandidate second;
+  second.num_threads = 2;
+
+  SUPPORT_ASSERT_OK(cache.Store("key", first));
+  SUPPORT_ASSERT_OK(cache.Store("key", second));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<AutoTuneCandidate> result,
+                               cache.Lookup("key"));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, second);
+}
+
+TEST_F(AutoTuneCacheTest, LookupIgnoresMalformedRecord) {
+  {
+    std::ofstream file(path_);
+    file << "key\t2\t1\nkey\tnot a number\t1\nother\t3\n";
+  }
+  AutoTuneCache cache(path_);
+
+  // The last record for "key" is malformed, which requires tuning again.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<AutoTuneCandidate> result,
+                               cache.Lookup("key"));
+  EXPECT_FALSE(result.has_value());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<AutoTuneCandidate> other,
+                               cache.Lookup("other"));
+  EXPECT_FALSE(other.has_value());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
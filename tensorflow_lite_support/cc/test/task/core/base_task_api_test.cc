@@ -0,0 +1,1196 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/base_task_api.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <fstream>
+#include <future>  // NOLINT(build/c++11)
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "flatbuffers/flatbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/test_util.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/aligned_buffer.h"
+#include "tensorflow_lite_support/cc/task/core/cpu_affinity.h"
+#include "tensorflow_lite_support/cc/task/core/inference_stats.h"
+#include "tensorflow_lite_support/cc/task/core/memory_stats.h"
+#include "tensorflow_lite_support/cc/task/core/model_cache.h"
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+#include "tensorflow_lite_support/cc/task/core/proto/base_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/core/shared_thread_pool.h"
+#include "tensorflow_lite_support/cc/task/core/task_api_factory.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+#include "tensorflow_lite_support/cc/task/core/task_utils.h"
+#include "tensorflow_lite_support/cc/task/core/tflite_engine.h"
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::Each;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+using ::tflite::task::JoinPath;
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/core/";
+// Model with two signatures sharing a single weight `w = 3`: "add" (the
+// primary subgraph) computes `x + w` and "mul" computes `x * w`, on float
+// inputs of shape [1, length].
+constexpr char kAddMulSignaturesModel[] = "add_mul_signatures.tflite";
+
+// Task running the test model on a vector of floats, resizing the model input
+// to the length of the vector, padded with zeros up to the shape bucket.
+class VectorTask
+    : public BaseTaskApi<std::vector<float>, const std::vector<float>&> {
+ public:
+  using BaseTaskApi::BaseTaskApi;
+  using BaseTaskApi::GetTfLiteEngine;
+  using BaseTaskApi::Infer;
+  using BaseTaskApi::InferAsync;
+  using BaseTaskApi::InferBatch;
+  using BaseTaskApi::InferWithDeadline;
+  using BaseTaskApi::InferWithSignature;
+  using BaseTaskApi::InferWithSignatureWithDeadline;
+
+ protected:
+  absl::Status Preprocess(const std::vector<TfLiteTensor*>& input_tensors,
+                          const std::vector<float>& input) override {
+    TfLiteEngine* engine = GetTfLiteEngine();
+    // Batched inputs keep the shape of the batch slots.
+    if (engine->input_batch_size() > 1) {
+      return PopulateTensor(input, engine->GetInputTensor(0));
+    }
+    std::vector<float> padded_input = input;
+    padded_input.resize(
+        engine->RoundUpToShapeBucket(static_cast<int>(input.size())), 0.f);
+    RETURN_IF_ERROR(engine->ResizeInputTensors(
+        {{0, {1, static_cast<int>(padded_input.size())}}}));
+    // Resizing may re-allocate the tensors, so `input_tensors` is not used.
+    return PopulateTensor(padded_input, engine->GetInputTensor(0));
+  }
+
+  StatusOr<std::vector<float>> Postprocess(
+      const std::vector<const TfLiteTensor*>& output_tensors,
+      const std::vector<float>& input) override {
+    std::vector<float> output;
+    RETURN_IF_ERROR(PopulateVector(output_tensors[0], &output));
+    // Drops the outputs of the padding, if any.
+    output.resize(input.size());
+    return output;
+  }
+};
+
+class BaseTaskApiTest : public tflite::testing::Test {
+ protected:
+  static std::string GetModelPath() {
+    return JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                    kAddMulSignaturesModel);
+  }
+
+  static BaseOptions CreateBaseOptions() {
+    BaseOptions options;
+    options.mutable_model_file()->set_file_name(GetModelPath());
+    return options;
+  }
+
+  static StatusOr<std::unique_ptr<VectorTask>> CreateTask(
+      const BaseOptions& options = CreateBaseOptions()) {
+    return TaskAPIFactory::CreateFromBaseOptions<VectorTask>(&options);
+  }
+
+  // Returns the lines of the text file at `path`.
+  static std::vector<std::string> ReadLines(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  static std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+  }
+
+  static void WriteFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+  }
+
+  // Returns a copy of the test model where the weight of the primary subgraph
+  // is no longer backed by a buffer. The interpreter still builds such a model,
+  // but `tflite::Verify` rejects it since the weight is never produced.
+  static std::string CreateUnverifiableModel() {
+    const std::string content = ReadFile(GetModelPath());
+    std::unique_ptr<tflite::ModelT> model = tflite::UnPackModel(content.data());
+    model->subgraphs[0]->tensors[1]->buffer = 0;
+    flatbuffers::FlatBufferBuilder builder;
+    tflite::FinishModelBuffer(builder,
+                              tflite::Model::Pack(builder, model.get()));
+    return std::string(
+        reinterpret_cast<const char*>(builder.GetBufferPointer()),
+        builder.GetSize());
+  }
+
+  // Returns a copy of the test model where the input of the "mul" signature
+  // is an int32 tensor, which no longer matches the primary subgraph.
+  static std::string CreateModelWithMismatchedSignature() {
+    const std::string content = ReadFile(GetModelPath());
+    std::unique_ptr<tflite::ModelT> model = tflite::UnPackModel(content.data());
+    tflite::SubGraphT* mul_subgraph = model->subgraphs[1].get();
+    mul_subgraph->tensors[mul_subgraph->inputs[0]]->type =
+        tflite::TensorType_INT32;
+    flatbuffers::FlatBufferBuilder builder;
+    tflite::FinishModelBuffer(builder,
+                              tflite::Model::Pack(builder, model.get()));
+    return std::string(
+        reinterpret_cast<const char*>(builder.GetBufferPointer()),
+        builder.GetSize());
+  }
+
+  // Returns a model chaining `num_ops` ADD_N ops, each doubling its float
+  // input of shape [1, length], so that invocations take long enough for a
+  // deadline to expire between two ops. ADD_N is not supported by XNNPACK, so
+  // that the ops are not delegated and are run one by one by the interpreter.
+  static std::string CreateSlowModel(int num_ops) {
+    tflite::ModelT model;
+    model.version = 3;
+    auto op_code = std::make_unique<tflite::OperatorCodeT>();
+    op_code->builtin_code = tflite::BuiltinOperator_ADD_N;
+    op_code->deprecated_builtin_code = tflite::BuiltinOperator_ADD_N;
+    op_code->version = 1;
+    model.operator_codes.push_back(std::move(op_code));
+    model.buffers.push_back(std::make_unique<tflite::BufferT>());
+    auto subgraph = std::make_unique<tflite::SubGraphT>();
+    for (int i = 0; i <= num_ops; ++i) {
+      auto tensor = std::make_unique<tflite::TensorT>();
+      tensor->type = tflite::TensorType_FLOAT32;
+      tensor->shape = {1, 4};
+      tensor->shape_signature = {1, -1};
+      tensor->buffer = 0;
+      tensor->name = absl::StrCat("tensor_", i);
+      subgraph->tensors.push_back(std::move(tensor));
+    }
+    for (int i = 0; i < num_ops; ++i) {
+      auto op = std::make_unique<tflite::OperatorT>();
+      op->opcode_index = 0;
+      op->inputs = {i, i};
+      op->outputs = {i + 1};
+      op->builtin_options.Set(tflite::AddNOptionsT());
+      subgraph->operators.push_back(std::move(op));
+    }
+    subgraph->inputs = {0};
+    subgraph->outputs = {num_ops};
+    model.subgraphs.push_back(std::move(subgraph));
+    flatbuffers::FlatBufferBuilder builder;
+    tflite::FinishModelBuffer(builder, tflite::Model::Pack(builder, &model));
+    return std::string(
+        reinterpret_cast<const char*>(builder.GetBufferPointer()),
+        builder.GetSize());
+  }
+
+  const std::vector<float> input_ = {1, 2, 3, 4};
+  // Output of the primary subgraph for `input_`.
+  const std::vector<float> expected_output_ = {4, 5, 6, 7};
+};
+
+TEST_F(BaseTaskApiTest, SucceedsWithInterpreterPool) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(2);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  // Each call uses a different input length, which each interpreter of the
+  // pool resizes its inputs to.
+  constexpr int kNumThreads = 4;
+  std::vector<StatusOr<std::vector<float>>> outputs(
+      kNumThreads, absl::UnknownError("Not run"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      outputs[i] = task->Infer(std::vector<float>(4 + i, i));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    SUPPORT_ASSERT_OK(outputs[i]);
+    EXPECT_THAT(outputs[i].value(),
+                ElementsAreArray(std::vector<float>(4 + i, i + 3)));
+  }
+}
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidNumInterpreters) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(0);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(),
+              HasSubstr("`num_interpreters` must be greater than 0"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithBatch) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  const std::vector<std::vector<float>> batch = {
+      input_, {0, 0, 0, 1}, {-3, -2, -1, 0}};
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<std::vector<float>> outputs,
+                               task->InferBatch(absl::MakeConstSpan(batch)));
+
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_THAT(outputs[0], ElementsAreArray(expected_output_));
+  EXPECT_THAT(outputs[1], ElementsAreArray({3, 3, 3, 4}));
+  EXPECT_THAT(outputs[2], ElementsAreArray({0, 1, 2, 3}));
+  EXPECT_EQ(task->GetTfLiteEngine()->input_batch_size(), 3);
+  // Single inferences bring the inputs back to a batch size of 1.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+  EXPECT_EQ(task->GetTfLiteEngine()->input_batch_size(), 1);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithEmptyBatch) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<float>> outputs,
+      task->InferBatch(absl::Span<const std::vector<float>>()));
+
+  EXPECT_TRUE(outputs.empty());
+  EXPECT_EQ(task->GetTfLiteEngine()->input_batch_size(), 1);
+}
+
+TEST_F(BaseTaskApiTest, FailsWholeBatchWithInvalidElement) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  // Batch slots keep the [1, 4] shape of the model input, which the second
+  // element does not fit.
+  const std::vector<std::vector<float>> batch = {input_, {1, 2, 3}};
+
+  StatusOr<std::vector<std::vector<float>>> outputs_or =
+      task->InferBatch(absl::MakeConstSpan(batch));
+
+  EXPECT_EQ(outputs_or.status().code(), absl::StatusCode::kInternal);
+  // The task remains usable afterwards.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithAsyncInference) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(2);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::shared_ptr<TaskExecutor> executor,
+                               TaskExecutor::Create(/*num_threads=*/2));
+  task->SetExecutor(executor);
+
+  // The inputs are passed by reference, so they must outlive the futures.
+  constexpr int kNumRequests = 4;
+  std::vector<std::vector<float>> inputs;
+  for (int i = 0; i < kNumRequests; ++i) {
+    inputs.push_back(std::vector<float>(4, i));
+  }
+  std::vector<std::future<StatusOr<std::vector<float>>>> futures;
+  for (const std::vector<float>& input : inputs) {
+    futures.push_back(task->InferAsync(input));
+  }
+
+  for (int i = 0; i < kNumRequests; ++i) {
+    StatusOr<std::vector<float>> output_or = futures[i].get();
+    SUPPORT_ASSERT_OK(output_or);
+    EXPECT_THAT(output_or.value(),
+                ElementsAreArray(std::vector<float>(4, i + 3)));
+  }
+}
+
+TEST_F(BaseTaskApiTest, FailsAsyncInferenceWhenExecutorQueueIsFull) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<TaskExecutor> executor,
+      TaskExecutor::Create(/*num_threads=*/1, /*max_pending_closures=*/1));
+  task->SetExecutor(executor);
+  absl::Notification started;
+  absl::Notification release;
+  SUPPORT_ASSERT_OK(executor->Schedule([&]() {
+    started.Notify();
+    release.WaitForNotification();
+  }));
+  started.WaitForNotification();
+
+  std::future<StatusOr<std::vector<float>>> queued_future =
+      task->InferAsync(input_);
+  std::future<StatusOr<std::vector<float>>> rejected_future =
+      task->InferAsync(input_);
+
+  // The rejected request fails right away, with the executor status.
+  EXPECT_EQ(rejected_future.get().status().code(),
+            absl::StatusCode::kResourceExhausted);
+  release.Notify();
+  StatusOr<std::vector<float>> output_or = queued_future.get();
+  SUPPORT_ASSERT_OK(output_or);
+  EXPECT_THAT(output_or.value(), ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithDeadline) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      task->InferWithDeadline(absl::Now() + absl::Minutes(10), input_));
+
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithExceededDeadline) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  StatusOr<std::vector<float>> output_or =
+      task->InferWithDeadline(absl::Now() - absl::Seconds(1), input_);
+
+  EXPECT_EQ(output_or.status().code(), absl::StatusCode::kDeadlineExceeded);
+  // The task remains usable afterwards.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithDeadlineExceededDuringInvoke) {
+  BaseOptions options;
+  options.mutable_model_file()->set_file_content(
+      CreateSlowModel(/*num_ops=*/1000));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+  const std::vector<float> input(1 << 16, 0.f);
+  // The first call allocates the tensors for this input length, the second
+  // one times a full invocation.
+  SUPPORT_ASSERT_OK(task->Infer(input));
+  const absl::Time start = absl::Now();
+  SUPPORT_ASSERT_OK(task->Infer(input));
+  const absl::Duration inference_time = absl::Now() - start;
+
+  StatusOr<std::vector<float>> output_or =
+      task->InferWithDeadline(absl::Now() + inference_time / 4, input);
+
+  EXPECT_EQ(output_or.status().code(), absl::StatusCode::kDeadlineExceeded);
+  EXPECT_THAT(output_or.status().message(),
+              HasSubstr("Invoke() exceeded its deadline"));
+  // The interpreter remains usable afterwards.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input));
+  EXPECT_EQ(output.size(), input.size());
+  EXPECT_THAT(output, Each(0.f));
+}
+
+TEST_F(BaseTaskApiTest, GetMemoryStatsSucceeds) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(2);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  MemoryStats stats = task->GetMemoryStats();
+
+  EXPECT_EQ(stats.model_bytes,
+            static_cast<int64_t>(ReadFile(GetModelPath()).size()));
+  // Each interpreter holds the [1, 4] float input and output of the primary
+  // subgraph in its arena.
+  EXPECT_GE(stats.tensor_arena_bytes,
+            static_cast<int64_t>(2 * 2 * 4 * sizeof(float)));
+  EXPECT_EQ(stats.shared_model_bytes, 0);
+  EXPECT_TRUE(stats.task_bytes.empty());
+  EXPECT_EQ(stats.total_bytes(),
+            stats.model_bytes + stats.tensor_arena_bytes +
+                stats.persistent_arena_bytes + stats.dynamic_tensor_bytes);
+}
+
+TEST_F(BaseTaskApiTest, GetMemoryStatsReportsSharedModelSeparately) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_use_model_cache(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  MemoryStats stats = task->GetMemoryStats();
+
+  EXPECT_EQ(stats.model_bytes, 0);
+  EXPECT_EQ(stats.shared_model_bytes,
+            static_cast<int64_t>(ReadFile(GetModelPath()).size()));
+  EXPECT_EQ(stats.total_bytes(),
+            stats.tensor_arena_bytes + stats.persistent_arena_bytes +
+                stats.dynamic_tensor_bytes);
+}
+
+TEST_F(BaseTaskApiTest, GetMemoryStatsSucceedsDuringInference) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(2);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  // Inputs of varying lengths make the interpreters re-allocate their tensors
+  // while the stats are collected.
+  constexpr int kNumThreads = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int length = 1; length <= 50; ++length) {
+        EXPECT_TRUE(task->Infer(std::vector<float>(length + i, 1)).ok());
+      }
+    });
+  }
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_GT(task->GetMemoryStats().tensor_arena_bytes, 0);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithDynamicBatching) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_dynamic_batching()->set_max_batch_size(4);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  constexpr int kNumThreads = 8;
+  std::vector<StatusOr<std::vector<float>>> outputs(
+      kNumThreads, absl::UnknownError("Not run"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      outputs[i] = task->Infer(std::vector<float>(4, i));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    SUPPORT_ASSERT_OK(outputs[i]);
+    EXPECT_THAT(outputs[i].value(),
+                ElementsAreArray(std::vector<float>(4, i + 3)));
+  }
+}
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidDynamicBatchingOptions) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_dynamic_batching()->set_max_batch_size(1);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(),
+              HasSubstr("`max_batch_size` must be greater than 1"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithModelCache) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> uncached_task,
+                               CreateTask());
+  BaseOptions options = CreateBaseOptions();
+  options.set_use_model_cache(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task1,
+                               CreateTask(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task2,
+                               CreateTask(options));
+
+  // The model content is shared, but each engine reports errors to its own
+  // error reporter.
+  const TfLiteEngine::Model* model1 = task1->GetTfLiteEngine()->model();
+  const TfLiteEngine::Model* model2 = task2->GetTfLiteEngine()->model();
+  EXPECT_EQ(model1->allocation()->base(), model2->allocation()->base());
+  EXPECT_NE(model1->allocation()->base(),
+            uncached_task->GetTfLiteEngine()->model()->allocation()->base());
+  EXPECT_NE(model1->error_reporter(), model2->error_reporter());
+  EXPECT_EQ(task1->GetMetadataExtractor(), task2->GetMetadataExtractor());
+
+  // The cached model outlives the task it was first loaded with.
+  task1.reset();
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task2->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithModelCacheAndDifferentMmapOptions) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_use_model_cache(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task1,
+                               CreateTask(options));
+  options.mutable_model_file()->mutable_mmap_options()->set_prefetch(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task2,
+                               CreateTask(options));
+
+  EXPECT_NE(task1->GetTfLiteEngine()->model()->allocation()->base(),
+            task2->GetTfLiteEngine()->model()->allocation()->base());
+}
+
+TEST_F(BaseTaskApiTest, FileIdentityKeyChangesWithSubsecondModifications) {
+  const std::string model_file =
+      JoinPath(::testing::TempDir(), "touched_model.tflite");
+  WriteFile(model_file, ReadFile(GetModelPath()));
+  ExternalFile external_file;
+  external_file.set_file_name(model_file);
+  const timespec times[2] = {{1000000000, 100}, {1000000000, 100}};
+  ASSERT_EQ(utimensat(AT_FDCWD, model_file.c_str(), times, 0), 0);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::string key,
+                               ModelCache::GetFileIdentityKey(external_file));
+
+  // Same size and second, only the nanoseconds of the mtime differ.
+  const timespec new_times[2] = {{1000000000, 200}, {1000000000, 200}};
+  ASSERT_EQ(utimensat(AT_FDCWD, model_file.c_str(), new_times, 0), 0);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::string new_key,
+                               ModelCache::GetFileIdentityKey(external_file));
+  EXPECT_NE(key, new_key);
+
+  external_file.mutable_mmap_options()->set_populate(true);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::string populate_key,
+                               ModelCache::GetFileIdentityKey(external_file));
+  EXPECT_NE(new_key, populate_key);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithVerifiedModelsCacheFile) {
+  const std::string cache_file =
+      JoinPath(::testing::TempDir(), "verified_models_cache.txt");
+  std::remove(cache_file.c_str());
+  BaseOptions options = CreateBaseOptions();
+  options.set_verified_models_cache_file(cache_file);
+
+  // The first creation verifies the model and records its digest, the second
+  // one skips verification.
+  for (int i = 0; i < 2; ++i) {
+    SUPPORT_ASSERT_OK(CreateTask(options));
+    std::vector<std::string> lines = ReadLines(cache_file);
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_THAT(lines[0], HasSubstr("sha256:"));
+  }
+}
+
+TEST_F(BaseTaskApiTest, SkipsVerificationOfRecordedModels) {
+  const std::string model_file =
+      JoinPath(::testing::TempDir(), "unverifiable_model.tflite");
+  const std::string cache_file =
+      JoinPath(::testing::TempDir(), "skipped_models_cache.txt");
+  std::remove(cache_file.c_str());
+  const std::string content = CreateUnverifiableModel();
+  WriteFile(model_file, content);
+  BaseOptions options;
+  options.mutable_model_file()->set_file_name(model_file);
+  options.set_verified_models_cache_file(cache_file);
+
+  // Without a record, verification runs and rejects the model.
+  StatusOr<std::unique_ptr<VectorTask>> task = CreateTask(options);
+  EXPECT_EQ(task.status().code(), absl::StatusCode::kUnknown);
+  EXPECT_THAT(task.status().message(), HasSubstr("Could not build model"));
+  EXPECT_TRUE(ReadLines(cache_file).empty());
+
+  // Once the digest is recorded, the model is loaded without verification.
+  SUPPORT_ASSERT_OK(VerifiedModelsCache(cache_file).Add(
+      VerifiedModelsCache::ComputeDigest(content)));
+  SUPPORT_EXPECT_OK(CreateTask(options));
+}
+
+TEST_F(BaseTaskApiTest, VerifiesModifiedModelsAgain) {
+  const std::string model_file =
+      JoinPath(::testing::TempDir(), "modified_model.tflite");
+  const std::string cache_file =
+      JoinPath(::testing::TempDir(), "modified_models_cache.txt");
+  std::remove(cache_file.c_str());
+  WriteFile(model_file, ReadFile(GetModelPath()));
+  BaseOptions options;
+  options.mutable_model_file()->set_file_name(model_file);
+  options.set_verified_models_cache_file(cache_file);
+  SUPPORT_ASSERT_OK(CreateTask(options));
+  ASSERT_EQ(ReadLines(cache_file).size(), 1);
+
+  // Modifying the file in place changes its digest, so the recorded entry
+  // must not let the modified model skip verification.
+  WriteFile(model_file, CreateUnverifiableModel());
+  StatusOr<std::unique_ptr<VectorTask>> task = CreateTask(options);
+  EXPECT_EQ(task.status().code(), absl::StatusCode::kUnknown);
+  EXPECT_EQ(ReadLines(cache_file).size(), 1);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithInferenceStats) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  auto stats = std::make_shared<InferenceStats>();
+  int num_exported_calls = 0;
+  stats->SetExportCallback([&num_exported_calls](const InferenceTimings&) {
+    ++num_exported_calls;
+  });
+  task->SetInferenceStats(stats);
+
+  constexpr int kNumCalls = 3;
+  for (int i = 0; i < kNumCalls; ++i) {
+    SUPPORT_ASSERT_OK(task->Infer(input_));
+  }
+
+  InferenceStatsSnapshot snapshot = stats->Snapshot();
+  EXPECT_EQ(snapshot.num_calls, kNumCalls);
+  EXPECT_EQ(snapshot.num_failed_calls, 0);
+  EXPECT_EQ(num_exported_calls, kNumCalls);
+  for (InferenceStage stage :
+       {InferenceStage::kPreprocess, InferenceStage::kInvoke,
+        InferenceStage::kPostprocess, InferenceStage::kTotal}) {
+    EXPECT_EQ(snapshot.stage(stage).count, kNumCalls);
+    EXPECT_LE(snapshot.stage(stage).p50, snapshot.stage(stage).p99);
+    EXPECT_LE(snapshot.stage(stage).p99, snapshot.stage(stage).max);
+  }
+
+  stats->Reset();
+  EXPECT_EQ(stats->Snapshot().num_calls, 0);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithOpProfiling) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_op_profiling();
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  constexpr int kNumCalls = 2;
+  for (int i = 0; i < kNumCalls; ++i) {
+    SUPPORT_ASSERT_OK(task->Infer(input_));
+  }
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<OpProfile> profiles,
+                               task->GetOpProfiles());
+  ASSERT_FALSE(profiles.empty());
+  for (int i = 0; i < static_cast<int>(profiles.size()); ++i) {
+    EXPECT_FALSE(profiles[i].op_type.empty());
+    EXPECT_EQ(profiles[i].invocation_count, kNumCalls);
+    if (i > 0) {
+      EXPECT_GE(profiles[i - 1].total_time, profiles[i].total_time);
+    }
+  }
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::string trace,
+                               task->GetOpProfilingChromeTrace());
+  EXPECT_THAT(trace, HasSubstr("\"traceEvents\""));
+  EXPECT_THAT(trace, HasSubstr(profiles[0].op_type));
+
+  task->ResetOpProfiling();
+  SUPPORT_ASSERT_OK_AND_ASSIGN(profiles, task->GetOpProfiles());
+  EXPECT_TRUE(profiles.empty());
+}
+
+TEST_F(BaseTaskApiTest, FailsToGetOpProfilesWithoutOpProfiling) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  EXPECT_EQ(task->GetOpProfiles().status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(BaseTaskApiTest, SkipsAllocationForSameShapes) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  const TfLiteEngine* engine = task->GetTfLiteEngine();
+
+  // The model input already has the shape of `input_`.
+  SUPPORT_ASSERT_OK(task->Infer(input_));
+  EXPECT_EQ(engine->num_input_tensor_allocations(), 0);
+
+  const std::vector<float> longer_input = {1, 2, 3, 4, 5, 6};
+  for (int i = 0; i < 2; ++i) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output,
+                                 task->Infer(longer_input));
+    EXPECT_THAT(output, ElementsAre(4, 5, 6, 7, 8, 9));
+    EXPECT_EQ(engine->num_input_tensor_allocations(), 1);
+  }
+
+  SUPPORT_ASSERT_OK(task->Infer(input_));
+  EXPECT_EQ(engine->num_input_tensor_allocations(), 2);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithShapeBuckets) {
+  BaseOptions options = CreateBaseOptions();
+  options.add_shape_buckets(16);
+  options.add_shape_buckets(8);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+  const TfLiteEngine* engine = task->GetTfLiteEngine();
+  EXPECT_EQ(engine->RoundUpToShapeBucket(1), 8);
+  EXPECT_EQ(engine->RoundUpToShapeBucket(8), 8);
+  EXPECT_EQ(engine->RoundUpToShapeBucket(9), 16);
+  EXPECT_EQ(engine->RoundUpToShapeBucket(17), 17);
+
+  // Lengths 4 to 8 are all padded to 8, so that only the first inference
+  // re-allocates the tensors.
+  for (int length = 4; length <= 8; ++length) {
+    std::vector<float> input(length);
+    std::vector<float> expected_output(length);
+    for (int i = 0; i < length; ++i) {
+      input[i] = i;
+      expected_output[i] = i + 3;
+    }
+    SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output,
+                                 task->Infer(input));
+    EXPECT_THAT(output, ElementsAreArray(expected_output));
+    EXPECT_THAT(std::vector<int>(task->GetInputShape(0)->data,
+                                 task->GetInputShape(0)->data +
+                                     task->GetInputShape(0)->size),
+                ElementsAre(1, 8));
+    EXPECT_EQ(engine->num_input_tensor_allocations(), 1);
+  }
+
+  SUPPORT_ASSERT_OK(task->Infer(std::vector<float>(9)));
+  EXPECT_EQ(engine->num_input_tensor_allocations(), 2);
+}
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidShapeBuckets) {
+  BaseOptions options = CreateBaseOptions();
+  options.add_shape_buckets(64);
+  options.add_shape_buckets(0);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(),
+              HasSubstr("Shape buckets must be positive"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithBoundTensorBuffers) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  AlignedBuffer input_buffer(input_.size() * sizeof(float));
+  AlignedBuffer output_buffer(input_.size() * sizeof(float));
+  SUPPORT_ASSERT_OK(task->BindInputTensorBuffer(0, input_buffer.data(),
+                                                input_buffer.size()));
+  SUPPORT_ASSERT_OK(task->BindOutputTensorBuffer(0, output_buffer.data(),
+                                                 output_buffer.size()));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+  // The inputs and outputs were written to the bound buffers.
+  const float* input_data = static_cast<const float*>(input_buffer.data());
+  const float* output_data = static_cast<const float*>(output_buffer.data());
+  EXPECT_THAT(std::vector<float>(input_data, input_data + input_.size()),
+              ElementsAreArray(input_));
+  EXPECT_THAT(std::vector<float>(output_data, output_data + input_.size()),
+              ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, FailsToBindMisalignedTensorBuffer) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  AlignedBuffer buffer(1 << 10);
+
+  absl::Status status = task->BindInputTensorBuffer(
+      0, static_cast<char*>(buffer.data()) + 1, buffer.size() - 1);
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(), HasSubstr("aligned"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithAutoTune) {
+  const std::string cache_file =
+      JoinPath(::testing::TempDir(), "auto_tune_cache.txt");
+  std::remove(cache_file.c_str());
+  BaseOptions options = CreateBaseOptions();
+  AutoTuneOptions* auto_tune = options.mutable_auto_tune();
+  auto_tune->add_candidate_num_threads(1);
+  auto_tune->add_candidate_num_threads(2);
+  auto_tune->set_try_xnnpack(false);
+  auto_tune->set_num_runs(1);
+  auto_tune->set_cache_file(cache_file);
+
+  // The first creation benchmarks the candidates and records the best one,
+  // the second one reads it from the cache file.
+  for (int i = 0; i < 2; ++i) {
+    SUPPORT_ASSERT_OK(CreateTask(options));
+    std::vector<std::string> lines = ReadLines(cache_file);
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_THAT(lines[0], ::testing::AnyOf(HasSubstr("\t1\t0"),
+                                           HasSubstr("\t2\t0")));
+  }
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithAutoTuneAfterCandidatesChange) {
+  const std::string cache_file =
+      JoinPath(::testing::TempDir(), "changed_auto_tune_cache.txt");
+  std::remove(cache_file.c_str());
+  BaseOptions options = CreateBaseOptions();
+  AutoTuneOptions* auto_tune = options.mutable_auto_tune();
+  auto_tune->add_candidate_num_threads(1);
+  auto_tune->set_try_xnnpack(false);
+  auto_tune->set_num_runs(1);
+  auto_tune->set_cache_file(cache_file);
+  SUPPORT_ASSERT_OK(CreateTask(options));
+  ASSERT_EQ(ReadLines(cache_file).size(), 1);
+
+  // The result cached for other candidates is not reused.
+  auto_tune->set_candidate_num_threads(0, 3);
+  SUPPORT_ASSERT_OK(CreateTask(options));
+  std::vector<std::string> lines = ReadLines(cache_file);
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_THAT(lines[0], HasSubstr("\t1\t0"));
+  EXPECT_THAT(lines[1], HasSubstr("\t3\t0"));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidAutoTuneOptions) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_auto_tune()->set_num_runs(0);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(), HasSubstr("num_runs"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithWarmup) {
+  BaseOptions options = CreateBaseOptions();
+  options.set_num_interpreters(2);
+  options.mutable_op_profiling();
+  options.mutable_warmup()->set_num_runs(2);
+  options.mutable_warmup()->set_prefault_model(true);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  // Warm-up invocations are not reported in the op profiles.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<OpProfile> profiles,
+                               task->GetOpProfiles());
+  EXPECT_TRUE(profiles.empty());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidWarmupOptions) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_warmup()->set_num_runs(-1);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(), HasSubstr("num_runs"));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithMmapOptions) {
+  BaseOptions options = CreateBaseOptions();
+  MmapOptions* mmap_options =
+      options.mutable_model_file()->mutable_mmap_options();
+  mmap_options->set_access_pattern(MmapOptions::SEQUENTIAL);
+  mmap_options->set_prefetch(true);
+  mmap_options->set_populate(true);
+  mmap_options->set_huge_pages(true);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithSharedThreadPool) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_compute_settings()
+      ->mutable_tflite_settings()
+      ->mutable_cpu_settings()
+      ->set_num_threads(2);
+  options.mutable_threading()->set_shared_thread_pool("base_task_api_test");
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> first,
+                               CreateTask(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> second,
+                               CreateTask(options));
+
+  // Both task instances run on the same thread pool. Sequential inferences
+  // reuse the same backend context.
+  SharedThreadPool* pool = first->GetTfLiteEngine()->shared_thread_pool();
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(second->GetTfLiteEngine()->shared_thread_pool(), pool);
+  SUPPORT_EXPECT_OK(first->Infer(input_));
+  SUPPORT_EXPECT_OK(second->Infer(input_));
+  EXPECT_EQ(pool->num_cpu_backend_contexts(), 1);
+  std::vector<TfLiteExternalContext*> cpu_backend_contexts;
+  for (VectorTask* task : {first.get(), second.get()}) {
+    TfLiteContext* context =
+        task->GetTfLiteEngine()->interpreter()->primary_subgraph().context();
+    cpu_backend_contexts.push_back(
+        context->GetExternalContext(context, kTfLiteCpuBackendContext));
+  }
+  EXPECT_NE(cpu_backend_contexts[0], nullptr);
+  EXPECT_EQ(cpu_backend_contexts[0], cpu_backend_contexts[1]);
+
+  std::thread thread([&]() {
+    for (int i = 0; i < 3; ++i) {
+      SUPPORT_EXPECT_OK(first->Infer(input_));
+    }
+  });
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_EXPECT_OK(second->Infer(input_));
+  }
+  thread.join();
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithOverlappingLeasesOnSharedThreadPool) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_compute_settings()
+      ->mutable_tflite_settings()
+      ->mutable_cpu_settings()
+      ->set_num_threads(2);
+  options.mutable_threading()->set_shared_thread_pool("overlapping_leases");
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> first,
+                               CreateTask(options));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> second,
+                               CreateTask(options));
+
+  // Each thread leases the interpreter of one task, then waits for the other
+  // thread to hold its own lease before running an inference: this times out
+  // if leases on the pool are serialized.
+  absl::Notification first_leased;
+  absl::Notification second_leased;
+  std::thread thread([&]() {
+    TfLiteEngine::InterpreterLease lease =
+        second->GetTfLiteEngine()->AcquireInterpreter();
+    second_leased.Notify();
+    EXPECT_TRUE(first_leased.WaitForNotificationWithTimeout(absl::Seconds(10)));
+    SUPPORT_EXPECT_OK(second->Infer(input_));
+  });
+  {
+    TfLiteEngine::InterpreterLease lease =
+        first->GetTfLiteEngine()->AcquireInterpreter();
+    first_leased.Notify();
+    EXPECT_TRUE(
+        second_leased.WaitForNotificationWithTimeout(absl::Seconds(10)));
+    SUPPORT_EXPECT_OK(first->Infer(input_));
+  }
+  thread.join();
+
+  EXPECT_EQ(first->GetTfLiteEngine()->shared_thread_pool()
+                ->num_cpu_backend_contexts(),
+            2);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithNestedLeasesOnSharedThreadPools) {
+  BaseOptions first_options = CreateBaseOptions();
+  first_options.mutable_threading()->set_shared_thread_pool("nested_first");
+  BaseOptions second_options = CreateBaseOptions();
+  second_options.mutable_threading()->set_shared_thread_pool("nested_second");
+  std::vector<std::unique_ptr<VectorTask>> tasks;
+  for (const BaseOptions* options :
+       {&first_options, &second_options, &second_options, &first_options}) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                                 CreateTask(*options));
+    tasks.push_back(std::move(task));
+  }
+
+  // Each thread holds a lease on one pool while running an inference on the
+  // other one, in opposite orders.
+  absl::Notification leased[2];
+  auto run_nested = [&](int index) {
+    TfLiteEngine::InterpreterLease lease =
+        tasks[2 * index]->GetTfLiteEngine()->AcquireInterpreter();
+    leased[index].Notify();
+    EXPECT_TRUE(leased[1 - index].WaitForNotificationWithTimeout(
+        absl::Seconds(10)));
+    SUPPORT_EXPECT_OK(tasks[2 * index + 1]->Infer(input_));
+  };
+  std::thread thread(run_nested, 1);
+  run_nested(0);
+  thread.join();
+}
+
+#ifdef __linux__
+// Task recording the CPU affinity of the thread running its pre-processing,
+// i.e. within the inference call.
+class CpuAffinityTask : public VectorTask {
+ public:
+  using VectorTask::VectorTask;
+
+  const std::vector<int>& inference_cpu_affinity() const {
+    return inference_cpu_affinity_;
+  }
+
+ protected:
+  absl::Status Preprocess(const std::vector<TfLiteTensor*>& input_tensors,
+                          const std::vector<float>& input) override {
+    ASSIGN_OR_RETURN(inference_cpu_affinity_, GetCurrentThreadCpuAffinity());
+    return VectorTask::Preprocess(input_tensors, input);
+  }
+
+ private:
+  std::vector<int> inference_cpu_affinity_;
+};
+
+TEST_F(BaseTaskApiTest, SucceedsWithCpuAffinity) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<int> initial_cpus,
+                               GetCurrentThreadCpuAffinity());
+  ASSERT_FALSE(initial_cpus.empty());
+  // The last allowed CPU, so that the affinity differs from the initial one
+  // on hosts with several CPUs.
+  const int cpu = initial_cpus.back();
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_threading()->add_cpu_affinity(cpu);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CpuAffinityTask> task,
+      TaskAPIFactory::CreateFromBaseOptions<CpuAffinityTask>(&options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output, task->Infer(input_));
+
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+  EXPECT_THAT(task->inference_cpu_affinity(), ElementsAre(cpu));
+  // The calling thread stays pinned afterwards, so that later inferences
+  // don't set its affinity again.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<int> final_cpus,
+                               GetCurrentThreadCpuAffinity());
+  EXPECT_THAT(final_cpus, ElementsAre(cpu));
+  SUPPORT_ASSERT_OK(SetCurrentThreadCpuAffinity(initial_cpus));
+}
+#endif  // __linux__
+
+TEST_F(BaseTaskApiTest, FailsWithInvalidCpuAffinity) {
+  BaseOptions options = CreateBaseOptions();
+  options.mutable_threading()->add_cpu_affinity(-1);
+
+  StatusOr<std::unique_ptr<VectorTask>> task_or = CreateTask(options);
+
+#ifdef __linux__
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(task_or.status().message(), HasSubstr("CPU -1 out of range"));
+#else
+  EXPECT_EQ(task_or.status().code(), absl::StatusCode::kUnimplemented);
+#endif  // __linux__
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithSignatures) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  EXPECT_THAT(task->GetSignatureKeys(), ElementsAre("add", "mul"));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> add_output,
+                               task->InferWithSignature("add", input_));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> mul_output,
+                               task->InferWithSignature("mul", input_));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> primary_output,
+                               task->Infer(input_));
+
+  EXPECT_THAT(add_output, ElementsAreArray({4, 5, 6, 7}));
+  EXPECT_THAT(mul_output, ElementsAreArray({3, 6, 9, 12}));
+  EXPECT_THAT(primary_output, ElementsAreArray({4, 5, 6, 7}));
+  // Both signatures read their weight from the same model buffer.
+  TfLiteEngine::Interpreter* interpreter =
+      task->GetTfLiteEngine()->interpreter();
+  ASSERT_EQ(interpreter->subgraphs_size(), 2);
+  const TfLiteTensor* add_weight = interpreter->subgraph(0)->tensor(1);
+  const TfLiteTensor* mul_weight = interpreter->subgraph(1)->tensor(1);
+  EXPECT_EQ(add_weight->allocation_type, kTfLiteMmapRo);
+  EXPECT_EQ(add_weight->data.raw, mul_weight->data.raw);
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithResizedSignatureInputs) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      task->InferWithSignature("mul", {1, 2, 3, 4, 5, 6}));
+
+  EXPECT_THAT(output, ElementsAreArray({3, 6, 9, 12, 15, 18}));
+  // The primary subgraph keeps its shape.
+  EXPECT_THAT(std::vector<int>(task->GetInputShape(0)->data,
+                               task->GetInputShape(0)->data +
+                                   task->GetInputShape(0)->size),
+              ElementsAre(1, 4));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(output, task->InferWithSignature("mul", input_));
+  EXPECT_THAT(output, ElementsAreArray({3, 6, 9, 12}));
+}
+
+TEST_F(BaseTaskApiTest, SucceedsWithSignatureAfterBatch) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+  const std::vector<std::vector<float>> batch = {input_, {0, 0, 0, 1}};
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<float>> batch_outputs,
+      task->InferBatch(absl::MakeConstSpan(batch)));
+  ASSERT_EQ(batch_outputs.size(), 2);
+  EXPECT_THAT(batch_outputs[1], ElementsAreArray({3, 3, 3, 4}));
+
+  // The primary inputs are brought back to a batch size of 1.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output,
+                               task->InferWithSignature("mul", input_));
+  EXPECT_THAT(output, ElementsAreArray({3, 6, 9, 12}));
+  EXPECT_EQ(task->GetTfLiteEngine()->input_batch_size(), 1);
+}
+
+TEST_F(BaseTaskApiTest, FailsWithSignatureAndExceededDeadline) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  StatusOr<std::vector<float>> output_or = task->InferWithSignatureWithDeadline(
+      "mul", absl::Now() - absl::Seconds(1), input_);
+
+  EXPECT_EQ(output_or.status().code(), absl::StatusCode::kDeadlineExceeded);
+  // The task remains usable afterwards.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<float> output,
+      task->InferWithSignatureWithDeadline(
+          "mul", absl::Now() + absl::Minutes(10), input_));
+  EXPECT_THAT(output, ElementsAreArray({3, 6, 9, 12}));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(output, task->Infer(input_));
+  EXPECT_THAT(output, ElementsAreArray({4, 5, 6, 7}));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithUnknownSignature) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task, CreateTask());
+
+  StatusOr<std::vector<float>> output_or =
+      task->InferWithSignature("unknown", input_);
+
+  EXPECT_EQ(output_or.status().code(), absl::StatusCode::kNotFound);
+  EXPECT_THAT(output_or.status().message(),
+              HasSubstr("Model has no signature with key \"unknown\""));
+}
+
+TEST_F(BaseTaskApiTest, FailsWithMismatchedSignature) {
+  BaseOptions options;
+  options.mutable_model_file()->set_file_content(
+      CreateModelWithMismatchedSignature());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VectorTask> task,
+                               CreateTask(options));
+
+  StatusOr<std::vector<float>> output_or =
+      task->InferWithSignature("mul", input_);
+
+  EXPECT_EQ(output_or.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(output_or.status().message(),
+              HasSubstr("input 0 has a different type or shape"));
+  // The matching signature and the primary subgraph remain usable.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<float> output,
+                               task->InferWithSignature("add", input_));
+  EXPECT_THAT(output, ElementsAreArray(expected_output_));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
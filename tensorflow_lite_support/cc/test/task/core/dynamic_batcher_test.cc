@@ -0,0 +1,191 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/dynamic_batcher.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "absl/types/span.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+
+using IntBatcher = DynamicBatcher<int, int>;
+
+// Long enough for a batch to never time out during a test.
+constexpr absl::Duration kLongTimeout = absl::Minutes(10);
+
+// Batch function doubling its inputs, recording the size of each batch.
+class DoublingBatchFunction {
+ public:
+  StatusOr<std::vector<int>> operator()(
+      absl::Span<const std::tuple<int>> batch) {
+    {
+      absl::MutexLock lock(&mutex_);
+      batch_sizes_.push_back(batch.size());
+    }
+    std::vector<int> results;
+    for (const std::tuple<int>& inputs : batch) {
+      results.push_back(2 * std::get<0>(inputs));
+    }
+    return results;
+  }
+
+  std::vector<int> batch_sizes() {
+    absl::MutexLock lock(&mutex_);
+    return batch_sizes_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<int> batch_sizes_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Calls `batcher->Run(i)` from `num_calls` threads, and returns the results.
+std::vector<StatusOr<int>> RunConcurrently(IntBatcher* batcher,
+                                           int num_calls) {
+  std::vector<StatusOr<int>> results(num_calls,
+                                     absl::UnknownError("Not run"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_calls; ++i) {
+    threads.emplace_back([&, i]() { results[i] = batcher->Run(i); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
+TEST(DynamicBatcherTest, FlushesOnMaxBatchSize) {
+  DoublingBatchFunction batch_function;
+  IntBatcher batcher(/*max_batch_size=*/3, kLongTimeout,
+                     [&](absl::Span<const std::tuple<int>> batch) {
+                       return batch_function(batch);
+                     });
+
+  // The batch is run as soon as it is full, long before the timeout.
+  std::vector<StatusOr<int>> results = RunConcurrently(&batcher, 3);
+
+  for (int i = 0; i < 3; ++i) {
+    SUPPORT_ASSERT_OK(results[i]);
+    EXPECT_EQ(results[i].value(), 2 * i);
+  }
+  EXPECT_THAT(batch_function.batch_sizes(), ElementsAre(3));
+}
+
+TEST(DynamicBatcherTest, FlushesOnTimeout) {
+  DoublingBatchFunction batch_function;
+  IntBatcher batcher(/*max_batch_size=*/8, absl::Milliseconds(10),
+                     [&](absl::Span<const std::tuple<int>> batch) {
+                       return batch_function(batch);
+                     });
+
+  const absl::Time start = absl::Now();
+  StatusOr<int> result = batcher.Run(21);
+
+  SUPPORT_ASSERT_OK(result);
+  EXPECT_EQ(result.value(), 42);
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(10));
+  EXPECT_THAT(batch_function.batch_sizes(), ElementsAre(1));
+}
+
+TEST(DynamicBatcherTest, FansOutBatchFunctionError) {
+  IntBatcher batcher(/*max_batch_size=*/2, kLongTimeout,
+                     [](absl::Span<const std::tuple<int>> batch)
+                         -> StatusOr<std::vector<int>> {
+                       return absl::InternalError("Batch failed");
+                     });
+
+  std::vector<StatusOr<int>> results = RunConcurrently(&batcher, 2);
+
+  for (const StatusOr<int>& result : results) {
+    EXPECT_EQ(result.status().code(), absl::StatusCode::kInternal);
+    EXPECT_EQ(result.status().message(), "Batch failed");
+  }
+}
+
+TEST(DynamicBatcherTest, FailsAllCallsWithPartialBatchResults) {
+  // Only returns the result of the first call of the batch.
+  IntBatcher batcher(/*max_batch_size=*/2, kLongTimeout,
+                     [](absl::Span<const std::tuple<int>> batch)
+                         -> StatusOr<std::vector<int>> {
+                       return std::vector<int>{std::get<0>(batch[0])};
+                     });
+
+  std::vector<StatusOr<int>> results = RunConcurrently(&batcher, 2);
+
+  for (const StatusOr<int>& result : results) {
+    EXPECT_EQ(result.status().code(), absl::StatusCode::kInternal);
+    EXPECT_THAT(result.status().message(),
+                HasSubstr("Expected 2 batched results, got 1"));
+  }
+}
+
+TEST(DynamicBatcherTest, RunsPendingCallsOnDestruction) {
+  DoublingBatchFunction batch_function;
+  auto batcher = std::make_unique<IntBatcher>(
+      /*max_batch_size=*/8, kLongTimeout,
+      [&](absl::Span<const std::tuple<int>> batch) {
+        return batch_function(batch);
+      });
+  constexpr int kNumCalls = 3;
+  std::vector<StatusOr<int>> results(kNumCalls,
+                                     absl::UnknownError("Not run"));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumCalls; ++i) {
+    threads.emplace_back([&, i]() { results[i] = batcher->Run(i); });
+  }
+  // Lets the calls wait for the batch to fill up, which never happens.
+  absl::SleepFor(absl::Milliseconds(50));
+
+  // Returns once all the calls have returned, without waiting for the
+  // timeout.
+  batcher.reset();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kNumCalls; ++i) {
+    SUPPORT_ASSERT_OK(results[i]);
+    EXPECT_EQ(results[i].value(), 2 * i);
+  }
+  int num_batched_calls = 0;
+  for (int batch_size : batch_function.batch_sizes()) {
+    num_batched_calls += batch_size;
+  }
+  EXPECT_EQ(num_batched_calls, kNumCalls);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,118 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/external_file_handler.h"
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/proto/external_file_proto_inc.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::tflite::task::JoinPath;
+
+constexpr size_t kPageSize = 4096;
+
+// Sets the soft RLIMIT_MEMLOCK limit of the process for the lifetime of this
+// object.
+class ScopedMemlockLimit {
+ public:
+  explicit ScopedMemlockLimit(rlim_t limit) {
+    EXPECT_EQ(getrlimit(RLIMIT_MEMLOCK, &original_limit_), 0);
+    struct rlimit new_limit = original_limit_;
+    new_limit.rlim_cur = limit;
+    EXPECT_EQ(setrlimit(RLIMIT_MEMLOCK, &new_limit), 0);
+  }
+
+  ~ScopedMemlockLimit() { setrlimit(RLIMIT_MEMLOCK, &original_limit_); }
+
+ private:
+  struct rlimit original_limit_;
+};
+
+// Returns whether the process may lock memory regardless of RLIMIT_MEMLOCK,
+// e.g. with CAP_IPC_LOCK, in which case locking failures can't be triggered.
+bool IgnoresMemlockLimit() {
+  ScopedMemlockLimit limit(0);
+  alignas(kPageSize) static char page[kPageSize];
+  if (mlock(page, sizeof(page)) != 0) {
+    return false;
+  }
+  munlock(page, sizeof(page));
+  return true;
+}
+
+// Writes a file of `size` bytes in the test temporary directory and returns an
+// ExternalFile locking it in memory.
+ExternalFile CreateLockedFile(const std::string& name, size_t size) {
+  const std::string path = JoinPath(::testing::TempDir(), name);
+  std::ofstream(path, std::ios::binary) << std::string(size, 'x');
+  ExternalFile external_file;
+  external_file.set_file_name(path);
+  external_file.mutable_mmap_options()->set_lock(true);
+  return external_file;
+}
+
+TEST(ExternalFileHandlerTest, SucceedsWithLock) {
+  ExternalFile external_file = CreateLockedFile("locked.bin", kPageSize);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ExternalFileHandler> handler,
+      ExternalFileHandler::CreateFromExternalFile(&external_file));
+
+  EXPECT_EQ(handler->GetFileContent(), std::string(kPageSize, 'x'));
+}
+
+TEST(ExternalFileHandlerTest, FailsToLockWithZeroMemlockLimit) {
+  if (IgnoresMemlockLimit()) {
+    GTEST_SKIP() << "The process may lock memory regardless of its limit.";
+  }
+  ExternalFile external_file = CreateLockedFile("locked.bin", kPageSize);
+  ScopedMemlockLimit limit(0);
+
+  auto handler_or = ExternalFileHandler::CreateFromExternalFile(&external_file);
+
+  EXPECT_EQ(handler_or.status().code(), absl::StatusCode::kPermissionDenied);
+}
+
+TEST(ExternalFileHandlerTest, FailsToLockAboveMemlockLimit) {
+  if (IgnoresMemlockLimit()) {
+    GTEST_SKIP() << "The process may lock memory regardless of its limit.";
+  }
+  ExternalFile external_file =
+      CreateLockedFile("large_locked.bin", 256 * kPageSize);
+  ScopedMemlockLimit limit(kPageSize);
+
+  auto handler_or = ExternalFileHandler::CreateFromExternalFile(&external_file);
+
+  EXPECT_EQ(handler_or.status().code(), absl::StatusCode::kResourceExhausted);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,174 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/inference_stats.h"
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::HasSubstr;
+
+// Records one successful call per provided invoke latency, in microseconds.
+void RecordInvokes(InferenceStats& stats, std::initializer_list<int64_t> micros,
+                   int times = 1) {
+  for (int i = 0; i < times; ++i) {
+    for (int64_t value : micros) {
+      InferenceTimings timings;
+      timings.stages[static_cast<int>(InferenceStage::kInvoke)] =
+          absl::Microseconds(value);
+      timings.stages[static_cast<int>(InferenceStage::kTotal)] =
+          absl::Microseconds(value);
+      timings.ok = true;
+      stats.Record(timings);
+    }
+  }
+}
+
+TEST(InferenceStatsTest, EmptyHistogramReportsZeros) {
+  InferenceStats stats;
+
+  InferenceStatsSnapshot snapshot = stats.Snapshot();
+
+  EXPECT_EQ(snapshot.num_calls, 0);
+  EXPECT_EQ(snapshot.num_failed_calls, 0);
+  for (const StageLatencyStats& stage : snapshot.stages) {
+    EXPECT_EQ(stage.count, 0);
+    EXPECT_EQ(stage.min, absl::ZeroDuration());
+    EXPECT_EQ(stage.max, absl::ZeroDuration());
+    EXPECT_EQ(stage.p50, absl::ZeroDuration());
+    EXPECT_EQ(stage.p99, absl::ZeroDuration());
+  }
+}
+
+TEST(InferenceStatsTest, CountsCallsAndSkipsStagesNotReached) {
+  InferenceStats stats;
+  RecordInvokes(stats, {100, 200});
+  InferenceTimings failed;
+  failed.stages[static_cast<int>(InferenceStage::kPreprocess)] =
+      absl::Microseconds(5);
+  stats.Record(failed);
+
+  InferenceStatsSnapshot snapshot = stats.Snapshot();
+
+  EXPECT_EQ(snapshot.num_calls, 3);
+  EXPECT_EQ(snapshot.num_failed_calls, 1);
+  EXPECT_EQ(snapshot.stage(InferenceStage::kPreprocess).count, 1);
+  EXPECT_EQ(snapshot.stage(InferenceStage::kInvoke).count, 2);
+  EXPECT_EQ(snapshot.stage(InferenceStage::kPostprocess).count, 0);
+  // The total stage is always recorded, even if zero.
+  EXPECT_EQ(snapshot.stage(InferenceStage::kTotal).count, 3);
+  const StageLatencyStats& invoke = snapshot.stage(InferenceStage::kInvoke);
+  EXPECT_EQ(invoke.total, absl::Microseconds(300));
+  EXPECT_EQ(invoke.mean, absl::Microseconds(150));
+  EXPECT_EQ(invoke.min, absl::Microseconds(100));
+  EXPECT_EQ(invoke.max, absl::Microseconds(200));
+}
+
+TEST(InferenceStatsTest, BucketsSmallLatenciesExactly) {
+  InferenceStats stats;
+  RecordInvokes(stats, {1, 2, 3, 4, 5, 6, 7});
+
+  const StageLatencyStats invoke =
+      stats.Snapshot().stage(InferenceStage::kInvoke);
+
+  EXPECT_EQ(invoke.p50, absl::Microseconds(4));
+  EXPECT_EQ(invoke.p90, absl::Microseconds(6));
+  EXPECT_EQ(invoke.p99, absl::Microseconds(7));
+}
+
+TEST(InferenceStatsTest, BucketsAtPowerOfTwoBoundaries) {
+  // 1023us falls in the last sub-bucket below 1024us, i.e. [960, 1024).
+  InferenceStats below;
+  RecordInvokes(below, {1023}, /*times=*/3);
+  RecordInvokes(below, {1});
+  EXPECT_EQ(below.Snapshot().stage(InferenceStage::kInvoke).p50,
+            absl::Microseconds(992));
+
+  // 1024us falls in the first sub-bucket of the next power of two, i.e.
+  // [1024, 1152).
+  InferenceStats above;
+  RecordInvokes(above, {1024}, /*times=*/3);
+  RecordInvokes(above, {2000});
+  EXPECT_EQ(above.Snapshot().stage(InferenceStage::kInvoke).p50,
+            absl::Microseconds(1088));
+}
+
+TEST(InferenceStatsTest, PercentilesAreWithinBucketResolution) {
+  InferenceStats stats;
+  for (int64_t micros = 1; micros <= 10000; ++micros) {
+    RecordInvokes(stats, {micros});
+  }
+
+  const StageLatencyStats invoke =
+      stats.Snapshot().stage(InferenceStage::kInvoke);
+
+  EXPECT_EQ(invoke.count, 10000);
+  EXPECT_NEAR(absl::ToDoubleMicroseconds(invoke.p50), 5000, 5000 * 0.125);
+  EXPECT_NEAR(absl::ToDoubleMicroseconds(invoke.p90), 9000, 9000 * 0.125);
+  EXPECT_NEAR(absl::ToDoubleMicroseconds(invoke.p99), 9900, 9900 * 0.125);
+  EXPECT_LE(invoke.p99, invoke.max);
+}
+
+TEST(InferenceStatsTest, ClampsHugeLatenciesToOverflowBucket) {
+  const int64_t huge_micros = int64_t{1} << 50;
+  InferenceStats stats;
+  RecordInvokes(stats, {huge_micros}, /*times=*/3);
+  RecordInvokes(stats, {1});
+
+  const StageLatencyStats invoke =
+      stats.Snapshot().stage(InferenceStage::kInvoke);
+
+  // All latencies from 15 * 2^38us on share the last bucket, whose lower bound
+  // is reported.
+  EXPECT_EQ(invoke.p50, absl::Microseconds(int64_t{15} << 38));
+  EXPECT_EQ(invoke.max, absl::Microseconds(huge_micros));
+}
+
+TEST(InferenceStatsTest, ResetClearsStatistics) {
+  InferenceStats stats;
+  RecordInvokes(stats, {10, 20});
+
+  stats.Reset();
+
+  InferenceStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.num_calls, 0);
+  EXPECT_EQ(snapshot.stage(InferenceStage::kInvoke).count, 0);
+}
+
+TEST(InferenceStatsTest, InvokesExportCallbackAndFormatsSummary) {
+  InferenceStats stats;
+  int num_exported = 0;
+  stats.SetExportCallback(
+      [&num_exported](const InferenceTimings&) { ++num_exported; });
+
+  RecordInvokes(stats, {10, 20});
+
+  EXPECT_EQ(num_exported, 2);
+  EXPECT_THAT(stats.Snapshot().ToString(), HasSubstr("calls: 2 (failed: 0)"));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
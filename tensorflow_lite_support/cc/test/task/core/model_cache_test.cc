@@ -0,0 +1,164 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/model_cache.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::tflite::support::StatusOr;
+
+// Returns a unique key per test, since the cache is process-wide.
+std::string GetTestKey(const std::string& suffix = "") {
+  return std::string("test:") +
+         ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+         suffix;
+}
+
+TEST(ModelCacheTest, ReturnsCachedModelWhileAlive) {
+  ModelCache* cache = ModelCache::GetInstance();
+  const int initial_size = cache->size();
+  int num_creations = 0;
+  auto create = [&num_creations]() -> StatusOr<std::shared_ptr<CachedModel>> {
+    ++num_creations;
+    return std::make_shared<CachedModel>();
+  };
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::shared_ptr<CachedModel> first,
+                               cache->GetOrCreate(GetTestKey(), create));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::shared_ptr<CachedModel> second,
+                               cache->GetOrCreate(GetTestKey(), create));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<CachedModel> other,
+      cache->GetOrCreate(GetTestKey("other"), create));
+
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+  EXPECT_EQ(num_creations, 2);
+  EXPECT_EQ(cache->size(), initial_size + 2);
+}
+
+TEST(ModelCacheTest, ReleasesExpiredModels) {
+  ModelCache* cache = ModelCache::GetInstance();
+  const int initial_size = cache->size();
+  int num_creations = 0;
+  auto create = [&num_creations]() -> StatusOr<std::shared_ptr<CachedModel>> {
+    ++num_creations;
+    return std::make_shared<CachedModel>();
+  };
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::shared_ptr<CachedModel> model,
+                               cache->GetOrCreate(GetTestKey(), create));
+  std::weak_ptr<CachedModel> weak_model = model;
+  ASSERT_EQ(cache->size(), initial_size + 1);
+
+  // The cache does not keep the model alive.
+  model.reset();
+
+  EXPECT_TRUE(weak_model.expired());
+  EXPECT_EQ(cache->size(), initial_size);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(model, cache->GetOrCreate(GetTestKey(), create));
+  EXPECT_NE(model, nullptr);
+  EXPECT_EQ(num_creations, 2);
+}
+
+TEST(ModelCacheTest, DoesNotCacheErrors) {
+  ModelCache* cache = ModelCache::GetInstance();
+  const int initial_size = cache->size();
+
+  StatusOr<std::shared_ptr<CachedModel>> result = cache->GetOrCreate(
+      GetTestKey(), []() -> StatusOr<std::shared_ptr<CachedModel>> {
+        return absl::InvalidArgumentError("invalid model");
+      });
+
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(cache->size(), initial_size);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<CachedModel> model,
+      cache->GetOrCreate(GetTestKey(),
+                         []() -> StatusOr<std::shared_ptr<CachedModel>> {
+                           return std::make_shared<CachedModel>();
+                         }));
+  EXPECT_NE(model, nullptr);
+}
+
+TEST(ModelCacheTest, SharesModelAcrossConcurrentCalls) {
+  constexpr int kNumThreads = 8;
+  ModelCache* cache = ModelCache::GetInstance();
+  const std::string key = GetTestKey();
+  std::atomic<int> num_creations{0};
+  absl::Notification start;
+  std::vector<std::shared_ptr<CachedModel>> models(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      start.WaitForNotification();
+      StatusOr<std::shared_ptr<CachedModel>> model = cache->GetOrCreate(
+          key, [&]() -> StatusOr<std::shared_ptr<CachedModel>> {
+            ++num_creations;
+            // Let other threads miss the cache meanwhile.
+            absl::SleepFor(absl::Milliseconds(20));
+            return std::make_shared<CachedModel>();
+          });
+      if (model.ok()) {
+        models[i] = *std::move(model);
+      }
+    });
+  }
+
+  start.Notify();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Models are created without holding the cache lock, so several threads may
+  // create one, but all of them get the first one that was cached.
+  EXPECT_GE(num_creations.load(), 1);
+  for (const std::shared_ptr<CachedModel>& model : models) {
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(model, models[0]);
+  }
+}
+
+TEST(ModelCacheTest, GetContentKeyIsStable) {
+  EXPECT_EQ(ModelCache::GetContentKey("model"),
+            "content:" + VerifiedModelsCache::ComputeDigest("model"));
+  EXPECT_EQ(ModelCache::GetContentKey("model"),
+            ModelCache::GetContentKey(std::string("model")));
+  EXPECT_NE(ModelCache::GetContentKey("model"),
+            ModelCache::GetContentKey("other model"));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
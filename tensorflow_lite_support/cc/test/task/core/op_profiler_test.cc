@@ -0,0 +1,110 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/op_profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using EventType = ::tflite::Profiler::EventType;
+
+TEST(FormatChromeTraceTest, FormatsEventsPerThread) {
+  std::vector<std::vector<OpTraceEvent>> events(2);
+  events[0].push_back({"CONV_2D", /*subgraph_index=*/0, /*node_index=*/1,
+                       /*start_ns=*/1500, /*duration_ns=*/2000});
+  events[1].push_back({"ADD", /*subgraph_index=*/1, /*node_index=*/2,
+                       /*start_ns=*/4000, /*duration_ns=*/250});
+
+  EXPECT_EQ(FormatChromeTrace(events),
+            "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            "{\"name\":\"CONV_2D\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,"
+            "\"tid\":0,\"ts\":1.500,\"dur\":2.000,"
+            "\"args\":{\"subgraph_index\":0,\"node_index\":1}},\n"
+            "{\"name\":\"ADD\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,"
+            "\"tid\":1,\"ts\":4.000,\"dur\":0.250,"
+            "\"args\":{\"subgraph_index\":1,\"node_index\":2}}\n"
+            "]}\n");
+}
+
+TEST(FormatChromeTraceTest, FormatsNoEvents) {
+  EXPECT_EQ(FormatChromeTrace({}),
+            "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n");
+}
+
+TEST(FormatChromeTraceTest, EscapesOpTypes) {
+  std::vector<std::vector<OpTraceEvent>> events(1);
+  events[0].push_back({"my\"op\\\n", 0, 0, 0, 0});
+
+  EXPECT_THAT(FormatChromeTrace(events),
+              HasSubstr("\"name\":\"my\\\"op\\\\\\u000a\""));
+}
+
+TEST(OpProfilerTest, AggregatesOpInvocations) {
+  OpProfiler profiler(/*max_trace_events=*/0);
+
+  for (int i = 0; i < 3; ++i) {
+    uint32_t handle = profiler.BeginEvent(
+        "ADD", EventType::OPERATOR_INVOKE_EVENT, /*event_metadata1=*/4,
+        /*event_metadata2=*/0);
+    profiler.EndEvent(handle);
+  }
+  // Non-op events are ignored.
+  profiler.EndEvent(
+      profiler.BeginEvent("Invoke", EventType::DEFAULT, 0, 0));
+
+  std::vector<OpProfile> profiles = profiler.GetOpProfiles();
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_EQ(profiles[0].op_type, "ADD");
+  EXPECT_EQ(profiles[0].node_index, 4);
+  EXPECT_EQ(profiles[0].invocation_count, 3);
+  EXPECT_FALSE(profiles[0].delegated);
+  EXPECT_TRUE(profiler.GetTraceEvents().empty());
+}
+
+TEST(OpProfilerTest, KeepsMostRecentTraceEvents) {
+  OpProfiler profiler(/*max_trace_events=*/2);
+
+  for (int node_index = 0; node_index < 3; ++node_index) {
+    // The tag only lives for the duration of the event.
+    std::string tag = "OP_" + std::to_string(node_index);
+    profiler.EndEvent(profiler.BeginEvent(
+        tag.c_str(), EventType::OPERATOR_INVOKE_EVENT, node_index, 0));
+  }
+
+  EXPECT_THAT(profiler.GetTraceEvents(),
+              ElementsAre(Field(&OpTraceEvent::op_type, "OP_1"),
+                          Field(&OpTraceEvent::op_type, "OP_2")));
+  profiler.Reset();
+  EXPECT_TRUE(profiler.GetTraceEvents().empty());
+  EXPECT_TRUE(profiler.GetOpProfiles().empty());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,134 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/sidecar_file.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/types/optional.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Optional;
+
+class SidecarFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = JoinPath(::testing::TempDir(),
+                     ::testing::UnitTest::GetInstance()->current_test_info()
+                         ->name());
+    std::remove(path_.c_str());
+  }
+
+  void Append(const std::string& content) {
+    std::ofstream file(path_, std::ios::app);
+    file << content;
+  }
+
+  std::string path_;
+};
+
+TEST_F(SidecarFileTest, LookupSucceedsWithMissingFile) {
+  SidecarFile file(path_, "test");
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> value,
+                               file.Lookup("key"));
+
+  EXPECT_FALSE(value.has_value());
+}
+
+TEST_F(SidecarFileTest, LookupReturnsStoredValues) {
+  SidecarFile file(path_, "test");
+
+  SUPPORT_ASSERT_OK(file.Store("first", "1"));
+  SUPPORT_ASSERT_OK(file.Store("second", "2\twith\ttabs"));
+  SUPPORT_ASSERT_OK(file.Store("empty", ""));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> first,
+                               file.Lookup("first"));
+  EXPECT_THAT(first, Optional(std::string("1")));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> second,
+                               file.Lookup("second"));
+  EXPECT_THAT(second, Optional(std::string("2\twith\ttabs")));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> empty,
+                               file.Lookup("empty"));
+  EXPECT_THAT(empty, Optional(std::string()));
+  // Keys are matched exactly.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> prefix,
+                               file.Lookup("firs"));
+  EXPECT_FALSE(prefix.has_value());
+}
+
+TEST_F(SidecarFileTest, LookupReturnsLastValue) {
+  SidecarFile file(path_, "test");
+
+  SUPPORT_ASSERT_OK(file.Store("key", "old"));
+  SUPPORT_ASSERT_OK(file.Store("other", "value"));
+  SUPPORT_ASSERT_OK(file.Store("key", "new"));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> value,
+                               file.Lookup("key"));
+  EXPECT_THAT(value, Optional(std::string("new")));
+}
+
+TEST_F(SidecarFileTest, LookupIgnoresMalformedLines) {
+  Append("key\n\nkey\tvalue\ngarbage without separator\n\tno key\nkey");
+  SidecarFile file(path_, "test");
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> value,
+                               file.Lookup("key"));
+  EXPECT_THAT(value, Optional(std::string("value")));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(absl::optional<std::string> empty_key,
+                               file.Lookup(""));
+  EXPECT_THAT(empty_key, Optional(std::string("no key")));
+}
+
+TEST_F(SidecarFileTest, StoreFailsWithInvalidRecord) {
+  SidecarFile file(path_, "test");
+
+  EXPECT_EQ(file.Store("a\tb", "value").code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(file.Store("a\nb", "value").code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(file.Store("key", "a\nb").code(),
+            absl::StatusCode::kInvalidArgument);
+  std::ifstream stream(path_);
+  EXPECT_FALSE(stream.is_open());
+}
+
+TEST_F(SidecarFileTest, StoreFailsWithMissingDirectory) {
+  SidecarFile file(JoinPath(path_, "missing", "file.txt"), "test cache");
+
+  absl::Status status = file.Store("key", "value");
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kPermissionDenied);
+  EXPECT_THAT(status.message(), HasSubstr("Unable to open test cache file"));
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,104 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+TEST(TaskExecutorTest, RunsAllClosures) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TaskExecutor> executor,
+                               TaskExecutor::Create(/*num_threads=*/4));
+  EXPECT_EQ(executor->num_threads(), 4);
+  std::atomic<int> num_runs{0};
+
+  for (int i = 0; i < 100; ++i) {
+    SUPPORT_ASSERT_OK(executor->Schedule([&num_runs]() { ++num_runs; }));
+  }
+  executor.reset();
+
+  EXPECT_EQ(num_runs, 100);
+}
+
+TEST(TaskExecutorTest, FailsWithInvalidNumThreads) {
+  auto executor_or = TaskExecutor::Create(/*num_threads=*/0);
+
+  EXPECT_EQ(executor_or.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+TEST(TaskExecutorTest, RunsQueuedClosuresOnShutdown) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TaskExecutor> executor,
+                               TaskExecutor::Create(/*num_threads=*/1));
+  absl::Notification release;
+  std::atomic<int> num_runs{0};
+  // The only worker is blocked, so that the other closures stay queued.
+  SUPPORT_ASSERT_OK(executor->Schedule([&release]() {
+    release.WaitForNotification();
+  }));
+  for (int i = 0; i < 5; ++i) {
+    SUPPORT_ASSERT_OK(executor->Schedule([&num_runs]() { ++num_runs; }));
+  }
+
+  std::thread destroyer([&executor]() { executor.reset(); });
+  // Lets the destructor start shutting down with the closures still queued.
+  absl::SleepFor(absl::Milliseconds(50));
+  EXPECT_EQ(num_runs, 0);
+  release.Notify();
+  destroyer.join();
+
+  EXPECT_EQ(num_runs, 5);
+}
+
+TEST(TaskExecutorTest, FailsToScheduleWhenQueueIsFull) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskExecutor> executor,
+      TaskExecutor::Create(/*num_threads=*/1, /*max_pending_closures=*/1));
+  absl::Notification started;
+  absl::Notification release;
+  std::atomic<int> num_runs{0};
+  SUPPORT_ASSERT_OK(executor->Schedule([&]() {
+    started.Notify();
+    release.WaitForNotification();
+  }));
+  // The running closure no longer counts as pending.
+  started.WaitForNotification();
+  SUPPORT_ASSERT_OK(executor->Schedule([&num_runs]() { ++num_runs; }));
+
+  absl::Status status = executor->Schedule([&num_runs]() { ++num_runs; });
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kResourceExhausted);
+  release.Notify();
+  executor.reset();
+  // The rejected closure was not run.
+  EXPECT_EQ(num_runs, 1);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
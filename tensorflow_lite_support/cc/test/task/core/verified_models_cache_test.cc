@@ -0,0 +1,122 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/core/verified_models_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace core {
+namespace {
+
+class VerifiedModelsCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = JoinPath(::testing::TempDir(),
+                     ::testing::UnitTest::GetInstance()->current_test_info()
+                         ->name());
+    std::remove(path_.c_str());
+  }
+
+  void WriteFile(const std::string& content) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file << content;
+  }
+
+  std::string path_;
+};
+
+TEST_F(VerifiedModelsCacheTest, ComputesKnownDigests) {
+  // SHA-256 test vectors from FIPS 180-2.
+  EXPECT_EQ(VerifiedModelsCache::ComputeDigest(""),
+            "sha256:0:e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b"
+            "7852b855");
+  EXPECT_EQ(VerifiedModelsCache::ComputeDigest("abc"),
+            "sha256:3:ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61"
+            "f20015ad");
+  EXPECT_EQ(VerifiedModelsCache::ComputeDigest(
+                "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+            "sha256:56:248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd"
+            "419db06c1");
+}
+
+TEST_F(VerifiedModelsCacheTest, ContainsSucceedsWithMissingFile) {
+  VerifiedModelsCache cache(path_);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      bool contains,
+      cache.Contains(VerifiedModelsCache::ComputeDigest("model")));
+
+  EXPECT_FALSE(contains);
+}
+
+TEST_F(VerifiedModelsCacheTest, ContainsAddedDigests) {
+  const std::string digest = VerifiedModelsCache::ComputeDigest("model");
+  const std::string other_digest =
+      VerifiedModelsCache::ComputeDigest("other model");
+  VerifiedModelsCache cache(path_);
+
+  SUPPORT_ASSERT_OK(cache.Add(digest));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(bool contains, cache.Contains(digest));
+  EXPECT_TRUE(contains);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(bool contains_other,
+                               cache.Contains(other_digest));
+  EXPECT_FALSE(contains_other);
+  // The file is shared across instances, e.g. across processes.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(bool contains_in_new_instance,
+                               VerifiedModelsCache(path_).Contains(digest));
+  EXPECT_TRUE(contains_in_new_instance);
+}
+
+TEST_F(VerifiedModelsCacheTest, IgnoresCorruptedFile) {
+  const std::string digest = VerifiedModelsCache::ComputeDigest("model");
+  // A bare digest (e.g. from an older format), a truncated record, an
+  // unexpected value and binary garbage.
+  WriteFile(digest + "\n" + digest.substr(0, digest.size() / 2) +
+            "\tverified\n" + digest + "\tunverified\n" +
+            std::string("\0\xff\t\n", 4));
+  VerifiedModelsCache cache(path_);
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(bool contains, cache.Contains(digest));
+  EXPECT_FALSE(contains);
+
+  // Models are verified again and recorded after the corrupted lines.
+  SUPPORT_ASSERT_OK(cache.Add(digest));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(bool contains_after_add,
+                               cache.Contains(digest));
+  EXPECT_TRUE(contains_after_add);
+}
+
+TEST_F(VerifiedModelsCacheTest, AddFailsWithUnwritableFile) {
+  VerifiedModelsCache cache(JoinPath(path_, "missing", "cache.txt"));
+
+  EXPECT_EQ(cache.Add(VerifiedModelsCache::ComputeDigest("model")).code(),
+            absl::StatusCode::kPermissionDenied);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace task
+}  // namespace tflite
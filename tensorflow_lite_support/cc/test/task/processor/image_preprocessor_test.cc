@@ -15,16 +15,29 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/task/processor/image_preprocessor.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"  // from @com_google_absl
 #include "tensorflow/lite/test_util.h"
 #include "tensorflow_lite_support/cc/port/gmock.h"
 #include "tensorflow_lite_support/cc/port/gtest.h"
 #include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
 #include "tensorflow_lite_support/cc/task/core/task_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/fused_preprocessing.h"
 #include "tensorflow_lite_support/cc/task/vision/utils/image_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
 #include "tensorflow_lite_support/cc/test/test_utils.h"
 
 namespace tflite {
@@ -34,10 +47,15 @@ namespace {
 
 using ::tflite::support::StatusOr;
 using ::tflite::task::JoinPath;
+using ::tflite::task::core::TaskExecutor;
 using ::tflite::task::core::TfLiteEngine;
+using ::tflite::task::vision::BoundingBox;
 using ::tflite::task::vision::DecodeImageFromFile;
 using ::tflite::task::vision::FrameBuffer;
+using ::tflite::task::vision::FrameBufferUtils;
+using ::tflite::task::vision::FusedPreprocess;
 using ::tflite::task::vision::ImageData;
+using ::tflite::task::vision::ScratchBufferPool;
 
 constexpr char kTestDataDirectory[] =
     "/tensorflow_lite_support/cc/test/testdata/task/"
@@ -45,6 +63,16 @@ constexpr char kTestDataDirectory[] =
 
 constexpr char kDilatedConvolutionModelWithMetaData[] = "dilated_conv.tflite";
 
+constexpr char kMobileNetFloatWithMetadata[] =
+    "mobilenet_v1_0.25_224_1_default_1.tflite";
+
+// Models without metadata dequantizing an int8 input of shape [1, 8, 8, 3]
+// with the quantization parameters given in their name.
+constexpr char kInt8InputWithUnitScale[] =
+    "int8_input_scale1_zero_point_minus128.tflite";
+constexpr char kInt8InputWithScale2[] =
+    "int8_input_scale2_zero_point_minus100.tflite";
+
 StatusOr<ImageData> LoadImage(std::string image_name) {
   return DecodeImageFromFile(JoinPath("./" /*test src dir*/,
                                       kTestDataDirectory, image_name));
@@ -109,6 +137,391 @@ TEST_F(DynamicInputTest, GoldenImageComparison) {
   ImageDataFree(&image);
 }
 
+class FusedPreprocessingTest : public tflite::testing::Test {
+ protected:
+  // Preprocesses the `roi` of the test image with the dynamic input model and
+  // copies the content of the input tensor to `input_data`.
+  void PreprocessImage(bool fused_preprocessing, const BoundingBox& roi,
+                       std::vector<float>* input_data) {
+    TfLiteEngine engine;
+    SUPPORT_ASSERT_OK(engine.BuildModelFromFile(
+        JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                 kDilatedConvolutionModelWithMetaData)));
+    SUPPORT_ASSERT_OK(engine.InitInterpreter());
+
+    SUPPORT_ASSERT_OK_AND_ASSIGN(auto preprocessor,
+                                 ImagePreprocessor::Create(&engine, {0}));
+    preprocessor->SetFusedPreprocessing(fused_preprocessing);
+
+    SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+    std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+        image.pixel_data, FrameBuffer::Dimension{image.width, image.height});
+    absl::Status status = preprocessor->Preprocess(*frame_buffer, roi);
+    ImageDataFree(&image);
+    SUPPORT_ASSERT_OK(status);
+
+    const TfLiteTensor* input_tensor = engine.GetInputs()[0];
+    input_data->assign(
+        input_tensor->data.f,
+        input_tensor->data.f + input_tensor->bytes / sizeof(float));
+  }
+};
+
+// With a dynamic input model, cropping doesn't involve any resizing, so both
+// preprocessing paths are expected to produce the same result.
+TEST_F(FusedPreprocessingTest, MatchesDefaultPreprocessingWhenCropping) {
+  BoundingBox roi;
+  roi.set_origin_x(10);
+  roi.set_origin_y(20);
+  roi.set_width(100);
+  roi.set_height(50);
+
+  std::vector<float> expected;
+  PreprocessImage(/*fused_preprocessing=*/false, roi, &expected);
+  std::vector<float> actual;
+  PreprocessImage(/*fused_preprocessing=*/true, roi, &actual);
+
+  ASSERT_EQ(actual.size(),
+            static_cast<size_t>(roi.width() * roi.height() * 3));
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], std::numeric_limits<float>::epsilon());
+  }
+}
+
+class FusedPreprocessTest : public tflite::testing::Test {
+ protected:
+  // Largest expected difference, in pixel values, between `FusedPreprocess`
+  // and `FrameBufferUtils::Preprocess`, which rounds each intermediate result
+  // to 8 bits and converts YUV to RGB in fixed point.
+  static constexpr float kMaxPixelDifference = 4.0f;
+
+  // Normalization parameters, different for each channel.
+  static constexpr std::array<float, 3> kMeanValues = {127.5f, 100.0f, 50.0f};
+  static constexpr std::array<float, 3> kStdValues = {127.5f, 64.0f, 32.0f};
+
+  // Returns the crop region of the source image used by all tests.
+  static BoundingBox CreateRoi() {
+    BoundingBox roi;
+    roi.set_origin_x(8);
+    roi.set_origin_y(4);
+    roi.set_width(80);
+    roi.set_height(56);
+    return roi;
+  }
+
+  // Checks that `FusedPreprocess` matches `FrameBufferUtils::Preprocess`
+  // followed by normalization, on the `CreateRoi()` region of a synthetic
+  // image in the given `format` and `orientation`, for `output_dimension`.
+  //
+  // The image is a smooth gradient, so that the slight differences in sample
+  // positions between both implementations stay within the tolerance, while
+  // each channel varies along a different direction, so that any misplaced
+  // output pixel shows.
+  void ExpectFusedMatchesPreprocess(FrameBuffer::Format format,
+                                    FrameBuffer::Orientation orientation,
+                                    FrameBuffer::Dimension output_dimension) {
+    const FrameBuffer::Dimension dimension = {96, 64};
+    std::vector<uint8_t> rgb_data(
+        GetFrameBufferByteSize(dimension, FrameBuffer::Format::kRGB));
+    for (int y = 0; y < dimension.height; ++y) {
+      for (int x = 0; x < dimension.width; ++x) {
+        uint8_t* pixel = &rgb_data[(y * dimension.width + x) * 3];
+        pixel[0] = 40 + x;
+        pixel[1] = 40 + 2 * y;
+        pixel[2] = 200 - x - y;
+      }
+    }
+    std::unique_ptr<FrameBuffer> frame_buffer =
+        CreateFromRgbRawBuffer(rgb_data.data(), dimension, orientation);
+    std::vector<uint8_t> converted_data;
+    if (format != FrameBuffer::Format::kRGB) {
+      converted_data.resize(GetFrameBufferByteSize(dimension, format));
+      SUPPORT_ASSERT_OK_AND_ASSIGN(
+          std::unique_ptr<FrameBuffer> converted_frame_buffer,
+          CreateFromRawBuffer(converted_data.data(), dimension, format,
+                              orientation));
+      SUPPORT_ASSERT_OK(
+          FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv)
+              ->Convert(*frame_buffer, converted_frame_buffer.get()));
+      frame_buffer = std::move(converted_frame_buffer);
+    }
+    const BoundingBox roi = CreateRoi();
+
+    std::vector<uint8_t> expected_rgb_data(
+        GetFrameBufferByteSize(output_dimension, FrameBuffer::Format::kRGB));
+    std::unique_ptr<FrameBuffer> expected_frame_buffer =
+        CreateFromRgbRawBuffer(expected_rgb_data.data(), output_dimension);
+    SUPPORT_ASSERT_OK(
+        FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv)
+            ->Preprocess(*frame_buffer, roi, expected_frame_buffer.get()));
+    std::vector<float> actual(expected_rgb_data.size());
+    SUPPORT_ASSERT_OK(FusedPreprocess(*frame_buffer, roi, output_dimension,
+                                      kMeanValues, kStdValues, actual.data()));
+
+    for (size_t i = 0; i < actual.size(); ++i) {
+      const int c = i % 3;
+      const float expected =
+          (expected_rgb_data[i] - kMeanValues[c]) / kStdValues[c];
+      ASSERT_NEAR(actual[i], expected, kMaxPixelDifference / kStdValues[c])
+          << "at pixel " << i / 3 << ", channel " << c;
+    }
+  }
+
+  static constexpr FrameBuffer::Format kFormats[] = {
+      FrameBuffer::Format::kRGB, FrameBuffer::Format::kNV21,
+      FrameBuffer::Format::kYV12};
+  static constexpr FrameBuffer::Orientation kOrientations[] = {
+      FrameBuffer::Orientation::kTopLeft,
+      FrameBuffer::Orientation::kTopRight,
+      FrameBuffer::Orientation::kBottomRight,
+      FrameBuffer::Orientation::kBottomLeft,
+      FrameBuffer::Orientation::kLeftTop,
+      FrameBuffer::Orientation::kRightTop,
+      FrameBuffer::Orientation::kRightBottom,
+      FrameBuffer::Orientation::kLeftBottom};
+};
+
+TEST_F(FusedPreprocessTest, MatchesPreprocessWhenDownscaling) {
+  for (FrameBuffer::Format format : kFormats) {
+    for (FrameBuffer::Orientation orientation : kOrientations) {
+      SCOPED_TRACE(::testing::Message()
+                   << "format: " << static_cast<int>(format)
+                   << ", orientation: " << static_cast<int>(orientation));
+      ExpectFusedMatchesPreprocess(format, orientation, {40, 30});
+    }
+  }
+}
+
+TEST_F(FusedPreprocessTest, MatchesPreprocessWhenUpscaling) {
+  for (FrameBuffer::Format format : kFormats) {
+    for (FrameBuffer::Orientation orientation : kOrientations) {
+      SCOPED_TRACE(::testing::Message()
+                   << "format: " << static_cast<int>(format)
+                   << ", orientation: " << static_cast<int>(orientation));
+      ExpectFusedMatchesPreprocess(format, orientation, {150, 100});
+    }
+  }
+}
+
+class Int8InputTest : public tflite::testing::Test {
+ protected:
+  // Preprocesses a frame of the size of the input of `model_name`, so that
+  // pixel values are only requantized, and copies them to `pixel_values` and
+  // the content of the input tensor to `input_data`.
+  void PreprocessFrame(const std::string& model_name,
+                       std::vector<uint8_t>* pixel_values,
+                       std::vector<int8_t>* input_data) {
+    TfLiteEngine engine;
+    SUPPORT_ASSERT_OK(engine.BuildModelFromFile(
+        JoinPath("./" /*test src dir*/, kTestDataDirectory, model_name)));
+    SUPPORT_ASSERT_OK(engine.InitInterpreter());
+    SUPPORT_ASSERT_OK_AND_ASSIGN(auto preprocessor,
+                                 ImagePreprocessor::Create(&engine, {0}));
+
+    const FrameBuffer::Dimension dimension = {8, 8};
+    pixel_values->resize(
+        GetFrameBufferByteSize(dimension, FrameBuffer::Format::kRGB));
+    for (size_t i = 0; i < pixel_values->size(); ++i) {
+      (*pixel_values)[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    SUPPORT_ASSERT_OK(preprocessor->Preprocess(
+        *CreateFromRgbRawBuffer(pixel_values->data(), dimension)));
+
+    const TfLiteTensor* input_tensor = engine.GetInputs()[0];
+    ASSERT_EQ(input_tensor->type, kTfLiteInt8);
+    input_data->assign(input_tensor->data.int8,
+                       input_tensor->data.int8 + input_tensor->bytes);
+  }
+};
+
+// Pixel values are offset by 128 without going through the lookup table.
+TEST_F(Int8InputTest, SucceedsWithUnitScale) {
+  std::vector<uint8_t> pixel_values;
+  std::vector<int8_t> input_data;
+  ASSERT_NO_FATAL_FAILURE(
+      PreprocessFrame(kInt8InputWithUnitScale, &pixel_values, &input_data));
+
+  ASSERT_EQ(input_data.size(), pixel_values.size());
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    EXPECT_EQ(input_data[i], pixel_values[i] - 128) << "at index " << i;
+  }
+}
+
+TEST_F(Int8InputTest, SucceedsWithScale) {
+  std::vector<uint8_t> pixel_values;
+  std::vector<int8_t> input_data;
+  ASSERT_NO_FATAL_FAILURE(
+      PreprocessFrame(kInt8InputWithScale2, &pixel_values, &input_data));
+
+  ASSERT_EQ(input_data.size(), pixel_values.size());
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    const int expected =
+        static_cast<int>(std::round(pixel_values[i] / 2.0f)) - 100;
+    EXPECT_EQ(input_data[i], std::min(std::max(expected, -128), 127))
+        << "at index " << i;
+  }
+}
+
+class ScratchBufferPoolTest : public tflite::testing::Test {};
+
+// Frames of a constant size are expected to only allocate intermediate buffers
+// for the first one.
+TEST_F(ScratchBufferPoolTest, ReusesBuffersAcrossFrames) {
+  TfLiteEngine engine;
+  SUPPORT_ASSERT_OK(engine.BuildModelFromFile(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kMobileNetFloatWithMetadata)));
+  SUPPORT_ASSERT_OK(engine.InitInterpreter());
+
+  auto scratch_buffer_pool = std::make_shared<ScratchBufferPool>();
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      auto preprocessor,
+      ImagePreprocessor::Create(
+          &engine, {0}, vision::FrameBufferUtils::ProcessEngine::kLibyuv,
+          scratch_buffer_pool));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      image.pixel_data, FrameBuffer::Dimension{image.width, image.height},
+      FrameBuffer::Orientation::kRightTop);
+
+  absl::Status first_status = preprocessor->Preprocess(*frame_buffer);
+  const ScratchBufferPool::Stats first_stats = scratch_buffer_pool->GetStats();
+  absl::Status second_status = preprocessor->Preprocess(*frame_buffer);
+  const ScratchBufferPool::Stats second_stats = scratch_buffer_pool->GetStats();
+  ImageDataFree(&image);
+
+  SUPPORT_ASSERT_OK(first_status);
+  SUPPORT_ASSERT_OK(second_status);
+  EXPECT_GT(first_stats.num_allocations, 0);
+  EXPECT_GT(second_stats.num_acquisitions, first_stats.num_acquisitions);
+  EXPECT_EQ(second_stats.num_allocations, first_stats.num_allocations);
+  EXPECT_EQ(second_stats.allocated_bytes, first_stats.allocated_bytes);
+}
+
+class ProcessEngineTest : public tflite::testing::Test {
+ protected:
+  // Largest expected difference between the pixel values produced by the
+  // kSimd and kLibyuv engines, which differ in fixed point rounding.
+  static constexpr float kMaxPixelDifference = 3.0f;
+
+  // Preprocesses the test image in the given `format` with both process
+  // engines, and copies the content of the input tensor of the float model to
+  // `libyuv_input_data` and `simd_input_data` respectively.
+  void PreprocessImage(FrameBuffer::Format format,
+                       FrameBuffer::Orientation orientation,
+                       std::vector<float>* libyuv_input_data,
+                       std::vector<float>* simd_input_data) {
+    TfLiteEngine engine;
+    SUPPORT_ASSERT_OK(engine.BuildModelFromFile(
+        JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                 kMobileNetFloatWithMetadata)));
+    SUPPORT_ASSERT_OK(engine.InitInterpreter());
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        auto preprocessor,
+        ImagePreprocessor::Create(&engine, {0},
+                                  FrameBufferUtils::ProcessEngine::kLibyuv));
+
+    SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+    const FrameBuffer::Dimension dimension = {image.width, image.height};
+    std::vector<uint8_t> rgb_data(
+        image.pixel_data,
+        image.pixel_data +
+            GetFrameBufferByteSize(dimension, FrameBuffer::Format::kRGB));
+    ImageDataFree(&image);
+
+    std::unique_ptr<FrameBuffer> frame_buffer =
+        CreateFromRgbRawBuffer(rgb_data.data(), dimension, orientation);
+    std::vector<uint8_t> converted_data;
+    if (format != FrameBuffer::Format::kRGB) {
+      converted_data.resize(GetFrameBufferByteSize(dimension, format));
+      SUPPORT_ASSERT_OK_AND_ASSIGN(
+          std::unique_ptr<FrameBuffer> converted_frame_buffer,
+          CreateFromRawBuffer(converted_data.data(), dimension, format,
+                              orientation));
+      SUPPORT_ASSERT_OK(
+          FrameBufferUtils::Create(FrameBufferUtils::ProcessEngine::kLibyuv)
+              ->Convert(*frame_buffer, converted_frame_buffer.get()));
+      frame_buffer = std::move(converted_frame_buffer);
+    }
+
+    const TfLiteTensor* input_tensor = engine.GetInputs()[0];
+    const float* input_data = input_tensor->data.f;
+    const size_t input_size = input_tensor->bytes / sizeof(float);
+    SUPPORT_ASSERT_OK(preprocessor->Preprocess(*frame_buffer));
+    libyuv_input_data->assign(input_data, input_data + input_size);
+    preprocessor->SetProcessEngine(FrameBufferUtils::ProcessEngine::kSimd);
+    SUPPORT_ASSERT_OK(preprocessor->Preprocess(*frame_buffer));
+    simd_input_data->assign(input_data, input_data + input_size);
+  }
+
+  // Checks that both preprocessed inputs are close, given that the model
+  // normalizes pixel values to [-1, 1].
+  void ExpectNear(const std::vector<float>& libyuv_input_data,
+                  const std::vector<float>& simd_input_data) {
+    ASSERT_EQ(simd_input_data.size(), libyuv_input_data.size());
+    for (size_t i = 0; i < simd_input_data.size(); ++i) {
+      EXPECT_NEAR(simd_input_data[i], libyuv_input_data[i],
+                  kMaxPixelDifference / 127.5f);
+    }
+  }
+};
+
+// kRGB frames are resized without going through kRGBA.
+TEST_F(ProcessEngineTest, SimdMatchesLibyuvForRgb) {
+  std::vector<float> libyuv_input_data;
+  std::vector<float> simd_input_data;
+  ASSERT_NO_FATAL_FAILURE(PreprocessImage(FrameBuffer::Format::kRGB,
+                                          FrameBuffer::Orientation::kTopLeft,
+                                          &libyuv_input_data,
+                                          &simd_input_data));
+
+  ExpectNear(libyuv_input_data, simd_input_data);
+}
+
+// Rotated kNV21 frames, as provided by cameras, are converted to kRGB after
+// being resized and rotated.
+TEST_F(ProcessEngineTest, SimdMatchesLibyuvForNv21) {
+  std::vector<float> libyuv_input_data;
+  std::vector<float> simd_input_data;
+  ASSERT_NO_FATAL_FAILURE(PreprocessImage(FrameBuffer::Format::kNV21,
+                                          FrameBuffer::Orientation::kRightTop,
+                                          &libyuv_input_data,
+                                          &simd_input_data));
+
+  ExpectNear(libyuv_input_data, simd_input_data);
+}
+
+TEST_F(ProcessEngineTest, SucceedsWithExecutor) {
+  TfLiteEngine engine;
+  SUPPORT_ASSERT_OK(engine.BuildModelFromFile(JoinPath(
+      "./" /*test src dir*/, kTestDataDirectory, kMobileNetFloatWithMetadata)));
+  SUPPORT_ASSERT_OK(engine.InitInterpreter());
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      auto preprocessor,
+      ImagePreprocessor::Create(&engine, {0},
+                                FrameBufferUtils::ProcessEngine::kSimd));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(ImageData image, LoadImage("burger.jpg"));
+  std::unique_ptr<FrameBuffer> frame_buffer = CreateFromRgbRawBuffer(
+      image.pixel_data, FrameBuffer::Dimension{image.width, image.height});
+  const TfLiteTensor* input_tensor = engine.GetInputs()[0];
+  const float* input_data = input_tensor->data.f;
+  const size_t input_size = input_tensor->bytes / sizeof(float);
+
+  SUPPORT_ASSERT_OK(preprocessor->Preprocess(*frame_buffer));
+  const std::vector<float> serial_input_data(input_data,
+                                             input_data + input_size);
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::shared_ptr<TaskExecutor> executor,
+                               TaskExecutor::Create(/*num_threads=*/2));
+  preprocessor->SetExecutor(executor);
+  SUPPORT_ASSERT_OK(preprocessor->Preprocess(*frame_buffer));
+  ImageDataFree(&image);
+
+  // Resizing bands of rows in parallel yields the same input.
+  EXPECT_EQ(std::vector<float>(input_data, input_data + input_size),
+            serial_input_data);
+}
+
 }  // namespace
 }  // namespace processor
 }  // namespace task
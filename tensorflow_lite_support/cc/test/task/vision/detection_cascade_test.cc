@@ -0,0 +1,258 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/detection_cascade.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "tensorflow/lite/test_util.h"
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/object_detector.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/bounding_box_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/classifications_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/detections_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/object_detector_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_utils.h"
+#include "tensorflow_lite_support/cc/test/test_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::JoinPath;
+using ::tflite::task::ParseTextProtoOrDie;
+
+constexpr char kTestDataDirectory[] =
+    "/tensorflow_lite_support/cc/test/testdata/task/"
+    "vision/";
+constexpr char kMobileSsdWithMetadata[] =
+    "coco_ssd_mobilenet_v1_1.0_quant_2018_06_29.tflite";
+constexpr char kMobileNetFloatWithMetadata[] = "mobilenet_v2_1.0_224.tflite";
+
+StatusOr<ImageData> LoadImage(std::string image_name) {
+  return DecodeImageFromFile(JoinPath("./" /*test src dir*/,
+                                      kTestDataDirectory, image_name));
+}
+
+class DetectionCascadeTest : public tflite::testing::Test {
+ protected:
+  void SetUp() override {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(rgb_image_, LoadImage("cats_and_dogs.jpg"));
+    frame_buffer_ = CreateFromRgbRawBuffer(
+        rgb_image_.pixel_data,
+        FrameBuffer::Dimension{rgb_image_.width, rgb_image_.height});
+
+    ObjectDetectorOptions detector_options;
+    detector_options.set_max_results(4);
+    detector_options.mutable_model_file_with_metadata()->set_file_name(
+        JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                 kMobileSsdWithMetadata));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        object_detector_, ObjectDetector::CreateFromOptions(detector_options));
+
+    ImageClassifierOptions classifier_options;
+    classifier_options.set_max_results(3);
+    classifier_options.mutable_model_file_with_metadata()->set_file_name(
+        JoinPath("./" /*test src dir*/, kTestDataDirectory,
+                 kMobileNetFloatWithMetadata));
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        image_classifier_,
+        ImageClassifier::CreateFromOptions(classifier_options));
+  }
+
+  void TearDown() override { ImageDataFree(&rgb_image_); }
+
+  // Checks that `result` matches the classification of its region of interest
+  // through a separate `Classify` call.
+  void ExpectSameAsClassify(const ClassifiedDetection& result) {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(
+        ClassificationResult expected,
+        image_classifier_->Classify(*frame_buffer_, result.roi));
+    const Classifications& actual_head =
+        result.classification_result.classifications(0);
+    const Classifications& expected_head = expected.classifications(0);
+    ASSERT_EQ(actual_head.classes_size(), expected_head.classes_size());
+    for (int i = 0; i < actual_head.classes_size(); ++i) {
+      EXPECT_EQ(actual_head.classes(i).index(),
+                expected_head.classes(i).index());
+      EXPECT_NEAR(actual_head.classes(i).score(),
+                  expected_head.classes(i).score(), 1e-4);
+    }
+  }
+
+  ImageData rgb_image_ = {};
+  std::unique_ptr<FrameBuffer> frame_buffer_;
+  std::unique_ptr<ObjectDetector> object_detector_;
+  std::unique_ptr<ImageClassifier> image_classifier_;
+};
+
+TEST_F(DetectionCascadeTest, SucceedsWithBatchedClassification) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionCascade> cascade,
+      DetectionCascade::Create(object_detector_.get(),
+                               image_classifier_.get()));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<ClassifiedDetection> results,
+                               cascade->Run(*frame_buffer_));
+
+  ASSERT_EQ(results.size(), 4);
+  for (int i = 0; i < results.size(); ++i) {
+    if (i > 0) {
+      EXPECT_GE(results[i - 1].detection.classes(0).score(),
+                results[i].detection.classes(0).score());
+    }
+    ExpectSameAsClassify(results[i]);
+  }
+}
+
+TEST_F(DetectionCascadeTest, SucceedsWithMultipleBatches) {
+  DetectionCascadeOptions options;
+  // The 4 detections are classified in a batch of 3 crops, then a batch of 1.
+  options.max_batch_size = 3;
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionCascade> cascade,
+      DetectionCascade::Create(object_detector_.get(), image_classifier_.get(),
+                               options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<ClassifiedDetection> results,
+                               cascade->Run(*frame_buffer_));
+
+  ASSERT_EQ(results.size(), 4);
+  for (const ClassifiedDetection& result : results) {
+    ExpectSameAsClassify(result);
+  }
+}
+
+TEST_F(DetectionCascadeTest, SucceedsWithMoreCropsThanModelBatchSize) {
+  DetectionCascadeOptions options;
+  // The classifier model has a batch size of 1, so classifying the 4 crops in
+  // two batches of 2 requires resizing its input tensor, and reusing the
+  // resized tensor for the second batch.
+  options.max_batch_size = 2;
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionCascade> cascade,
+      DetectionCascade::Create(object_detector_.get(), image_classifier_.get(),
+                               options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<ClassifiedDetection> results,
+                               cascade->Run(*frame_buffer_));
+  ASSERT_EQ(results.size(), 4);
+  // Running the cascade again, with the classifier in its batched state, must
+  // yield the same results.
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<ClassifiedDetection> rerun_results,
+                               cascade->Run(*frame_buffer_));
+  ASSERT_EQ(rerun_results.size(), results.size());
+
+  for (int i = 0; i < results.size(); ++i) {
+    // Single-crop classifications, interleaved with the batched ones, use the
+    // unbatched input shape.
+    ExpectSameAsClassify(results[i]);
+    const Classifications& head =
+        results[i].classification_result.classifications(0);
+    const Classifications& rerun_head =
+        rerun_results[i].classification_result.classifications(0);
+    ASSERT_EQ(head.classes_size(), rerun_head.classes_size());
+    for (int j = 0; j < head.classes_size(); ++j) {
+      EXPECT_EQ(head.classes(j).index(), rerun_head.classes(j).index());
+      EXPECT_NEAR(head.classes(j).score(), rerun_head.classes(j).score(),
+                  1e-4);
+    }
+  }
+}
+
+TEST_F(DetectionCascadeTest, SucceedsWithOptions) {
+  DetectionCascadeOptions options;
+  options.min_detection_score = 0.55;
+  options.max_detections = 2;
+  options.box_margin = 0.1;
+  options.max_batch_size = 1;
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionCascade> cascade,
+      DetectionCascade::Create(object_detector_.get(), image_classifier_.get(),
+                               options));
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::vector<ClassifiedDetection> results,
+                               cascade->Run(*frame_buffer_));
+
+  ASSERT_EQ(results.size(), 2);
+  for (const ClassifiedDetection& result : results) {
+    EXPECT_GE(result.detection.classes(0).score(), 0.55);
+    // The margin enlarges the region of interest.
+    EXPECT_GT(result.roi.width(), result.detection.bounding_box().width());
+    ExpectSameAsClassify(result);
+  }
+}
+
+TEST_F(DetectionCascadeTest, ClassifyDetectionsClampsBoxes) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DetectionCascade> cascade,
+      DetectionCascade::Create(/*object_detector=*/nullptr,
+                               image_classifier_.get()));
+  DetectionResult detection_result = ParseTextProtoOrDie<DetectionResult>(
+      R"pb(detections {
+             bounding_box { origin_x: -20 origin_y: -10 width: 200 height: 150 }
+             classes { index: 16 score: 0.9 }
+           }
+           detections {
+             # Entirely outside of the frame.
+             bounding_box { origin_x: 5000 origin_y: 0 width: 10 height: 10 }
+             classes { index: 17 score: 0.8 }
+           }
+      )pb");
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      std::vector<ClassifiedDetection> results,
+      cascade->ClassifyDetections(*frame_buffer_, detection_result));
+
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].roi.origin_x(), 0);
+  EXPECT_EQ(results[0].roi.origin_y(), 0);
+  EXPECT_EQ(results[0].roi.width(), 180);
+  EXPECT_EQ(results[0].roi.height(), 140);
+  ExpectSameAsClassify(results[0]);
+  // Running the full cascade requires a detector.
+  EXPECT_EQ(cascade->Run(*frame_buffer_).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(DetectionCascadeTest, FailsWithInvalidOptions) {
+  EXPECT_EQ(DetectionCascade::Create(object_detector_.get(), nullptr)
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+  DetectionCascadeOptions options;
+  options.max_batch_size = -1;
+  EXPECT_EQ(DetectionCascade::Create(object_detector_.get(),
+                                     image_classifier_.get(), options)
+                .status()
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
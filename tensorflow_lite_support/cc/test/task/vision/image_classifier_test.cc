@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"  // from @com_google_absl
 #include "absl/status/status.h"  // from @com_google_absl
@@ -54,6 +56,7 @@ using ::tflite::support::StatusOr;
 using ::tflite::support::TfLiteSupportStatus;
 using ::tflite::task::JoinPath;
 using ::tflite::task::ParseTextProtoOrDie;
+using ::tflite::task::core::MemoryStats;
 using ::tflite::task::core::PopulateTensor;
 using ::tflite::task::core::TaskAPIFactory;
 using ::tflite::task::core::TfLiteEngine;
@@ -547,6 +550,22 @@ TEST(ClassifyTest, GetOutputShapeSucceeds) {
   EXPECT_THAT(shape_vector, ElementsAreArray({1, 1001}));
 }
 
+TEST(ClassifyTest, GetMemoryStatsIncludesLabelMaps) {
+  ImageClassifierOptions options;
+  options.mutable_base_options()->mutable_model_file()->set_file_name(
+      JoinPath("./" /*test src dir*/, kTestDataDirectory,
+               kMobileNetFloatWithMetadata));
+  SUPPORT_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                               ImageClassifier::CreateFromOptions(options));
+
+  MemoryStats stats = image_classifier->GetMemoryStats();
+
+  // 1001 labels.
+  EXPECT_GT(stats.task_bytes["label_maps"],
+            static_cast<int64_t>(1001 * sizeof(std::string)));
+  EXPECT_THAT(stats.ToString(), HasSubstr("label_maps"));
+}
+
 class PostprocessTest : public tflite::testing::Test {
  public:
   class TestImageClassifier : public ImageClassifier {
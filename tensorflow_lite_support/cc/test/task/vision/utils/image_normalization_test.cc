@@ -0,0 +1,137 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/image_normalization.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+// Covers empty inputs, inputs shorter than a block of the vectorized kernels
+// and inputs with leftover values after one or more blocks.
+constexpr size_t kMaxSize = 97;
+
+constexpr std::array<float, 3> kMeanValues = {127.5f, 100.0f, 10.0f};
+constexpr std::array<float, 3> kStdValues = {127.5f, 3.0f, 0.5f};
+
+// Returns `size` pixel values covering the whole 8-bit range.
+std::vector<uint8_t> CreateInput(size_t size) {
+  std::vector<uint8_t> input(size);
+  for (size_t i = 0; i < size; ++i) {
+    input[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+  return input;
+}
+
+void ExpectNormalizedAsScalarFormula(int num_channels) {
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    SCOPED_TRACE(size);
+    const std::vector<uint8_t> input = CreateInput(size);
+    // One extra value checks that nothing is written past `size`.
+    std::vector<float> output(size + 1, -1.0f);
+    NormalizeToFloat(input.data(), size, num_channels, kMeanValues,
+                     kStdValues, output.data());
+    for (size_t i = 0; i < size; ++i) {
+      const int c = i % num_channels;
+      EXPECT_FLOAT_EQ(output[i], (input[i] - kMeanValues[c]) / kStdValues[c])
+          << "at index " << i;
+    }
+    EXPECT_EQ(output[size], -1.0f);
+  }
+}
+
+TEST(NormalizeToFloatTest, MatchesScalarFormulaWithOneChannel) {
+  ExpectNormalizedAsScalarFormula(/*num_channels=*/1);
+}
+
+TEST(NormalizeToFloatTest, MatchesScalarFormulaWithThreeChannels) {
+  ExpectNormalizedAsScalarFormula(/*num_channels=*/3);
+}
+
+TEST(BuildInt8QuantizationTableTest, DetectsOffsetBy128) {
+  const Int8QuantizationTable table = BuildInt8QuantizationTable(
+      /*mean_values=*/{0.0f, 0.0f, 0.0f}, /*std_values=*/{1.0f, 1.0f, 1.0f},
+      /*num_values=*/1, /*scale=*/1.0f, /*zero_point=*/-128);
+
+  EXPECT_TRUE(table.is_offset_by_128);
+}
+
+TEST(BuildInt8QuantizationTableTest, MatchesScalarFormula) {
+  const float scale = 0.5f;
+  const int32_t zero_point = 3;
+  const Int8QuantizationTable table = BuildInt8QuantizationTable(
+      kMeanValues, kStdValues, /*num_values=*/3, scale, zero_point);
+
+  EXPECT_FALSE(table.is_offset_by_128);
+  for (int c = 0; c < 3; ++c) {
+    for (int p = 0; p < 256; ++p) {
+      const float quantized =
+          std::round((p - kMeanValues[c]) / kStdValues[c] / scale) +
+          zero_point;
+      EXPECT_EQ(table.values[c][p],
+                std::min(std::max(quantized, -128.0f), 127.0f))
+          << "for channel " << c << " and pixel value " << p;
+    }
+  }
+}
+
+// Checks `QuantizeToInt8` with `table` against a lookup of each value in the
+// table of its channel.
+void ExpectQuantizedAsTableLookup(const Int8QuantizationTable& table) {
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    SCOPED_TRACE(size);
+    const std::vector<uint8_t> input = CreateInput(size);
+    // One extra value checks that nothing is written past `size`.
+    std::vector<int8_t> output(size + 1, 42);
+    QuantizeToInt8(input.data(), size, table, output.data());
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(output[i], table.values[i % 3][input[i]]) << "at index " << i;
+    }
+    EXPECT_EQ(output[size], 42);
+  }
+}
+
+TEST(QuantizeToInt8Test, MatchesTableWhenOffsetBy128) {
+  const Int8QuantizationTable table = BuildInt8QuantizationTable(
+      /*mean_values=*/{0.0f, 0.0f, 0.0f}, /*std_values=*/{1.0f, 1.0f, 1.0f},
+      /*num_values=*/1, /*scale=*/1.0f, /*zero_point=*/-128);
+  ASSERT_TRUE(table.is_offset_by_128);
+
+  ExpectQuantizedAsTableLookup(table);
+}
+
+TEST(QuantizeToInt8Test, MatchesTableWhenNotOffsetBy128) {
+  const Int8QuantizationTable table = BuildInt8QuantizationTable(
+      kMeanValues, kStdValues, /*num_values=*/3, /*scale=*/0.5f,
+      /*zero_point=*/3);
+  ASSERT_FALSE(table.is_offset_by_128);
+
+  ExpectQuantizedAsTableLookup(table);
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
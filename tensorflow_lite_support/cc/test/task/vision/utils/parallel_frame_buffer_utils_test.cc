@@ -0,0 +1,266 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/synchronization/notification.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/task_executor_band_executor.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+using ::tflite::task::core::TaskExecutor;
+
+// Both dimensions are larger than two bands of rows, so that operations get
+// split whichever axis they are split along. Odd dimensions exercise the
+// handling of the chroma planes of YUV formats.
+const FrameBuffer::Dimension kEvenDimension = {258, 194};
+const FrameBuffer::Dimension kOddDimension = {257, 193};
+
+constexpr FrameBuffer::Format kYuvFormats[] = {FrameBuffer::Format::kNV12,
+                                               FrameBuffer::Format::kNV21,
+                                               FrameBuffer::Format::kYV12};
+
+// Frame buffer over the data it owns.
+struct Image {
+  std::vector<uint8_t> data;
+  std::unique_ptr<FrameBuffer> buffer;
+};
+
+// Creates an image filled with arbitrary values depending on `seed`.
+void CreateImage(FrameBuffer::Dimension dimension, FrameBuffer::Format format,
+                 int seed, Image* image) {
+  image->data.resize(GetFrameBufferByteSize(dimension, format));
+  for (size_t i = 0; i < image->data.size(); ++i) {
+    image->data[i] = static_cast<uint8_t>(i * 131 + (i >> 9) + seed);
+  }
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      image->buffer,
+      CreateFromRawBuffer(image->data.data(), dimension, format));
+}
+
+// Operation writing to the provided output buffer with the provided utils.
+using Operation =
+    std::function<absl::Status(FrameBufferUtils*, FrameBuffer* output_buffer)>;
+
+// Tests `FrameBufferUtils` backed by an executor, which runs the operations of
+// an engine through `ParallelFrameBufferUtils`, against the same serial engine.
+class ParallelFrameBufferUtilsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SUPPORT_ASSERT_OK_AND_ASSIGN(executor_, TaskExecutor::Create(3));
+  }
+
+  // Expects `operation` to produce the same bytes in an output buffer of
+  // `output_dimension` and `output_format` with serial and parallel utils.
+  void ExpectSameAsSerial(FrameBuffer::Dimension output_dimension,
+                          FrameBuffer::Format output_format,
+                          const Operation& operation,
+                          FrameBufferUtils::ProcessEngine engine =
+                              FrameBufferUtils::ProcessEngine::kLibyuv) {
+    Image serial_output;
+    ASSERT_NO_FATAL_FAILURE(CreateImage(output_dimension, output_format,
+                                        /*seed=*/0, &serial_output));
+    Image parallel_output;
+    ASSERT_NO_FATAL_FAILURE(CreateImage(output_dimension, output_format,
+                                        /*seed=*/0, &parallel_output));
+    SUPPORT_ASSERT_OK(operation(FrameBufferUtils::Create(engine).get(),
+                                serial_output.buffer.get()));
+    SUPPORT_ASSERT_OK(operation(
+        FrameBufferUtils::Create(
+            engine, /*scratch_buffer_pool=*/nullptr,
+            std::make_shared<TaskExecutorBandExecutor>(executor_))
+            .get(),
+        parallel_output.buffer.get()));
+
+    for (size_t i = 0; i < serial_output.data.size(); ++i) {
+      ASSERT_EQ(parallel_output.data[i], serial_output.data[i])
+          << "at byte " << i;
+    }
+  }
+
+  // Checks crop, rotations and flips of `input`, in its own format.
+  void ExpectGeometricOperationsSameAsSerial(const Image& input) {
+    const FrameBuffer& buffer = *input.buffer;
+    const FrameBuffer::Dimension dimension = buffer.dimension();
+    const FrameBuffer::Format format = buffer.format();
+
+    // Cropping without resizing, from even coordinates as required by YUV
+    // formats.
+    const int x0 = 2, y0 = 4;
+    const int x1 = dimension.width - 3, y1 = dimension.height - 1;
+    {
+      SCOPED_TRACE("Crop");
+      ExpectSameAsSerial(
+          {x1 - x0 + 1, y1 - y0 + 1}, format,
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->Crop(buffer, x0, y0, x1, y1, output_buffer);
+          });
+    }
+    for (FrameBufferUtils::RotationDegree rotation :
+         {FrameBufferUtils::RotationDegree::k90,
+          FrameBufferUtils::RotationDegree::k180,
+          FrameBufferUtils::RotationDegree::k270}) {
+      SCOPED_TRACE(::testing::Message()
+                   << "Rotate " << static_cast<int>(rotation) * 90);
+      FrameBuffer::Dimension rotated_dimension = dimension;
+      if (rotation != FrameBufferUtils::RotationDegree::k180) {
+        rotated_dimension.Swap();
+      }
+      ExpectSameAsSerial(
+          rotated_dimension, format,
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->Rotate(buffer, rotation, output_buffer);
+          });
+    }
+    {
+      SCOPED_TRACE("FlipHorizontally");
+      ExpectSameAsSerial(
+          dimension, format,
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->FlipHorizontally(buffer, output_buffer);
+          });
+    }
+    {
+      SCOPED_TRACE("FlipVertically");
+      ExpectSameAsSerial(
+          dimension, format,
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->FlipVertically(buffer, output_buffer);
+          });
+    }
+  }
+
+  // Checks all the split operations on even and odd dimensions.
+  void ExpectAllOperationsSameAsSerial() {
+    for (const FrameBuffer::Dimension& dimension :
+         {kEvenDimension, kOddDimension}) {
+      SCOPED_TRACE(::testing::Message()
+                   << dimension.width << "x" << dimension.height);
+      Image rgb_input;
+      ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, FrameBuffer::Format::kRGB,
+                                          /*seed=*/1, &rgb_input));
+      {
+        SCOPED_TRACE("kRGB");
+        ExpectGeometricOperationsSameAsSerial(rgb_input);
+      }
+      for (FrameBuffer::Format format : kYuvFormats) {
+        SCOPED_TRACE(::testing::Message()
+                     << "format: " << static_cast<int>(format));
+        Image yuv_input;
+        ASSERT_NO_FATAL_FAILURE(
+            CreateImage(dimension, format, /*seed=*/2, &yuv_input));
+        ExpectGeometricOperationsSameAsSerial(yuv_input);
+        ExpectSameAsSerial(
+            dimension, FrameBuffer::Format::kRGB,
+            [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+              return utils->Convert(*yuv_input.buffer, output_buffer);
+            });
+        ExpectSameAsSerial(
+            dimension, format,
+            [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+              return utils->Convert(*rgb_input.buffer, output_buffer);
+            });
+      }
+    }
+  }
+
+  // Checks bilinear resizing, with and without cropping, of `input` with the
+  // SIMD engine, which resizes bands of rows of interleaved formats.
+  void ExpectResizingSameAsSerial(const Image& input) {
+    const FrameBuffer& buffer = *input.buffer;
+    const FrameBuffer::Dimension dimension = buffer.dimension();
+    // Downscaling and upscaling, along both axes.
+    for (const FrameBuffer::Dimension& output_dimension :
+         {FrameBuffer::Dimension{224, 150},
+          FrameBuffer::Dimension{dimension.width * 2 - 1, 300}}) {
+      SCOPED_TRACE(::testing::Message() << "to " << output_dimension.width
+                                        << "x" << output_dimension.height);
+      ExpectSameAsSerial(
+          output_dimension, buffer.format(),
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->Resize(buffer, output_buffer);
+          },
+          FrameBufferUtils::ProcessEngine::kSimd);
+      ExpectSameAsSerial(
+          output_dimension, buffer.format(),
+          [&](FrameBufferUtils* utils, FrameBuffer* output_buffer) {
+            return utils->Crop(buffer, /*x0=*/3, /*y0=*/5,
+                               /*x1=*/dimension.width - 8,
+                               /*y1=*/dimension.height - 2, output_buffer);
+          },
+          FrameBufferUtils::ProcessEngine::kSimd);
+    }
+  }
+
+  std::shared_ptr<TaskExecutor> executor_;
+};
+
+TEST_F(ParallelFrameBufferUtilsTest, MatchesSerialUtils) {
+  ExpectAllOperationsSameAsSerial();
+}
+
+TEST_F(ParallelFrameBufferUtilsTest, MatchesSerialUtilsWhenResizing) {
+  for (FrameBuffer::Format format :
+       {FrameBuffer::Format::kRGB, FrameBuffer::Format::kRGBA,
+        FrameBuffer::Format::kGRAY}) {
+    SCOPED_TRACE(::testing::Message()
+                 << "format: " << static_cast<int>(format));
+    Image input;
+    ASSERT_NO_FATAL_FAILURE(
+        CreateImage(kOddDimension, format, /*seed=*/3, &input));
+    ExpectResizingSameAsSerial(input);
+  }
+}
+
+// When no band can be scheduled, the calling thread processes all of them.
+TEST_F(ParallelFrameBufferUtilsTest, MatchesSerialUtilsWithFullExecutor) {
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      executor_, TaskExecutor::Create(/*num_threads=*/1,
+                                      /*max_pending_closures=*/1));
+  // Keeps the worker busy and its queue full until the end of the test.
+  auto release = std::make_shared<absl::Notification>();
+  absl::Notification started;
+  SUPPORT_ASSERT_OK(executor_->Schedule([release, &started]() {
+    started.Notify();
+    release->WaitForNotification();
+  }));
+  started.WaitForNotification();
+  SUPPORT_ASSERT_OK(
+      executor_->Schedule([release]() { release->WaitForNotification(); }));
+  ASSERT_EQ(executor_->Schedule([]() {}).code(),
+            absl::StatusCode::kResourceExhausted);
+
+  ExpectAllOperationsSameAsSerial();
+
+  release->Notify();
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
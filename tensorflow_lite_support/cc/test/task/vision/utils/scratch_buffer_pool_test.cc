@@ -0,0 +1,136 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/scratch_buffer_pool.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "tensorflow_lite_support/cc/port/gtest.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+TEST(ScratchBufferPoolTest, AllocatesWhenEmpty) {
+  ScratchBufferPool pool;
+
+  ScratchBufferPool::Buffer buffer = pool.Acquire(100);
+
+  ASSERT_NE(buffer.data(), nullptr);
+  EXPECT_EQ(buffer.size(), 100);
+  const ScratchBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(stats.num_acquisitions, 1);
+  EXPECT_EQ(stats.num_allocations, 1);
+  EXPECT_EQ(stats.allocated_bytes, 100);
+}
+
+TEST(ScratchBufferPoolTest, ReusesBufferAfterRelease) {
+  ScratchBufferPool pool;
+  const uint8_t* data = nullptr;
+  {
+    ScratchBufferPool::Buffer buffer = pool.Acquire(100);
+    data = buffer.data();
+  }
+
+  ScratchBufferPool::Buffer buffer = pool.Acquire(80);
+
+  // The free buffer is large enough, and is returned with its full capacity.
+  EXPECT_EQ(buffer.data(), data);
+  EXPECT_EQ(buffer.size(), 100);
+  const ScratchBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(stats.num_acquisitions, 2);
+  EXPECT_EQ(stats.num_allocations, 1);
+  EXPECT_EQ(stats.allocated_bytes, 100);
+}
+
+TEST(ScratchBufferPoolTest, DoesNotShareAcquiredBuffers) {
+  ScratchBufferPool pool;
+
+  ScratchBufferPool::Buffer first = pool.Acquire(100);
+  ScratchBufferPool::Buffer second = pool.Acquire(100);
+
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_EQ(pool.GetStats().num_allocations, 2);
+  EXPECT_EQ(pool.GetStats().allocated_bytes, 200);
+}
+
+TEST(ScratchBufferPoolTest, SelectsSmallestFreeBufferThatFits) {
+  ScratchBufferPool pool;
+  const uint8_t* small_data = nullptr;
+  const uint8_t* medium_data = nullptr;
+  {
+    ScratchBufferPool::Buffer large = pool.Acquire(300);
+    ScratchBufferPool::Buffer small = pool.Acquire(100);
+    ScratchBufferPool::Buffer medium = pool.Acquire(200);
+    small_data = small.data();
+    medium_data = medium.data();
+  }
+
+  ScratchBufferPool::Buffer fits_medium = pool.Acquire(150);
+  ScratchBufferPool::Buffer fits_small = pool.Acquire(50);
+
+  EXPECT_EQ(fits_medium.data(), medium_data);
+  EXPECT_EQ(fits_medium.size(), 200);
+  EXPECT_EQ(fits_small.data(), small_data);
+  EXPECT_EQ(fits_small.size(), 100);
+  EXPECT_EQ(pool.GetStats().num_allocations, 3);
+}
+
+TEST(ScratchBufferPoolTest, ReplacesLargestFreeBufferWhenNoneFits) {
+  ScratchBufferPool pool;
+  {
+    ScratchBufferPool::Buffer small = pool.Acquire(100);
+    ScratchBufferPool::Buffer medium = pool.Acquire(200);
+  }
+
+  ScratchBufferPool::Buffer buffer = pool.Acquire(500);
+
+  // The 200-byte buffer is evicted, the 100-byte one is kept.
+  EXPECT_EQ(buffer.size(), 500);
+  ScratchBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(stats.num_allocations, 3);
+  EXPECT_EQ(stats.allocated_bytes, 600);
+
+  ScratchBufferPool::Buffer other = pool.Acquire(50);
+
+  EXPECT_EQ(other.size(), 100);
+  stats = pool.GetStats();
+  EXPECT_EQ(stats.num_allocations, 3);
+  EXPECT_EQ(stats.allocated_bytes, 600);
+}
+
+TEST(ScratchBufferPoolTest, ReleasesMovedBufferOnce) {
+  ScratchBufferPool pool;
+  {
+    ScratchBufferPool::Buffer buffer = pool.Acquire(100);
+    ScratchBufferPool::Buffer moved = std::move(buffer);
+    EXPECT_EQ(buffer.data(), nullptr);
+    EXPECT_EQ(moved.size(), 100);
+  }
+
+  ScratchBufferPool::Buffer first = pool.Acquire(100);
+  ScratchBufferPool::Buffer second = pool.Acquire(100);
+
+  // Only one buffer was returned to the pool.
+  EXPECT_NE(first.data(), second.data());
+  EXPECT_EQ(pool.GetStats().num_allocations, 2);
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
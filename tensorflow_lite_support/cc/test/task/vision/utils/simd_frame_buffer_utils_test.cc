@@ -0,0 +1,353 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/cc/task/vision/utils/simd_frame_buffer_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/frame_buffer_common_utils.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/libyuv_frame_buffer_utils.h"
+
+namespace tflite {
+namespace task {
+namespace vision {
+namespace {
+
+// Covers single pixels, rows shorter than a block of the vectorized kernels and
+// rows with leftover pixels after one or more blocks. Odd dimensions exercise
+// the handling of the chroma planes of YUV formats.
+const FrameBuffer::Dimension kDimensions[] = {
+    {1, 1}, {2, 2}, {7, 5}, {17, 9}, {64, 48}, {67, 35}, {257, 33}};
+
+constexpr FrameBuffer::Format kYuvFormats[] = {
+    FrameBuffer::Format::kNV12, FrameBuffer::Format::kNV21,
+    FrameBuffer::Format::kYV12, FrameBuffer::Format::kYV21};
+
+constexpr FrameBuffer::Format kInterleavedFormats[] = {
+    FrameBuffer::Format::kRGB, FrameBuffer::Format::kRGBA,
+    FrameBuffer::Format::kGRAY};
+
+// Largest difference between the SIMD and libyuv results, which round
+// intermediate values differently.
+constexpr int kMaxPixelDifference = 3;
+
+// Frame buffer over the data it owns.
+struct Image {
+  std::vector<uint8_t> data;
+  std::unique_ptr<FrameBuffer> buffer;
+};
+
+// Creates an image filled with arbitrary values covering the whole 8-bit range.
+void CreateImage(FrameBuffer::Dimension dimension, FrameBuffer::Format format,
+                 Image* image) {
+  image->data.resize(GetFrameBufferByteSize(dimension, format));
+  for (size_t i = 0; i < image->data.size(); ++i) {
+    image->data[i] = static_cast<uint8_t>(i * 131 + (i >> 9) + 7);
+  }
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      image->buffer,
+      CreateFromRawBuffer(image->data.data(), dimension, format));
+}
+
+// Returns the dimensions to resize `dimension` to: down, up, and up along one
+// axis while down along the other.
+std::vector<FrameBuffer::Dimension> GetResizedDimensions(
+    FrameBuffer::Dimension dimension) {
+  return {{std::max(dimension.width / 3, 1), std::max(dimension.height / 2, 1)},
+          {dimension.width * 2 + 1, dimension.height * 3 - 1},
+          {dimension.width + 5, std::max(dimension.height - 3, 1)}};
+}
+
+// Operation writing to the provided output buffer with the provided engine.
+using Operation = std::function<absl::Status(FrameBufferUtilsInterface*,
+                                             FrameBuffer* output_buffer)>;
+
+// Expects `operation` to produce bytes differing by at most `max_difference`
+// in an output buffer of `output_dimension` and `output_format` with the SIMD
+// and libyuv engines.
+void ExpectNearLibyuv(FrameBuffer::Dimension output_dimension,
+                      FrameBuffer::Format output_format,
+                      const Operation& operation,
+                      int max_difference = kMaxPixelDifference) {
+  Image simd_output;
+  ASSERT_NO_FATAL_FAILURE(
+      CreateImage(output_dimension, output_format, &simd_output));
+  Image libyuv_output;
+  ASSERT_NO_FATAL_FAILURE(
+      CreateImage(output_dimension, output_format, &libyuv_output));
+  SimdFrameBufferUtils simd_utils;
+  LibyuvFrameBufferUtils libyuv_utils;
+  SUPPORT_ASSERT_OK(operation(&simd_utils, simd_output.buffer.get()));
+  SUPPORT_ASSERT_OK(operation(&libyuv_utils, libyuv_output.buffer.get()));
+
+  for (size_t i = 0; i < simd_output.data.size(); ++i) {
+    ASSERT_LE(std::abs(simd_output.data[i] - libyuv_output.data[i]),
+              max_difference)
+        << "at byte " << i;
+  }
+}
+
+// Input samples and 7-bit weight of the second one, for an output sample of
+// the bilinear interpolation.
+struct Tap {
+  int index0;
+  int index1;
+  int weight;
+};
+
+// Returns the tap of output sample `i`, following the 16.16 fixed point
+// sampling grid of libyuv's bilinear scaler.
+Tap GetTap(int i, int input_size, int output_size) {
+  int64_t step = 0;
+  int64_t position = 0;
+  if (output_size <= input_size) {
+    step = (static_cast<int64_t>(input_size) << 16) / output_size;
+    position = (step >> 1) - 32768;
+  } else if (input_size > 1) {
+    step = ((static_cast<int64_t>(input_size) << 16) - 0x00010001) /
+           (output_size - 1);
+  }
+  position = std::min(std::max<int64_t>(position + i * step, 0),
+                      static_cast<int64_t>(input_size - 1) << 16);
+  const int index0 = static_cast<int>(position >> 16);
+  return {index0, std::min(index0 + 1, input_size - 1),
+          static_cast<int>(position >> 9) & 127};
+}
+
+// Returns the bytes of the crop of `input` from (x0, y0) resized to
+// `output_dimension`, interpolated one value at a time.
+std::vector<uint8_t> ResizeAsScalarFormula(
+    const Image& input, int x0, int y0, int x1, int y1,
+    FrameBuffer::Dimension output_dimension) {
+  const FrameBuffer& buffer = *input.buffer;
+  const int channels = GetPixelStrides(buffer.format()).value();
+  const int row_stride = buffer.plane(0).stride.row_stride_bytes;
+  const uint8_t* crop =
+      buffer.plane(0).buffer + y0 * row_stride + x0 * channels;
+  std::vector<uint8_t> output;
+  for (int y = 0; y < output_dimension.height; ++y) {
+    const Tap y_tap = GetTap(y, y1 - y0 + 1, output_dimension.height);
+    for (int x = 0; x < output_dimension.width; ++x) {
+      const Tap x_tap = GetTap(x, x1 - x0 + 1, output_dimension.width);
+      for (int c = 0; c < channels; ++c) {
+        auto sample = [&](int row, int column) -> int {
+          return crop[row * row_stride + column * channels + c];
+        };
+        const int row0 = (128 - x_tap.weight) * sample(y_tap.index0,
+                                                       x_tap.index0) +
+                         x_tap.weight * sample(y_tap.index0, x_tap.index1);
+        const int row1 = (128 - x_tap.weight) * sample(y_tap.index1,
+                                                       x_tap.index0) +
+                         x_tap.weight * sample(y_tap.index1, x_tap.index1);
+        output.push_back(static_cast<uint8_t>(
+            ((128 - y_tap.weight) * row0 + y_tap.weight * row1 + 8192) >> 14));
+      }
+    }
+  }
+  return output;
+}
+
+uint8_t ClampToUint8(int value) {
+  return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+// Returns the bytes of the kRGB conversion of YUV `input`, using the BT.601
+// limited range matrix in 6-bit fixed point.
+std::vector<uint8_t> ConvertYuvToRgbAsScalarFormula(const Image& input) {
+  const FrameBuffer& buffer = *input.buffer;
+  const FrameBuffer::YuvData yuv =
+      FrameBuffer::GetYuvDataFromFrameBuffer(buffer).value();
+  std::vector<uint8_t> output;
+  for (int y = 0; y < buffer.dimension().height; ++y) {
+    for (int x = 0; x < buffer.dimension().width; ++x) {
+      const int uv_offset =
+          (y / 2) * yuv.uv_row_stride + (x / 2) * yuv.uv_pixel_stride;
+      const int luma =
+          ((yuv.y_buffer[y * yuv.y_row_stride + x] * 0x0101 * 18997) >> 16) -
+          1160;
+      const int u = yuv.u_buffer[uv_offset] - 128;
+      const int v = yuv.v_buffer[uv_offset] - 128;
+      output.push_back(ClampToUint8((luma + 102 * v) >> 6));
+      output.push_back(ClampToUint8((luma - 25 * u - 52 * v) >> 6));
+      output.push_back(ClampToUint8((luma + 129 * u) >> 6));
+    }
+  }
+  return output;
+}
+
+// Expects `operation` to produce `expected` with the SIMD engine, in an output
+// buffer of `output_dimension` and `output_format`.
+void ExpectSameAs(const std::vector<uint8_t>& expected,
+                  FrameBuffer::Dimension output_dimension,
+                  FrameBuffer::Format output_format,
+                  const Operation& operation) {
+  Image output;
+  ASSERT_NO_FATAL_FAILURE(
+      CreateImage(output_dimension, output_format, &output));
+  SimdFrameBufferUtils utils;
+  SUPPORT_ASSERT_OK(operation(&utils, output.buffer.get()));
+
+  ASSERT_EQ(output.data.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(output.data[i], expected[i]) << "at byte " << i;
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, ConvertsYuvToRgbLikeLibyuv) {
+  for (FrameBuffer::Format format : kYuvFormats) {
+    for (const FrameBuffer::Dimension& dimension : kDimensions) {
+      SCOPED_TRACE(absl::StrFormat("format %d, %dx%d", format,
+                                    dimension.width, dimension.height));
+      Image input;
+      ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+      ExpectNearLibyuv(
+          dimension, FrameBuffer::Format::kRGB,
+          [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+            return utils->Convert(*input.buffer, output_buffer);
+          });
+    }
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, ConvertsRgbaToRgbLikeLibyuv) {
+  for (const FrameBuffer::Dimension& dimension : kDimensions) {
+    SCOPED_TRACE(absl::StrFormat("%dx%d", dimension.width, dimension.height));
+    Image input;
+    ASSERT_NO_FATAL_FAILURE(
+        CreateImage(dimension, FrameBuffer::Format::kRGBA, &input));
+    // Dropping the alpha channel is exact.
+    ExpectNearLibyuv(
+        dimension, FrameBuffer::Format::kRGB,
+        [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+          return utils->Convert(*input.buffer, output_buffer);
+        },
+        /*max_difference=*/0);
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, ResizesLikeLibyuv) {
+  for (FrameBuffer::Format format : kInterleavedFormats) {
+    for (const FrameBuffer::Dimension& dimension : kDimensions) {
+      Image input;
+      ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+      for (const FrameBuffer::Dimension& output_dimension :
+           GetResizedDimensions(dimension)) {
+        SCOPED_TRACE(absl::StrFormat(
+            "format %d, %dx%d to %dx%d", format, dimension.width,
+            dimension.height, output_dimension.width, output_dimension.height));
+        ExpectNearLibyuv(
+            output_dimension, format,
+            [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+              return utils->Resize(*input.buffer, output_buffer);
+            });
+      }
+    }
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, CropsAndResizesLikeLibyuv) {
+  const FrameBuffer::Dimension dimension = {67, 35};
+  const int x0 = 3, y0 = 2, x1 = 60, y1 = 30;
+  for (FrameBuffer::Format format : kInterleavedFormats) {
+    Image input;
+    ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+    for (const FrameBuffer::Dimension& output_dimension :
+         GetResizedDimensions({x1 - x0 + 1, y1 - y0 + 1})) {
+      SCOPED_TRACE(absl::StrFormat(
+          "format %d, %dx%d to %dx%d", format, dimension.width,
+          dimension.height, output_dimension.width, output_dimension.height));
+      ExpectNearLibyuv(
+          output_dimension, format,
+          [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+            return utils->Crop(*input.buffer, x0, y0, x1, y1, output_buffer);
+          });
+    }
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, ConvertsYuvToRgbAsScalarFormula) {
+  for (FrameBuffer::Format format : kYuvFormats) {
+    for (const FrameBuffer::Dimension& dimension : kDimensions) {
+      SCOPED_TRACE(absl::StrFormat("format %d, %dx%d", format,
+                                    dimension.width, dimension.height));
+      Image input;
+      ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+      ExpectSameAs(
+          ConvertYuvToRgbAsScalarFormula(input), dimension,
+          FrameBuffer::Format::kRGB,
+          [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+            return utils->Convert(*input.buffer, output_buffer);
+          });
+    }
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, ResizesAsScalarFormula) {
+  for (FrameBuffer::Format format : kInterleavedFormats) {
+    for (const FrameBuffer::Dimension& dimension : kDimensions) {
+      Image input;
+      ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+      for (const FrameBuffer::Dimension& output_dimension :
+           GetResizedDimensions(dimension)) {
+        SCOPED_TRACE(absl::StrFormat(
+            "format %d, %dx%d to %dx%d", format, dimension.width,
+            dimension.height, output_dimension.width, output_dimension.height));
+        ExpectSameAs(
+            ResizeAsScalarFormula(input, 0, 0, dimension.width - 1,
+                                  dimension.height - 1, output_dimension),
+            output_dimension, format,
+            [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+              return utils->Resize(*input.buffer, output_buffer);
+            });
+      }
+    }
+  }
+}
+
+TEST(SimdFrameBufferUtilsTest, CropsAndResizesAsScalarFormula) {
+  const FrameBuffer::Dimension dimension = {67, 35};
+  const int x0 = 3, y0 = 2, x1 = 60, y1 = 30;
+  for (FrameBuffer::Format format : kInterleavedFormats) {
+    Image input;
+    ASSERT_NO_FATAL_FAILURE(CreateImage(dimension, format, &input));
+    for (const FrameBuffer::Dimension& output_dimension :
+         GetResizedDimensions({x1 - x0 + 1, y1 - y0 + 1})) {
+      SCOPED_TRACE(absl::StrFormat(
+          "format %d, %dx%d to %dx%d", format, dimension.width,
+          dimension.height, output_dimension.width, output_dimension.height));
+      ExpectSameAs(
+          ResizeAsScalarFormula(input, x0, y0, x1, y1, output_dimension),
+          output_dimension, format,
+          [&](FrameBufferUtilsInterface* utils, FrameBuffer* output_buffer) {
+            return utils->Crop(*input.buffer, x0, y0, x1, y1, output_buffer);
+          });
+    }
+  }
+}
+
+}  // namespace
+}  // namespace vision
+}  // namespace task
+}  // namespace tflite
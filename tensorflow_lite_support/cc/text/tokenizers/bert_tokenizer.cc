@@ -55,6 +55,17 @@ bool FlatHashMapBackedWordpiece::LookupWord(int vocab_id,
   return true;
 }
 
+int64_t FlatHashMapBackedWordpiece::EstimateHeapMemoryUsage() const {
+  int64_t bytes = vocab_.capacity() * sizeof(std::string);
+  for (const std::string& word : vocab_) {
+    bytes += word.capacity();
+  }
+  // Flat hash maps use one control byte per slot.
+  bytes += index_map_.capacity() *
+           (sizeof(decltype(index_map_)::value_type) + 1);
+  return bytes;
+}
+
 TokenizerResult BertTokenizer::Tokenize(const std::string& input) {
   return TokenizeWordpiece(input);
 }
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_BERT_TOKENIZER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_BERT_TOKENIZER_H_
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -79,6 +80,9 @@ class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
   bool LookupWord(int vocab_id, absl::string_view* result) const;
   int VocabularySize() const { return vocab_.size(); }
 
+  // Returns the approximate heap memory used by the vocabulary.
+  int64_t EstimateHeapMemoryUsage() const;
+
  private:
   // All words indexed position in vocabulary file.
   std::vector<std::string> vocab_;
@@ -134,6 +138,10 @@ class BertTokenizer : public tflite::support::text::tokenizer::Tokenizer {
 
   int VocabularySize() const { return vocab_.VocabularySize(); }
 
+  int64_t EstimateMemoryUsage() const override {
+    return sizeof(BertTokenizer) + vocab_.EstimateHeapMemoryUsage();
+  }
+
  private:
   tflite::support::text::tokenizer::FlatHashMapBackedWordpiece vocab_;
   BertTokenizerOptions options_;
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow_lite_support/cc/text/tokenizers/regex_tokenizer.h"
 
+#include <cstdint>
 #include <iostream>
 
 #include "absl/strings/str_cat.h"  // from @com_google_absl
@@ -107,6 +108,21 @@ bool RegexTokenizer::LookupWord(int vocab_id, absl::string_view* result) const {
   return true;
 }
 
+int64_t RegexTokenizer::EstimateMemoryUsage() const {
+  // Node hash maps hold one pointer and one control byte per slot, and
+  // allocate each element separately.
+  constexpr int64_t kSlotBytes = sizeof(void*) + 1;
+  int64_t bytes = sizeof(RegexTokenizer) +
+                  token_index_map_.capacity() * kSlotBytes +
+                  index_token_map_.capacity() * kSlotBytes;
+  for (const auto& entry : token_index_map_) {
+    bytes += sizeof(entry) + entry.first.capacity();
+  }
+  bytes += index_token_map_.size() *
+           sizeof(decltype(index_token_map_)::value_type);
+  return bytes;
+}
+
 bool RegexTokenizer::GetStartToken(int* start_token) {
   return LookupId(kStart, start_token);
 }
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 
+#include <cstdint>
+
 #include "absl/container/node_hash_map.h"  // from @com_google_absl
 #include "re2/re2.h"
 #include "tensorflow_lite_support/cc/text/tokenizers/tokenizer.h"
@@ -45,6 +47,8 @@ class RegexTokenizer : public Tokenizer {
   bool GetPadToken(int* pad_token);
   bool GetUnknownToken(int* unknown_token);
 
+  int64_t EstimateMemoryUsage() const override;
+
  private:
   RE2 delim_re_;
   absl::node_hash_map<std::string, int> token_index_map_;
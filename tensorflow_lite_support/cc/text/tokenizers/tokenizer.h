@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 #define TENSORFLOW_LITE_SUPPORT_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -43,6 +44,10 @@ class Tokenizer {
   // Find the string token from an id.
   virtual bool LookupWord(int vocab_id, absl::string_view* result) const = 0;
 
+  // Returns the approximate memory used by the tokenizer, mostly for its
+  // vocabulary, or 0 if unknown.
+  virtual int64_t EstimateMemoryUsage() const { return 0; }
+
   // Destructor.
   virtual ~Tokenizer() = default;
 };
@@ -0,0 +1,381 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/load_generator.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_format.h"  // from @com_google_absl
+#include "absl/synchronization/mutex.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/task_executor.h"
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::TaskExecutor;
+
+// Timing of a single request.
+struct Sample {
+  // When the request arrived (open loop) or was issued (closed loop).
+  absl::Time arrival;
+  // When a worker started serving the request.
+  absl::Time start;
+  // When the task API returned.
+  absl::Time end;
+  bool ok;
+};
+
+// Collects samples from all workers.
+class SampleSink {
+ public:
+  void Add(const Sample& sample, const absl::Status& status) {
+    absl::MutexLock lock(&mutex_);
+    samples_.push_back(sample);
+    if (!status.ok() && first_error_.ok()) {
+      first_error_ = status;
+    }
+  }
+
+  void AddAll(const std::vector<Sample>& samples, const absl::Status& status) {
+    absl::MutexLock lock(&mutex_);
+    samples_.insert(samples_.end(), samples.begin(), samples.end());
+    if (!status.ok() && first_error_.ok()) {
+      first_error_ = status;
+    }
+  }
+
+  void AddDropped(absl::Time arrival) {
+    absl::MutexLock lock(&mutex_);
+    dropped_.push_back(arrival);
+  }
+
+  // Only meant to be called once all workers are done.
+  std::vector<Sample> samples() const {
+    absl::MutexLock lock(&mutex_);
+    return samples_;
+  }
+  std::vector<absl::Time> dropped() const {
+    absl::MutexLock lock(&mutex_);
+    return dropped_;
+  }
+  absl::Status first_error() const {
+    absl::MutexLock lock(&mutex_);
+    return first_error_;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::vector<Sample> samples_ ABSL_GUARDED_BY(mutex_);
+  std::vector<absl::Time> dropped_ ABSL_GUARDED_BY(mutex_);
+  absl::Status first_error_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Hands out idle task runners to workers. With a shared runner, the same
+// instance is added once per worker.
+class TaskRunnerPool {
+ public:
+  void Add(std::shared_ptr<TaskRunner> runner) {
+    absl::MutexLock lock(&mutex_);
+    idle_runners_.push_back(std::move(runner));
+  }
+
+  std::shared_ptr<TaskRunner> Acquire() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(this, &TaskRunnerPool::HasIdleRunner));
+    std::shared_ptr<TaskRunner> runner = std::move(idle_runners_.back());
+    idle_runners_.pop_back();
+    return runner;
+  }
+
+  void Release(std::shared_ptr<TaskRunner> runner) { Add(std::move(runner)); }
+
+ private:
+  bool HasIdleRunner() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !idle_runners_.empty();
+  }
+
+  absl::Mutex mutex_;
+  std::vector<std::shared_ptr<TaskRunner>> idle_runners_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+absl::Status ValidateOptions(const LoadGeneratorOptions& options) {
+  if (options.concurrency < 1) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Expected a positive concurrency, got %d.", options.concurrency));
+  }
+  if (options.mode == LoadMode::kOpenLoop && options.request_rate <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Expected a positive request rate in open-loop mode, "
+                        "got %f.",
+                        options.request_rate));
+  }
+  if (options.warmup < absl::ZeroDuration()) {
+    return absl::InvalidArgumentError("Expected a non-negative warmup.");
+  }
+  if (options.duration <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError("Expected a positive duration.");
+  }
+  return absl::OkStatus();
+}
+
+// Returns the CPU time consumed so far by all threads of this process.
+absl::Duration GetProcessCpuTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return absl::InfiniteDuration();
+  }
+  return absl::DurationFromTimeval(usage.ru_utime) +
+         absl::DurationFromTimeval(usage.ru_stime);
+}
+
+std::string FormatDistribution(const LatencyDistribution& distribution) {
+  auto ms = [](absl::Duration duration) {
+    return absl::StrFormat("%.2f", absl::ToDoubleMilliseconds(duration));
+  };
+  return absl::StrCat("mean ", ms(distribution.mean), ", p50 ",
+                      ms(distribution.p50), ", p90 ", ms(distribution.p90),
+                      ", p95 ", ms(distribution.p95), ", p99 ",
+                      ms(distribution.p99), ", p99.9 ", ms(distribution.p999),
+                      ", max ", ms(distribution.max));
+}
+
+// Applies closed-loop load until `end`.
+void RunClosedLoop(const LoadGeneratorOptions& options, absl::Time end,
+                   int corpus_size, TaskRunnerPool* pool, TaskExecutor* executor,
+                   SampleSink* sink) {
+  for (int worker = 0; worker < options.concurrency; ++worker) {
+    // The executor has one thread per worker, so scheduling never fails.
+    executor
+        ->Schedule([&options, end, corpus_size, pool, sink, worker]() {
+          std::shared_ptr<TaskRunner> runner = pool->Acquire();
+          std::vector<Sample> samples;
+          absl::Status first_error;
+          // Workers interleave their walks through the corpus.
+          for (int64_t i = worker;; i += options.concurrency) {
+            const absl::Time start = absl::Now();
+            if (start >= end) break;
+            absl::Status status = runner->Run(i % corpus_size);
+            samples.push_back({start, start, absl::Now(), status.ok()});
+            if (!status.ok() && first_error.ok()) {
+              first_error = status;
+            }
+          }
+          pool->Release(std::move(runner));
+          sink->AddAll(samples, first_error);
+        })
+        .IgnoreError();
+  }
+}
+
+// Applies open-loop load from `start` until `end`.
+void RunOpenLoop(const LoadGeneratorOptions& options, absl::Time start,
+                 absl::Time end, int corpus_size, TaskRunnerPool* pool,
+                 TaskExecutor* executor, SampleSink* sink) {
+  std::mt19937_64 generator(options.seed);
+  std::exponential_distribution<double> interarrival_seconds(
+      options.request_rate);
+  absl::Time arrival = start;
+  for (int64_t i = 0;; ++i) {
+    arrival += absl::Seconds(interarrival_seconds(generator));
+    if (arrival >= end) break;
+    absl::SleepFor(arrival - absl::Now());
+    const int index = i % corpus_size;
+    absl::Status status =
+        executor->Schedule([arrival, index, pool, sink]() {
+          std::shared_ptr<TaskRunner> runner = pool->Acquire();
+          const absl::Time start = absl::Now();
+          absl::Status status = runner->Run(index);
+          const absl::Time end = absl::Now();
+          pool->Release(std::move(runner));
+          sink->Add({arrival, start, end, status.ok()}, status);
+        });
+    if (!status.ok()) {
+      sink->AddDropped(arrival);
+    }
+  }
+}
+
+}  // namespace
+
+absl::Duration Percentile(const std::vector<absl::Duration>& sorted_durations,
+                          double percentile) {
+  if (sorted_durations.empty()) {
+    return absl::ZeroDuration();
+  }
+  const int rank = static_cast<int>(
+      std::ceil(percentile / 100.0 * sorted_durations.size()));
+  return sorted_durations[std::min(std::max(rank, 1),
+                                   static_cast<int>(sorted_durations.size())) -
+                          1];
+}
+
+LatencyDistribution Summarize(std::vector<absl::Duration> durations) {
+  LatencyDistribution distribution;
+  if (durations.empty()) {
+    return distribution;
+  }
+  std::sort(durations.begin(), durations.end());
+  absl::Duration total;
+  for (const absl::Duration& duration : durations) {
+    total += duration;
+  }
+  distribution.mean = total / static_cast<int64_t>(durations.size());
+  distribution.p50 = Percentile(durations, 50);
+  distribution.p90 = Percentile(durations, 90);
+  distribution.p95 = Percentile(durations, 95);
+  distribution.p99 = Percentile(durations, 99);
+  distribution.p999 = Percentile(durations, 99.9);
+  distribution.max = durations.back();
+  return distribution;
+}
+
+StatusOr<LoadReport> RunLoad(const TaskRunnerFactory& task_runner_factory,
+                             const LoadGeneratorOptions& options) {
+  RETURN_IF_ERROR(ValidateOptions(options));
+
+  // Create the task runners before starting the clock.
+  TaskRunnerPool pool;
+  int corpus_size = 0;
+  std::shared_ptr<TaskRunner> shared_runner;
+  for (int i = 0; i < options.concurrency; ++i) {
+    if (!options.share_task_runner || shared_runner == nullptr) {
+      ASSIGN_OR_RETURN(shared_runner, task_runner_factory());
+      corpus_size = shared_runner->corpus_size();
+    }
+    pool.Add(shared_runner);
+  }
+  if (corpus_size < 1) {
+    return absl::InvalidArgumentError("Expected a non-empty input corpus.");
+  }
+  shared_runner.reset();
+
+  ASSIGN_OR_RETURN(std::unique_ptr<TaskExecutor> executor,
+                   TaskExecutor::Create(options.concurrency,
+                                        options.mode == LoadMode::kOpenLoop
+                                            ? options.max_pending_requests
+                                            : 0));
+  SampleSink sink;
+  const absl::Time start = absl::Now();
+  const absl::Time measurement_start = start + options.warmup;
+  const absl::Time end = measurement_start + options.duration;
+
+  // Samples CPU usage at the boundaries of the measurement window.
+  absl::Duration cpu_time_at_start;
+  absl::Duration cpu_time_at_end;
+  std::thread cpu_monitor([&]() {
+    absl::SleepFor(measurement_start - absl::Now());
+    cpu_time_at_start = GetProcessCpuTime();
+    absl::SleepFor(end - absl::Now());
+    cpu_time_at_end = GetProcessCpuTime();
+  });
+
+  if (options.mode == LoadMode::kClosedLoop) {
+    RunClosedLoop(options, end, corpus_size, &pool, executor.get(), &sink);
+  } else {
+    RunOpenLoop(options, start, end, corpus_size, &pool, executor.get(),
+                &sink);
+  }
+  // Waits for all pending requests to be served.
+  executor.reset();
+  cpu_monitor.join();
+
+  LoadReport report;
+  report.measured_duration = options.duration;
+  report.num_cpus = std::thread::hardware_concurrency();
+  report.first_error = sink.first_error();
+  if (cpu_time_at_start != absl::InfiniteDuration() &&
+      cpu_time_at_end != absl::InfiniteDuration()) {
+    report.cpu_cores_used = absl::FDivDuration(
+        cpu_time_at_end - cpu_time_at_start, options.duration);
+  }
+
+  auto in_window = [&](absl::Time time) {
+    return time >= measurement_start && time < end;
+  };
+  std::vector<absl::Duration> latencies;
+  std::vector<absl::Duration> service_times;
+  int64_t completed_in_window = 0;
+  for (const Sample& sample : sink.samples()) {
+    if (sample.ok && in_window(sample.end)) {
+      ++completed_in_window;
+    }
+    if (!in_window(sample.arrival)) continue;
+    if (sample.ok) {
+      latencies.push_back(sample.end - sample.arrival);
+      service_times.push_back(sample.end - sample.start);
+    } else {
+      ++report.failed_requests;
+    }
+  }
+  for (const absl::Time& arrival : sink.dropped()) {
+    if (in_window(arrival)) {
+      ++report.dropped_requests;
+    }
+  }
+  report.completed_requests = latencies.size();
+  report.throughput =
+      completed_in_window / absl::ToDoubleSeconds(options.duration);
+  report.latency = Summarize(std::move(latencies));
+  report.service_time = Summarize(std::move(service_times));
+  return report;
+}
+
+std::string FormatLoadReport(const LoadReport& report) {
+  std::string output = absl::StrFormat(
+      "Measured duration: %.1f s\n"
+      "Requests: %d completed, %d failed, %d dropped\n"
+      "Throughput: %.2f requests/s\n"
+      "Latency (ms): %s\n"
+      "Service time (ms): %s\n",
+      absl::ToDoubleSeconds(report.measured_duration),
+      report.completed_requests, report.failed_requests,
+      report.dropped_requests, report.throughput,
+      FormatDistribution(report.latency),
+      FormatDistribution(report.service_time));
+  if (report.cpu_cores_used >= 0) {
+    absl::StrAppendFormat(&output, "CPU utilization: %.2f cores",
+                          report.cpu_cores_used);
+    if (report.num_cpus > 0) {
+      absl::StrAppendFormat(&output, " (%.1f%% of %d CPUs)",
+                            100 * report.cpu_cores_used / report.num_cpus,
+                            report.num_cpus);
+    }
+    absl::StrAppend(&output, "\n");
+  }
+  if (!report.first_error.ok()) {
+    absl::StrAppend(&output, "First error: ", report.first_error.ToString(),
+                    "\n");
+  }
+  return output;
+}
+
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,156 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_LOAD_GENERATOR_H_
+#define TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_LOAD_GENERATOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+
+// A task API instance along with the corpus of inputs it serves requests from.
+class TaskRunner {
+ public:
+  virtual ~TaskRunner() = default;
+
+  // Returns the number of inputs in the corpus.
+  virtual int corpus_size() const = 0;
+
+  // Runs inference on the corpus input at `index`, in [0, corpus_size()).
+  virtual absl::Status Run(int index) = 0;
+};
+
+// Creates a new, independent TaskRunner each time it is called.
+using TaskRunnerFactory =
+    std::function<tflite::support::StatusOr<std::unique_ptr<TaskRunner>>()>;
+
+// How requests are issued to the task runners.
+enum class LoadMode {
+  // Each of the `concurrency` workers issues a new request as soon as its
+  // previous one has completed. Measures the maximum sustainable throughput.
+  kClosedLoop,
+  // Requests arrive following a Poisson process of rate `request_rate`,
+  // independently of how fast they are served, and are queued until one of the
+  // `concurrency` workers picks them up. Measures latency under a given load.
+  kOpenLoop,
+};
+
+struct LoadGeneratorOptions {
+  LoadMode mode = LoadMode::kClosedLoop;
+
+  // Number of requests that can be served concurrently.
+  int concurrency = 1;
+
+  // Mean number of requests per second. Only used in open-loop mode.
+  double request_rate = 0;
+
+  // Maximum number of requests waiting for a worker in open-loop mode. Requests
+  // arriving while the queue is full are dropped and reported as such.
+  int max_pending_requests = 1000;
+
+  // Time during which load is applied before measurements start, so that
+  // caches, thread pools and delegates reach a steady state.
+  absl::Duration warmup = absl::Seconds(5);
+
+  // Time during which measurements are taken.
+  absl::Duration duration = absl::Seconds(30);
+
+  // If true, a single task runner is shared by all workers. This requires the
+  // task to support concurrent calls, e.g. through
+  // `BaseOptions.num_interpreters`. Otherwise, each worker gets its own.
+  bool share_task_runner = false;
+
+  // Seed of the Poisson arrival process.
+  uint64_t seed = 0;
+};
+
+// Summary of a distribution of durations.
+struct LatencyDistribution {
+  absl::Duration mean;
+  absl::Duration p50;
+  absl::Duration p90;
+  absl::Duration p95;
+  absl::Duration p99;
+  absl::Duration p999;
+  absl::Duration max;
+};
+
+// Measurements taken during a RunLoad call.
+//
+// Requests are accounted for if they arrived (open loop) or were issued (closed
+// loop) during the measurement window, with the exception of `throughput`
+// which counts the requests successfully completed during that window.
+struct LoadReport {
+  // Duration of the measurement window.
+  absl::Duration measured_duration;
+
+  int64_t completed_requests = 0;
+  int64_t failed_requests = 0;
+  int64_t dropped_requests = 0;
+
+  // Successfully completed requests per second.
+  double throughput = 0;
+
+  // Time between the arrival of a request and its completion. This includes
+  // queueing delays in open-loop mode.
+  LatencyDistribution latency;
+
+  // Time spent in the task API to serve a request.
+  LatencyDistribution service_time;
+
+  // Average number of CPU cores used by the whole process, or a negative value
+  // if CPU usage could not be measured.
+  double cpu_cores_used = -1;
+
+  // Number of CPUs available on the machine.
+  int num_cpus = 0;
+
+  // The first error returned by the task API, if any.
+  absl::Status first_error;
+};
+
+// Creates the task runners needed for `options`, applies load to them and
+// returns the resulting measurements.
+tflite::support::StatusOr<LoadReport> RunLoad(
+    const TaskRunnerFactory& task_runner_factory,
+    const LoadGeneratorOptions& options);
+
+// Returns a human readable version of `report`.
+std::string FormatLoadReport(const LoadReport& report);
+
+// Returns the nearest-rank `percentile`, in [0, 100], of `sorted_durations`,
+// or zero if empty.
+absl::Duration Percentile(const std::vector<absl::Duration>& sorted_durations,
+                          double percentile);
+
+// Returns the summary of `durations`, which need not be sorted. All fields are
+// zero if `durations` is empty.
+LatencyDistribution Summarize(std::vector<absl::Duration> durations);
+
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_LOAD_GENERATOR_H_
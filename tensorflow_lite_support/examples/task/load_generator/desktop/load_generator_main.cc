@@ -0,0 +1,196 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Example usage:
+// bazel run -c opt \
+//  tensorflow_lite_support/examples/task/load_generator/desktop:load_generator \
+//  -- \
+//  --task=image_classifier \
+//  --model_path=/path/to/model.tflite \
+//  --input_corpus=/path/to/corpus.txt \
+//  --mode=open_loop \
+//  --request_rate=50 \
+//  --concurrency=4
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "absl/flags/flag.h"  // from @com_google_absl
+#include "absl/flags/parse.h"  // from @com_google_absl
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/configuration_proto_inc.h"
+#include "tensorflow_lite_support/cc/port/proto2.h"
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/core/proto/base_options_proto_inc.h"
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/load_generator.h"
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/task_runners.h"
+
+ABSL_FLAG(std::string, task, "",
+          "Name of the task API to load, e.g. 'image_classifier'.");
+ABSL_FLAG(std::string, model_path, "",
+          "Absolute path to the '.tflite' model. Overrides the model file set "
+          "in 'base_options', if any.");
+ABSL_FLAG(std::string, base_options, "",
+          "Optional path to a text-format tflite.task.core.BaseOptions proto "
+          "used to create the task instances.");
+ABSL_FLAG(std::string, compute_settings, "",
+          "Optional path to a text-format tflite.proto.ComputeSettings proto, "
+          "merged into the compute settings of 'base_options'.");
+ABSL_FLAG(std::string, input_corpus, "",
+          "Path to a text file with one input per line. See README.md for the "
+          "format expected by each task.");
+ABSL_FLAG(std::string, mode, "closed_loop",
+          "Either 'closed_loop', where each worker issues a new request as "
+          "soon as the previous one completes, or 'open_loop', where requests "
+          "arrive following a Poisson process of rate 'request_rate'.");
+ABSL_FLAG(int, concurrency, 1, "Number of requests served concurrently.");
+ABSL_FLAG(double, request_rate, 0,
+          "Mean number of requests per second in open-loop mode.");
+ABSL_FLAG(int, max_pending_requests, 1000,
+          "Maximum number of requests queued in open-loop mode. Requests "
+          "arriving while the queue is full are dropped.");
+ABSL_FLAG(double, warmup_seconds, 5,
+          "Time during which load is applied before measurements start.");
+ABSL_FLAG(double, duration_seconds, 30,
+          "Time during which measurements are taken.");
+ABSL_FLAG(bool, share_task_runner, false,
+          "If true, a single task instance serves all workers. Use along with "
+          "'num_interpreters' in 'base_options'.");
+ABSL_FLAG(uint64_t, seed, 0, "Seed of the open-loop arrival process.");
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+
+namespace {
+
+using ::tflite::support::proto::TextFormat;
+
+template <typename Proto>
+absl::Status ReadTextProto(const std::string& path, Proto* proto) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return absl::NotFoundError(absl::StrCat("Unable to open file: ", path));
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  if (!TextFormat::ParseFromString(contents.str(), proto)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unable to parse text proto: ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+tflite::support::StatusOr<core::BaseOptions> BuildBaseOptions() {
+  core::BaseOptions base_options;
+  if (!absl::GetFlag(FLAGS_base_options).empty()) {
+    RETURN_IF_ERROR(
+        ReadTextProto(absl::GetFlag(FLAGS_base_options), &base_options));
+  }
+  if (!absl::GetFlag(FLAGS_compute_settings).empty()) {
+    tflite::proto::ComputeSettings compute_settings;
+    RETURN_IF_ERROR(ReadTextProto(absl::GetFlag(FLAGS_compute_settings),
+                                  &compute_settings));
+    base_options.mutable_compute_settings()->MergeFrom(compute_settings);
+  }
+  if (!absl::GetFlag(FLAGS_model_path).empty()) {
+    base_options.mutable_model_file()->Clear();
+    base_options.mutable_model_file()->set_file_name(
+        absl::GetFlag(FLAGS_model_path));
+  }
+  return base_options;
+}
+
+tflite::support::StatusOr<LoadGeneratorOptions> BuildLoadGeneratorOptions() {
+  LoadGeneratorOptions options;
+  const std::string mode = absl::GetFlag(FLAGS_mode);
+  if (mode == "closed_loop") {
+    options.mode = LoadMode::kClosedLoop;
+  } else if (mode == "open_loop") {
+    options.mode = LoadMode::kOpenLoop;
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown mode '", mode,
+                     "', expected 'closed_loop' or 'open_loop'."));
+  }
+  options.concurrency = absl::GetFlag(FLAGS_concurrency);
+  options.request_rate = absl::GetFlag(FLAGS_request_rate);
+  options.max_pending_requests = absl::GetFlag(FLAGS_max_pending_requests);
+  options.warmup = absl::Seconds(absl::GetFlag(FLAGS_warmup_seconds));
+  options.duration = absl::Seconds(absl::GetFlag(FLAGS_duration_seconds));
+  options.share_task_runner = absl::GetFlag(FLAGS_share_task_runner);
+  options.seed = absl::GetFlag(FLAGS_seed);
+  if (options.share_task_runner &&
+      !SupportsSharedTaskRunner(absl::GetFlag(FLAGS_task))) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Task '", absl::GetFlag(FLAGS_task),
+                     "' does not support 'share_task_runner'."));
+  }
+  return options;
+}
+
+absl::Status RunLoadGenerator() {
+  ASSIGN_OR_RETURN(core::BaseOptions base_options, BuildBaseOptions());
+  ASSIGN_OR_RETURN(LoadGeneratorOptions options, BuildLoadGeneratorOptions());
+  ASSIGN_OR_RETURN(TaskRunnerFactory factory,
+                   CreateTaskRunnerFactory(absl::GetFlag(FLAGS_task),
+                                           base_options,
+                                           absl::GetFlag(FLAGS_input_corpus)));
+  ASSIGN_OR_RETURN(LoadReport report, RunLoad(factory, options));
+  std::cout << FormatLoadReport(report);
+  return absl::OkStatus();
+}
+
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  // Parse command line and perform sanity checks.
+  absl::ParseCommandLine(argc, argv);
+  if (absl::GetFlag(FLAGS_task).empty()) {
+    std::cerr << "Missing mandatory 'task' argument. Supported tasks are: "
+              << absl::StrJoin(
+                     tflite::task::load_generator::GetSupportedTasks(), ", ")
+              << "\n";
+    return 1;
+  }
+  if (absl::GetFlag(FLAGS_model_path).empty() &&
+      absl::GetFlag(FLAGS_base_options).empty()) {
+    std::cerr << "Missing mandatory 'model_path' or 'base_options' "
+                 "argument.\n";
+    return 1;
+  }
+  if (absl::GetFlag(FLAGS_input_corpus).empty()) {
+    std::cerr << "Missing mandatory 'input_corpus' argument.\n";
+    return 1;
+  }
+
+  // Run load generator.
+  absl::Status status = tflite::task::load_generator::RunLoadGenerator();
+  if (status.ok()) {
+    return 0;
+  } else {
+    std::cerr << "Load generation failed: " << status.message() << "\n";
+    return 1;
+  }
+}
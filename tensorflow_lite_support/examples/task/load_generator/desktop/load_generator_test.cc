@@ -0,0 +1,227 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/load_generator.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/time/clock.h"  // from @com_google_absl
+#include "absl/time/time.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/gmock.h"
+#include "tensorflow_lite_support/cc/port/gtest.h"
+#include "tensorflow_lite_support/cc/port/status_matchers.h"
+#include "tensorflow_lite_support/cc/port/statusor.h"
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tflite::support::StatusOr;
+
+// Shared state of the stub task runners created by a test.
+struct StubState {
+  std::atomic<int> num_runners{0};
+  std::atomic<int> num_runs{0};
+  std::atomic<int> max_index{-1};
+};
+
+// Task runner sleeping for a fixed service time, and failing if requested.
+class StubTaskRunner : public TaskRunner {
+ public:
+  StubTaskRunner(StubState* state, absl::Duration service_time, bool fail)
+      : state_(state), service_time_(service_time), fail_(fail) {}
+
+  int corpus_size() const override { return 3; }
+
+  absl::Status Run(int index) override {
+    state_->num_runs.fetch_add(1);
+    int max_index = state_->max_index.load();
+    while (index > max_index &&
+           !state_->max_index.compare_exchange_weak(max_index, index)) {
+    }
+    absl::SleepFor(service_time_);
+    return fail_ ? absl::InternalError("stub failure") : absl::OkStatus();
+  }
+
+ private:
+  StubState* const state_;
+  const absl::Duration service_time_;
+  const bool fail_;
+};
+
+TaskRunnerFactory CreateStubFactory(StubState* state,
+                                    absl::Duration service_time,
+                                    bool fail = false) {
+  return [=]() -> StatusOr<std::unique_ptr<TaskRunner>> {
+    state->num_runners.fetch_add(1);
+    return std::unique_ptr<TaskRunner>(
+        new StubTaskRunner(state, service_time, fail));
+  };
+}
+
+std::vector<absl::Duration> Milliseconds(std::vector<int> values) {
+  std::vector<absl::Duration> durations;
+  for (int value : values) {
+    durations.push_back(absl::Milliseconds(value));
+  }
+  return durations;
+}
+
+TEST(PercentileTest, ReturnsZeroWhenEmpty) {
+  EXPECT_EQ(Percentile({}, 50), absl::ZeroDuration());
+}
+
+TEST(PercentileTest, ReturnsSingleSample) {
+  const std::vector<absl::Duration> durations = Milliseconds({7});
+
+  EXPECT_EQ(Percentile(durations, 0), absl::Milliseconds(7));
+  EXPECT_EQ(Percentile(durations, 50), absl::Milliseconds(7));
+  EXPECT_EQ(Percentile(durations, 100), absl::Milliseconds(7));
+}
+
+TEST(PercentileTest, ReturnsNearestRank) {
+  const std::vector<absl::Duration> durations =
+      Milliseconds({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+  EXPECT_EQ(Percentile(durations, 0), absl::Milliseconds(1));
+  EXPECT_EQ(Percentile(durations, 10), absl::Milliseconds(1));
+  EXPECT_EQ(Percentile(durations, 11), absl::Milliseconds(2));
+  EXPECT_EQ(Percentile(durations, 50), absl::Milliseconds(5));
+  EXPECT_EQ(Percentile(durations, 99.9), absl::Milliseconds(10));
+  EXPECT_EQ(Percentile(durations, 100), absl::Milliseconds(10));
+}
+
+TEST(SummarizeTest, ReturnsZerosWhenEmpty) {
+  const LatencyDistribution distribution = Summarize({});
+
+  EXPECT_EQ(distribution.mean, absl::ZeroDuration());
+  EXPECT_EQ(distribution.p50, absl::ZeroDuration());
+  EXPECT_EQ(distribution.max, absl::ZeroDuration());
+}
+
+TEST(SummarizeTest, SummarizesUnsortedDurations) {
+  std::vector<absl::Duration> durations;
+  for (int i = 100; i >= 1; --i) {
+    durations.push_back(absl::Milliseconds(i));
+  }
+
+  const LatencyDistribution distribution = Summarize(durations);
+
+  EXPECT_EQ(distribution.mean, absl::Microseconds(50500));
+  EXPECT_EQ(distribution.p50, absl::Milliseconds(50));
+  EXPECT_EQ(distribution.p90, absl::Milliseconds(90));
+  EXPECT_EQ(distribution.p95, absl::Milliseconds(95));
+  EXPECT_EQ(distribution.p99, absl::Milliseconds(99));
+  EXPECT_EQ(distribution.p999, absl::Milliseconds(100));
+  EXPECT_EQ(distribution.max, absl::Milliseconds(100));
+}
+
+TEST(RunLoadTest, FailsWithInvalidOptions) {
+  StubState state;
+  LoadGeneratorOptions options;
+  options.mode = LoadMode::kOpenLoop;
+  options.request_rate = 0;
+
+  StatusOr<LoadReport> report =
+      RunLoad(CreateStubFactory(&state, absl::ZeroDuration()), options);
+
+  EXPECT_EQ(report.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(state.num_runners.load(), 0);
+}
+
+TEST(RunLoadTest, SchedulesOpenLoopRequestsAtRequestRate) {
+  StubState state;
+  LoadGeneratorOptions options;
+  options.mode = LoadMode::kOpenLoop;
+  options.concurrency = 2;
+  options.request_rate = 200;
+  options.warmup = absl::ZeroDuration();
+  options.duration = absl::Seconds(1);
+  options.seed = 42;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      LoadReport report,
+      RunLoad(CreateStubFactory(&state, absl::Milliseconds(1)), options));
+
+  // One runner per worker, and requests spread over the whole corpus.
+  EXPECT_EQ(state.num_runners.load(), 2);
+  EXPECT_EQ(state.max_index.load(), 2);
+  // ~200 Poisson arrivals, i.e. a standard deviation of ~14.
+  EXPECT_GT(report.completed_requests, 120);
+  EXPECT_LT(report.completed_requests, 280);
+  EXPECT_EQ(report.completed_requests, state.num_runs.load());
+  EXPECT_EQ(report.failed_requests, 0);
+  EXPECT_EQ(report.dropped_requests, 0);
+  EXPECT_TRUE(report.first_error.ok());
+  // Latencies include the service time.
+  EXPECT_GE(report.service_time.p50, absl::Milliseconds(1));
+  EXPECT_GE(report.latency.p50, report.service_time.p50);
+  EXPECT_GE(report.latency.max, report.latency.p99);
+}
+
+TEST(RunLoadTest, DropsOpenLoopRequestsWhenQueueIsFull) {
+  StubState state;
+  LoadGeneratorOptions options;
+  options.mode = LoadMode::kOpenLoop;
+  options.concurrency = 1;
+  options.request_rate = 500;
+  options.max_pending_requests = 1;
+  options.warmup = absl::ZeroDuration();
+  options.duration = absl::Milliseconds(500);
+  options.share_task_runner = true;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      LoadReport report,
+      RunLoad(CreateStubFactory(&state, absl::Milliseconds(20)), options));
+
+  // At most ~25 requests can be served, out of ~250 arrivals.
+  EXPECT_GT(report.dropped_requests, 0);
+  EXPECT_LT(report.completed_requests, 50);
+  // Dropped requests are never run.
+  EXPECT_EQ(report.completed_requests, state.num_runs.load());
+}
+
+TEST(RunLoadTest, ReportsFailedRequests) {
+  StubState state;
+  LoadGeneratorOptions options;
+  options.concurrency = 2;
+  options.warmup = absl::ZeroDuration();
+  options.duration = absl::Milliseconds(100);
+  options.share_task_runner = true;
+
+  SUPPORT_ASSERT_OK_AND_ASSIGN(
+      LoadReport report,
+      RunLoad(CreateStubFactory(&state, absl::Milliseconds(5), /*fail=*/true),
+              options));
+
+  // A single runner is shared by both workers.
+  EXPECT_EQ(state.num_runners.load(), 1);
+  EXPECT_EQ(report.completed_requests, 0);
+  EXPECT_GT(report.failed_requests, 0);
+  EXPECT_EQ(report.throughput, 0);
+  EXPECT_EQ(report.first_error.code(), absl::StatusCode::kInternal);
+  EXPECT_THAT(FormatLoadReport(report),
+              HasSubstr("First error: INTERNAL: stub failure"));
+}
+
+}  // namespace
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,417 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/task_runners.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"  // from @com_google_absl
+#include "absl/strings/str_cat.h"  // from @com_google_absl
+#include "absl/strings/str_join.h"  // from @com_google_absl
+#include "absl/strings/str_split.h"  // from @com_google_absl
+#include "absl/strings/string_view.h"  // from @com_google_absl
+#include "tensorflow_lite_support/cc/port/status_macros.h"
+#include "tensorflow_lite_support/cc/task/audio/audio_classifier.h"
+#include "tensorflow_lite_support/cc/task/audio/audio_embedder.h"
+#include "tensorflow_lite_support/cc/task/audio/core/audio_buffer.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_classifier_options.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/proto/audio_embedder_options.pb.h"
+#include "tensorflow_lite_support/cc/task/audio/utils/audio_utils.h"
+#include "tensorflow_lite_support/cc/task/text/bert_clu_annotator.h"
+#include "tensorflow_lite_support/cc/task/text/bert_nl_classifier.h"
+#include "tensorflow_lite_support/cc/task/text/bert_question_answerer.h"
+#include "tensorflow_lite_support/cc/task/text/nlclassifier/nl_classifier.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_clu_annotator_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_nl_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/bert_question_answerer_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/clu_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/nl_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/text/proto/text_embedder_options.pb.h"
+#include "tensorflow_lite_support/cc/task/text/proto/text_searcher_options.pb.h"
+#include "tensorflow_lite_support/cc/task/text/text_embedder.h"
+#include "tensorflow_lite_support/cc/task/text/text_searcher.h"
+#include "tensorflow_lite_support/cc/task/text/utils/text_op_resolver.h"
+#include "tensorflow_lite_support/cc/task/vision/core/frame_buffer.h"
+#include "tensorflow_lite_support/cc/task/vision/image_classifier.h"
+#include "tensorflow_lite_support/cc/task/vision/image_embedder.h"
+#include "tensorflow_lite_support/cc/task/vision/image_searcher.h"
+#include "tensorflow_lite_support/cc/task/vision/image_segmenter.h"
+#include "tensorflow_lite_support/cc/task/vision/object_detector.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_classifier_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_embedder_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_searcher_options.pb.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/image_segmenter_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/proto/object_detector_options_proto_inc.h"
+#include "tensorflow_lite_support/cc/task/vision/utils/image_utils.h"
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+
+namespace {
+
+using ::tflite::support::StatusOr;
+using ::tflite::task::core::BaseOptions;
+
+constexpr char kImageClassifier[] = "image_classifier";
+constexpr char kObjectDetector[] = "object_detector";
+constexpr char kImageSegmenter[] = "image_segmenter";
+constexpr char kImageEmbedder[] = "image_embedder";
+constexpr char kImageSearcher[] = "image_searcher";
+constexpr char kNLClassifier[] = "nl_classifier";
+constexpr char kBertNLClassifier[] = "bert_nl_classifier";
+constexpr char kBertQuestionAnswerer[] = "bert_question_answerer";
+constexpr char kTextEmbedder[] = "text_embedder";
+constexpr char kTextSearcher[] = "text_searcher";
+constexpr char kBertCluAnnotator[] = "bert_clu_annotator";
+constexpr char kAudioClassifier[] = "audio_classifier";
+constexpr char kAudioEmbedder[] = "audio_embedder";
+
+// A decoded image, along with the FrameBuffer wrapping its pixels.
+class DecodedImage {
+ public:
+  static StatusOr<std::unique_ptr<DecodedImage>> Load(const std::string& path) {
+    ASSIGN_OR_RETURN(vision::ImageData image_data,
+                     vision::DecodeImageFromFile(path));
+    std::unique_ptr<DecodedImage> image(new DecodedImage(image_data));
+    ASSIGN_OR_RETURN(image->frame_buffer_,
+                     vision::CreateFrameBufferFromImageData(image_data));
+    return image;
+  }
+
+  ~DecodedImage() { vision::ImageDataFree(&image_data_); }
+
+  DecodedImage(const DecodedImage&) = delete;
+  DecodedImage& operator=(const DecodedImage&) = delete;
+
+  const vision::FrameBuffer& frame_buffer() const { return *frame_buffer_; }
+
+ private:
+  explicit DecodedImage(vision::ImageData image_data)
+      : image_data_(image_data) {}
+
+  vision::ImageData image_data_;
+  std::unique_ptr<vision::FrameBuffer> frame_buffer_;
+};
+
+// A decoded WAV file, along with the AudioBuffer wrapping its samples.
+struct DecodedAudio {
+  // Backs `buffer` and needs to outlive it.
+  std::vector<float> wav_data;
+  std::unique_ptr<audio::AudioBuffer> buffer;
+};
+
+using ImageCorpus = std::vector<std::unique_ptr<DecodedImage>>;
+using TextCorpus = std::vector<std::string>;
+using QuestionCorpus = std::vector<std::pair<std::string, std::string>>;
+using CluCorpus = std::vector<text::CluRequest>;
+using AudioCorpus = std::vector<std::unique_ptr<DecodedAudio>>;
+
+// Runs `infer` on an instance of `Task`, with inputs taken from `corpus`.
+template <typename Task, typename Corpus, typename InferFn>
+class TaskRunnerImpl : public TaskRunner {
+ public:
+  TaskRunnerImpl(std::unique_ptr<Task> task,
+                 std::shared_ptr<const Corpus> corpus, InferFn infer)
+      : task_(std::move(task)),
+        corpus_(std::move(corpus)),
+        infer_(std::move(infer)) {}
+
+  int corpus_size() const override { return corpus_->size(); }
+
+  absl::Status Run(int index) override {
+    return infer_(task_.get(), (*corpus_)[index]);
+  }
+
+ private:
+  std::unique_ptr<Task> task_;
+  std::shared_ptr<const Corpus> corpus_;
+  InferFn infer_;
+};
+
+// Returns a factory creating task instances from `options` with `create`, and
+// running `infer` on them.
+template <typename Options, typename CreateFn, typename Corpus,
+          typename InferFn>
+TaskRunnerFactory MakeTaskRunnerFactory(const BaseOptions& base_options,
+                                        CreateFn create,
+                                        std::shared_ptr<const Corpus> corpus,
+                                        InferFn infer) {
+  Options options;
+  *options.mutable_base_options() = base_options;
+  return [options, create, corpus,
+          infer]() -> StatusOr<std::unique_ptr<TaskRunner>> {
+    ASSIGN_OR_RETURN(auto task, create(options));
+    using Task = typename decltype(task)::element_type;
+    return std::unique_ptr<TaskRunner>(
+        new TaskRunnerImpl<Task, Corpus, InferFn>(std::move(task), corpus,
+                                                  infer));
+  };
+}
+
+// Same as above, for tasks created through `Task::CreateFromOptions` with the
+// default op resolver.
+template <typename Task, typename Options, typename Corpus, typename InferFn>
+TaskRunnerFactory MakeTaskRunnerFactory(const BaseOptions& base_options,
+                                        std::shared_ptr<const Corpus> corpus,
+                                        InferFn infer) {
+  return MakeTaskRunnerFactory<Options>(
+      base_options,
+      [](const Options& options) { return Task::CreateFromOptions(options); },
+      std::move(corpus), std::move(infer));
+}
+
+// Returns the non-empty lines of the file at `path`.
+StatusOr<std::vector<std::string>> ReadCorpusLines(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return absl::NotFoundError(
+        absl::StrCat("Unable to open input corpus: ", path));
+  }
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty()) {
+      lines.push_back(std::move(line));
+    }
+  }
+  if (lines.empty()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Input corpus is empty: ", path));
+  }
+  return lines;
+}
+
+StatusOr<std::shared_ptr<const ImageCorpus>> LoadImageCorpus(
+    const std::vector<std::string>& lines) {
+  auto corpus = std::make_shared<ImageCorpus>();
+  for (const std::string& path : lines) {
+    ASSIGN_OR_RETURN(std::unique_ptr<DecodedImage> image,
+                     DecodedImage::Load(path));
+    corpus->push_back(std::move(image));
+  }
+  return corpus;
+}
+
+StatusOr<std::shared_ptr<const QuestionCorpus>> LoadQuestionCorpus(
+    const std::vector<std::string>& lines) {
+  auto corpus = std::make_shared<QuestionCorpus>();
+  for (const std::string& line : lines) {
+    std::vector<std::string> fields =
+        absl::StrSplit(line, absl::MaxSplits('\t', 1));
+    if (fields.size() != 2) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected a question and a context separated by a tab, got: ",
+          line));
+    }
+    corpus->emplace_back(std::move(fields[0]), std::move(fields[1]));
+  }
+  return corpus;
+}
+
+std::shared_ptr<const CluCorpus> LoadCluCorpus(
+    const std::vector<std::string>& lines) {
+  auto corpus = std::make_shared<CluCorpus>();
+  for (const std::string& line : lines) {
+    text::CluRequest& request = corpus->emplace_back();
+    for (absl::string_view utterance : absl::StrSplit(line, '\t')) {
+      request.add_utterances(std::string(utterance));
+    }
+  }
+  return corpus;
+}
+
+// Loads the WAV files listed in `lines`, using a throwaway instance of `Task`
+// to find out how many samples the model consumes per inference.
+template <typename Task, typename Options>
+StatusOr<std::shared_ptr<const AudioCorpus>> LoadAudioCorpus(
+    const BaseOptions& base_options, const std::vector<std::string>& lines) {
+  Options options;
+  *options.mutable_base_options() = base_options;
+  ASSIGN_OR_RETURN(std::unique_ptr<Task> task,
+                   Task::CreateFromOptions(options));
+  const uint32_t required_buffer_size = task->GetRequiredInputBufferSize();
+  auto corpus = std::make_shared<AudioCorpus>();
+  for (const std::string& path : lines) {
+    auto audio = std::make_unique<DecodedAudio>();
+    uint32_t buffer_size = required_buffer_size;
+    uint32_t offset = 0;
+    ASSIGN_OR_RETURN(audio::AudioBuffer buffer,
+                     audio::LoadAudioBufferFromFile(path, &buffer_size, &offset,
+                                                    &audio->wav_data));
+    audio->buffer = std::make_unique<audio::AudioBuffer>(buffer);
+    corpus->push_back(std::move(audio));
+  }
+  return corpus;
+}
+
+}  // namespace
+
+std::vector<std::string> GetSupportedTasks() {
+  return {kImageClassifier, kObjectDetector,        kImageSegmenter,
+          kImageEmbedder,   kImageSearcher,         kNLClassifier,
+          kBertNLClassifier, kBertQuestionAnswerer, kTextEmbedder,
+          kTextSearcher,    kBertCluAnnotator,      kAudioClassifier,
+          kAudioEmbedder};
+}
+
+bool SupportsSharedTaskRunner(const std::string& task_name) {
+  // These tasks keep per-call state in the task instance.
+  return task_name != kBertQuestionAnswerer && task_name != kBertCluAnnotator;
+}
+
+StatusOr<TaskRunnerFactory> CreateTaskRunnerFactory(
+    const std::string& task_name, const BaseOptions& base_options,
+    const std::string& corpus_path) {
+  ASSIGN_OR_RETURN(std::vector<std::string> lines,
+                   ReadCorpusLines(corpus_path));
+
+  // Vision tasks.
+  if (task_name == kImageClassifier || task_name == kObjectDetector ||
+      task_name == kImageSegmenter || task_name == kImageEmbedder ||
+      task_name == kImageSearcher) {
+    ASSIGN_OR_RETURN(std::shared_ptr<const ImageCorpus> corpus,
+                     LoadImageCorpus(lines));
+    if (task_name == kImageClassifier) {
+      return MakeTaskRunnerFactory<vision::ImageClassifier,
+                                   vision::ImageClassifierOptions>(
+          base_options, corpus, [](auto* task, const auto& image) {
+            return task->Classify(image->frame_buffer()).status();
+          });
+    }
+    if (task_name == kObjectDetector) {
+      return MakeTaskRunnerFactory<vision::ObjectDetector,
+                                   vision::ObjectDetectorOptions>(
+          base_options, corpus, [](auto* task, const auto& image) {
+            return task->Detect(image->frame_buffer()).status();
+          });
+    }
+    if (task_name == kImageSegmenter) {
+      return MakeTaskRunnerFactory<vision::ImageSegmenter,
+                                   vision::ImageSegmenterOptions>(
+          base_options, corpus, [](auto* task, const auto& image) {
+            return task->Segment(image->frame_buffer()).status();
+          });
+    }
+    if (task_name == kImageEmbedder) {
+      return MakeTaskRunnerFactory<vision::ImageEmbedder,
+                                   vision::ImageEmbedderOptions>(
+          base_options, corpus, [](auto* task, const auto& image) {
+            return task->Embed(image->frame_buffer()).status();
+          });
+    }
+    return MakeTaskRunnerFactory<vision::ImageSearcher,
+                                 vision::ImageSearcherOptions>(
+        base_options, corpus, [](auto* task, const auto& image) {
+          return task->Search(image->frame_buffer()).status();
+        });
+  }
+
+  // Text tasks.
+  auto text_corpus = std::make_shared<const TextCorpus>(std::move(lines));
+  if (task_name == kNLClassifier) {
+    return MakeTaskRunnerFactory<text::nlclassifier::NLClassifier,
+                                 text::NLClassifierOptions>(
+        base_options, text_corpus, [](auto* task, const std::string& input) {
+          return task->ClassifyText(input).status();
+        });
+  }
+  if (task_name == kBertNLClassifier) {
+    return MakeTaskRunnerFactory<text::BertNLClassifier,
+                                 text::BertNLClassifierOptions>(
+        base_options, text_corpus, [](auto* task, const std::string& input) {
+          return task->ClassifyText(input).status();
+        });
+  }
+  if (task_name == kTextEmbedder) {
+    return MakeTaskRunnerFactory<text::TextEmbedderOptions>(
+        base_options,
+        [](const text::TextEmbedderOptions& options) {
+          return text::TextEmbedder::CreateFromOptions(
+              options, text::CreateTextOpResolver());
+        },
+        text_corpus,
+        [](auto* task, const std::string& input) {
+          return task->Embed(input).status();
+        });
+  }
+  if (task_name == kTextSearcher) {
+    return MakeTaskRunnerFactory<text::TextSearcherOptions>(
+        base_options,
+        [](const text::TextSearcherOptions& options) {
+          return text::TextSearcher::CreateFromOptions(
+              options, text::CreateTextOpResolver());
+        },
+        text_corpus,
+        [](auto* task, const std::string& input) {
+          return task->Search(input).status();
+        });
+  }
+  if (task_name == kBertQuestionAnswerer) {
+    ASSIGN_OR_RETURN(std::shared_ptr<const QuestionCorpus> corpus,
+                     LoadQuestionCorpus(*text_corpus));
+    return MakeTaskRunnerFactory<text::BertQuestionAnswerer,
+                                 text::BertQuestionAnswererOptions>(
+        base_options, corpus, [](auto* task, const auto& question) {
+          // Answer() does not report errors.
+          task->Answer(/*context=*/question.second,
+                       /*question=*/question.first);
+          return absl::OkStatus();
+        });
+  }
+  if (task_name == kBertCluAnnotator) {
+    return MakeTaskRunnerFactory<text::clu::BertCluAnnotator,
+                                 text::BertCluAnnotatorOptions>(
+        base_options, LoadCluCorpus(*text_corpus),
+        [](auto* task, const text::CluRequest& request) {
+          return task->Annotate(request).status();
+        });
+  }
+
+  // Audio tasks.
+  if (task_name == kAudioClassifier) {
+    ASSIGN_OR_RETURN(
+        std::shared_ptr<const AudioCorpus> corpus,
+        (LoadAudioCorpus<audio::AudioClassifier, audio::AudioClassifierOptions>(
+            base_options, *text_corpus)));
+    return MakeTaskRunnerFactory<audio::AudioClassifier,
+                                 audio::AudioClassifierOptions>(
+        base_options, corpus, [](auto* task, const auto& audio) {
+          return task->Classify(*audio->buffer).status();
+        });
+  }
+  if (task_name == kAudioEmbedder) {
+    ASSIGN_OR_RETURN(
+        std::shared_ptr<const AudioCorpus> corpus,
+        (LoadAudioCorpus<audio::AudioEmbedder, audio::AudioEmbedderOptions>(
+            base_options, *text_corpus)));
+    return MakeTaskRunnerFactory<audio::AudioEmbedder,
+                                 audio::AudioEmbedderOptions>(
+        base_options, corpus, [](auto* task, const auto& audio) {
+          return task->Embed(*audio->buffer).status();
+        });
+  }
+
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unsupported task: ", task_name, ". Supported tasks are: ",
+                   absl::StrJoin(GetSupportedTasks(), ", ")));
+}
+
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
@@ -0,0 +1,57 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_TASK_RUNNERS_H_
+#define TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_TASK_RUNNERS_H_
+
+#include <string>
+#include <vector>
+
+#include "tensorflow_lite_support/cc/port/statusor.h"
+#include "tensorflow_lite_support/cc/task/core/proto/base_options_proto_inc.h"
+#include "tensorflow_lite_support/examples/task/load_generator/desktop/load_generator.h"
+
+namespace tflite {
+namespace task {
+namespace load_generator {
+
+// Returns the names of the task APIs supported by CreateTaskRunnerFactory.
+std::vector<std::string> GetSupportedTasks();
+
+// Returns whether a single instance of `task_name` can serve concurrent
+// requests, i.e. whether it can be used with
+// `LoadGeneratorOptions.share_task_runner`.
+bool SupportsSharedTaskRunner(const std::string& task_name);
+
+// Creates a factory of task runners for the `task_name` task API, each
+// instance being created from `base_options`.
+//
+// `corpus_path` points to a text file with one input per line, loaded once and
+// shared by all task runners:
+// - vision tasks: path to an image file,
+// - audio tasks: path to a WAV file,
+// - bert_question_answerer: a question and its context, separated by a tab,
+// - bert_clu_annotator: the utterances of a dialogue, separated by tabs,
+// - other text tasks: the input text.
+tflite::support::StatusOr<TaskRunnerFactory> CreateTaskRunnerFactory(
+    const std::string& task_name,
+    const tflite::task::core::BaseOptions& base_options,
+    const std::string& corpus_path);
+
+}  // namespace load_generator
+}  // namespace task
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SUPPORT_EXAMPLES_TASK_LOAD_GENERATOR_DESKTOP_TASK_RUNNERS_H_